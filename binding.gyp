@@ -1,64 +1,100 @@
 {
+    "variables": {
+        # Opt-in optimization profile, passed as --signun_build_profile=<profile>:
+        #   default: The compiler defaults of node-gyp.
+        #   lto: Link-time optimization across secp256k1, BLAKE2 and the addons.
+        #   pgo-generate: LTO, instrumented to record a profile into signun_pgo_dir.
+        #   pgo-use: LTO, optimized with the profile recorded by pgo-generate.
+        # See util/pgo/build.sh for the whole PGO cycle.
+        "signun_build_profile%": "default",
+        # Outside of build/, as node-gyp rebuild wipes that between the two PGO builds.
+        "signun_pgo_dir%": "<(module_root_dir)/pgo-profile"
+    },
     "targets": [{
         "target_name": "signun",
-        "actions": [
-            {
-                # For debugging purposes, it's printed whether we
-                # are building with GMP or not.
-                'action_name': 'print_gmp_found',
-                'action': [ 'echo', 'Building with GMP: <(gmp_found)' ],
-                'inputs': [],
-                # Must reference a source file here so that
-                # the action is called.
-                'outputs': [ "./src/native/src/signun.c" ]
-            }
-        ],
-        "variables": {
-            "conditions": [
-                [
-                    "OS=='win'",
-                    # On Windows, we don't even try to find GMP.
-                    {
-                        "gmp_found%": "false"
-                    },
-                    # Otherwise, check if it's installed.
-                    {
-                        "gmp_found%": "<!(sh ./util/has_lib.sh gmp)"
-                    }
-                ]
-            ]
-        },
         "sources": [
-            # secp256k1
-            "./dependencies/secp256k1/src/secp256k1.c",
+            # secp256k1, whose secp256k1.c is compiled through secp256k1_addon/internal.c
+            "./dependencies/secp256k1/src/precomputed_ecmult.c",
+            "./dependencies/secp256k1/src/precomputed_ecmult_gen.c",
+
+            # curve25519
+            "./dependencies/curve25519/crypto/curve25519/curve25519.c",
+            "./dependencies/curve25519/crypto/mem.c",
 
             # signun
             "./src/native/src/signun.c",
+            "./src/native/src/signun_batch.c",
+            "./src/native/src/signun_instance.c",
             "./src/native/src/signun_node.c",
+            "./src/native/src/signun_pool.c",
+            "./src/native/src/signun_scheduler.c",
+            "./src/native/src/signun_sha512.c",
             "./src/native/src/signun_util.c",
+            "./src/native/src/argon2_addon/argon2_addon.c",
+            "./src/native/src/argon2_addon/argon2.c",
+            "./src/native/src/argon2_addon/hash.c",
             "./src/native/src/blake2_addon/blake2_addon.c",
+            "./src/native/src/blake2_addon/blake2b_mac.c",
+            "./src/native/src/blake2_addon/blake2b_merkle.c",
+            "./src/native/src/blake2_addon/blake2b_merkle_accumulator.c",
+            "./src/native/src/blake2_addon/blake2b_stream.c",
+            "./src/native/src/blake2_addon/blake2b_work.c",
             "./src/native/src/blake2_addon/signun_blake2b.c",
+            "./src/native/src/ed25519_addon/ed25519_addon.c",
+            "./src/native/src/ed25519_addon/ed25519.c",
+            "./src/native/src/ed25519_addon/public_key_create.c",
+            "./src/native/src/ed25519_addon/sign.c",
+            "./src/native/src/ed25519_addon/util.c",
+            "./src/native/src/ed25519_addon/verify.c",
+            "./src/native/src/musig_addon/musig_addon.c",
+            "./src/native/src/musig_addon/key_agg.c",
+            "./src/native/src/musig_addon/session.c",
+            "./src/native/src/musig_addon/verify.c",
             "./src/native/src/secp256k1_addon/secp256k1_addon.c",
+            "./src/native/src/secp256k1_addon/derive.c",
+            "./src/native/src/secp256k1_addon/ecdh.c",
+            "./src/native/src/secp256k1_addon/internal.c",
+            "./src/native/src/secp256k1_addon/key_pair.c",
+            "./src/native/src/secp256k1_addon/message.c",
+            "./src/native/src/secp256k1_addon/multisig.c",
             "./src/native/src/secp256k1_addon/private_key_verify.c",
+            "./src/native/src/secp256k1_addon/public_key_convert.c",
             "./src/native/src/secp256k1_addon/public_key_create.c",
+            "./src/native/src/secp256k1_addon/public_key_pin.c",
             "./src/native/src/secp256k1_addon/sign.c",
+            "./src/native/src/secp256k1_addon/signature.c",
+            "./src/native/src/secp256k1_addon/signature_cache.c",
             "./src/native/src/secp256k1_addon/verify.c"
         ],
         "include_dirs": [
             # Dependencies
-            # Local Headers (including GMP)
-            "/usr/local/include",
-
             # secp256k1
             "./dependencies/secp256k1",
             "./dependencies/secp256k1/include",
             "./dependencies/secp256k1/src",
 
+            # curve25519
+            "./dependencies/curve25519",
+            "./dependencies/curve25519/include",
+
             # signun
             "./src/native/include"
         ],
         "defines": [
-            "ENABLE_MODULE_RECOVERY=1"
+            "ENABLE_MODULE_ECDH=1",
+            "ENABLE_MODULE_RECOVERY=1",
+            "ENABLE_MODULE_EXTRAKEYS=1",
+            "ENABLE_MODULE_SCHNORRSIG=1",
+            "ENABLE_MODULE_MUSIG=1",
+            # Elliptic curve multiplication precomputation table size.
+            # Set to the default value. Tune if needed.
+            "ECMULT_WINDOW_SIZE=15",
+            # Blocks and teeth of the signing comb, which has to be one of
+            # the tables in precomputed_ecmult_gen.c. Set to the default value.
+            "COMB_BLOCKS=11",
+            "COMB_TEETH=6",
+            # The portable C of curve25519, without ring's assembly.
+            "OPENSSL_NO_ASM=1"
         ],
         "cflags": [
             "-Wall",
@@ -73,46 +109,6 @@
             "-Wno-nonnull-compare",
         ],
         "conditions": [
-            [
-                "gmp_found == 'true'",
-                # If GMP is installed and found.
-                {
-                    "defines": [
-                        # GMP is installed on the system.
-                        "HAVE_LIBGMP=1",
-                        # Use GMP-based implementation for num.
-                        "USE_NUM_GMP=1",
-                        # Use the num-based field inverse implementation.
-                        "USE_FIELD_INV_NUM=1",
-                        # Use the num-based scalar inverse implementation.
-                        "USE_SCALAR_INV_NUM=1",
-                        # Elliptic curve multiplication precomputation table size.
-                        "ECMULT_WINDOW_SIZE=15",
-                        # Elliptic curve multiplication precomputation precision.
-                        "ECMULT_GEN_PREC_BITS=4"
-                    ],
-                    "libraries": [
-                        "-lgmp"
-                    ]
-                },
-                # Otherwise.
-                {
-                    "defines": [
-                        # Use no num implementation.
-                        "USE_NUM_NONE=1",
-                        # Use the native field inverse implementation.
-                        "USE_FIELD_INV_BUILTIN=1",
-                        # Use the native scalar inverse implementation.
-                        "USE_SCALAR_INV_BUILTIN=1",
-                        # Elliptic curve multiplication precomputation table size.
-                        # Set to the default value. Tune if needed.
-                        "ECMULT_WINDOW_SIZE=15",
-                        # Elliptic curve multiplication precomputation precision.
-                        # Set to the default value. Tune if needed.
-                        "ECMULT_GEN_PREC_BITS=4"
-                    ]
-                }
-            ],
             [
                 # Dependencies
                 # blake2
@@ -150,36 +146,75 @@
             [
                 "target_arch=='x64' and OS!='win'",
                 # 64-bit architecture but NOT Windows.
+                # secp256k1 picks its field and scalar implementations from
+                # the availability of __int128 on its own.
                 {
                     "defines": [
-                        # __int128 is available and supported.
-                        "HAVE___INT128=1",
                         # Enable x86_64 assembly optimizations.
-                        "USE_ASM_X86_64=1",
-                        # Use the FIELD_5X52 field implementation.
-                        "USE_FIELD_5X52=1",
-                        # TODO Not sure if needed.
-                        "USE_FIELD_5X52_INT128=1",
-                        # Use the 4x64 scalar implementation.
-                        "USE_SCALAR_4X64=1"
+                        "USE_ASM_X86_64=1"
                     ]
-                },
-                # Otherwise.
+                }
+            ],
+            [
+                "signun_build_profile!='default' and OS!='win'",
+                # LTO, for every profile but the default.
                 {
-                    "defines": [
-                        # Use the FIELD_10X26 field implementation.
-                        "USE_FIELD_10X26=1",
-                        # Use the 8x32 scalar implementation.
-                        "USE_SCALAR_8X32=1"
+                    "cflags": [
+                        "-O3",
+                        "-flto"
+                    ],
+                    "ldflags": [
+                        "-O3",
+                        "-flto"
+                    ],
+                    "xcode_settings": {
+                        "GCC_OPTIMIZATION_LEVEL": "3",
+                        "LLVM_LTO": "YES"
+                    }
+                }
+            ],
+            [
+                "signun_build_profile!='default' and OS=='win'",
+                {
+                    "msvs_settings": {
+                        "VCCLCompilerTool": {
+                            "WholeProgramOptimization": "true"
+                        },
+                        "VCLinkerTool": {
+                            "LinkTimeCodeGeneration": 1
+                        }
+                    }
+                }
+            ],
+            [
+                # PGO is only wired up for GCC, other toolchains get LTO alone.
+                "signun_build_profile=='pgo-generate' and OS=='linux'",
+                {
+                    "cflags": [
+                        "-fprofile-generate",
+                        "-fprofile-dir=<(signun_pgo_dir)",
+                        "-fprofile-update=atomic"
+                    ],
+                    "ldflags": [
+                        "-fprofile-generate",
+                        "-fprofile-dir=<(signun_pgo_dir)"
                     ]
                 }
             ],
             [
-                "OS=='mac'", {
-                # On Mac.
-                    "libraries": [
-                        "-L/usr/local/lib"
+                "signun_build_profile=='pgo-use' and OS=='linux'",
+                {
+                    "cflags": [
+                        "-fprofile-use",
+                        "-fprofile-dir=<(signun_pgo_dir)",
+                        "-fprofile-correction",
+                        # Functions the training workload never reaches have no profile.
+                        "-Wno-missing-profile"
                     ],
+                    "ldflags": [
+                        "-fprofile-use",
+                        "-fprofile-dir=<(signun_pgo_dir)"
+                    ]
                 }
             ]
         ]
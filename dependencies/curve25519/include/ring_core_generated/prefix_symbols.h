@@ -0,0 +1,25 @@
+// ring generates this header at build time to prefix every exported symbol
+// with its version. The symbols are prefixed with signun_ here instead, so
+// that they cannot clash with another copy of BoringSSL or ring loaded into
+// the same Node.js process.
+
+#ifndef RING_CORE_PREFIX_SYMBOLS_H
+#define RING_CORE_PREFIX_SYMBOLS_H
+
+#define CRYPTO_memcmp signun_CRYPTO_memcmp
+#define k25519Precomp signun_k25519Precomp
+#define x25519_fe_invert signun_x25519_fe_invert
+#define x25519_fe_isnegative signun_x25519_fe_isnegative
+#define x25519_fe_mul_ttt signun_x25519_fe_mul_ttt
+#define x25519_fe_neg signun_x25519_fe_neg
+#define x25519_fe_tobytes signun_x25519_fe_tobytes
+#define x25519_ge_double_scalarmult_vartime signun_x25519_ge_double_scalarmult_vartime
+#define x25519_ge_frombytes_vartime signun_x25519_ge_frombytes_vartime
+#define x25519_ge_scalarmult_base signun_x25519_ge_scalarmult_base
+#define x25519_public_from_private_generic_masked signun_x25519_public_from_private_generic_masked
+#define x25519_sc_mask signun_x25519_sc_mask
+#define x25519_sc_muladd signun_x25519_sc_muladd
+#define x25519_sc_reduce signun_x25519_sc_reduce
+#define x25519_scalar_mult_generic_masked signun_x25519_scalar_mult_generic_masked
+
+#endif
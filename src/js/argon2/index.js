@@ -0,0 +1,163 @@
+const { randomBytes, timingSafeEqual } = require('crypto');
+
+const { argon2 } = require('../native');
+const guard = require('../util/guard');
+const { invokeAsync } = require('../scheduler/invoke');
+
+
+// The second recommended option of RFC 9106, for memory-constrained hosts.
+const defaults = Object.freeze({
+    timeCost: 3,
+    memoryCost: 64 * 1024,
+    parallelism: 4,
+    hashLength: 32,
+    saltLength: 16
+});
+
+const limits = Object.freeze({
+    MIN_TIME_COST: 1,
+    MAX_TIME_COST: 2 ** 32 - 1,
+    // In KiB, up to 4 GiB, which keeps block indices within 32 bits.
+    MAX_MEMORY_COST: 2 ** 22,
+    MIN_PARALLELISM: 1,
+    MAX_PARALLELISM: 2 ** 24 - 1,
+    MIN_HASH_LENGTH: 4,
+    MAX_HASH_LENGTH: 2 ** 16,
+    MIN_SALT_LENGTH: 8,
+    MAX_SALT_LENGTH: 2 ** 16
+});
+
+const VERSION = 19;
+
+const messages = Object.freeze({
+    INVALID_PASSWORD: `The password must be a Buffer or a string.`,
+    INVALID_SALT: `The salt must be a Buffer of at least ${limits.MIN_SALT_LENGTH} bytes.`,
+    INVALID_SALT_LENGTH: `The salt length must be an integer between ${limits.MIN_SALT_LENGTH} and ${limits.MAX_SALT_LENGTH} (inclusive).`,
+    INVALID_SECRET: `The secret must be a Buffer.`,
+    INVALID_ASSOCIATED_DATA: `The associated data must be a Buffer.`,
+    INVALID_TIME_COST: `The time cost must be an integer between ${limits.MIN_TIME_COST} and ${limits.MAX_TIME_COST} (inclusive).`,
+    INVALID_MEMORY_COST: `The memory cost must be an integer number of KiB between 8 times the parallelism and ${limits.MAX_MEMORY_COST} (inclusive).`,
+    INVALID_PARALLELISM: `The parallelism must be an integer between ${limits.MIN_PARALLELISM} and ${limits.MAX_PARALLELISM} (inclusive).`,
+    INVALID_HASH_LENGTH: `The hash length must be an integer between ${limits.MIN_HASH_LENGTH} and ${limits.MAX_HASH_LENGTH} (inclusive).`,
+    INVALID_ENCODED: `The encoded hash must be an Argon2id hash string.`
+});
+
+const ENCODED_PATTERN = /^\$argon2id\$v=(\d+)\$m=(\d+),t=(\d+),p=(\d+)\$([A-Za-z0-9+/]+)\$([A-Za-z0-9+/]+)$/;
+
+function checkCosts({ timeCost, memoryCost, parallelism }) {
+    guard.isIntegerBetweenInclusive(timeCost, limits.MIN_TIME_COST, limits.MAX_TIME_COST, messages.INVALID_TIME_COST);
+
+    guard.isIntegerBetweenInclusive(parallelism, limits.MIN_PARALLELISM, limits.MAX_PARALLELISM, messages.INVALID_PARALLELISM);
+
+    guard.isIntegerBetweenInclusive(memoryCost, 8 * parallelism, limits.MAX_MEMORY_COST, messages.INVALID_MEMORY_COST);
+};
+
+function optionalBytes(bytes, errorMessage) {
+    if (bytes === undefined || bytes === null) {
+        return null;
+    }
+
+    guard.isBytes(bytes, errorMessage);
+
+    return bytes;
+};
+
+// Unpadded base64, as used by the PHC string format.
+function encodeBase64(bytes) {
+    return Buffer.from(bytes.buffer, bytes.byteOffset, bytes.byteLength).toString('base64').replace(/=+$/, '');
+};
+
+function hashRaw(password, salt, {
+    timeCost = defaults.timeCost,
+    memoryCost = defaults.memoryCost,
+    parallelism = defaults.parallelism,
+    hashLength = defaults.hashLength,
+    secret,
+    associatedData,
+    priority,
+    signal
+} = {}) {
+    guard.isBytesOrString(password, messages.INVALID_PASSWORD);
+
+    guard.isBytes(salt, messages.INVALID_SALT);
+
+    guard.isIntegerBetweenInclusive(salt.byteLength, limits.MIN_SALT_LENGTH, limits.MAX_SALT_LENGTH, messages.INVALID_SALT);
+
+    checkCosts({ timeCost, memoryCost, parallelism });
+
+    guard.isIntegerBetweenInclusive(hashLength, limits.MIN_HASH_LENGTH, limits.MAX_HASH_LENGTH, messages.INVALID_HASH_LENGTH);
+
+    const args = [
+        password,
+        salt,
+        optionalBytes(secret, messages.INVALID_SECRET),
+        optionalBytes(associatedData, messages.INVALID_ASSOCIATED_DATA),
+        timeCost,
+        memoryCost,
+        parallelism,
+        hashLength
+    ];
+
+    return invokeAsync(argon2.argon2id, args, { priority, signal });
+};
+
+async function hash(password, {
+    timeCost = defaults.timeCost,
+    memoryCost = defaults.memoryCost,
+    parallelism = defaults.parallelism,
+    hashLength = defaults.hashLength,
+    saltLength = defaults.saltLength,
+    secret,
+    priority,
+    signal
+} = {}) {
+    guard.isIntegerBetweenInclusive(saltLength, limits.MIN_SALT_LENGTH, limits.MAX_SALT_LENGTH, messages.INVALID_SALT_LENGTH);
+
+    const salt = randomBytes(saltLength);
+
+    const tag = await hashRaw(password, salt, { timeCost, memoryCost, parallelism, hashLength, secret, priority, signal });
+
+    return `$argon2id$v=${VERSION}$m=${memoryCost},t=${timeCost},p=${parallelism}$${encodeBase64(salt)}$${encodeBase64(tag)}`;
+};
+
+function decode(encoded) {
+    const match = typeof encoded === 'string' ? ENCODED_PATTERN.exec(encoded) : null;
+
+    if (!match || Number(match[1]) !== VERSION) {
+        throw new TypeError(messages.INVALID_ENCODED);
+    }
+
+    return {
+        memoryCost: Number(match[2]),
+        timeCost: Number(match[3]),
+        parallelism: Number(match[4]),
+        salt: Buffer.from(match[5], 'base64'),
+        tag: Buffer.from(match[6], 'base64')
+    };
+};
+
+async function verify(encoded, password, { secret, priority, signal } = {}) {
+    const { memoryCost, timeCost, parallelism, salt, tag } = decode(encoded);
+
+    const candidate = await hashRaw(password, salt, {
+        timeCost,
+        memoryCost,
+        parallelism,
+        hashLength: tag.byteLength,
+        secret,
+        priority,
+        signal
+    });
+
+    return timingSafeEqual(candidate, tag);
+};
+
+module.exports = Object.freeze({
+    argon2id: Object.freeze({
+        defaults,
+
+        hash,
+        hashRaw,
+        verify
+    })
+});
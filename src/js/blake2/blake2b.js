@@ -1,39 +1,352 @@
-const { blake2b } = require('../native');
+const { timingSafeEqual } = require('crypto');
+const { Transform } = require('stream');
+
+const { blake2b, scheduler } = require('../native');
 const guard = require('../util/guard');
+const { toBuffer, encodeString, packBytes } = require('../util/bytes');
+const { checkPriority } = require('../scheduler/priority');
+const { createAbortError, checkSignal, invokeAsync } = require('../scheduler/invoke');
 
 const lengths = Object.freeze({
     MIN_HASH_LENGTH: 1,
     MAX_HASH_LENGTH: 64,
-    KEY_LENGTH: 64
+    KEY_LENGTH: 64,
+    MIN_MAC_KEY_LENGTH: 1,
+    MAX_MAC_DATA_LENGTH: 2 ** 32 - 1,
+    MAX_MERKLE_LEAF_COUNT: 2 ** 32 - 1,
+    MIN_QUEUE_DEPTH: 1
 });
 
 const messages = Object.freeze({
-    INVALID_DATA: `Data must be a buffer.`,
+    INVALID_DATA: `Data must be a buffer or a string.`,
     INVALID_HASH_LENGTH: `Hash length must be an integer between ${lengths.MIN_HASH_LENGTH} and ${lengths.MAX_HASH_LENGTH} (inclusive).`,
-    INVALID_KEY: `Key must be a buffer of length ${lengths.KEY_LENGTH}`
+    INVALID_KEY: `Key must be a buffer of at most ${lengths.KEY_LENGTH} bytes.`,
+    INVALID_MAC_KEY: `Key must be null or a buffer of length ${lengths.MIN_MAC_KEY_LENGTH} to ${lengths.KEY_LENGTH}.`,
+    INVALID_PREFIX: `Prefix must be a buffer.`,
+    INVALID_TAG: `Tag must be a buffer.`,
+    INVALID_MESSAGES: `Messages must be an array of buffers.`,
+    INVALID_MESSAGES_LENGTH: `Messages must not exceed ${lengths.MAX_MAC_DATA_LENGTH} bytes in total.`,
+    INVALID_LEAVES: `Leaves must be a non-empty buffer of at most ${lengths.MAX_MERKLE_LEAF_COUNT} leaves.`,
+    INVALID_LEAF_LENGTH: `Leaf length must be a positive integer dividing the length of the leaves.`,
+    INVALID_DOMAIN_SEPARATION: `Domain separation must be a boolean.`,
+    INVALID_PROOFS: `Proofs must be an array of leaf indices.`,
+    INVALID_LEAF: `Leaf must be a buffer.`,
+    INVALID_LEAF_INDEX: `Leaf index must be a non-negative integer.`,
+    INVALID_PATH: `Path must be a string.`,
+    INVALID_QUEUE_DEPTH: `Queue depth must be a positive integer.`
 });
 
-function hashFactory(func) {
-    return function hash(data, hashLength) {
-        guard.isBuffer(data, messages.INVALID_DATA);
+function encodeData(data, encoding) {
+    guard.isBytesOrString(data, messages.INVALID_DATA);
+
+    return encodeString(data, encoding);
+};
 
-        return func(data, data.length, hashLength);
+function hashFactory(func, invoke) {
+    return function hash(data, hashLength, options = {}) {
+        return invoke(func, [encodeData(data, options.encoding), hashLength], options);
     };
 };
 
-function keyedHashFactory(func) {
-    return function keyedHash(data, key, hashLength) {
-        guard.isBuffer(data, messages.INVALID_DATA);
+function keyedHashFactory(func, invoke) {
+    return function keyedHash(data, key, hashLength, options = {}) {
+        const encodedData = encodeData(data, options.encoding);
+
+        guard.isBytes(key, messages.INVALID_KEY);
+
+        guard.isIntegerBetweenInclusive(key.byteLength, 0, lengths.KEY_LENGTH, messages.INVALID_KEY);
 
         guard.isIntegerBetweenInclusive(hashLength, lengths.MIN_HASH_LENGTH, lengths.MAX_HASH_LENGTH, messages.INVALID_HASH_LENGTH);
 
-        return func(data, data.length, key, key.length, hashLength);
+        return invoke(func, [encodedData, key, hashLength], options);
+    };
+};
+
+function packMessages(messageList) {
+    return packBytes(messageList, lengths.MAX_MAC_DATA_LENGTH, messages.INVALID_MESSAGES, messages.INVALID_MESSAGES_LENGTH);
+};
+
+function isMatchingTag(expected, tag) {
+    return expected.length === tag.byteLength && timingSafeEqual(expected, toBuffer(tag));
+};
+
+function createMacFactory(impl) {
+    return function createMac(key, hashLength, { prefix } = {}) {
+        if (key !== null) {
+            guard.isBytes(key, messages.INVALID_MAC_KEY);
+
+            guard.isIntegerBetweenInclusive(key.byteLength, lengths.MIN_MAC_KEY_LENGTH, lengths.KEY_LENGTH, messages.INVALID_MAC_KEY);
+        }
+
+        guard.isIntegerBetweenInclusive(hashLength, lengths.MIN_HASH_LENGTH, lengths.MAX_HASH_LENGTH, messages.INVALID_HASH_LENGTH);
+
+        if (prefix !== undefined) {
+            guard.isBytes(prefix, messages.INVALID_PREFIX);
+        }
+
+        const midstate = impl.macCreate(key, hashLength, prefix || null);
+
+        function macSync(data, { encoding } = {}) {
+            return impl.macSync(midstate, encodeData(data, encoding));
+        };
+
+        function mac(data, options = {}) {
+            return invokeAsync(impl.mac, [midstate, encodeData(data, options.encoding)], options);
+        };
+
+        function macMany(messageList, options) {
+            return invokeAsync(impl.macBatch, [midstate, ...packMessages(messageList)], options);
+        };
+
+        function verifySync(data, tag) {
+            guard.isBytes(tag, messages.INVALID_TAG);
+
+            return isMatchingTag(macSync(data), tag);
+        };
+
+        function verify(data, tag, options) {
+            guard.isBytes(tag, messages.INVALID_TAG);
+
+            return mac(data, options).then(expected => isMatchingTag(expected, tag));
+        };
+
+        return Object.freeze({
+            hashLength,
+            macSync,
+            mac,
+            macMany,
+            verifySync,
+            verify
+        });
+    };
+};
+
+function merkleRootFactory(func, invoke) {
+    return function merkleRoot(leaves, {
+        leafLength = 32,
+        leafHashLength = 32,
+        nodeHashLength = 32,
+        domainSeparation = true,
+        proofs,
+        priority,
+        signal
+    } = {}) {
+        guard.isBytes(leaves, messages.INVALID_LEAVES);
+
+        guard.isIntegerBetweenInclusive(leafLength, 1, Math.max(leaves.byteLength, 1), messages.INVALID_LEAF_LENGTH);
+        guard.isBytesOfLengthMultiple(leaves, leafLength, messages.INVALID_LEAF_LENGTH);
+        guard.isIntegerBetweenInclusive(leaves.byteLength / leafLength, 1, lengths.MAX_MERKLE_LEAF_COUNT, messages.INVALID_LEAVES);
+
+        guard.isIntegerBetweenInclusive(leafHashLength, lengths.MIN_HASH_LENGTH, lengths.MAX_HASH_LENGTH, messages.INVALID_HASH_LENGTH);
+        guard.isIntegerBetweenInclusive(nodeHashLength, lengths.MIN_HASH_LENGTH, lengths.MAX_HASH_LENGTH, messages.INVALID_HASH_LENGTH);
+        guard.isOneOf(domainSeparation, [true, false], messages.INVALID_DOMAIN_SEPARATION);
+
+        let proofIndices = null;
+        if (proofs !== undefined) {
+            if (!Array.isArray(proofs)) {
+                throw new TypeError(messages.INVALID_PROOFS);
+            }
+
+            const leafCount = leaves.byteLength / leafLength;
+            proofs.forEach(index => guard.isIntegerBetweenInclusive(index, 0, leafCount - 1, messages.INVALID_PROOFS));
+
+            proofIndices = Uint32Array.from(proofs);
+        }
+
+        return invoke(func, [leaves, leafLength, leafHashLength, nodeHashLength, domainSeparation, proofIndices], { priority, signal });
+    };
+};
+
+function createMerkleAccumulatorFactory(impl) {
+    return function createMerkleAccumulator({
+        leafHashLength = 32,
+        nodeHashLength = 32,
+        domainSeparation = true,
+        path
+    } = {}) {
+        guard.isIntegerBetweenInclusive(leafHashLength, lengths.MIN_HASH_LENGTH, lengths.MAX_HASH_LENGTH, messages.INVALID_HASH_LENGTH);
+        guard.isIntegerBetweenInclusive(nodeHashLength, lengths.MIN_HASH_LENGTH, lengths.MAX_HASH_LENGTH, messages.INVALID_HASH_LENGTH);
+        guard.isOneOf(domainSeparation, [true, false], messages.INVALID_DOMAIN_SEPARATION);
+
+        if (path !== undefined && typeof path !== 'string') {
+            throw new TypeError(messages.INVALID_PATH);
+        }
+
+        const accumulator = impl.merkleAccumulatorCreate(leafHashLength, nodeHashLength, domainSeparation, path === undefined ? null : path);
+
+        function size() {
+            return impl.merkleAccumulatorSize(accumulator);
+        };
+
+        function append(leaf) {
+            guard.isBytes(leaf, messages.INVALID_LEAF);
+
+            return impl.merkleAccumulatorAppend(accumulator, leaf);
+        };
+
+        function appendMany(leaves, { leafLength = 32, priority, signal } = {}) {
+            guard.isBytes(leaves, messages.INVALID_LEAVES);
+
+            guard.isIntegerBetweenInclusive(leafLength, 1, lengths.MAX_MERKLE_LEAF_COUNT, messages.INVALID_LEAF_LENGTH);
+            guard.isBytesOfLengthMultiple(leaves, leafLength, messages.INVALID_LEAF_LENGTH);
+
+            if (leaves.byteLength === 0) {
+                return Promise.resolve(size());
+            }
+
+            return invokeAsync(impl.merkleAccumulatorAppendMany, [accumulator, leaves, leafLength], { priority, signal });
+        };
+
+        function root() {
+            return impl.merkleAccumulatorRoot(accumulator);
+        };
+
+        function proof(index) {
+            guard.isIntegerBetweenInclusive(index, 0, lengths.MAX_MERKLE_LEAF_COUNT - 1, messages.INVALID_LEAF_INDEX);
+
+            return impl.merkleAccumulatorProof(accumulator, index);
+        };
+
+        function update(index, leaf) {
+            guard.isIntegerBetweenInclusive(index, 0, lengths.MAX_MERKLE_LEAF_COUNT - 1, messages.INVALID_LEAF_INDEX);
+            guard.isBytes(leaf, messages.INVALID_LEAF);
+
+            impl.merkleAccumulatorUpdate(accumulator, index, leaf);
+        };
+
+        function sync() {
+            impl.merkleAccumulatorSync(accumulator);
+        };
+
+        function close() {
+            impl.merkleAccumulatorClose(accumulator);
+        };
+
+        return Object.freeze({
+            size,
+            append,
+            appendMany,
+            root,
+            proof,
+            update,
+            sync,
+            close
+        });
+    };
+};
+
+// Chunks are hashed in write order by a single native worker per stream.
+// Writes are acknowledged while fewer than queueDepth chunks are waiting
+// natively, beyond that the stream waits for the oldest one to be hashed.
+function createHashStreamFactory(impl) {
+    return function createHashStream(hashLength, { key = null, queueDepth = 4, priority, signal, ...streamOptions } = {}) {
+        guard.isIntegerBetweenInclusive(hashLength, lengths.MIN_HASH_LENGTH, lengths.MAX_HASH_LENGTH, messages.INVALID_HASH_LENGTH);
+
+        if (key !== null) {
+            guard.isBytes(key, messages.INVALID_KEY);
+
+            guard.isIntegerBetweenInclusive(key.byteLength, 0, lengths.KEY_LENGTH, messages.INVALID_KEY);
+        }
+
+        guard.isIntegerBetweenInclusive(queueDepth, lengths.MIN_QUEUE_DEPTH, Number.MAX_SAFE_INTEGER, messages.INVALID_QUEUE_DEPTH);
+
+        checkPriority(priority);
+
+        if (signal !== undefined) {
+            checkSignal(signal);
+        }
+
+        // Destroying the stream drops the chunks that are still queued.
+        const cancelToken = scheduler.createCancelToken();
+        const state = impl.streamCreate(hashLength, key, priority, cancelToken);
+        const pending = [];
+        let failure = null;
+
+        function track(promise) {
+            pending.push(promise);
+
+            promise.then(() => pending.shift(), err => {
+                pending.shift();
+                failure = failure || err;
+            });
+
+            return promise;
+        };
+
+        const stream = new Transform({
+            ...streamOptions,
+            readableObjectMode: false,
+            writableObjectMode: false,
+
+            transform(chunk, encoding, callback) {
+                if (failure) {
+                    return callback(failure);
+                }
+
+                try {
+                    track(impl.streamUpdate(state, chunk));
+                } catch (err) {
+                    return callback(err);
+                }
+
+                if (impl.streamDepth(state) < queueDepth) {
+                    return callback();
+                }
+
+                const settle = () => callback(failure);
+                pending[0].then(settle, settle);
+            },
+
+            flush(callback) {
+                const settle = () => {
+                    if (failure) {
+                        return callback(failure);
+                    }
+
+                    try {
+                        callback(null, impl.streamDigest(state));
+                    } catch (err) {
+                        callback(err);
+                    }
+                };
+
+                Promise.all(pending).then(settle, settle);
+            },
+
+            destroy(err, callback) {
+                scheduler.cancel(cancelToken);
+
+                if (signal !== undefined) {
+                    signal.removeEventListener('abort', onAbort);
+                }
+
+                callback(err);
+            }
+        });
+
+        function onAbort() {
+            stream.destroy(createAbortError());
+        };
+
+        if (signal !== undefined) {
+            if (signal.aborted) {
+                process.nextTick(onAbort);
+            } else {
+                signal.addEventListener('abort', onAbort, { once: true });
+            }
+        }
+
+        return stream;
     };
 };
 
 module.exports = (function moduleFactory(impl) {
     return Object.freeze({
-        hash: hashFactory(impl.hash),
-        keyedHash: keyedHashFactory(impl.keyedHash),
+        hash: hashFactory(impl.hash, invokeAsync),
+        keyedHash: keyedHashFactory(impl.keyedHash, invokeAsync),
+        createMac: createMacFactory(impl),
+        merkleRoot: merkleRootFactory(impl.merkleRoot, invokeAsync),
+        createMerkleAccumulator: createMerkleAccumulatorFactory(impl),
+        createHashStream: createHashStreamFactory(impl)
     });
 })(blake2b);
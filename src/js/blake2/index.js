@@ -1,6 +1,8 @@
 const blake2b = require('./blake2b');
+const work = require('./work');
 
 
 module.exports = {
-    blake2b
+    blake2b,
+    work
 };
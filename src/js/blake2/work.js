@@ -0,0 +1,72 @@
+const { blake2b, scheduler } = require('../native');
+const guard = require('../util/guard');
+const { invokeSync, invokeAsync } = require('../scheduler/invoke');
+
+
+const lengths = Object.freeze({
+    ROOT: 32,
+    NONCE: 8,
+    MIN_THREADS: 1,
+    MAX_THREADS: 1024
+});
+
+const MAX_THRESHOLD = 2n ** 64n - 1n;
+
+const messages = Object.freeze({
+    INVALID_ROOT: `The root must be a Buffer of length ${lengths.ROOT}.`,
+    INVALID_NONCE: `The nonce must be a Buffer of length ${lengths.NONCE}.`,
+    INVALID_ROOTS: `The roots must be a Buffer of packed ${lengths.ROOT} byte roots.`,
+    INVALID_NONCES: `The nonces must be a Buffer of packed ${lengths.NONCE} byte nonces, one per root.`,
+    INVALID_THRESHOLD: `The threshold must be a bigint between 0 and ${MAX_THRESHOLD} (inclusive).`,
+    INVALID_THREADS: `The thread count must be an integer between ${lengths.MIN_THREADS} and ${lengths.MAX_THREADS} (inclusive).`
+});
+
+// Work values are compared as unsigned 64-bit integers, which the native side reads in little-endian order.
+function encodeThreshold(threshold) {
+    guard.isBigIntBetweenInclusive(threshold, 0n, MAX_THRESHOLD, messages.INVALID_THRESHOLD);
+
+    const encoded = Buffer.alloc(8);
+    encoded.writeBigUInt64LE(threshold);
+
+    return encoded;
+};
+
+function generateFactory(func, invoke) {
+    return function generate(root, threshold, { threads = scheduler.lanes().concurrency, priority, signal } = {}) {
+        guard.isBytesOfLength(root, lengths.ROOT, messages.INVALID_ROOT);
+
+        const encodedThreshold = encodeThreshold(threshold);
+
+        guard.isIntegerBetweenInclusive(threads, lengths.MIN_THREADS, lengths.MAX_THREADS, messages.INVALID_THREADS);
+
+        return invoke(func, [root, encodedThreshold, threads], { priority, signal });
+    };
+};
+
+function validateFactory(func, invoke) {
+    return function validate(root, nonce, threshold) {
+        guard.isBytesOfLength(root, lengths.ROOT, messages.INVALID_ROOT);
+
+        guard.isBytesOfLength(nonce, lengths.NONCE, messages.INVALID_NONCE);
+
+        return invoke(func, [root, nonce, encodeThreshold(threshold)]);
+    };
+};
+
+function validateBatchFactory(func, invoke) {
+    return function validateBatch(roots, nonces, threshold, { priority, signal } = {}) {
+        guard.isBytesOfLengthMultiple(roots, lengths.ROOT, messages.INVALID_ROOTS);
+
+        guard.isBytesOfLength(nonces, (roots.byteLength / lengths.ROOT) * lengths.NONCE, messages.INVALID_NONCES);
+
+        return invoke(func, [roots, nonces, encodeThreshold(threshold)], { priority, signal });
+    };
+};
+
+module.exports = (function moduleFactory(impl) {
+    return Object.freeze({
+        generate: generateFactory(impl.workGenerate, invokeAsync),
+        validate: validateFactory(impl.workValidateSync, invokeSync),
+        validateBatch: validateBatchFactory(impl.workValidateBatch, invokeAsync)
+    });
+})(blake2b);
@@ -0,0 +1,135 @@
+const { randomBytes } = require('crypto');
+
+const { ed25519 } = require('../native');
+const guard = require('../util/guard');
+const { encodeString, packBytes } = require('../util/bytes');
+const { invokeSync, invokeAsync, iterateAsync } = require('../scheduler/invoke');
+
+
+const lengths = Object.freeze({
+    SEED: 32,
+    PUBLIC_KEY: 32,
+    SIGNATURE: 64,
+    MAX_MESSAGES: 2 ** 32 - 1
+});
+
+// BLAKE2b-512 is the variant of Nano, SHA-512 the one of RFC 8032.
+const hashTypes = Object.freeze({
+    'blake2b-512': 0,
+    'sha512': 1
+});
+
+const hashes = Object.freeze(Object.keys(hashTypes));
+
+const messages = Object.freeze({
+    INVALID_SEED: `The seed must be a Buffer of length ${lengths.SEED}.`,
+    INVALID_PUBLIC_KEY: `The public key must be a Buffer of length ${lengths.PUBLIC_KEY}.`,
+    INVALID_SIGNATURE: `The signature must be a Buffer of length ${lengths.SIGNATURE}.`,
+    INVALID_MESSAGE: `The message must be a Buffer or a string.`,
+    INVALID_MESSAGES: `The messages must be an array of Buffers.`,
+    INVALID_MESSAGES_LENGTH: `The messages must not exceed ${lengths.MAX_MESSAGES} bytes in total.`,
+    INVALID_SIGNATURES: `The signatures must be a Buffer of packed ${lengths.SIGNATURE} byte signatures, one per message.`,
+    INVALID_PUBLIC_KEYS: `The public keys must be a Buffer of packed ${lengths.PUBLIC_KEY} byte public keys, one per message.`,
+    INVALID_HASH: `The hash must be one of: ${hashes.join(', ')}.`
+});
+
+function hashArgument(hash) {
+    guard.isOneOf(hash, hashes, messages.INVALID_HASH);
+
+    return hashTypes[hash];
+};
+
+function encodeMessage(message, encoding) {
+    guard.isBytesOrString(message, messages.INVALID_MESSAGE);
+
+    return encodeString(message, encoding);
+};
+
+function publicKeyCreateFactory(func, invoke) {
+    return function publicKeyCreate(seed, { hash = 'blake2b-512', priority, signal } = {}) {
+        guard.isBytesOfLength(seed, lengths.SEED, messages.INVALID_SEED);
+
+        return invoke(func, [seed, hashArgument(hash)], { priority, signal });
+    };
+};
+
+function generateKeyPairSyncFactory(publicKeyCreateSync) {
+    return function generateKeyPairSync({ hash = 'blake2b-512' } = {}) {
+        const seed = randomBytes(lengths.SEED);
+
+        return {
+            seed,
+            publicKey: publicKeyCreateSync(seed, { hash })
+        };
+    };
+};
+
+function generateKeyPairFactory(publicKeyCreate) {
+    return async function generateKeyPair({ hash = 'blake2b-512', priority, signal } = {}) {
+        const seed = randomBytes(lengths.SEED);
+
+        return {
+            seed,
+            publicKey: await publicKeyCreate(seed, { hash, priority, signal })
+        };
+    };
+};
+
+function signFactory(func, invoke) {
+    return function sign(message, seed, { hash = 'blake2b-512', encoding, priority, signal } = {}) {
+        const encodedMessage = encodeMessage(message, encoding);
+
+        guard.isBytesOfLength(seed, lengths.SEED, messages.INVALID_SEED);
+
+        return invoke(func, [encodedMessage, seed, hashArgument(hash)], { priority, signal });
+    };
+};
+
+function verifyFactory(func, invoke) {
+    return function verify(message, signature, publicKey, { hash = 'blake2b-512', encoding, priority, signal } = {}) {
+        const encodedMessage = encodeMessage(message, encoding);
+
+        guard.isBytesOfLength(signature, lengths.SIGNATURE, messages.INVALID_SIGNATURE);
+
+        guard.isBytesOfLength(publicKey, lengths.PUBLIC_KEY, messages.INVALID_PUBLIC_KEY);
+
+        return invoke(func, [encodedMessage, signature, publicKey, hashArgument(hash)], { priority, signal });
+    };
+};
+
+function verifyBatchFactory(func, invoke) {
+    return function verifyBatch(messageList, signatures, publicKeys, { hash = 'blake2b-512', priority, signal } = {}) {
+        const packedMessages = packBytes(messageList, lengths.MAX_MESSAGES, messages.INVALID_MESSAGES, messages.INVALID_MESSAGES_LENGTH);
+
+        const count = messageList.length;
+
+        guard.isBytesOfLength(signatures, count * lengths.SIGNATURE, messages.INVALID_SIGNATURES);
+
+        guard.isBytesOfLength(publicKeys, count * lengths.PUBLIC_KEY, messages.INVALID_PUBLIC_KEYS);
+
+        return invoke(func, [...packedMessages, signatures, publicKeys, hashArgument(hash)], { priority, signal });
+    };
+};
+
+module.exports = (function moduleFactory(impl) {
+    const publicKeyCreateSync = publicKeyCreateFactory(impl.publicKeyCreateSync, invokeSync);
+    const publicKeyCreate = publicKeyCreateFactory(impl.publicKeyCreate, invokeAsync);
+
+    return Object.freeze({
+        hashes,
+
+        publicKeyCreateSync,
+        publicKeyCreate,
+
+        generateKeyPairSync: generateKeyPairSyncFactory(publicKeyCreateSync),
+        generateKeyPair: generateKeyPairFactory(publicKeyCreate),
+
+        signSync: signFactory(impl.signSync, invokeSync),
+        sign: signFactory(impl.sign, invokeAsync),
+
+        verifySync: verifyFactory(impl.verifySync, invokeSync),
+        verify: verifyFactory(impl.verify, invokeAsync),
+        verifyBatch: verifyBatchFactory(impl.verifyBatch, invokeAsync),
+        verifyBatchChunks: verifyBatchFactory(impl.verifyBatch, iterateAsync)
+    });
+})(ed25519);
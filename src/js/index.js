@@ -1,8 +1,16 @@
+const argon2 = require('./argon2');
 const blake2 = require('./blake2');
+const ed25519 = require('./ed25519');
+const musig = require('./musig');
+const scheduler = require('./scheduler');
 const secp256k1 = require('./secp256k1');
 
 
 module.exports = Object.freeze({
+    ...argon2,
     ...blake2,
+    ed25519,
+    musig,
+    scheduler,
     secp256k1
 });
@@ -0,0 +1,140 @@
+const { musig } = require('../native');
+const guard = require('../util/guard');
+const { toBuffer } = require('../util/bytes');
+const { invokeSync, invokeAsync, iterateAsync } = require('../scheduler/invoke');
+
+
+const lengths = Object.freeze({
+    MESSAGE: 32,
+    PRIVATE_KEY: 32,
+    PUBLIC_KEY: 33,
+    AGGREGATE_PUBLIC_KEY: 32,
+    PUBLIC_NONCE: 66,
+    PARTIAL_SIGNATURE: 32,
+    SIGNATURE: 64
+});
+
+const messages = Object.freeze({
+    INVALID_MESSAGE: `The message must be a Buffer of length ${lengths.MESSAGE}.`,
+    INVALID_PRIVATE_KEY: `The private key must be a Buffer of length ${lengths.PRIVATE_KEY}.`,
+    INVALID_PUBLIC_KEY: `The public key must be a Buffer of length ${lengths.PUBLIC_KEY} or 65.`,
+    INVALID_PUBLIC_KEY_LIST: `The public keys must be a non-empty array of Buffers of length ${lengths.PUBLIC_KEY}.`,
+    INVALID_AGGREGATE_PUBLIC_KEY: `The public key must be a Buffer of length ${lengths.AGGREGATE_PUBLIC_KEY}.`,
+    INVALID_PUBLIC_NONCE: `The public nonce must be a Buffer of length ${lengths.PUBLIC_NONCE}.`,
+    INVALID_PUBLIC_NONCE_LIST: `The public nonces must be an array of Buffers of length ${lengths.PUBLIC_NONCE}.`,
+    INVALID_PARTIAL_SIGNATURE: `The partial signature must be a Buffer of length ${lengths.PARTIAL_SIGNATURE}.`,
+    INVALID_PARTIAL_SIGNATURE_LIST: `The partial signatures must be an array of Buffers of length ${lengths.PARTIAL_SIGNATURE}.`,
+    INVALID_SIGNATURE: `The signature must be a Buffer of length ${lengths.SIGNATURE}.`,
+    INVALID_MESSAGES: `The messages must be a Buffer of packed ${lengths.MESSAGE} byte messages.`,
+    INVALID_SIGNATURES: `The signatures must be a Buffer of packed ${lengths.SIGNATURE} byte signatures, one per message.`,
+    INVALID_PUBLIC_KEYS: `The public keys must be a Buffer of packed ${lengths.AGGREGATE_PUBLIC_KEY} byte public keys, one per message.`,
+    INVALID_SORT: 'The sort option must be a boolean.'
+});
+
+// Lists of fixed length items are packed back-to-back for the native side.
+function packList(list, itemLength, errorMessage) {
+    if (!Array.isArray(list)) {
+        throw new TypeError(errorMessage);
+    }
+
+    list.forEach(item => guard.isBytesOfLength(item, itemLength, errorMessage));
+
+    return Buffer.concat(list.map(toBuffer), list.length * itemLength);
+};
+
+function sessionFactory(impl, keyAgg, privateKey, message) {
+    guard.isBytesOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+
+    guard.isBytesOfLength(message, lengths.MESSAGE, messages.INVALID_MESSAGE);
+
+    const session = impl.sessionCreate(keyAgg, privateKey, message);
+
+    return Object.freeze({
+        publicNonce: impl.sessionPublicNonce(session),
+
+        processNonces(publicNonces) {
+            impl.sessionProcessNonces(session, packList(publicNonces, lengths.PUBLIC_NONCE, messages.INVALID_PUBLIC_NONCE_LIST));
+        },
+
+        sign() {
+            return impl.sessionSign(session);
+        },
+
+        verifyPartial(partialSignature, publicNonce, publicKey) {
+            guard.isBytesOfLength(partialSignature, lengths.PARTIAL_SIGNATURE, messages.INVALID_PARTIAL_SIGNATURE);
+
+            guard.isBytesOfLength(publicNonce, lengths.PUBLIC_NONCE, messages.INVALID_PUBLIC_NONCE);
+
+            guard.isBytesOfLengthAny(publicKey, [lengths.PUBLIC_KEY, 65], messages.INVALID_PUBLIC_KEY);
+
+            return impl.sessionVerifyPartial(session, partialSignature, publicNonce, publicKey);
+        },
+
+        aggregate(partialSignatures) {
+            return impl.sessionAggregate(session,
+                packList(partialSignatures, lengths.PARTIAL_SIGNATURE, messages.INVALID_PARTIAL_SIGNATURE_LIST));
+        }
+    });
+};
+
+function aggregatePublicKeysFactory(impl) {
+    return function aggregatePublicKeys(publicKeys, { sort = true } = {}) {
+        const packedPublicKeys = packList(publicKeys, lengths.PUBLIC_KEY, messages.INVALID_PUBLIC_KEY_LIST);
+
+        if (publicKeys.length === 0) {
+            throw new TypeError(messages.INVALID_PUBLIC_KEY_LIST);
+        }
+
+        if (typeof sort !== 'boolean') {
+            throw new TypeError(messages.INVALID_SORT);
+        }
+
+        const keyAgg = impl.keyAgg(packedPublicKeys, sort);
+
+        return Object.freeze({
+            publicKey: impl.keyAggPublicKey(keyAgg),
+            signerCount: publicKeys.length,
+
+            createSession(privateKey, message) {
+                return sessionFactory(impl, keyAgg, privateKey, message);
+            }
+        });
+    };
+};
+
+function verifyFactory(func, invoke) {
+    return function verify(message, signature, publicKey, { priority, signal } = {}) {
+        guard.isBytesOfLength(message, lengths.MESSAGE, messages.INVALID_MESSAGE);
+
+        guard.isBytesOfLength(signature, lengths.SIGNATURE, messages.INVALID_SIGNATURE);
+
+        guard.isBytesOfLength(publicKey, lengths.AGGREGATE_PUBLIC_KEY, messages.INVALID_AGGREGATE_PUBLIC_KEY);
+
+        return invoke(func, [message, signature, publicKey], { priority, signal });
+    };
+};
+
+function verifyBatchFactory(func, invoke) {
+    return function verifyBatch(messageBatch, signatures, publicKeys, { priority, signal } = {}) {
+        guard.isBytesOfLengthMultiple(messageBatch, lengths.MESSAGE, messages.INVALID_MESSAGES);
+
+        const count = messageBatch.byteLength / lengths.MESSAGE;
+
+        guard.isBytesOfLength(signatures, count * lengths.SIGNATURE, messages.INVALID_SIGNATURES);
+
+        guard.isBytesOfLength(publicKeys, count * lengths.AGGREGATE_PUBLIC_KEY, messages.INVALID_PUBLIC_KEYS);
+
+        return invoke(func, [messageBatch, signatures, publicKeys], { priority, signal });
+    };
+};
+
+module.exports = (function moduleFactory(impl) {
+    return Object.freeze({
+        aggregatePublicKeys: aggregatePublicKeysFactory(impl),
+
+        verifySync: verifyFactory(impl.verifySync, invokeSync),
+        verify: verifyFactory(impl.verify, invokeAsync),
+        verifyBatch: verifyBatchFactory(impl.verifyBatch, invokeAsync),
+        verifyBatchChunks: verifyBatchFactory(impl.verifyBatch, iterateAsync)
+    });
+})(musig);
@@ -0,0 +1,102 @@
+const { scheduler } = require('../native');
+const guard = require('../util/guard');
+const { priorities } = require('./priority');
+
+
+const opClasses = Object.freeze([
+    'privateKeyVerify',
+    'publicKeyCreate',
+    'sign',
+    'verify',
+    'hash',
+    'keyedHash',
+    'signatureBatch',
+    'verifyBatch',
+    'publicKeyBatch',
+    'derive',
+    'deriveBatch',
+    'ecdh',
+    'ecdhBatch',
+    'signBatch',
+    'keyPair',
+    'macBatch',
+    'merkle',
+    'passwordHash',
+    'work'
+]);
+
+const policies = Object.freeze([
+    'queue',
+    'reject'
+]);
+
+const laneSchedulings = Object.freeze([
+    'strict',
+    'weighted'
+]);
+
+const UNLIMITED = 0;
+const MAX_LIMIT = 0xFFFFFFFF;
+const MIN_CONCURRENCY = 1;
+const MAX_CONCURRENCY = 1024;
+const MIN_INTERACTIVE_WEIGHT = 1;
+const DEFAULT_INTERACTIVE_WEIGHT = 4;
+
+const messages = Object.freeze({
+    INVALID_OP_CLASS: `The operation class must be one of: ${opClasses.join(', ')}.`,
+    INVALID_LIMIT: `The limit must be an integer between ${UNLIMITED} and ${MAX_LIMIT} (inclusive), ${UNLIMITED} meaning no limit.`,
+    INVALID_POLICY: `The policy must be one of: ${policies.join(', ')}.`,
+    INVALID_CONCURRENCY: `The concurrency must be an integer between ${MIN_CONCURRENCY} and ${MAX_CONCURRENCY} (inclusive).`,
+    INVALID_LANE_SCHEDULING: `The lane scheduling must be one of: ${laneSchedulings.join(', ')}.`,
+    INVALID_INTERACTIVE_WEIGHT: `The interactive weight must be an integer between ${MIN_INTERACTIVE_WEIGHT} and ${MAX_LIMIT} (inclusive).`
+});
+
+function configureFactory(func) {
+    return function configure(opClass, { limit = UNLIMITED, policy = 'queue' } = {}) {
+        guard.isOneOf(opClass, opClasses, messages.INVALID_OP_CLASS);
+
+        guard.isIntegerBetweenInclusive(limit, UNLIMITED, MAX_LIMIT, messages.INVALID_LIMIT);
+
+        guard.isOneOf(policy, policies, messages.INVALID_POLICY);
+
+        return func(opClass, limit, policy);
+    };
+};
+
+function opClassFactory(func) {
+    return function withOpClass(opClass) {
+        guard.isOneOf(opClass, opClasses, messages.INVALID_OP_CLASS);
+
+        return func(opClass);
+    };
+};
+
+function configureLanesFactory(impl) {
+    return function configureLanes({ concurrency, scheduling = 'weighted', interactiveWeight = DEFAULT_INTERACTIVE_WEIGHT } = {}) {
+        const effectiveConcurrency = concurrency === undefined ? impl.lanes().concurrency : concurrency;
+
+        guard.isIntegerBetweenInclusive(effectiveConcurrency, MIN_CONCURRENCY, MAX_CONCURRENCY, messages.INVALID_CONCURRENCY);
+
+        guard.isOneOf(scheduling, laneSchedulings, messages.INVALID_LANE_SCHEDULING);
+
+        guard.isIntegerBetweenInclusive(interactiveWeight, MIN_INTERACTIVE_WEIGHT, MAX_LIMIT, messages.INVALID_INTERACTIVE_WEIGHT);
+
+        return impl.configureLanes(effectiveConcurrency, scheduling, interactiveWeight);
+    };
+};
+
+module.exports = (function moduleFactory(impl) {
+    return Object.freeze({
+        opClasses,
+        policies,
+        priorities,
+        laneSchedulings,
+
+        configure: configureFactory(impl.configure),
+        depth: opClassFactory(impl.depth),
+        pressure: opClassFactory(impl.pressure),
+
+        configureLanes: configureLanesFactory(impl),
+        lanes: impl.lanes
+    });
+})(scheduler);
@@ -0,0 +1,181 @@
+const { scheduler } = require('../native');
+const guard = require('../util/guard');
+const { checkPriority } = require('./priority');
+
+
+const messages = Object.freeze({
+    INVALID_SIGNAL: 'The signal must be an AbortSignal.',
+    ABORTED: 'The operation was aborted.'
+});
+
+function createAbortError() {
+    const error = new Error(messages.ABORTED);
+
+    error.name = 'AbortError';
+    error.code = 'ABORT_ERR';
+
+    return error;
+};
+
+function checkSignal(signal) {
+    const isAbortSignal = (typeof signal === 'object')
+        && (signal !== null)
+        && (typeof signal.aborted === 'boolean')
+        && (typeof signal.addEventListener === 'function');
+
+    if (!isAbortSignal) {
+        throw new TypeError(messages.INVALID_SIGNAL);
+    }
+};
+
+// Scheduling options only apply to async invocations.
+function invokeSync(func, args) {
+    return func(...args);
+};
+
+function invokeAsync(func, args, { priority, signal } = {}) {
+    checkPriority(priority);
+
+    if (signal === undefined) {
+        return func(...args, priority);
+    }
+
+    checkSignal(signal);
+
+    if (signal.aborted) {
+        return Promise.reject(createAbortError());
+    }
+
+    const cancelToken = scheduler.createCancelToken();
+    const onAbort = () => scheduler.cancel(cancelToken);
+    const removeListener = () => signal.removeEventListener('abort', onAbort);
+
+    signal.addEventListener('abort', onAbort, { once: true });
+
+    try {
+        const promise = func(...args, priority, cancelToken);
+
+        promise.then(removeListener, removeListener);
+
+        return promise;
+    } catch (err) {
+        removeListener();
+
+        throw err;
+    }
+};
+
+/*
+ * Invokes a batch function like invokeAsync, but returns an async iterator of
+ * { start, end, results } objects, one per chunk, in the order the chunks
+ * complete. Ending the iteration early aborts the rest of the batch.
+ */
+function iterateAsync(func, args, { priority, signal } = {}) {
+    checkPriority(priority);
+
+    if (signal !== undefined) {
+        checkSignal(signal);
+    }
+
+    const chunks = [];
+    const readers = [];
+    let isSettled = false;
+    let isReturned = false;
+    let error = null;
+
+    const cancelToken = scheduler.createCancelToken();
+    const onAbort = () => scheduler.cancel(cancelToken);
+    const removeListener = () => signal && signal.removeEventListener('abort', onAbort);
+
+    const onChunk = (start, end, results) => {
+        if (isReturned) {
+            return;
+        }
+
+        const chunk = { start, end, results };
+
+        if (readers.length > 0) {
+            readers.shift().resolve({ value: chunk, done: false });
+        } else {
+            chunks.push(chunk);
+        }
+    };
+
+    const onSettled = (err) => {
+        removeListener();
+
+        isSettled = true;
+        error = isReturned ? null : err;
+
+        while (readers.length > 0) {
+            const reader = readers.shift();
+
+            if (error) {
+                reader.reject(error);
+                error = null;
+            } else {
+                reader.resolve({ value: undefined, done: true });
+            }
+        }
+    };
+
+    let promise;
+    if (signal && signal.aborted) {
+        promise = Promise.reject(createAbortError());
+    } else {
+        if (signal) {
+            signal.addEventListener('abort', onAbort, { once: true });
+        }
+
+        try {
+            promise = func(...args, priority, cancelToken, onChunk);
+        } catch (err) {
+            removeListener();
+
+            throw err;
+        }
+    }
+
+    promise.then(() => onSettled(null), onSettled);
+
+    return {
+        next() {
+            if (chunks.length > 0) {
+                return Promise.resolve({ value: chunks.shift(), done: false });
+            }
+
+            if (isSettled) {
+                const err = error;
+                error = null;
+
+                return err ? Promise.reject(err) : Promise.resolve({ value: undefined, done: true });
+            }
+
+            return new Promise((resolve, reject) => readers.push({ resolve, reject }));
+        },
+        // Resolves once the batch has settled, so that nothing is left running.
+        return() {
+            chunks.length = 0;
+
+            if (!isSettled) {
+                isReturned = true;
+                scheduler.cancel(cancelToken);
+            }
+
+            const done = () => ({ value: undefined, done: true });
+
+            return promise.then(done, done);
+        },
+        [Symbol.asyncIterator]() {
+            return this;
+        }
+    };
+};
+
+module.exports = Object.freeze({
+    createAbortError,
+    checkSignal,
+    invokeSync,
+    invokeAsync,
+    iterateAsync
+});
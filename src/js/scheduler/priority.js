@@ -0,0 +1,22 @@
+const guard = require('../util/guard');
+
+
+const priorities = Object.freeze([
+    'interactive',
+    'bulk'
+]);
+
+const messages = Object.freeze({
+    INVALID_PRIORITY: `The priority must be one of: ${priorities.join(', ')}.`
+});
+
+function checkPriority(priority) {
+    if (priority !== undefined) {
+        guard.isOneOf(priority, priorities, messages.INVALID_PRIORITY);
+    }
+};
+
+module.exports = Object.freeze({
+    priorities,
+    checkPriority
+});
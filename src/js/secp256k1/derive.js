@@ -0,0 +1,159 @@
+const { secp256k1 } = require('../native');
+const guard = require('../util/guard');
+const { invokeSync, invokeAsync } = require('../scheduler/invoke');
+
+
+const HARDENED = 0x80000000;
+const MAX_INDEX = 0xFFFFFFFF;
+const MAX_DEPTH = 255;
+const MAX_BATCH_COUNT = 0xFFFFFFFF;
+
+const lengths = Object.freeze({
+    CHAIN_CODE: 32,
+    PRIVATE_KEY: 32,
+    PUBLIC_KEY1: 33,
+    PUBLIC_KEY2: 65,
+    MIN_SEED: 16,
+    MAX_SEED: 64
+});
+
+const messages = Object.freeze({
+    INVALID_NODE: 'The node must be an object with a chainCode and either a privateKey or a publicKey.',
+    INVALID_CHAIN_CODE: `The chain code must be a Buffer of length ${lengths.CHAIN_CODE}.`,
+    INVALID_PRIVATE_KEY: `The private key must be a Buffer of length ${lengths.PRIVATE_KEY}.`,
+    INVALID_PUBLIC_KEY: `The public key must be a Buffer of length ${lengths.PUBLIC_KEY1} or ${lengths.PUBLIC_KEY2}.`,
+    INVALID_SEED: `The seed must be a Buffer of length between ${lengths.MIN_SEED} and ${lengths.MAX_SEED} (inclusive).`,
+    INVALID_INDEX: `The index must be an integer between 0 and ${MAX_INDEX} (inclusive).`,
+    INVALID_PATH: `The path must be a string such as "m/44'/0'/0'" or an array of at most ${MAX_DEPTH} indices.`,
+    INVALID_COUNT: `The count must be an integer between 0 and ${MAX_BATCH_COUNT} (inclusive).`,
+    INVALID_RANGE: `The index range must not go past ${MAX_INDEX}.`,
+    HARDENED_FROM_PUBLIC: 'Cannot derive a hardened child from a public key.'
+});
+
+const PATH_SEGMENT = /^(\d+)(['hH]?)$/;
+
+function checkNode(node) {
+    if (typeof node !== 'object' || node === null) {
+        throw new TypeError(messages.INVALID_NODE);
+    }
+
+    guard.isBytesOfLength(node.chainCode, lengths.CHAIN_CODE, messages.INVALID_CHAIN_CODE);
+
+    if (node.privateKey !== undefined) {
+        guard.isBytesOfLength(node.privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+
+        return node.privateKey;
+    }
+
+    if (node.publicKey !== undefined) {
+        guard.isBytesOfLengthAny(node.publicKey, [lengths.PUBLIC_KEY1, lengths.PUBLIC_KEY2], messages.INVALID_PUBLIC_KEY);
+
+        return node.publicKey;
+    }
+
+    throw new TypeError(messages.INVALID_NODE);
+};
+
+function parsePath(path) {
+    if (Array.isArray(path)) {
+        guard.isIntegerBetweenInclusive(path.length, 0, MAX_DEPTH, messages.INVALID_PATH);
+
+        path.forEach(index => guard.isIntegerBetweenInclusive(index, 0, MAX_INDEX, messages.INVALID_INDEX));
+
+        return path;
+    }
+
+    if (typeof path !== 'string') {
+        throw new TypeError(messages.INVALID_PATH);
+    }
+
+    const segments = path.split('/');
+
+    if (segments[0] === 'm') {
+        segments.shift();
+    }
+
+    if (segments.length > MAX_DEPTH) {
+        throw new RangeError(messages.INVALID_PATH);
+    }
+
+    return segments.map(segment => {
+        const match = PATH_SEGMENT.exec(segment);
+        const index = match ? Number(match[1]) : HARDENED;
+
+        if (index >= HARDENED) {
+            throw new RangeError(messages.INVALID_PATH);
+        }
+
+        return match[2] ? index + HARDENED : index;
+    });
+};
+
+function deriveMasterFactory(func) {
+    return function deriveMaster(seed) {
+        guard.isBytes(seed, messages.INVALID_SEED);
+
+        guard.isIntegerBetweenInclusive(seed.byteLength, lengths.MIN_SEED, lengths.MAX_SEED, messages.INVALID_SEED);
+
+        return func(seed);
+    };
+};
+
+function deriveChildFactory(func, invoke) {
+    return function deriveChild(node, index, options) {
+        const key = checkNode(node);
+
+        guard.isIntegerBetweenInclusive(index, 0, MAX_INDEX, messages.INVALID_INDEX);
+
+        return invoke(func, [key, node.chainCode, [index]], options);
+    };
+};
+
+function derivePathFactory(func, invoke) {
+    return function derivePath(node, path, options) {
+        const key = checkNode(node);
+
+        return invoke(func, [key, node.chainCode, parsePath(path)], options);
+    };
+};
+
+function deriveBatchFactory(func) {
+    return function deriveBatch(node, path, start, count, options) {
+        const key = checkNode(node);
+        const indices = parsePath(path);
+
+        guard.isIntegerBetweenInclusive(start, 0, MAX_INDEX, messages.INVALID_INDEX);
+
+        guard.isIntegerBetweenInclusive(count, 0, MAX_BATCH_COUNT, messages.INVALID_COUNT);
+
+        if (start + count - 1 > MAX_INDEX) {
+            throw new RangeError(messages.INVALID_RANGE);
+        }
+
+        if (node.privateKey === undefined && count > 0 && start + count - 1 >= HARDENED) {
+            throw new RangeError(messages.HARDENED_FROM_PUBLIC);
+        }
+
+        return invokeAsync(func, [key, node.chainCode, indices, start, count], options);
+    };
+};
+
+module.exports = (function moduleFactory(impl) {
+    return Object.freeze({
+        HARDENED,
+
+        parsePath,
+
+        deriveMasterSync: deriveMasterFactory(impl.deriveMasterSync),
+
+        deriveChildSync: deriveChildFactory(impl.derivePathSync, invokeSync),
+        deriveChild: deriveChildFactory(impl.derivePath, invokeAsync),
+
+        derivePathSync: derivePathFactory(impl.derivePathSync, invokeSync),
+        derivePath: derivePathFactory(impl.derivePath, invokeAsync),
+
+        deriveBatch: deriveBatchFactory(impl.deriveBatch),
+
+        clearDerivationCache: impl.clearDerivationCache
+    });
+})(secp256k1);
@@ -1,5 +1,10 @@
+const { randomBytes } = require('crypto');
+
 const { secp256k1 } = require('../native');
 const guard = require('../util/guard');
+const { toBuffer, encodeString, packBytes } = require('../util/bytes');
+const { invokeSync, invokeAsync, iterateAsync } = require('../scheduler/invoke');
+const derive = require('./derive');
 
 
 const lengths = Object.freeze({
@@ -8,79 +13,595 @@ const lengths = Object.freeze({
     PRIVATE_KEY: 32,
     PUBLIC_KEY1: 33,
     PUBLIC_KEY2: 65,
-    SIGNATURE: 64
+    PUBLIC_KEY_XONLY: 32,
+    SIGNATURE: 64,
+    NONCE_TAG: 16,
+    PERSONAL: 16,
+    MAX_PAYLOADS: 2 ** 32 - 1
+});
+
+// Entropy is drawn in JavaScript, so both RFC6979 variants share a native nonce type.
+const nonceTypes = Object.freeze({
+    'rfc6979': 0,
+    'rfc6979+entropy': 0,
+    'rfc6979+tagged': 1,
+    'lowr': 2
+});
+
+const nonceStrategies = Object.freeze(Object.keys(nonceTypes));
+
+// Keeps the packed key Buffers below the Buffer size limit of 32 bit platforms.
+const MAX_KEY_PAIR_COUNT = 2 ** 24;
+
+// Each 64 byte bucket of the cache holds four entries.
+const MAX_SIGNATURE_CACHE_BYTES = 2 ** 31;
+
+// Each pinned public key takes about 60 KiB.
+const MAX_PINNED_PUBLIC_KEY_BYTES = 2 ** 31;
+
+const signatureFormats = Object.freeze([
+    'compact',
+    'der'
+]);
+
+const publicKeyLengths = Object.freeze({
+    compressed: lengths.PUBLIC_KEY1,
+    uncompressed: lengths.PUBLIC_KEY2,
+    xonly: lengths.PUBLIC_KEY_XONLY
 });
 
+const publicKeyFormats = Object.freeze(Object.keys(publicKeyLengths));
+
+// Payloads are hashed natively, in the same task as the signature operation.
+const messageHashes = Object.freeze([
+    'blake2b-256'
+]);
+
 const messages = Object.freeze({
     INVALID_DATA: `Data must be a buffer of length ${lengths.DATA}.`,
     INVALID_MESSAGE: `The message must be a Buffer of length ${lengths.MESSAGE}.`,
     INVALID_NONCE_FUNCTION: `nonceFunction must be a callable function.`,
+    INVALID_KEY_PAIR_COUNT: `The number of key pairs must be an integer between 0 and ${MAX_KEY_PAIR_COUNT}.`,
+    INVALID_HASH_FUNCTION: `hashfn must be a callable function.`,
+    INVALID_NONCE_STRATEGY: `The nonce must be one of: ${nonceStrategies.join(', ')}.`,
+    INVALID_NONCE_COMBINATION: `nonce cannot be combined with noncefn.`,
+    INVALID_NONCE_TAG: `The tag must be a Buffer of length ${lengths.NONCE_TAG}.`,
     INVALID_PRIVATE_KEY: `The private key must be a Buffer of length ${lengths.PRIVATE_KEY}.`,
     INVALID_PUBLIC_KEY: `The public key must be a Buffer of length ${lengths.PUBLIC_KEY1} or ${lengths.PUBLIC_KEY2}.`,
-    INVALID_SIGNATURE: `The signature must be a Buffer of length ${lengths.SIGNATURE}.`
+    INVALID_SIGNATURE: `The signature must be a Buffer of length ${lengths.SIGNATURE}.`,
+    INVALID_DER_SIGNATURE: `The signature must be a Buffer.`,
+    INVALID_MESSAGES: `The messages must be a Buffer of packed ${lengths.MESSAGE} byte messages.`,
+    INVALID_SIGNATURES: `The signatures must be a Buffer of packed ${lengths.SIGNATURE} byte signatures, one per message.`,
+    INVALID_DER_SIGNATURES: `The signatures must be a Buffer of back-to-back DER signatures.`,
+    INVALID_PUBLIC_KEYS: `The public keys must be a Buffer of packed ${lengths.PUBLIC_KEY1} or ${lengths.PUBLIC_KEY2} byte public keys, one per message.`,
+    INVALID_PUBLIC_KEY_FORMAT: `The public key format must be one of: ${publicKeyFormats.join(', ')}.`,
+    INVALID_ANY_PUBLIC_KEY: `The public key must be a Buffer of length ${lengths.PUBLIC_KEY_XONLY}, ${lengths.PUBLIC_KEY1} or ${lengths.PUBLIC_KEY2}.`,
+    INVALID_CONVERTED_PUBLIC_KEYS: `The public keys must be a Buffer of packed public keys in the input format.`,
+    INVALID_ECDH_PUBLIC_KEYS: `The public keys must be a Buffer of packed public keys in the given format.`,
+    INVALID_SIGNATURE_FORMAT: `The signature format must be one of: ${signatureFormats.join(', ')}.`,
+    INVALID_PAYLOAD: `The payload must be a Buffer or a string.`,
+    INVALID_PAYLOADS: `The payloads must be an array of Buffers.`,
+    INVALID_PAYLOADS_LENGTH: `The payloads must not exceed ${lengths.MAX_PAYLOADS} bytes in total.`,
+    INVALID_MESSAGE_HASH: `The hash must be one of: ${messageHashes.join(', ')}.`,
+    INVALID_PERSONAL: `The personalization must be a Buffer or a string of at most ${lengths.PERSONAL} bytes.`,
+    INVALID_MESSAGE_SIGNATURES: `The signatures must be a Buffer of packed ${lengths.SIGNATURE} byte signatures, one per payload.`,
+    INVALID_MESSAGE_PUBLIC_KEYS: `The public keys must be a Buffer of packed ${lengths.PUBLIC_KEY1} or ${lengths.PUBLIC_KEY2} byte public keys, one per payload.`,
+    INVALID_MULTISIG_SIGNATURES: `The signatures must be an array of Buffers of length ${lengths.SIGNATURE}, or of DER signatures in the der format.`,
+    INVALID_MULTISIG_PUBLIC_KEYS: `The public keys must be an array of Buffers of length ${lengths.PUBLIC_KEY1} or ${lengths.PUBLIC_KEY2}.`,
+    INVALID_MULTISIG_ITEMS_LENGTH: `The signatures and the public keys must not exceed ${lengths.MAX_PAYLOADS} bytes in total.`,
+    INVALID_MULTISIG_THRESHOLD: `m must be an integer between 0 and the number of public keys (inclusive).`,
+    INVALID_MULTISIG_SIGNATURE_COUNT: `There must be exactly m signatures.`,
+    INVALID_MULTISIG_CHECKS: `The checks must be an array of { message, signatures, publicKeys, m } objects.`,
+    INVALID_SIGNATURE_CACHE_SIZE: `The signature cache size must be an integer between 0 and ${MAX_SIGNATURE_CACHE_BYTES} (inclusive), 0 meaning disabled.`,
+    INVALID_PINNED_PUBLIC_KEY_BYTES: `The memory of pinned public keys must be an integer between 0 and ${MAX_PINNED_PUBLIC_KEY_BYTES} (inclusive).`,
+    INVALID_SIGNATURE_CACHE_PATH: `The signature cache path must be a string.`
 });
 
 const UNSET_NONCE_FUNCTION = null;
 const UNSET_SIGN_DATA = null;
+const UNSET_NONCE_TAG = null;
+const UNSET_PERSONAL = null;
+
+function nonceArguments(data, nonce, tag) {
+    guard.isOneOf(nonce, nonceStrategies, messages.INVALID_NONCE_STRATEGY);
+
+    if (data) {
+        guard.isBytesOfLength(data, lengths.DATA, messages.INVALID_DATA);
+    } else if (nonce === 'rfc6979+entropy') {
+        data = randomBytes(lengths.DATA);
+    }
+
+    if (nonce === 'rfc6979+tagged') {
+        guard.isBytesOfLength(tag, lengths.NONCE_TAG, messages.INVALID_NONCE_TAG);
+    }
+
+    return [data || UNSET_SIGN_DATA, nonceTypes[nonce], tag || UNSET_NONCE_TAG];
+};
+
+function personalArgument(hash, personal) {
+    guard.isOneOf(hash, messageHashes, messages.INVALID_MESSAGE_HASH);
+
+    if (personal === undefined || personal === null) {
+        return UNSET_PERSONAL;
+    }
+
+    guard.isBytesOrString(personal, messages.INVALID_PERSONAL);
+
+    const personalBytes = typeof personal === 'string' ? Buffer.from(personal) : personal;
+
+    guard.isIntegerBetweenInclusive(personalBytes.byteLength, 0, lengths.PERSONAL, messages.INVALID_PERSONAL);
+
+    return personalBytes;
+};
 
-function privateKeyVerifyFactory(func) {
-    return function privateKeyVerify(privateKey) {
-        guard.isBufferOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+function encodePayload(payload, encoding) {
+    guard.isBytesOrString(payload, messages.INVALID_PAYLOAD);
 
-        return func(privateKey);
+    return encodeString(payload, encoding);
+};
+
+function packPayloads(payloads) {
+    return packBytes(payloads, lengths.MAX_PAYLOADS, messages.INVALID_PAYLOADS, messages.INVALID_PAYLOADS_LENGTH);
+};
+
+function privateKeyVerifyFactory(func, invoke) {
+    return function privateKeyVerify(privateKey, options) {
+        guard.isBytesOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+
+        return invoke(func, [privateKey], options);
     };
 };
 
-function publicKeyCreateFactory(func) {
-    return function publicKeyCreate(privateKey, isCompressed = true) {
-        guard.isBufferOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+function publicKeyCreateFactory(func, invoke) {
+    return function publicKeyCreate(privateKey, isCompressed = true, options) {
+        guard.isBytesOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+
+        return invoke(func, [privateKey, !!isCompressed], options);
+    };
+};
 
-        return func(privateKey, !!isCompressed);
+function generateKeyPairSyncFactory(func) {
+    return function generateKeyPairSync({ compressed = true } = {}) {
+        return func(!!compressed);
     };
 };
 
-function signFactory(func) {
-    return function sign (message, privateKey, { data, noncefn } = {}) {
-        guard.isBufferOfLength(message, lengths.MESSAGE, messages.INVALID_MESSAGE);
+function generateKeyPairsFactory(func) {
+    return function generateKeyPairs(count, { compressed = true, priority, signal } = {}) {
+        guard.isIntegerBetweenInclusive(count, 0, MAX_KEY_PAIR_COUNT, messages.INVALID_KEY_PAIR_COUNT);
+
+        return invokeAsync(func, [count, !!compressed], { priority, signal });
+    };
+};
 
-        guard.isBufferOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+// A single key pair is a batch of one, which is interactive unless told otherwise.
+function generateKeyPairFactory(generateKeyPairs) {
+    return async function generateKeyPair({ compressed = true, priority = 'interactive', signal } = {}) {
+        const { privateKeys, publicKeys } = await generateKeyPairs(1, { compressed, priority, signal });
 
-        if (data) {
-            guard.isBufferOfLength(data, lengths.DATA, messages.INVALID_DATA);
-        }
+        return {
+            privateKey: privateKeys,
+            publicKey: publicKeys
+        };
+    };
+};
+
+function signFactory(func, invoke) {
+    return function sign (message, privateKey, { data, noncefn, nonce, tag, priority, signal } = {}) {
+        guard.isBytesOfLength(message, lengths.MESSAGE, messages.INVALID_MESSAGE);
+
+        guard.isBytesOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
 
         if (noncefn) {
             guard.isFunction(noncefn, messages.INVALID_NONCE_FUNCTION);
+
+            if (nonce !== undefined) {
+                throw new TypeError(messages.INVALID_NONCE_COMBINATION);
+            }
+        }
+
+        const nonceArgs = nonceArguments(data, nonce || 'rfc6979', tag);
+
+        return invoke(func, [message, privateKey, noncefn || UNSET_NONCE_FUNCTION, ...nonceArgs], { priority, signal });
+    };
+};
+
+function signBatchFactory(func) {
+    return function signBatch(messageBatch, privateKey, { data, nonce = 'rfc6979', tag, priority, signal } = {}) {
+        guard.isBytesOfLengthMultiple(messageBatch, lengths.MESSAGE, messages.INVALID_MESSAGES);
+
+        guard.isBytesOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+
+        return invokeAsync(func, [messageBatch, privateKey, ...nonceArguments(data, nonce, tag)], { priority, signal });
+    };
+};
+
+function verifyFactory(func, invoke) {
+    return function verify(message, signature, publicKey, options) {
+        guard.isBytesOfLength(message, lengths.MESSAGE, messages.INVALID_MESSAGE);
+
+        guard.isBytesOfLength(signature, lengths.SIGNATURE, messages.INVALID_SIGNATURE);
+
+        guard.isBytesOfLengthAny(publicKey, [lengths.PUBLIC_KEY1, lengths.PUBLIC_KEY2], messages.INVALID_PUBLIC_KEY);
+
+        return invoke(func, [message, signature, publicKey], options);
+    };
+};
+
+function signMessageFactory(func, invoke) {
+    return function signMessage(payload, privateKey, {
+        hash = 'blake2b-256',
+        personal,
+        encoding,
+        data,
+        nonce = 'rfc6979',
+        tag,
+        priority,
+        signal
+    } = {}) {
+        const encodedPayload = encodePayload(payload, encoding);
+
+        guard.isBytesOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+
+        const personalArg = personalArgument(hash, personal);
+
+        return invoke(func, [encodedPayload, privateKey, personalArg, ...nonceArguments(data, nonce, tag)], { priority, signal });
+    };
+};
+
+function signMessageBatchFactory(func) {
+    return function signMessageBatch(payloads, privateKey, { hash = 'blake2b-256', personal, data, nonce = 'rfc6979', tag, priority, signal } = {}) {
+        const packedPayloads = packPayloads(payloads);
+
+        guard.isBytesOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+
+        const personalArg = personalArgument(hash, personal);
+
+        return invokeAsync(func, [...packedPayloads, privateKey, personalArg, ...nonceArguments(data, nonce, tag)], { priority, signal });
+    };
+};
+
+function verifyMessageFactory(func, invoke) {
+    return function verifyMessage(payload, signature, publicKey, { hash = 'blake2b-256', personal, encoding, priority, signal } = {}) {
+        const encodedPayload = encodePayload(payload, encoding);
+
+        guard.isBytesOfLength(signature, lengths.SIGNATURE, messages.INVALID_SIGNATURE);
+
+        guard.isBytesOfLengthAny(publicKey, [lengths.PUBLIC_KEY1, lengths.PUBLIC_KEY2], messages.INVALID_PUBLIC_KEY);
+
+        return invoke(func, [encodedPayload, signature, publicKey, personalArgument(hash, personal)], { priority, signal });
+    };
+};
+
+function verifyMessageBatchFactory(func, invoke) {
+    return function verifyMessageBatch(payloads, signatures, publicKeys, { hash = 'blake2b-256', personal, priority, signal } = {}) {
+        const packedPayloads = packPayloads(payloads);
+
+        const count = payloads.length;
+
+        guard.isBytesOfLength(signatures, count * lengths.SIGNATURE, messages.INVALID_MESSAGE_SIGNATURES);
+
+        guard.isBytesOfLengthAny(publicKeys, [count * lengths.PUBLIC_KEY1, count * lengths.PUBLIC_KEY2], messages.INVALID_MESSAGE_PUBLIC_KEYS);
+
+        const personalArg = personalArgument(hash, personal);
+
+        return invoke(func, [...packedPayloads, signatures, publicKeys, personalArg], { priority, signal });
+    };
+};
+
+// The hash function is run in JavaScript on the raw shared point, so the
+// native side is asked to hand out the point instead of its SHA256 hash.
+function applySync(result, transform) {
+    return transform(result);
+};
+
+function applyAsync(promise, transform) {
+    return promise.then(transform);
+};
+
+function ecdhFactory(func, invoke, apply) {
+    return function ecdh(publicKey, privateKey, { hashfn, priority, signal } = {}) {
+        guard.isBytesOfLengthAny(publicKey, Object.values(publicKeyLengths), messages.INVALID_ANY_PUBLIC_KEY);
+
+        guard.isBytesOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+
+        if (!hashfn) {
+            return invoke(func, [publicKey, privateKey, false], { priority, signal });
+        }
+
+        guard.isFunction(hashfn, messages.INVALID_HASH_FUNCTION);
+
+        const point = invoke(func, [publicKey, privateKey, true], { priority, signal });
+
+        return apply(point, (result) => {
+            try {
+                return hashfn(result.subarray(0, 32), result.subarray(32, 64));
+            } finally {
+                // The raw shared point is as secret as the private key.
+                result.fill(0);
+            }
+        });
+    };
+};
+
+function ecdhBatchFactory(func) {
+    return function ecdhBatch(publicKeys, privateKey, { publicKeyFormat = 'compressed', priority, signal } = {}) {
+        guard.isOneOf(publicKeyFormat, publicKeyFormats, messages.INVALID_PUBLIC_KEY_FORMAT);
+
+        guard.isBytesOfLengthMultiple(publicKeys, publicKeyLengths[publicKeyFormat], messages.INVALID_ECDH_PUBLIC_KEYS);
+
+        guard.isBytesOfLength(privateKey, lengths.PRIVATE_KEY, messages.INVALID_PRIVATE_KEY);
+
+        return invokeAsync(func, [publicKeys, publicKeyLengths[publicKeyFormat], privateKey], { priority, signal });
+    };
+};
+
+function publicKeyConvertFactory(func, invoke) {
+    return function publicKeyConvert(publicKey, format = 'compressed', options) {
+        guard.isBytesOfLengthAny(publicKey, Object.values(publicKeyLengths), messages.INVALID_ANY_PUBLIC_KEY);
+
+        guard.isOneOf(format, publicKeyFormats, messages.INVALID_PUBLIC_KEY_FORMAT);
+
+        return invoke(func, [publicKey, publicKeyLengths[format]], options);
+    };
+};
+
+function publicKeyConvertBatchFactory(func) {
+    return function publicKeyConvertBatch(publicKeys, from, to, options) {
+        guard.isOneOf(from, publicKeyFormats, messages.INVALID_PUBLIC_KEY_FORMAT);
+
+        guard.isOneOf(to, publicKeyFormats, messages.INVALID_PUBLIC_KEY_FORMAT);
+
+        guard.isBytesOfLengthMultiple(publicKeys, publicKeyLengths[from], messages.INVALID_CONVERTED_PUBLIC_KEYS);
+
+        return invokeAsync(func, [publicKeys, publicKeyLengths[from], publicKeyLengths[to]], options);
+    };
+};
+
+function signatureImportFactory(func) {
+    return function signatureImport(signature) {
+        guard.isBytes(signature, messages.INVALID_DER_SIGNATURE);
+
+        return func(signature);
+    };
+};
+
+function signatureExportFactory(func) {
+    return function signatureExport(signature) {
+        guard.isBytesOfLength(signature, lengths.SIGNATURE, messages.INVALID_SIGNATURE);
+
+        return func(signature);
+    };
+};
+
+function signatureNormalizeFactory(func) {
+    return function signatureNormalize(signature) {
+        guard.isBytesOfLength(signature, lengths.SIGNATURE, messages.INVALID_SIGNATURE);
+
+        return func(signature);
+    };
+};
+
+function signatureImportBatchFactory(func) {
+    return function signatureImportBatch(signatures, options) {
+        guard.isBytes(signatures, messages.INVALID_DER_SIGNATURES);
+
+        return invokeAsync(func, [signatures], options);
+    };
+};
+
+function compactSignatureBatchFactory(func) {
+    return function compactSignatureBatch(signatures, options) {
+        guard.isBytesOfLengthMultiple(signatures, lengths.SIGNATURE, messages.INVALID_SIGNATURES);
+
+        return invokeAsync(func, [signatures], options);
+    };
+};
+
+function verifyBatchFactory(func, invoke) {
+    return function verifyBatch(messageBatch, signatures, publicKeys, { signatureFormat = 'compact', normalize = false, priority, signal } = {}) {
+        guard.isBytesOfLengthMultiple(messageBatch, lengths.MESSAGE, messages.INVALID_MESSAGES);
+
+        const count = messageBatch.byteLength / lengths.MESSAGE;
+
+        guard.isOneOf(signatureFormat, signatureFormats, messages.INVALID_SIGNATURE_FORMAT);
+
+        if (signatureFormat === 'der') {
+            guard.isBytes(signatures, messages.INVALID_DER_SIGNATURES);
+        } else {
+            guard.isBytesOfLength(signatures, count * lengths.SIGNATURE, messages.INVALID_SIGNATURES);
+        }
+
+        guard.isBytesOfLengthAny(publicKeys, [count * lengths.PUBLIC_KEY1, count * lengths.PUBLIC_KEY2], messages.INVALID_PUBLIC_KEYS);
+
+        return invoke(func, [messageBatch, signatures, publicKeys, signatureFormat === 'der', !!normalize], { priority, signal });
+    };
+};
+
+// CHECKMULTISIG takes exactly m signatures, each of which must match a distinct public key.
+function checkMultisig(message, signatureList, publicKeyList, m, signatureFormat) {
+    guard.isBytesOfLength(message, lengths.MESSAGE, messages.INVALID_MESSAGE);
+
+    if (!Array.isArray(signatureList)) {
+        throw new TypeError(messages.INVALID_MULTISIG_SIGNATURES);
+    }
+
+    if (signatureFormat === 'der') {
+        signatureList.forEach(signature => guard.isBytes(signature, messages.INVALID_MULTISIG_SIGNATURES));
+    } else {
+        signatureList.forEach(signature => guard.isBytesOfLength(signature, lengths.SIGNATURE, messages.INVALID_MULTISIG_SIGNATURES));
+    }
+
+    if (!Array.isArray(publicKeyList)) {
+        throw new TypeError(messages.INVALID_MULTISIG_PUBLIC_KEYS);
+    }
+
+    publicKeyList.forEach(publicKey => guard.isBytesOfLengthAny(publicKey, [lengths.PUBLIC_KEY1, lengths.PUBLIC_KEY2], messages.INVALID_MULTISIG_PUBLIC_KEYS));
+
+    guard.isIntegerBetweenInclusive(m, 0, publicKeyList.length, messages.INVALID_MULTISIG_THRESHOLD);
+
+    if (signatureList.length !== m) {
+        throw new RangeError(messages.INVALID_MULTISIG_SIGNATURE_COUNT);
+    }
+};
+
+function packMultisigItems(signatureList, publicKeyList) {
+    return [
+        ...packBytes(signatureList, lengths.MAX_PAYLOADS, messages.INVALID_MULTISIG_SIGNATURES, messages.INVALID_MULTISIG_ITEMS_LENGTH),
+        ...packBytes(publicKeyList, lengths.MAX_PAYLOADS, messages.INVALID_MULTISIG_PUBLIC_KEYS, messages.INVALID_MULTISIG_ITEMS_LENGTH)
+    ];
+};
+
+function verifyMultisigFactory(func, invoke) {
+    return function verifyMultisig(message, signatureList, publicKeyList, m, { signatureFormat = 'compact', normalize = false, priority, signal } = {}) {
+        guard.isOneOf(signatureFormat, signatureFormats, messages.INVALID_SIGNATURE_FORMAT);
+
+        checkMultisig(message, signatureList, publicKeyList, m, signatureFormat);
+
+        const packedItems = packMultisigItems(signatureList, publicKeyList);
+
+        return invoke(func, [message, ...packedItems, signatureFormat === 'der', !!normalize], { priority, signal });
+    };
+};
+
+function verifyMultisigBatchFactory(func, invoke) {
+    return function verifyMultisigBatch(checks, { signatureFormat = 'compact', normalize = false, priority, signal } = {}) {
+        guard.isOneOf(signatureFormat, signatureFormats, messages.INVALID_SIGNATURE_FORMAT);
+
+        if (!Array.isArray(checks)) {
+            throw new TypeError(messages.INVALID_MULTISIG_CHECKS);
+        }
+
+        // Signature and public key counts of every check, interleaved.
+        const counts = new Uint32Array(2 * checks.length);
+        const signatureList = [];
+        const publicKeyList = [];
+
+        checks.forEach((check, i) => {
+            if (typeof check !== 'object' || check === null) {
+                throw new TypeError(messages.INVALID_MULTISIG_CHECKS);
+            }
+
+            checkMultisig(check.message, check.signatures, check.publicKeys, check.m, signatureFormat);
+
+            counts[2 * i] = check.signatures.length;
+            counts[2 * i + 1] = check.publicKeys.length;
+
+            check.signatures.forEach(signature => signatureList.push(signature));
+            check.publicKeys.forEach(publicKey => publicKeyList.push(publicKey));
+        });
+
+        const packedMessages = Buffer.concat(checks.map(check => toBuffer(check.message)), checks.length * lengths.MESSAGE);
+        const packedItems = packMultisigItems(signatureList, publicKeyList);
+
+        return invoke(func, [packedMessages, ...packedItems, counts, signatureFormat === 'der', !!normalize], { priority, signal });
+    };
+};
+
+function configureSignatureCacheFactory(func) {
+    return function configureSignatureCache({ maxBytes, path } = {}) {
+        guard.isIntegerBetweenInclusive(maxBytes, 0, MAX_SIGNATURE_CACHE_BYTES, messages.INVALID_SIGNATURE_CACHE_SIZE);
+
+        if (path !== undefined && path !== null) {
+            guard.isString(path, messages.INVALID_SIGNATURE_CACHE_PATH);
         }
 
-        return func(message, privateKey, noncefn || UNSET_NONCE_FUNCTION, data || UNSET_SIGN_DATA);
+        return func(maxBytes, path || null);
+    };
+};
+
+function pinPublicKeyFactory(func) {
+    return function pinPublicKey(publicKey) {
+        guard.isBytesOfLengthAny(publicKey, [lengths.PUBLIC_KEY1, lengths.PUBLIC_KEY2], messages.INVALID_PUBLIC_KEY);
+
+        return func(publicKey);
     };
 };
 
-function verifyFactory(func) {
-    return function verify(message, signature, publicKey) {
-        guard.isBufferOfLength(message, lengths.MESSAGE, messages.INVALID_MESSAGE);
+function configurePinnedPublicKeysFactory(func) {
+    return function configurePinnedPublicKeys({ maxBytes } = {}) {
+        guard.isIntegerBetweenInclusive(maxBytes, 0, MAX_PINNED_PUBLIC_KEY_BYTES, messages.INVALID_PINNED_PUBLIC_KEY_BYTES);
 
-        guard.isBufferOfLength(signature, lengths.SIGNATURE, messages.INVALID_SIGNATURE);
+        return func(maxBytes);
+    };
+};
 
-        guard.isBufferOfLengthAny(publicKey, [lengths.PUBLIC_KEY1, lengths.PUBLIC_KEY2], messages.INVALID_PUBLIC_KEY);
+function saveSignatureCacheFactory(func) {
+    return function saveSignatureCache(path) {
+        guard.isString(path, messages.INVALID_SIGNATURE_CACHE_PATH);
 
-        return func(message, signature, publicKey);
+        return func(path);
     };
 };
 
 module.exports = (function moduleFactory(impl) {
     return Object.freeze({
-        privateKeyVerifySync: privateKeyVerifyFactory(impl.privateKeyVerifySync),
-        privateKeyVerify: privateKeyVerifyFactory(impl.privateKeyVerify),
+        privateKeyVerifySync: privateKeyVerifyFactory(impl.privateKeyVerifySync, invokeSync),
+        privateKeyVerify: privateKeyVerifyFactory(impl.privateKeyVerify, invokeAsync),
         
-        publicKeyCreateSync: publicKeyCreateFactory(impl.publicKeyCreateSync),
-        publicKeyCreate: publicKeyCreateFactory(impl.publicKeyCreate),
+        publicKeyCreateSync: publicKeyCreateFactory(impl.publicKeyCreateSync, invokeSync),
+        publicKeyCreate: publicKeyCreateFactory(impl.publicKeyCreate, invokeAsync),
+
+        generateKeyPairSync: generateKeyPairSyncFactory(impl.generateKeyPairSync),
+        generateKeyPair: generateKeyPairFactory(generateKeyPairsFactory(impl.generateKeyPairs)),
+        generateKeyPairs: generateKeyPairsFactory(impl.generateKeyPairs),
+
+        signSync: signFactory(impl.signSync, invokeSync),
+        sign: signFactory(impl.sign, invokeAsync),
+
+        nonceStrategies,
+
+        verifySync: verifyFactory(impl.verifySync, invokeSync),        
+        verify: verifyFactory(impl.verify, invokeAsync),
+
+        messageHashes,
+
+        signMessageSync: signMessageFactory(impl.signMessageSync, invokeSync),
+        signMessage: signMessageFactory(impl.signMessage, invokeAsync),
+        signMessageBatch: signMessageBatchFactory(impl.signMessageBatch),
+
+        verifyMessageSync: verifyMessageFactory(impl.verifyMessageSync, invokeSync),
+        verifyMessage: verifyMessageFactory(impl.verifyMessage, invokeAsync),
+        verifyMessageBatch: verifyMessageBatchFactory(impl.verifyMessageBatch, invokeAsync),
+        verifyMessageBatchChunks: verifyMessageBatchFactory(impl.verifyMessageBatch, iterateAsync),
+
+        ecdhSync: ecdhFactory(impl.ecdhSync, invokeSync, applySync),
+        ecdh: ecdhFactory(impl.ecdh, invokeAsync, applyAsync),
+        ecdhBatch: ecdhBatchFactory(impl.ecdhBatch),
+
+        ...derive,
+
+        publicKeyFormats,
+        signatureFormats,
+
+        publicKeyConvertSync: publicKeyConvertFactory(impl.publicKeyConvertSync, invokeSync),
+        publicKeyConvert: publicKeyConvertFactory(impl.publicKeyConvert, invokeAsync),
+        publicKeyConvertBatch: publicKeyConvertBatchFactory(impl.publicKeyConvertBatch),
+
+        configureSignatureCache: configureSignatureCacheFactory(impl.configureSignatureCache),
+        saveSignatureCache: saveSignatureCacheFactory(impl.saveSignatureCache),
+        signatureCacheStats: impl.signatureCacheStats,
+        clearSignatureCache: impl.clearSignatureCache,
+
+        pinPublicKey: pinPublicKeyFactory(impl.pinPublicKey),
+        unpinPublicKey: pinPublicKeyFactory(impl.unpinPublicKey),
+        configurePinnedPublicKeys: configurePinnedPublicKeysFactory(impl.configurePinnedPublicKeys),
+        pinnedPublicKeyStats: impl.pinnedPublicKeyStats,
+
+        signatureImportSync: signatureImportFactory(impl.signatureImportSync),
+        signatureExportSync: signatureExportFactory(impl.signatureExportSync),
+        signatureNormalizeSync: signatureNormalizeFactory(impl.signatureNormalizeSync),
 
-        signSync: signFactory(impl.signSync),
-        sign: signFactory(impl.sign),
+        signatureImportBatch: signatureImportBatchFactory(impl.signatureImportBatch),
+        signatureExportBatch: compactSignatureBatchFactory(impl.signatureExportBatch),
+        signatureNormalizeBatch: compactSignatureBatchFactory(impl.signatureNormalizeBatch),
+        signBatch: signBatchFactory(impl.signBatch),
+        verifyBatch: verifyBatchFactory(impl.verifyBatch, invokeAsync),
+        verifyBatchChunks: verifyBatchFactory(impl.verifyBatch, iterateAsync),
 
-        verifySync: verifyFactory(impl.verifySync),        
-        verify: verifyFactory(impl.verify)
+        verifyMultisigSync: verifyMultisigFactory(impl.verifyMultisigSync, invokeSync),
+        verifyMultisig: verifyMultisigFactory(impl.verifyMultisig, invokeAsync),
+        verifyMultisigBatch: verifyMultisigBatchFactory(impl.verifyMultisigBatch, invokeAsync),
+        verifyMultisigBatchChunks: verifyMultisigBatchFactory(impl.verifyMultisigBatch, iterateAsync)
     });
 })(secp256k1);
@@ -0,0 +1,63 @@
+const guard = require('./guard');
+
+
+const messages = Object.freeze({
+    INVALID_ENCODING: `Encoding must be a string encoding supported by Buffer.`
+});
+
+// A Buffer over the same memory, for the few places that need Buffer methods.
+function toBuffer(bytes) {
+    if (Buffer.isBuffer(bytes)) {
+        return bytes;
+    }
+
+    if (ArrayBuffer.isView(bytes)) {
+        return Buffer.from(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    }
+
+    return Buffer.from(bytes);
+};
+
+// UTF-8 strings are encoded natively, straight into the scratch space of the
+// operation, while other encodings go through a Buffer.
+function encodeString(data, encoding = 'utf8') {
+    if (typeof data !== 'string' || encoding === 'utf8' || encoding === 'utf-8') {
+        return data;
+    }
+
+    if (!Buffer.isEncoding(encoding)) {
+        throw new TypeError(messages.INVALID_ENCODING);
+    }
+
+    return Buffer.from(data, encoding);
+};
+
+// Byte arrays are packed back-to-back, with count + 1 offsets delimiting them.
+function packBytes(list, maxLength, invalidMessage, invalidLengthMessage) {
+    if (!Array.isArray(list)) {
+        throw new TypeError(invalidMessage);
+    }
+
+    const offsets = new Uint32Array(list.length + 1);
+    let totalLength = 0;
+
+    list.forEach((bytes, i) => {
+        guard.isBytes(bytes, invalidMessage);
+
+        totalLength += bytes.byteLength;
+
+        if (totalLength > maxLength) {
+            throw new RangeError(invalidLengthMessage);
+        }
+
+        offsets[i + 1] = totalLength;
+    });
+
+    return [Buffer.concat(list.map(toBuffer), totalLength), offsets];
+};
+
+module.exports = Object.freeze({
+    toBuffer,
+    encodeString,
+    packBytes
+});
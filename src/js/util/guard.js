@@ -1,32 +1,68 @@
 const guard = {
     isIntegerBetweenInclusive(obj, min, max, errorMessage) {
-        return Number.isInteger(obj)
+        const isValid = Number.isInteger(obj)
             && (min <= obj)
             && (obj <= max);
+
+        if (!isValid) {
+            throw new RangeError(errorMessage);
+        }
     },
-    isBuffer(obj, errorMessage) {
-        if (!Buffer.isBuffer(obj)) {
+    isBigIntBetweenInclusive(obj, min, max, errorMessage) {
+        const isValid = (typeof obj === 'bigint')
+            && (min <= obj)
+            && (obj <= max);
+
+        if (!isValid) {
+            throw new RangeError(errorMessage);
+        }
+    },
+    // Buffers, any other TypedArray, DataViews and ArrayBuffers are all passed to the native side as-is.
+    isBytes(obj, errorMessage) {
+        if (!ArrayBuffer.isView(obj) && !(obj instanceof ArrayBuffer)) {
             throw new TypeError(errorMessage);
         }
     },
-    isBufferOfLength(obj, expectedLength, errorMessage) {
-        guard.isBuffer(obj, errorMessage);
+    isBytesOrString(obj, errorMessage) {
+        if (typeof obj !== 'string') {
+            guard.isBytes(obj, errorMessage);
+        }
+    },
+    isBytesOfLength(obj, expectedLength, errorMessage) {
+        guard.isBytes(obj, errorMessage);
 
-        if (obj.length !== expectedLength) {
+        if (obj.byteLength !== expectedLength) {
             throw new RangeError(errorMessage);
         }
     },
-    isBufferOfLengthAny(obj, acceptedLengths, errorMessage) {
-        guard.isBuffer(obj, errorMessage);
+    isBytesOfLengthAny(obj, acceptedLengths, errorMessage) {
+        guard.isBytes(obj, errorMessage);
 
-        const hasAcceptedLength = acceptedLengths.some(accepted => obj.length === accepted);
+        const hasAcceptedLength = acceptedLengths.some(accepted => obj.byteLength === accepted);
 
         if (!hasAcceptedLength) {
             throw new RangeError(errorMessage);
         }
     },
+    isBytesOfLengthMultiple(obj, unitLength, errorMessage) {
+        guard.isBytes(obj, errorMessage);
+
+        if (obj.byteLength % unitLength !== 0) {
+            throw new RangeError(errorMessage);
+        }
+    },
+    isString(obj, errorMessage) {
+        if (typeof obj !== 'string') {
+            throw new TypeError(errorMessage);
+        }
+    },
+    isOneOf(obj, acceptedValues, errorMessage) {
+        if (!acceptedValues.includes(obj)) {
+            throw new TypeError(errorMessage);
+        }
+    },
     isFunction(obj, errorMessage) {
-        if (!typeof obj === 'function') {
+        if (typeof obj !== 'function') {
             throw new TypeError(errorMessage);
         }
     }
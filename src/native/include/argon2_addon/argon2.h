@@ -0,0 +1,72 @@
+#ifndef __SIGNUN_ARGON2_ADDON_ARGON2_H
+#define __SIGNUN_ARGON2_ADDON_ARGON2_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define ARGON2_BLOCK_SIZE 1024
+#define ARGON2_QWORDS_IN_BLOCK (ARGON2_BLOCK_SIZE / 8)
+#define ARGON2_SYNC_POINTS 4
+#define ARGON2_PREHASH_LENGTH 64
+
+#define ARGON2_MIN_LANES 1
+#define ARGON2_MAX_LANES 0xFFFFFF
+#define ARGON2_MIN_PASSES 1
+#define ARGON2_MIN_HASH_LENGTH 4
+#define ARGON2_MIN_SALT_LENGTH 8
+
+typedef struct
+{
+    uint64_t v[ARGON2_QWORDS_IN_BLOCK];
+} argon2_block_t;
+
+/*
+ * The state of one Argon2id computation, as specified by RFC 9106.
+ *
+ * The memory is split into lanes, each of which is split into four segments
+ * per pass. The segments of the same slice, one per lane, can be filled in
+ * parallel, while the slices themselves must be filled in order.
+ */
+typedef struct
+{
+    // A single allocation, aligned for SIMD loads and to cache lines.
+    argon2_block_t *memory;
+    uint32_t block_count;
+    uint32_t lane_count;
+    uint32_t lane_length;
+    uint32_t segment_length;
+    uint32_t pass_count;
+
+    unsigned char prehash[ARGON2_PREHASH_LENGTH];
+} argon2_addon_instance_t;
+
+/*
+ * Computes the prehash of the inputs and allocates the memory, rounded down
+ * to a multiple of four blocks per lane. The secret and the associated data
+ * are optional. The memory cost is in KiB and must be at least eight per
+ * lane. Returns false if the memory cannot be allocated.
+ */
+bool argon2_addon_instance_init(argon2_addon_instance_t *instance, uint32_t pass_count, uint32_t memory_cost, uint32_t lane_count,
+    uint32_t hash_length, const unsigned char *password, size_t password_length, const unsigned char *salt, size_t salt_length,
+    const unsigned char *secret, size_t secret_length, const unsigned char *associated_data, size_t associated_data_length);
+
+/*
+ * Fills the segment of a lane in the specified pass and slice. Every segment
+ * of the previous slices must have been filled before.
+ */
+void argon2_addon_fill_segment(argon2_addon_instance_t *instance, uint32_t pass, uint32_t slice, uint32_t lane);
+
+/*
+ * Computes the tag from the last block of every lane, once every segment has
+ * been filled, then wipes the memory.
+ */
+void argon2_addon_instance_finalize(argon2_addon_instance_t *instance, unsigned char *hash, size_t hash_length);
+
+/*
+ * Wipes and frees the memory and the prehash. Safe to call more than once.
+ */
+void argon2_addon_instance_release(argon2_addon_instance_t *instance);
+
+#endif
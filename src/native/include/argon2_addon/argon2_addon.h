@@ -0,0 +1,9 @@
+#ifndef __SIGNUN_ARGON2_ADDON_H
+#define __SIGNUN_ARGON2_ADDON_H
+
+#include <node_api.h>
+
+
+napi_status create_argon2_addon(napi_env env, napi_value base);
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef __SIGNUN_ARGON2_ADDON_HASH_H
+#define __SIGNUN_ARGON2_ADDON_HASH_H
+
+#include <node_api.h>
+
+
+napi_value argon2_addon_argon2id_hash(napi_env env, napi_callback_info info);
+
+#endif
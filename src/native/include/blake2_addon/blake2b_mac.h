@@ -0,0 +1,15 @@
+#ifndef __SIGNUN_BLAKE2_ADDON_BLAKE2B_MAC_H
+#define __SIGNUN_BLAKE2_ADDON_BLAKE2B_MAC_H
+
+#include <node_api.h>
+
+
+napi_value blake2_addon_blake2b_mac_create(napi_env env, napi_callback_info info);
+
+napi_value blake2_addon_blake2b_mac_sync(napi_env env, napi_callback_info info);
+
+napi_value blake2_addon_blake2b_mac_async(napi_env env, napi_callback_info info);
+
+napi_value blake2_addon_blake2b_mac_batch(napi_env env, napi_callback_info info);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef __SIGNUN_BLAKE2_ADDON_BLAKE2B_MERKLE_H
+#define __SIGNUN_BLAKE2_ADDON_BLAKE2B_MERKLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <node_api.h>
+
+
+#define BLAKE2B_MERKLE_LEAF_PREFIX 0x00
+#define BLAKE2B_MERKLE_NODE_PREFIX 0x01
+
+/*
+ * Hashes a leaf or an inner node, prepending the prefix if domain separation
+ * is enabled. Shared by the one-shot builder and the accumulator, so that
+ * both produce the same trees.
+ */
+int blake2_addon_merkle_hash(unsigned char *output, size_t output_length, bool domain_separation, unsigned char prefix,
+    const unsigned char *data, size_t data_length);
+
+napi_value blake2_addon_blake2b_merkle_root(napi_env env, napi_callback_info info);
+
+#endif
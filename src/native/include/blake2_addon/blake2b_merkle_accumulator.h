@@ -0,0 +1,17 @@
+#ifndef __SIGNUN_BLAKE2_ADDON_BLAKE2B_MERKLE_ACCUMULATOR_H
+#define __SIGNUN_BLAKE2_ADDON_BLAKE2B_MERKLE_ACCUMULATOR_H
+
+#include <node_api.h>
+
+
+napi_value blake2_addon_merkle_accumulator_create(napi_env env, napi_callback_info info);
+napi_value blake2_addon_merkle_accumulator_size(napi_env env, napi_callback_info info);
+napi_value blake2_addon_merkle_accumulator_append(napi_env env, napi_callback_info info);
+napi_value blake2_addon_merkle_accumulator_append_many(napi_env env, napi_callback_info info);
+napi_value blake2_addon_merkle_accumulator_root(napi_env env, napi_callback_info info);
+napi_value blake2_addon_merkle_accumulator_proof(napi_env env, napi_callback_info info);
+napi_value blake2_addon_merkle_accumulator_update(napi_env env, napi_callback_info info);
+napi_value blake2_addon_merkle_accumulator_sync(napi_env env, napi_callback_info info);
+napi_value blake2_addon_merkle_accumulator_close(napi_env env, napi_callback_info info);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef __SIGNUN_BLAKE2_ADDON_BLAKE2B_STREAM_H
+#define __SIGNUN_BLAKE2_ADDON_BLAKE2B_STREAM_H
+
+#include <node_api.h>
+
+
+napi_value blake2_addon_blake2b_stream_create(napi_env env, napi_callback_info info);
+
+napi_value blake2_addon_blake2b_stream_update(napi_env env, napi_callback_info info);
+
+napi_value blake2_addon_blake2b_stream_depth(napi_env env, napi_callback_info info);
+
+napi_value blake2_addon_blake2b_stream_digest(napi_env env, napi_callback_info info);
+
+#endif
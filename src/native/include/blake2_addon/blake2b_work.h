@@ -0,0 +1,13 @@
+#ifndef __SIGNUN_BLAKE2_ADDON_BLAKE2B_WORK_H
+#define __SIGNUN_BLAKE2_ADDON_BLAKE2B_WORK_H
+
+#include <node_api.h>
+
+
+napi_value blake2_addon_blake2b_work_validate_sync(napi_env env, napi_callback_info info);
+
+napi_value blake2_addon_blake2b_work_validate_batch(napi_env env, napi_callback_info info);
+
+napi_value blake2_addon_blake2b_work_generate(napi_env env, napi_callback_info info);
+
+#endif
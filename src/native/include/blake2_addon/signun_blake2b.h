@@ -1,9 +1,21 @@
 #ifndef __SIGNUN_BLAKE2_ADDON_SIGNUN_BLAKE2B_H
 #define __SIGNUN_BLAKE2_ADDON_SIGNUN_BLAKE2B_H
 
+#include <stddef.h>
+
 #include <node_api.h>
 
 
+#define BLAKE2B_PERSONAL_LENGTH 16
+
+/*
+ * Computes an unkeyed BLAKE2b hash, with the personalization string of the
+ * parameter block set to personal, zero-padded to BLAKE2B_PERSONAL_LENGTH.
+ * Lets other addons hash on the worker thread of their own operations.
+ */
+int blake2_addon_blake2b_personal(unsigned char *output, size_t output_length, const unsigned char *personal, size_t personal_length,
+    const void *data, size_t data_length);
+
 napi_value blake2_addon_blake2b_hash_async(napi_env env, napi_callback_info info);
 
 napi_value blake2_addon_blake2b_keyed_hash_async(napi_env env, napi_callback_info info);
@@ -0,0 +1,42 @@
+#ifndef __SIGNUN_ED25519_ADDON_ED25519_H
+#define __SIGNUN_ED25519_ADDON_ED25519_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+#define ED25519_SEED_LENGTH 32
+#define ED25519_PUBLIC_KEY_LENGTH 32
+#define ED25519_SIGNATURE_LENGTH 64
+
+/*
+ * The 512 bit hash that derives the secret scalar, the nonce and the
+ * challenge. BLAKE2b-512 is the variant used by Nano, SHA-512 is RFC 8032.
+ */
+typedef enum
+{
+    ED25519_HASH_BLAKE2B,
+    ED25519_HASH_SHA512,
+    ED25519_HASH_TYPE_COUNT
+} ed25519_addon_hash_type_t;
+
+/*
+ * Derives the public key of a 32 byte seed, the private key of RFC 8032.
+ */
+void ed25519_addon_public_key_create(unsigned char *public_key, const unsigned char *seed, ed25519_addon_hash_type_t hash_type);
+
+/*
+ * Signs a message of any length deterministically, as specified by RFC 8032.
+ */
+void ed25519_addon_sign(unsigned char *signature, const unsigned char *message, size_t message_length,
+    const unsigned char *seed, ed25519_addon_hash_type_t hash_type);
+
+/*
+ * Verifies a signature, rejecting non-canonical public keys, points and
+ * scalars, so that a signature cannot be altered without invalidating it.
+ * Runs in variable time, as every input is public.
+ */
+bool ed25519_addon_verify(const unsigned char *signature, const unsigned char *message, size_t message_length,
+    const unsigned char *public_key, ed25519_addon_hash_type_t hash_type);
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef __SIGNUN_ED25519_ADDON_H
+#define __SIGNUN_ED25519_ADDON_H
+
+#include <node_api.h>
+
+
+napi_status create_ed25519_addon(napi_env env, napi_value base);
+
+#endif
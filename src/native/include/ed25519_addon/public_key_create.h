@@ -0,0 +1,11 @@
+#ifndef __SIGNUN_ED25519_ADDON_PUBLIC_KEY_CREATE_H
+#define __SIGNUN_ED25519_ADDON_PUBLIC_KEY_CREATE_H
+
+#include <node_api.h>
+
+
+napi_value ed25519_addon_public_key_create_sync(napi_env env, napi_callback_info info);
+
+napi_value ed25519_addon_public_key_create_async(napi_env env, napi_callback_info info);
+
+#endif
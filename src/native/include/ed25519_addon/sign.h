@@ -0,0 +1,11 @@
+#ifndef __SIGNUN_ED25519_ADDON_SIGN_H
+#define __SIGNUN_ED25519_ADDON_SIGN_H
+
+#include <node_api.h>
+
+
+napi_value ed25519_addon_sign_sync(napi_env env, napi_callback_info info);
+
+napi_value ed25519_addon_sign_async(napi_env env, napi_callback_info info);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef __SIGNUN_ED25519_ADDON_UTIL_H
+#define __SIGNUN_ED25519_ADDON_UTIL_H
+
+#include <node_api.h>
+
+#include "ed25519_addon/ed25519.h"
+
+
+// Strings up to this length are encoded into the callback data itself.
+#define ED25519_MESSAGE_SCRATCH_LENGTH 512
+
+/*
+ * Reads the index of the hash, as listed by ed25519_addon_hash_type_t.
+ */
+napi_status ed25519_addon_get_hash_type(napi_env env, napi_value value, ed25519_addon_hash_type_t *hash_type);
+
+#endif
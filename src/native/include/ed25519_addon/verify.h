@@ -0,0 +1,13 @@
+#ifndef __SIGNUN_ED25519_ADDON_VERIFY_H
+#define __SIGNUN_ED25519_ADDON_VERIFY_H
+
+#include <node_api.h>
+
+
+napi_value ed25519_addon_verify_sync(napi_env env, napi_callback_info info);
+
+napi_value ed25519_addon_verify_async(napi_env env, napi_callback_info info);
+
+napi_value ed25519_addon_verify_batch(napi_env env, napi_callback_info info);
+
+#endif
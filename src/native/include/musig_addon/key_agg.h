@@ -0,0 +1,18 @@
+#ifndef __SIGNUN_MUSIG_ADDON_KEY_AGG_H
+#define __SIGNUN_MUSIG_ADDON_KEY_AGG_H
+
+#include <node_api.h>
+
+#include "musig_addon/util.h"
+
+
+/*
+ * Reads a key aggregate created by musig_addon_key_agg.
+ */
+napi_status musig_addon_get_key_agg(napi_env env, napi_value value, musig_addon_key_agg_t **key_agg);
+
+napi_value musig_addon_key_agg(napi_env env, napi_callback_info info);
+
+napi_value musig_addon_key_agg_public_key(napi_env env, napi_callback_info info);
+
+#endif
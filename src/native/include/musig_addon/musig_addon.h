@@ -0,0 +1,15 @@
+#ifndef __SIGNUN_MUSIG_ADDON_H
+#define __SIGNUN_MUSIG_ADDON_H
+
+#include <node_api.h>
+
+#include "secp256k1_addon/util.h"
+
+
+/*
+ * Registers the MuSig2 functions, which share the context of the secp256k1
+ * addon.
+ */
+napi_status create_musig_addon(napi_env env, napi_value base, secp256k1_addon_callback_data_t *callback_data);
+
+#endif
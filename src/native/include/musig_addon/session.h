@@ -0,0 +1,19 @@
+#ifndef __SIGNUN_MUSIG_ADDON_SESSION_H
+#define __SIGNUN_MUSIG_ADDON_SESSION_H
+
+#include <node_api.h>
+
+
+napi_value musig_addon_session_create(napi_env env, napi_callback_info info);
+
+napi_value musig_addon_session_public_nonce(napi_env env, napi_callback_info info);
+
+napi_value musig_addon_session_process_nonces(napi_env env, napi_callback_info info);
+
+napi_value musig_addon_session_sign(napi_env env, napi_callback_info info);
+
+napi_value musig_addon_session_verify_partial(napi_env env, napi_callback_info info);
+
+napi_value musig_addon_session_aggregate(napi_env env, napi_callback_info info);
+
+#endif
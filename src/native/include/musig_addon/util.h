@@ -0,0 +1,27 @@
+#ifndef __SIGNUN_MUSIG_ADDON_UTIL_H
+#define __SIGNUN_MUSIG_ADDON_UTIL_H
+
+#include <stddef.h>
+
+#include "secp256k1.h"
+#include "secp256k1_musig.h"
+
+#include "secp256k1_addon/util.h"
+
+
+#define PUBLIC_NONCE_LENGTH 66
+#define PARTIAL_SIGNATURE_LENGTH 32
+#define SCHNORR_SIGNATURE_LENGTH 64
+
+/*
+ * The aggregate of a list of public keys, shared read-only by every session
+ * signing for it.
+ */
+typedef struct
+{
+    secp256k1_musig_keyagg_cache cache;
+    unsigned char public_key[XONLY_PUBLIC_KEY_LENGTH];
+    size_t signer_count;
+} musig_addon_key_agg_t;
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef __SIGNUN_SECP256K1_ADDON_DERIVE_H
+#define __SIGNUN_SECP256K1_ADDON_DERIVE_H
+
+#include <node_api.h>
+
+
+napi_value secp256k1_addon_derive_master_sync(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_derive_path_sync(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_derive_path_async(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_derive_batch(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_clear_derivation_cache(napi_env env, napi_callback_info info);
+
+#endif
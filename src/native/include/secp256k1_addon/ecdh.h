@@ -0,0 +1,13 @@
+#ifndef __SIGNUN_SECP256K1_ADDON_ECDH_H
+#define __SIGNUN_SECP256K1_ADDON_ECDH_H
+
+#include <node_api.h>
+
+
+napi_value secp256k1_addon_ecdh_sync(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_ecdh_async(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_ecdh_batch(napi_env env, napi_callback_info info);
+
+#endif
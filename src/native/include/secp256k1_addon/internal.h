@@ -0,0 +1,44 @@
+#ifndef __SIGNUN_SECP256K1_ADDON_INTERNAL_H
+#define __SIGNUN_SECP256K1_ADDON_INTERNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "secp256k1.h"
+
+
+/*
+ * Creates the public keys of count packed private keys like
+ * secp256k1_ec_pubkey_create, but converts them to affine coordinates with a
+ * single shared field inversion. Returns false if a private key is invalid,
+ * or if the scratch space could not be allocated.
+ */
+bool secp256k1_addon_ec_pubkey_create_all(const secp256k1_context *ctx, secp256k1_pubkey *public_keys, const unsigned char *private_keys, size_t count);
+
+/*
+ * The multiples of a public key by every digit of every 4-bit window of a
+ * scalar, so that multiplying by a scalar takes one addition per window and
+ * no doublings.
+ */
+typedef struct secp256k1_addon_window_table_s secp256k1_addon_window_table_t;
+
+/*
+ * The memory taken by the table of a public key.
+ */
+size_t secp256k1_addon_window_table_size(void);
+
+/*
+ * Builds the table of a public key, along with the table of the generator
+ * the first time around. Returns NULL if either could not be allocated.
+ */
+secp256k1_addon_window_table_t *secp256k1_addon_window_table_create(const secp256k1_context *ctx, const secp256k1_pubkey *public_key);
+
+void secp256k1_addon_window_table_destroy(secp256k1_addon_window_table_t *table);
+
+/*
+ * Verifies like secp256k1_ecdsa_verify, against the public key of the table.
+ */
+bool secp256k1_addon_ecdsa_verify_window(const secp256k1_context *ctx, const secp256k1_ecdsa_signature *signature,
+    const unsigned char *message, const secp256k1_addon_window_table_t *table);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef __SIGNUN_SECP256K1_ADDON_KEY_PAIR_H
+#define __SIGNUN_SECP256K1_ADDON_KEY_PAIR_H
+
+#include <node_api.h>
+
+
+napi_value secp256k1_addon_generate_key_pair_sync(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_generate_key_pairs(napi_env env, napi_callback_info info);
+
+#endif
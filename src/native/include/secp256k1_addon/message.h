@@ -0,0 +1,19 @@
+#ifndef __SIGNUN_SECP256K1_ADDON_MESSAGE_H
+#define __SIGNUN_SECP256K1_ADDON_MESSAGE_H
+
+#include <node_api.h>
+
+
+napi_value secp256k1_addon_sign_message_sync(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_sign_message_async(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_sign_message_batch(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_verify_message_sync(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_verify_message_async(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_verify_message_batch(napi_env env, napi_callback_info info);
+
+#endif
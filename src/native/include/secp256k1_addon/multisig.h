@@ -0,0 +1,13 @@
+#ifndef __SIGNUN_SECP256K1_ADDON_MULTISIG_H
+#define __SIGNUN_SECP256K1_ADDON_MULTISIG_H
+
+#include <node_api.h>
+
+
+napi_value secp256k1_addon_verify_multisig_sync(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_verify_multisig_async(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_verify_multisig_batch(napi_env env, napi_callback_info info);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef __SIGNUN_SECP256K1_ADDON_PUBLIC_KEY_CONVERT_H
+#define __SIGNUN_SECP256K1_ADDON_PUBLIC_KEY_CONVERT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <node_api.h>
+
+#include "secp256k1.h"
+
+
+/*
+ * Parses a compressed, uncompressed or x-only public key, telling them apart
+ * by length. X-only keys are lifted to the point with an even Y coordinate.
+ */
+bool secp256k1_addon_public_key_parse(const secp256k1_context *ctx, secp256k1_pubkey *public_key, const unsigned char *input, size_t input_length);
+
+/*
+ * Serializes a public key into output_length bytes, which selects between
+ * the compressed, uncompressed and x-only forms.
+ */
+void secp256k1_addon_public_key_serialize(const secp256k1_context *ctx, unsigned char *output, size_t output_length, const secp256k1_pubkey *public_key);
+
+napi_value secp256k1_addon_public_key_convert_sync(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_public_key_convert_async(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_public_key_convert_batch(napi_env env, napi_callback_info info);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef __SIGNUN_SECP256K1_ADDON_PUBLIC_KEY_PIN_H
+#define __SIGNUN_SECP256K1_ADDON_PUBLIC_KEY_PIN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <node_api.h>
+
+#include "secp256k1.h"
+
+
+/*
+ * Verifies like secp256k1_ecdsa_verify against a serialized public key,
+ * which fails to verify if it does not parse. A pinned key is verified
+ * against its window table instead of being parsed. Safe to call from
+ * workers.
+ */
+bool secp256k1_addon_ecdsa_verify_public_key(const secp256k1_context *ctx, const secp256k1_ecdsa_signature *signature,
+    const unsigned char *message, const unsigned char *raw_public_key, size_t raw_public_key_length);
+
+napi_value secp256k1_addon_pin_public_key(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_unpin_public_key(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_pinned_public_keys_configure(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_pinned_public_keys_stats(napi_env env, napi_callback_info info);
+
+#endif
@@ -1,11 +1,39 @@
 #ifndef __SIGNUN_SECP256K1_ADDON_SIGN_H
 #define __SIGNUN_SECP256K1_ADDON_SIGN_H
 
+#include <stdbool.h>
+
 #include <node_api.h>
 
+#include "secp256k1.h"
+
+
+typedef enum
+{
+    SIGN_NONCE_RFC6979,
+    SIGN_NONCE_RFC6979_TAGGED,
+    SIGN_NONCE_LOW_R,
+
+    SIGN_NONCE_TYPE_COUNT
+} secp256k1_addon_nonce_type_t;
+
+/*
+ * Signs a 32 byte message into a compact signature and a recovery id, with
+ * the nonce derived according to nonce_type. data and tag may be NULL when
+ * the nonce type does not use them.
+ */
+bool secp256k1_addon_sign_with_nonce(const secp256k1_context *ctx, unsigned char *output, int *recovery_id, const unsigned char *message, const unsigned char *private_key,
+    const unsigned char *data, secp256k1_addon_nonce_type_t nonce_type, const unsigned char *tag);
+
+/*
+ * Reads the nonce type and, for tagged nonces, the 16 byte tag passed from JavaScript.
+ */
+napi_status secp256k1_addon_get_nonce_options(napi_env env, napi_value js_nonce_type, napi_value js_tag, secp256k1_addon_nonce_type_t *nonce_type, unsigned char *tag);
 
 napi_value secp256k1_addon_sign_sync(napi_env env, napi_callback_info info);
 
 napi_value secp256k1_addon_sign_async(napi_env env, napi_callback_info info);
 
+napi_value secp256k1_addon_sign_batch(napi_env env, napi_callback_info info);
+
 #endif
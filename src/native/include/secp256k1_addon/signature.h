@@ -0,0 +1,29 @@
+#ifndef __SIGNUN_SECP256K1_ADDON_SIGNATURE_H
+#define __SIGNUN_SECP256K1_ADDON_SIGNATURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <node_api.h>
+
+
+/*
+ * Finds the boundaries of back-to-back DER signatures. If offsets is not NULL,
+ * it must have room for count + 1 entries, the last one being the end of the
+ * input. Returns false if the input is not a sequence of DER signatures.
+ */
+bool secp256k1_addon_scan_der_signatures(const unsigned char *input, size_t input_length, size_t *offsets, size_t *count);
+
+napi_value secp256k1_addon_signature_import_sync(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_signature_export_sync(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_signature_normalize_sync(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_signature_import_batch(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_signature_export_batch(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_signature_normalize_batch(napi_env env, napi_callback_info info);
+
+#endif
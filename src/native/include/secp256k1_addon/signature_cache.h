@@ -0,0 +1,45 @@
+#ifndef __SIGNUN_SECP256K1_ADDON_SIGNATURE_CACHE_H
+#define __SIGNUN_SECP256K1_ADDON_SIGNATURE_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <node_api.h>
+
+
+#define SIGNATURE_CACHE_KEY_LENGTH 32
+
+// Verification options that change the outcome, and so are part of the key.
+#define SIGNATURE_CACHE_FLAG_DER 0x01
+#define SIGNATURE_CACHE_FLAG_NORMALIZE 0x02
+#define SIGNATURE_CACHE_FLAG_SCHNORR 0x04
+
+typedef struct
+{
+    bool is_set;
+    unsigned char digest[SIGNATURE_CACHE_KEY_LENGTH];
+} secp256k1_addon_signature_cache_key_t;
+
+/*
+ * Derives the key of a (message, signature, public key) triple and returns
+ * whether it is known to be valid. The key is left unset if the cache is
+ * disabled. Safe to call from workers, lookups only take a read lock.
+ */
+bool secp256k1_addon_signature_cache_lookup(secp256k1_addon_signature_cache_key_t *key, const unsigned char *message,
+    const unsigned char *signature, size_t signature_length, const unsigned char *public_key, size_t public_key_length, unsigned char flags);
+
+/*
+ * Remembers a triple that was verified to be valid. Only valid triples are
+ * cached, so a hit can never turn an invalid signature into a valid one.
+ */
+void secp256k1_addon_signature_cache_insert(const secp256k1_addon_signature_cache_key_t *key);
+
+napi_value secp256k1_addon_signature_cache_configure(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_signature_cache_save(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_signature_cache_stats(napi_env env, napi_callback_info info);
+
+napi_value secp256k1_addon_signature_cache_clear(napi_env env, napi_callback_info info);
+
+#endif
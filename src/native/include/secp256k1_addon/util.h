@@ -10,7 +10,12 @@
 #define ALGORITHM_LENGTH 16
 #define NONCE_LENGTH 32
 #define SIGNATURE_LENGTH 64
+#define DER_SIGNATURE_MAX_LENGTH 72
 #define SERIALIZED_PUBLIC_KEY_LENGTH 65
+#define COMPRESSED_PUBLIC_KEY_LENGTH 33
+#define XONLY_PUBLIC_KEY_LENGTH 32
+#define SHARED_SECRET_LENGTH 32
+#define SHARED_POINT_LENGTH 64
 
 #define NONCE_FAILED 0
 #define NONCE_SUCCESS 1
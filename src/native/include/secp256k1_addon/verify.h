@@ -8,4 +8,6 @@ napi_value secp256k1_addon_verify_sync(napi_env env, napi_callback_info info);
 
 napi_value secp256k1_addon_verify_async(napi_env env, napi_callback_info info);
 
+napi_value secp256k1_addon_verify_batch(napi_env env, napi_callback_info info);
+
 #endif
@@ -0,0 +1,159 @@
+#ifndef __SIGNUN_BATCH_H
+#define __SIGNUN_BATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <node_api.h>
+#include <uv.h>
+
+#include "signun_scheduler.h"
+
+
+#define SIGNUN_BATCH_MAX_RETAINED_VALUES 5
+
+struct signun_batch_s;
+
+typedef struct
+{
+    signun_task_t task;
+
+    struct signun_batch_s *batch;
+    size_t start;
+    size_t end;
+
+    // Written by the worker running the chunk, read once it has completed.
+    const char *error_message;
+} signun_batch_chunk_t;
+
+/*
+ * Processes the items in [start, end). Runs on a worker thread, concurrently
+ * with other chunks of the same batch.
+ */
+typedef void (*signun_batch_execute_callback)(struct signun_batch_s *batch, signun_batch_chunk_t *chunk);
+
+/*
+ * Produces the value the batch promise is resolved with, once every chunk has
+ * succeeded. Runs on the main thread.
+ */
+typedef napi_status (*signun_batch_complete_callback)(napi_env env, struct signun_batch_s *batch, napi_value *result);
+
+/*
+ * Releases the batch once it has settled. Runs on the main thread.
+ */
+typedef void (*signun_batch_finalize_callback)(napi_env env, struct signun_batch_s *batch);
+
+/*
+ * Prepares the next phase of a batch, once every chunk of the current phase
+ * has succeeded, and returns its item count, or zero if the batch is done.
+ * Runs on the main thread.
+ */
+typedef size_t (*signun_batch_advance_callback)(struct signun_batch_s *batch);
+
+/*
+ * A batch splits its items into fixed-size chunks, each of which is queued
+ * as a separate task. Chunks therefore run in parallel, are served by the
+ * priority lanes one at a time and are dropped individually on abort.
+ *
+ * Operations embed the batch as the first member of their own batch data.
+ *
+ * Batches whose items depend on the results of other items, such as the
+ * levels of a tree, run in phases: the chunks of a phase are only queued once
+ * the previous phase has completed, without a round trip to JavaScript.
+ */
+typedef struct signun_batch_s
+{
+    napi_deferred deferred;
+
+    size_t item_count;
+    size_t chunk_size;
+    size_t chunk_count;
+    size_t pending_chunk_count;
+    signun_batch_chunk_t *chunks;
+
+    // Tells workers to skip the rest of the batch once it is known to fail.
+    // Set from workers and the main thread alike, so guarded by the mutex.
+    uv_mutex_t mutex;
+    bool failed;
+    bool is_aborted;
+    const char *error_message;
+
+    size_t retained_value_count;
+    napi_ref retained_values[SIGNUN_BATCH_MAX_RETAINED_VALUES];
+
+    signun_batch_execute_callback execute;
+    signun_batch_complete_callback complete;
+    signun_batch_finalize_callback finalize;
+
+    // Only set for batches that run in phases.
+    signun_batch_advance_callback advance;
+    const char *resource_identifier;
+
+    // Only set for batches whose results are delivered as chunks complete.
+    napi_ref listener;
+    const unsigned char *results;
+    size_t result_length;
+
+    // Where later phases are queued, set by signun_batch_queue.
+    signun_op_class_t op_class;
+    signun_priority_t priority;
+    signun_cancel_token_t *cancel_token;
+} signun_batch_t;
+
+/*
+ * Creates the result promise and splits item_count items into chunks of at
+ * most chunk_size items. On failure, nothing is left to clean up except the
+ * operation's own data.
+ */
+napi_status signun_batch_init(napi_env env, signun_batch_t *batch, size_t item_count, size_t chunk_size,
+    signun_batch_execute_callback execute, signun_batch_complete_callback complete, signun_batch_finalize_callback finalize,
+    napi_value *promise);
+
+/*
+ * Makes the batch run in phases, the first of which consists of the items
+ * passed to signun_batch_init. Later phases are queued with the specified
+ * resource name, which must outlive the batch.
+ */
+void signun_batch_set_advance(signun_batch_t *batch, signun_batch_advance_callback advance, const char *resource_identifier);
+
+/*
+ * Calls listener with the start and end index of every chunk that succeeds,
+ * along with a copy of its results, each of which is result_length bytes of
+ * results. Chunks are delivered in the order they complete, from their
+ * completion on the main thread, before the promise settles. Does nothing if
+ * listener is null or undefined. Not supported for batches that run in
+ * phases.
+ */
+napi_status signun_batch_set_listener(napi_env env, signun_batch_t *batch, napi_value listener,
+    const unsigned char *results, size_t result_length);
+
+/*
+ * Keeps a JavaScript value, such as an input Buffer read by the workers,
+ * alive until the batch has settled.
+ */
+napi_status signun_batch_retain(napi_env env, signun_batch_t *batch, napi_value value);
+
+/*
+ * Gets a value retained by the batch, indexed in the order of retaining.
+ */
+napi_status signun_batch_get_retained_value(napi_env env, signun_batch_t *batch, size_t index, napi_value *value);
+
+/*
+ * Queues every chunk. From here on, the batch owns itself: it settles its
+ * promise and calls finalize, even if queueing fails halfway through.
+ */
+void signun_batch_queue(napi_env env, signun_batch_t *batch, signun_op_class_t op_class, signun_priority_t priority,
+    signun_cancel_token_t *cancel_token, napi_value resource_name);
+
+/*
+ * Undoes signun_batch_init and signun_batch_retain, for batches that could
+ * not be queued. Does not call finalize.
+ */
+void signun_batch_discard(napi_env env, signun_batch_t *batch);
+
+/*
+ * Fails the batch from a worker thread.
+ */
+void signun_batch_chunk_fail(signun_batch_t *batch, signun_batch_chunk_t *chunk, const char *message);
+
+#endif
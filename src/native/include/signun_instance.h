@@ -0,0 +1,31 @@
+#ifndef __SIGNUN_INSTANCE_H
+#define __SIGNUN_INSTANCE_H
+
+#include <node_api.h>
+
+#include "signun_pool.h"
+#include "signun_scheduler.h"
+
+
+/*
+ * State of the addon in one environment. The main thread and every
+ * worker_threads Worker load their own instance, so state that is touched
+ * without a lock lives here rather than in statics.
+ */
+typedef struct
+{
+    signun_scheduler_t *scheduler;
+    signun_pool_free_list_t pools[SIGNUN_POOL_COUNT];
+} signun_instance_t;
+
+/*
+ * Attaches a new instance to the environment, which frees it on teardown.
+ */
+napi_status signun_instance_create(napi_env env);
+
+/*
+ * The instance of the environment, or NULL if it has none.
+ */
+signun_instance_t *signun_get_instance(napi_env env);
+
+#endif
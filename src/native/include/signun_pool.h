@@ -0,0 +1,77 @@
+#ifndef __SIGNUN_POOL_H
+#define __SIGNUN_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <node_api.h>
+
+
+typedef enum
+{
+    SIGNUN_POOL_PRIVATE_KEY_VERIFY,
+    SIGNUN_POOL_PUBLIC_KEY_CREATE,
+    SIGNUN_POOL_SIGN,
+    SIGNUN_POOL_VERIFY,
+    SIGNUN_POOL_SIGN_MESSAGE,
+    SIGNUN_POOL_VERIFY_MESSAGE,
+    SIGNUN_POOL_ECDH,
+    SIGNUN_POOL_PUBLIC_KEY_CONVERT,
+    SIGNUN_POOL_DERIVE,
+    SIGNUN_POOL_HASH,
+    SIGNUN_POOL_KEYED_HASH,
+    SIGNUN_POOL_MAC,
+    SIGNUN_POOL_STREAM_CHUNK,
+    SIGNUN_POOL_ED25519_PUBLIC_KEY_CREATE,
+    SIGNUN_POOL_ED25519_SIGN,
+    SIGNUN_POOL_ED25519_VERIFY,
+    SIGNUN_POOL_MUSIG_VERIFY,
+
+    SIGNUN_POOL_COUNT
+} signun_pool_id_t;
+
+typedef struct signun_pool_node_s
+{
+    struct signun_pool_node_s *next;
+} signun_pool_node_t;
+
+/*
+ * The released items of one pool in one environment.
+ */
+typedef struct
+{
+    size_t free_count;
+    signun_pool_node_t *free_list;
+} signun_pool_free_list_t;
+
+/*
+ * Freelist of fixed-size items, growing on demand. At most high_water_mark
+ * released items are kept around, the rest is returned to the allocator.
+ *
+ * The pool itself is only a constant description. Every environment keeps
+ * its own freelists in its instance, as items are acquired and released on
+ * the thread of the environment, in the entry point and in the completion of
+ * async work respectively, and are therefore never locked.
+ */
+typedef struct
+{
+    signun_pool_id_t id;
+    size_t item_size;
+    size_t high_water_mark;
+    // Items of secret-bearing pools are zeroised on release.
+    bool is_secret;
+} signun_pool_t;
+
+#define SIGNUN_POOL_INIT(id, type, high_water_mark, is_secret)  \
+    { id, sizeof (type), high_water_mark, is_secret }
+
+void *signun_pool_acquire(napi_env env, const signun_pool_t *pool);
+
+void signun_pool_release(napi_env env, const signun_pool_t *pool, void *item);
+
+/*
+ * Frees every item of a freelist, when its environment is torn down.
+ */
+void signun_pool_free_list_clear(signun_pool_free_list_t *free_list);
+
+#endif
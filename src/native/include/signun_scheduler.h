@@ -0,0 +1,149 @@
+#ifndef __SIGNUN_SCHEDULER_H
+#define __SIGNUN_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <node_api.h>
+#include <uv.h>
+
+
+typedef enum
+{
+    SIGNUN_OP_PRIVATE_KEY_VERIFY,
+    SIGNUN_OP_PUBLIC_KEY_CREATE,
+    SIGNUN_OP_SIGN,
+    SIGNUN_OP_VERIFY,
+    SIGNUN_OP_HASH,
+    SIGNUN_OP_KEYED_HASH,
+    SIGNUN_OP_SIGNATURE_BATCH,
+    SIGNUN_OP_VERIFY_BATCH,
+    SIGNUN_OP_PUBLIC_KEY_BATCH,
+    SIGNUN_OP_DERIVE,
+    SIGNUN_OP_DERIVE_BATCH,
+    SIGNUN_OP_ECDH,
+    SIGNUN_OP_ECDH_BATCH,
+    SIGNUN_OP_SIGN_BATCH,
+    SIGNUN_OP_KEY_PAIR,
+    SIGNUN_OP_MAC_BATCH,
+    SIGNUN_OP_MERKLE,
+    SIGNUN_OP_PASSWORD_HASH,
+    SIGNUN_OP_WORK,
+
+    SIGNUN_OP_CLASS_COUNT
+} signun_op_class_t;
+
+typedef enum
+{
+    // Work over the limit is held in a native FIFO until a slot frees up.
+    SIGNUN_POLICY_QUEUE,
+    // Work over the limit is rejected right away.
+    SIGNUN_POLICY_REJECT
+} signun_admission_policy_t;
+
+typedef enum
+{
+    // Latency-critical work, such as signing on behalf of a user.
+    SIGNUN_PRIORITY_INTERACTIVE,
+    // Throughput-oriented work, such as verifying a backlog of blocks.
+    SIGNUN_PRIORITY_BULK,
+
+    SIGNUN_PRIORITY_COUNT
+} signun_priority_t;
+
+typedef enum
+{
+    // Bulk work is only dispatched when no interactive work is waiting.
+    SIGNUN_LANE_SCHEDULING_STRICT,
+    // Bulk work gets a slot after every `weight` interactive dispatches.
+    SIGNUN_LANE_SCHEDULING_WEIGHTED
+} signun_lane_scheduling_t;
+
+/*
+ * Queues, limits and lanes of one environment, owned by its instance.
+ */
+typedef struct signun_scheduler_s signun_scheduler_t;
+
+/*
+ * Shared between the main thread and the workers. The flag is written once,
+ * on the main thread, and workers poll it, so it is only accessed under the
+ * mutex. The reference count never leaves the main thread.
+ */
+typedef struct
+{
+    uv_mutex_t mutex;
+    bool cancelled;
+    unsigned int ref_count;
+} signun_cancel_token_t;
+
+/*
+ * Every async operation embeds a task as the first member of its callback
+ * data, so the scheduler can hold it in its queues without allocating.
+ */
+typedef struct signun_task_s
+{
+    signun_scheduler_t *scheduler;
+    signun_op_class_t op_class;
+    signun_priority_t priority;
+    signun_cancel_token_t *cancel_token;
+    napi_async_work async_work;
+
+    napi_async_execute_callback execute;
+    napi_async_complete_callback complete;
+
+    struct signun_task_s *next;
+} signun_task_t;
+
+/*
+ * Drop-in replacement for napi_create_async_work. The execute and complete
+ * callbacks receive the task itself as their data pointer.
+ */
+napi_status signun_task_create(napi_env env, signun_task_t *task, signun_op_class_t op_class, signun_priority_t priority,
+    signun_cancel_token_t *cancel_token, napi_value resource_name, napi_async_execute_callback execute, napi_async_complete_callback complete);
+
+/*
+ * Drop-in replacement for napi_queue_async_work. Returns napi_queue_full if
+ * the task was turned away by the admission policy of its op class.
+ *
+ * Tasks aborted through their cancel token complete with napi_cancelled.
+ */
+napi_status signun_task_queue(napi_env env, signun_task_t *task);
+
+/*
+ * Applies the admission policy of an op class to work that is made of many
+ * tasks, such as a batch. Returns napi_queue_full if the work has to be
+ * turned away, napi_ok if it may go on to queue every one of its tasks
+ * through signun_task_queue_admitted.
+ */
+napi_status signun_op_class_admit(napi_env env, signun_op_class_t op_class);
+
+/*
+ * Like signun_task_queue, for a task of work already admitted through
+ * signun_op_class_admit. Tasks over the limit of the op class are held in
+ * the native queue rather than turned away, whatever the policy.
+ */
+napi_status signun_task_queue_admitted(napi_env env, signun_task_t *task);
+
+/*
+ * Reads an optional priority argument, falling back to the specified default
+ * if the value is undefined or null.
+ */
+napi_status signun_get_priority(napi_env env, napi_value value, signun_priority_t default_priority, signun_priority_t *priority);
+
+/*
+ * Reads an optional cancel token argument, as created by
+ * scheduler.createCancelToken(). Yields NULL if the value is undefined.
+ */
+napi_status signun_get_cancel_token(napi_env env, napi_value value, signun_cancel_token_t **cancel_token);
+
+/*
+ * Whether the task has been aborted. Safe to call from workers, which should
+ * poll it between chunks of long-running work.
+ */
+bool signun_task_is_cancelled(const signun_task_t *task);
+
+void signun_scheduler_destroy(signun_scheduler_t *scheduler);
+
+napi_status create_scheduler_addon(napi_env env, napi_value base);
+
+#endif
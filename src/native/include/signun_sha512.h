@@ -0,0 +1,33 @@
+#ifndef __SIGNUN_SHA512_H
+#define __SIGNUN_SHA512_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define SIGNUN_SHA512_DIGEST_LENGTH 64
+#define SIGNUN_SHA512_BLOCK_LENGTH 128
+
+typedef struct
+{
+    uint64_t state[8];
+    uint64_t length;
+    unsigned char buffer[SIGNUN_SHA512_BLOCK_LENGTH];
+    size_t buffer_length;
+} signun_sha512_t;
+
+void signun_sha512_init(signun_sha512_t *sha512);
+
+void signun_sha512_update(signun_sha512_t *sha512, const unsigned char *data, size_t length);
+
+/*
+ * Writes the digest and wipes the state.
+ */
+void signun_sha512_final(signun_sha512_t *sha512, unsigned char *digest);
+
+/*
+ * HMAC-SHA512 as specified in RFC 2104, as used by BIP32.
+ */
+void signun_hmac_sha512(const unsigned char *key, size_t key_length, const unsigned char *data, size_t data_length, unsigned char *mac);
+
+#endif
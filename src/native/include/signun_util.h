@@ -1,6 +1,9 @@
 #ifndef __SIGNUN_UTIL_H
 #define __SIGNUN_UTIL_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <node_api.h>
 
 
@@ -57,8 +60,66 @@
         napi_reject_deferred(env, deferred, __unique_error);    \
     }                                                           \
     while (0)                                                   \
-        
+
+#define REJECT_WITH_ABORT_ERROR(env, deferred)                  \
+    do                                                          \
+    {                                                           \
+        napi_value __unique_error;                              \
+        signun_create_abort_error(env, &__unique_error);        \
+        napi_reject_deferred(env, deferred, __unique_error);    \
+    }                                                           \
+    while (0)                                                   \
+
 
 napi_status signun_create_error(napi_env env, const char *message, napi_value *error);
 
+/*
+ * Creates an error shaped like the one Node.js uses for aborted operations,
+ * with name 'AbortError' and code 'ABORT_ERR'.
+ */
+napi_status signun_create_abort_error(napi_env env, napi_value *error);
+
+/*
+ * Zeroes memory in a way the compiler cannot optimize away, for wiping
+ * secrets.
+ */
+void signun_secure_zero(void *ptr, size_t length);
+
+/*
+ * Drop-in replacement for napi_get_buffer_info, which also accepts any
+ * TypedArray, a DataView or an ArrayBuffer. Never copies. The length is in
+ * bytes and is optional.
+ */
+napi_status signun_get_bytes(napi_env env, napi_value value, void **data, size_t *length);
+
+/*
+ * Like signun_get_bytes, but also accepts a string, which is encoded as UTF-8
+ * into the scratch space. Strings that do not fit are encoded into a new
+ * allocation, returned in allocation for the caller to free, which is
+ * otherwise set to NULL.
+ */
+napi_status signun_get_bytes_or_string(napi_env env, napi_value value, unsigned char *scratch, size_t scratch_length,
+    unsigned char **data, size_t *length, unsigned char **allocation);
+
+/*
+ * Keeps the bytes returned by signun_get_bytes_or_string alive while a worker
+ * reads them, by taking a reference on the object that owns them. Strings are
+ * already copied and are not pinned, in which case the reference is set to
+ * NULL. Pair with signun_unpin_bytes on the main thread.
+ */
+napi_status signun_pin_bytes(napi_env env, napi_value value, napi_ref *ref);
+
+/*
+ * Releases a reference taken by signun_pin_bytes, if any, and resets it.
+ */
+void signun_unpin_bytes(napi_env env, napi_ref *ref);
+
+/*
+ * Reads byte arrays packed back-to-back, delimited by a Uint32Array of
+ * count + 1 offsets, item i spanning [offsets[i], offsets[i + 1]). The
+ * offsets are checked, so that workers can trust them.
+ */
+napi_status signun_get_packed_bytes(napi_env env, napi_value js_data, napi_value js_offsets,
+    const unsigned char **data, const uint32_t **offsets, size_t *count);
+
 #endif
@@ -0,0 +1,578 @@
+#include "argon2_addon/argon2.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+#include "blake2.h"
+
+#include "signun_util.h"
+
+
+#define ARGON2_VERSION 0x13
+#define ARGON2_TYPE_ID 2
+
+// A cache line, which also satisfies every SIMD load of the block function.
+#define ARGON2_MEMORY_ALIGNMENT 64
+
+static void store32(unsigned char *dst, uint32_t w)
+{
+    dst[0] = (unsigned char) w;
+    dst[1] = (unsigned char) (w >> 8);
+    dst[2] = (unsigned char) (w >> 16);
+    dst[3] = (unsigned char) (w >> 24);
+}
+
+static uint64_t load64(const unsigned char *src)
+{
+    uint64_t w = 0;
+    for (int i = 7; i >= 0; --i)
+    {
+        w = (w << 8) | src[i];
+    }
+
+    return w;
+}
+
+static void store64(unsigned char *dst, uint64_t w)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        dst[i] = (unsigned char) (w >> (8 * i));
+    }
+}
+
+static void *aligned_alloc_memory(size_t size)
+{
+#if defined(_WIN32)
+    return _aligned_malloc(size, ARGON2_MEMORY_ALIGNMENT);
+#else
+    void *memory;
+    return 0 == posix_memalign(&memory, ARGON2_MEMORY_ALIGNMENT, size) ? memory : NULL;
+#endif
+}
+
+static void aligned_free_memory(void *memory)
+{
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
+
+static void hash_update_length(blake2b_state *state, uint32_t length)
+{
+    unsigned char bytes[4];
+    store32(bytes, length);
+
+    blake2b_update(state, bytes, sizeof bytes);
+}
+
+static void hash_update_input(blake2b_state *state, const unsigned char *input, size_t input_length)
+{
+    hash_update_length(state, (uint32_t) input_length);
+
+    if (input_length)
+    {
+        blake2b_update(state, input, input_length);
+    }
+}
+
+/*
+ * H' of RFC 9106, BLAKE2b extended to outputs of any length by chaining
+ * 64 byte hashes and keeping the first half of all but the last one.
+ */
+static void hash_long(unsigned char *output, size_t output_length, const unsigned char *input, size_t input_length)
+{
+    blake2b_state state;
+
+    if (output_length <= BLAKE2B_OUTBYTES)
+    {
+        blake2b_init(&state, output_length);
+        hash_update_length(&state, (uint32_t) output_length);
+        blake2b_update(&state, input, input_length);
+        blake2b_final(&state, output, output_length);
+
+        return;
+    }
+
+    unsigned char chain[BLAKE2B_OUTBYTES];
+    blake2b_init(&state, BLAKE2B_OUTBYTES);
+    hash_update_length(&state, (uint32_t) output_length);
+    blake2b_update(&state, input, input_length);
+    blake2b_final(&state, chain, BLAKE2B_OUTBYTES);
+
+    memcpy(output, chain, BLAKE2B_OUTBYTES / 2);
+    output += BLAKE2B_OUTBYTES / 2;
+    output_length -= BLAKE2B_OUTBYTES / 2;
+
+    while (output_length > BLAKE2B_OUTBYTES)
+    {
+        blake2b(chain, BLAKE2B_OUTBYTES, chain, BLAKE2B_OUTBYTES, NULL, 0);
+
+        memcpy(output, chain, BLAKE2B_OUTBYTES / 2);
+        output += BLAKE2B_OUTBYTES / 2;
+        output_length -= BLAKE2B_OUTBYTES / 2;
+    }
+
+    blake2b(output, output_length, chain, BLAKE2B_OUTBYTES, NULL, 0);
+
+    signun_secure_zero(chain, sizeof chain);
+}
+
+static void block_from_bytes(argon2_block_t *block, const unsigned char *bytes)
+{
+    for (size_t i = 0; i < ARGON2_QWORDS_IN_BLOCK; ++i)
+    {
+        block->v[i] = load64(&bytes[8 * i]);
+    }
+}
+
+static void block_to_bytes(unsigned char *bytes, const argon2_block_t *block)
+{
+    for (size_t i = 0; i < ARGON2_QWORDS_IN_BLOCK; ++i)
+    {
+        store64(&bytes[8 * i], block->v[i]);
+    }
+}
+
+#if defined(__SSE2__)
+
+/*
+ * The permutation works on pairs of 64 bit words, so that each BLAKE2b round
+ * runs two columns or two diagonals at once.
+ */
+static inline __m128i blamka(__m128i x, __m128i y)
+{
+    const __m128i z = _mm_mul_epu32(x, y);
+
+    return _mm_add_epi64(_mm_add_epi64(x, y), _mm_add_epi64(z, z));
+}
+
+#define ROTR32(x) _mm_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+#define ROTR63(x) _mm_xor_si128(_mm_srli_epi64((x), 63), _mm_add_epi64((x), (x)))
+
+#if defined(__SSSE3__)
+#define ROTR24(x) _mm_shuffle_epi8((x), _mm_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10))
+#define ROTR16(x) _mm_shuffle_epi8((x), _mm_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9))
+#else
+#define ROTR24(x) _mm_xor_si128(_mm_srli_epi64((x), 24), _mm_slli_epi64((x), 40))
+#define ROTR16(x) _mm_xor_si128(_mm_srli_epi64((x), 16), _mm_slli_epi64((x), 48))
+#endif
+
+#define G1(A0, B0, C0, D0, A1, B1, C1, D1) \
+    do \
+    { \
+        A0 = blamka(A0, B0); \
+        A1 = blamka(A1, B1); \
+        D0 = ROTR32(_mm_xor_si128(D0, A0)); \
+        D1 = ROTR32(_mm_xor_si128(D1, A1)); \
+        C0 = blamka(C0, D0); \
+        C1 = blamka(C1, D1); \
+        B0 = ROTR24(_mm_xor_si128(B0, C0)); \
+        B1 = ROTR24(_mm_xor_si128(B1, C1)); \
+    } while (0)
+
+#define G2(A0, B0, C0, D0, A1, B1, C1, D1) \
+    do \
+    { \
+        A0 = blamka(A0, B0); \
+        A1 = blamka(A1, B1); \
+        D0 = ROTR16(_mm_xor_si128(D0, A0)); \
+        D1 = ROTR16(_mm_xor_si128(D1, A1)); \
+        C0 = blamka(C0, D0); \
+        C1 = blamka(C1, D1); \
+        B0 = ROTR63(_mm_xor_si128(B0, C0)); \
+        B1 = ROTR63(_mm_xor_si128(B1, C1)); \
+    } while (0)
+
+#define DIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1) \
+    do \
+    { \
+        __m128i t0 = D0; \
+        __m128i t1 = B0; \
+        D0 = C0; \
+        C0 = C1; \
+        C1 = D0; \
+        D0 = _mm_unpackhi_epi64(D1, _mm_unpacklo_epi64(t0, t0)); \
+        D1 = _mm_unpackhi_epi64(t0, _mm_unpacklo_epi64(D1, D1)); \
+        B0 = _mm_unpackhi_epi64(B0, _mm_unpacklo_epi64(B1, B1)); \
+        B1 = _mm_unpackhi_epi64(B1, _mm_unpacklo_epi64(t1, t1)); \
+    } while (0)
+
+#define UNDIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1) \
+    do \
+    { \
+        __m128i t0 = C0; \
+        C0 = C1; \
+        C1 = t0; \
+        t0 = B0; \
+        __m128i t1 = D0; \
+        B0 = _mm_unpackhi_epi64(B1, _mm_unpacklo_epi64(B0, B0)); \
+        B1 = _mm_unpackhi_epi64(t0, _mm_unpacklo_epi64(B1, B1)); \
+        D0 = _mm_unpackhi_epi64(D0, _mm_unpacklo_epi64(D1, D1)); \
+        D1 = _mm_unpackhi_epi64(D1, _mm_unpacklo_epi64(t1, t1)); \
+    } while (0)
+
+#define BLAKE2_ROUND(A0, A1, B0, B1, C0, C1, D0, D1) \
+    do \
+    { \
+        G1(A0, B0, C0, D0, A1, B1, C1, D1); \
+        G2(A0, B0, C0, D0, A1, B1, C1, D1); \
+        DIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1); \
+        G1(A0, B0, C0, D0, A1, B1, C1, D1); \
+        G2(A0, B0, C0, D0, A1, B1, C1, D1); \
+        UNDIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1); \
+    } while (0)
+
+/*
+ * The compression function G of RFC 9106. From the second pass on, the new
+ * block is XORed into the one it overwrites.
+ */
+static void fill_block(const argon2_block_t *prev_block, const argon2_block_t *ref_block, argon2_block_t *next_block, bool with_xor)
+{
+    __m128i state[ARGON2_QWORDS_IN_BLOCK / 2];
+    __m128i block_xy[ARGON2_QWORDS_IN_BLOCK / 2];
+
+    const __m128i *prev = (const __m128i *) prev_block->v;
+    const __m128i *ref = (const __m128i *) ref_block->v;
+    __m128i *next = (__m128i *) next_block->v;
+
+    for (size_t i = 0; i < ARGON2_QWORDS_IN_BLOCK / 2; ++i)
+    {
+        state[i] = _mm_xor_si128(_mm_loadu_si128(&prev[i]), _mm_loadu_si128(&ref[i]));
+        block_xy[i] = with_xor ? _mm_xor_si128(state[i], _mm_loadu_si128(&next[i])) : state[i];
+    }
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        BLAKE2_ROUND(state[8 * i + 0], state[8 * i + 1], state[8 * i + 2], state[8 * i + 3],
+            state[8 * i + 4], state[8 * i + 5], state[8 * i + 6], state[8 * i + 7]);
+    }
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        BLAKE2_ROUND(state[8 * 0 + i], state[8 * 1 + i], state[8 * 2 + i], state[8 * 3 + i],
+            state[8 * 4 + i], state[8 * 5 + i], state[8 * 6 + i], state[8 * 7 + i]);
+    }
+
+    for (size_t i = 0; i < ARGON2_QWORDS_IN_BLOCK / 2; ++i)
+    {
+        _mm_storeu_si128(&next[i], _mm_xor_si128(state[i], block_xy[i]));
+    }
+}
+
+#else
+
+static inline uint64_t rotr64(uint64_t w, unsigned int c)
+{
+    return (w >> c) | (w << (64 - c));
+}
+
+static inline uint64_t blamka(uint64_t x, uint64_t y)
+{
+    const uint64_t m = UINT64_C(0xFFFFFFFF);
+
+    return x + y + 2 * ((x & m) * (y & m));
+}
+
+#define G(a, b, c, d) \
+    do \
+    { \
+        a = blamka(a, b); \
+        d = rotr64(d ^ a, 32); \
+        c = blamka(c, d); \
+        b = rotr64(b ^ c, 24); \
+        a = blamka(a, b); \
+        d = rotr64(d ^ a, 16); \
+        c = blamka(c, d); \
+        b = rotr64(b ^ c, 63); \
+    } while (0)
+
+#define BLAKE2_ROUND(v0, v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14, v15) \
+    do \
+    { \
+        G(v0, v4, v8, v12); \
+        G(v1, v5, v9, v13); \
+        G(v2, v6, v10, v14); \
+        G(v3, v7, v11, v15); \
+        G(v0, v5, v10, v15); \
+        G(v1, v6, v11, v12); \
+        G(v2, v7, v8, v13); \
+        G(v3, v4, v9, v14); \
+    } while (0)
+
+/*
+ * The compression function G of RFC 9106. From the second pass on, the new
+ * block is XORed into the one it overwrites.
+ */
+static void fill_block(const argon2_block_t *prev_block, const argon2_block_t *ref_block, argon2_block_t *next_block, bool with_xor)
+{
+    argon2_block_t r;
+    argon2_block_t tmp;
+
+    for (size_t i = 0; i < ARGON2_QWORDS_IN_BLOCK; ++i)
+    {
+        r.v[i] = prev_block->v[i] ^ ref_block->v[i];
+        tmp.v[i] = with_xor ? r.v[i] ^ next_block->v[i] : r.v[i];
+    }
+
+    uint64_t *v = r.v;
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        BLAKE2_ROUND(v[16 * i], v[16 * i + 1], v[16 * i + 2], v[16 * i + 3],
+            v[16 * i + 4], v[16 * i + 5], v[16 * i + 6], v[16 * i + 7],
+            v[16 * i + 8], v[16 * i + 9], v[16 * i + 10], v[16 * i + 11],
+            v[16 * i + 12], v[16 * i + 13], v[16 * i + 14], v[16 * i + 15]);
+    }
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        BLAKE2_ROUND(v[2 * i], v[2 * i + 1], v[2 * i + 16], v[2 * i + 17],
+            v[2 * i + 32], v[2 * i + 33], v[2 * i + 48], v[2 * i + 49],
+            v[2 * i + 64], v[2 * i + 65], v[2 * i + 80], v[2 * i + 81],
+            v[2 * i + 96], v[2 * i + 97], v[2 * i + 112], v[2 * i + 113]);
+    }
+
+    for (size_t i = 0; i < ARGON2_QWORDS_IN_BLOCK; ++i)
+    {
+        next_block->v[i] = tmp.v[i] ^ v[i];
+    }
+}
+
+#endif
+
+/*
+ * The pseudo-random block of the data-independent addressing of the first
+ * half pass, derived from the position and the counter in the input block.
+ */
+static void next_addresses(argon2_block_t *address_block, argon2_block_t *input_block, const argon2_block_t *zero_block)
+{
+    input_block->v[6]++;
+
+    fill_block(zero_block, input_block, address_block, false);
+    fill_block(zero_block, address_block, address_block, false);
+}
+
+/*
+ * Maps the pseudo-random value of a block to the index of its reference
+ * block within the reference lane, skewed towards recent blocks.
+ */
+static uint32_t reference_index(const argon2_addon_instance_t *instance, uint32_t pass, uint32_t slice, uint32_t index,
+    uint32_t pseudo_random, bool is_same_lane)
+{
+    uint32_t reference_area_size;
+
+    if (0 == pass)
+    {
+        if (0 == slice)
+        {
+            reference_area_size = index - 1;
+        }
+        else if (is_same_lane)
+        {
+            reference_area_size = slice * instance->segment_length + index - 1;
+        }
+        else
+        {
+            reference_area_size = slice * instance->segment_length - (0 == index ? 1 : 0);
+        }
+    }
+    else
+    {
+        if (is_same_lane)
+        {
+            reference_area_size = instance->lane_length - instance->segment_length + index - 1;
+        }
+        else
+        {
+            reference_area_size = instance->lane_length - instance->segment_length - (0 == index ? 1 : 0);
+        }
+    }
+
+    uint64_t relative_position = pseudo_random;
+    relative_position = (relative_position * relative_position) >> 32;
+    relative_position = reference_area_size - 1 - ((reference_area_size * relative_position) >> 32);
+
+    const uint32_t start_position = 0 != pass && ARGON2_SYNC_POINTS - 1 != slice ? (slice + 1) * instance->segment_length : 0;
+
+    return (uint32_t) ((start_position + relative_position) % instance->lane_length);
+}
+
+/*
+ * The first two blocks of a lane are derived from the prehash directly.
+ */
+static void fill_first_blocks(argon2_addon_instance_t *instance, uint32_t lane)
+{
+    unsigned char input[ARGON2_PREHASH_LENGTH + 8];
+    unsigned char block_bytes[ARGON2_BLOCK_SIZE];
+
+    memcpy(input, instance->prehash, ARGON2_PREHASH_LENGTH);
+    store32(&input[ARGON2_PREHASH_LENGTH + 4], lane);
+
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        store32(&input[ARGON2_PREHASH_LENGTH], i);
+
+        hash_long(block_bytes, ARGON2_BLOCK_SIZE, input, sizeof input);
+        block_from_bytes(&instance->memory[lane * instance->lane_length + i], block_bytes);
+    }
+
+    signun_secure_zero(input, sizeof input);
+    signun_secure_zero(block_bytes, sizeof block_bytes);
+}
+
+bool argon2_addon_instance_init(argon2_addon_instance_t *instance, uint32_t pass_count, uint32_t memory_cost, uint32_t lane_count,
+    uint32_t hash_length, const unsigned char *password, size_t password_length, const unsigned char *salt, size_t salt_length,
+    const unsigned char *secret, size_t secret_length, const unsigned char *associated_data, size_t associated_data_length)
+{
+    const uint32_t segment_length = memory_cost / (lane_count * ARGON2_SYNC_POINTS);
+
+    instance->lane_count = lane_count;
+    instance->segment_length = segment_length;
+    instance->lane_length = segment_length * ARGON2_SYNC_POINTS;
+    instance->block_count = instance->lane_length * lane_count;
+    instance->pass_count = pass_count;
+
+    blake2b_state state;
+    blake2b_init(&state, ARGON2_PREHASH_LENGTH);
+    hash_update_length(&state, lane_count);
+    hash_update_length(&state, hash_length);
+    hash_update_length(&state, memory_cost);
+    hash_update_length(&state, pass_count);
+    hash_update_length(&state, ARGON2_VERSION);
+    hash_update_length(&state, ARGON2_TYPE_ID);
+    hash_update_input(&state, password, password_length);
+    hash_update_input(&state, salt, salt_length);
+    hash_update_input(&state, secret, secret_length);
+    hash_update_input(&state, associated_data, associated_data_length);
+    blake2b_final(&state, instance->prehash, ARGON2_PREHASH_LENGTH);
+
+    signun_secure_zero(&state, sizeof state);
+
+    instance->memory = (argon2_block_t *) aligned_alloc_memory((size_t) instance->block_count * sizeof (argon2_block_t));
+
+    return NULL != instance->memory;
+}
+
+void argon2_addon_fill_segment(argon2_addon_instance_t *instance, uint32_t pass, uint32_t slice, uint32_t lane)
+{
+    // Argon2id addresses data-independently in the first half of the first pass only.
+    const bool is_data_independent = 0 == pass && slice < ARGON2_SYNC_POINTS / 2;
+
+    argon2_block_t address_block;
+    argon2_block_t input_block;
+    argon2_block_t zero_block;
+
+    if (is_data_independent)
+    {
+        memset(&zero_block, 0, sizeof zero_block);
+        memset(&input_block, 0, sizeof input_block);
+
+        input_block.v[0] = pass;
+        input_block.v[1] = lane;
+        input_block.v[2] = slice;
+        input_block.v[3] = instance->block_count;
+        input_block.v[4] = instance->pass_count;
+        input_block.v[5] = ARGON2_TYPE_ID;
+    }
+
+    uint32_t starting_index = 0;
+    if (0 == pass && 0 == slice)
+    {
+        fill_first_blocks(instance, lane);
+
+        starting_index = 2;
+        if (is_data_independent)
+        {
+            next_addresses(&address_block, &input_block, &zero_block);
+        }
+    }
+
+    uint32_t current_offset = lane * instance->lane_length + slice * instance->segment_length + starting_index;
+    uint32_t previous_offset = 0 == current_offset % instance->lane_length
+        ? current_offset + instance->lane_length - 1
+        : current_offset - 1;
+
+    for (uint32_t i = starting_index; i < instance->segment_length; ++i, ++current_offset, ++previous_offset)
+    {
+        if (1 == current_offset % instance->lane_length)
+        {
+            previous_offset = current_offset - 1;
+        }
+
+        uint64_t pseudo_random;
+        if (is_data_independent)
+        {
+            if (0 == i % ARGON2_QWORDS_IN_BLOCK)
+            {
+                next_addresses(&address_block, &input_block, &zero_block);
+            }
+
+            pseudo_random = address_block.v[i % ARGON2_QWORDS_IN_BLOCK];
+        }
+        else
+        {
+            pseudo_random = instance->memory[previous_offset].v[0];
+        }
+
+        const uint32_t reference_lane = 0 == pass && 0 == slice
+            ? lane
+            : (uint32_t) ((pseudo_random >> 32) % instance->lane_count);
+
+        const uint32_t index = reference_index(instance, pass, slice, i, (uint32_t) pseudo_random, reference_lane == lane);
+
+        fill_block(&instance->memory[previous_offset], &instance->memory[reference_lane * instance->lane_length + index],
+            &instance->memory[current_offset], 0 != pass);
+    }
+}
+
+void argon2_addon_instance_finalize(argon2_addon_instance_t *instance, unsigned char *hash, size_t hash_length)
+{
+    argon2_block_t final_block = instance->memory[instance->lane_length - 1];
+
+    for (uint32_t lane = 1; lane < instance->lane_count; ++lane)
+    {
+        const argon2_block_t *last_block = &instance->memory[lane * instance->lane_length + instance->lane_length - 1];
+
+        for (size_t i = 0; i < ARGON2_QWORDS_IN_BLOCK; ++i)
+        {
+            final_block.v[i] ^= last_block->v[i];
+        }
+    }
+
+    unsigned char final_bytes[ARGON2_BLOCK_SIZE];
+    block_to_bytes(final_bytes, &final_block);
+
+    hash_long(hash, hash_length, final_bytes, ARGON2_BLOCK_SIZE);
+
+    signun_secure_zero(&final_block, sizeof final_block);
+    signun_secure_zero(final_bytes, sizeof final_bytes);
+
+    argon2_addon_instance_release(instance);
+}
+
+void argon2_addon_instance_release(argon2_addon_instance_t *instance)
+{
+    signun_secure_zero(instance->prehash, ARGON2_PREHASH_LENGTH);
+
+    if (instance->memory)
+    {
+        signun_secure_zero(instance->memory, (size_t) instance->block_count * sizeof (argon2_block_t));
+        aligned_free_memory(instance->memory);
+        instance->memory = NULL;
+    }
+}
@@ -0,0 +1,22 @@
+#include "argon2_addon/argon2_addon.h"
+
+#include "signun_util.h"
+#include "argon2_addon/hash.h"
+
+
+napi_status create_argon2_addon(napi_env env, napi_value base)
+{
+    napi_value addon;
+
+    RETURN_ON_FAILURE(napi_create_object(env, &addon));
+
+    const size_t property_count = 1;
+    napi_property_descriptor properties[] = {
+        DECLARE_NAPI_METHOD("argon2id", argon2_addon_argon2id_hash, NULL)
+    };
+
+    RETURN_ON_FAILURE(napi_define_properties(env, addon, property_count, properties));
+    RETURN_ON_FAILURE(napi_set_named_property(env, base, "argon2", addon));
+
+    return napi_ok;
+}
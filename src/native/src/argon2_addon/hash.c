@@ -0,0 +1,259 @@
+#include "argon2_addon/hash.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "signun_batch.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+#include "argon2_addon/argon2.h"
+
+
+// Strings up to this length are encoded on the stack.
+#define PASSWORD_SCRATCH_LENGTH 256
+
+// Each lane fills its segment of a slice as a chunk of its own, so that the
+// lanes run on separate workers.
+#define ARGON2_LANES_PER_CHUNK 1
+
+typedef struct
+{
+    signun_batch_t batch;
+
+    argon2_addon_instance_t instance;
+
+    // The segment filled by the current phase, or the tag once every segment is.
+    uint32_t pass;
+    uint32_t slice;
+    bool is_finalizing;
+
+    unsigned char *hash;
+    size_t hash_length;
+} argon2_batch_data_t;
+
+/*
+ * Reads a Buffer which may also be null, in which case it is empty.
+ */
+static napi_status get_optional_bytes(napi_env env, napi_value value, const unsigned char **data, size_t *length)
+{
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, value, &type));
+
+    if (napi_null == type)
+    {
+        *data = NULL;
+        *length = 0;
+
+        return napi_ok;
+    }
+
+    return signun_get_bytes(env, value, (void **) data, length);
+}
+
+static void argon2_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    argon2_batch_data_t *batch_data = (argon2_batch_data_t *) batch;
+
+    if (batch_data->is_finalizing)
+    {
+        argon2_addon_instance_finalize(&batch_data->instance, batch_data->hash, batch_data->hash_length);
+        return;
+    }
+
+    for (size_t lane = chunk->start; lane < chunk->end; ++lane)
+    {
+        argon2_addon_fill_segment(&batch_data->instance, batch_data->pass, batch_data->slice, (uint32_t) lane);
+    }
+}
+
+/*
+ * Moves on to the next slice, once every lane has filled its segment of the
+ * current one. The tag is computed, and the memory wiped, on a worker too.
+ */
+static size_t argon2_batch_advance(signun_batch_t *batch)
+{
+    argon2_batch_data_t *batch_data = (argon2_batch_data_t *) batch;
+
+    if (batch_data->is_finalizing)
+    {
+        return 0;
+    }
+
+    if (ARGON2_SYNC_POINTS == ++batch_data->slice)
+    {
+        batch_data->slice = 0;
+        batch_data->pass++;
+    }
+
+    if (batch_data->instance.pass_count == batch_data->pass)
+    {
+        batch_data->is_finalizing = true;
+        return 1;
+    }
+
+    return batch_data->instance.lane_count;
+}
+
+static napi_status argon2_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    return signun_batch_get_retained_value(env, batch, 0, result);
+}
+
+static void argon2_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    argon2_batch_data_t *batch_data = (argon2_batch_data_t *) batch;
+
+    argon2_addon_instance_release(&batch_data->instance);
+    free(batch_data);
+}
+
+napi_value argon2_addon_argon2id_hash(napi_env env, napi_callback_info info)
+{
+    size_t argc = 10;
+    napi_value argv[10];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    size_t salt_length;
+    const unsigned char *salt;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &salt, &salt_length),
+        env, "Invalid buffer was passed as salt."
+    );
+
+    size_t secret_length;
+    const unsigned char *secret;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_optional_bytes(env, argv[2], &secret, &secret_length),
+        env, "Invalid buffer was passed as secret."
+    );
+
+    size_t associated_data_length;
+    const unsigned char *associated_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_optional_bytes(env, argv[3], &associated_data, &associated_data_length),
+        env, "Invalid buffer was passed as associated data."
+    );
+
+    uint32_t time_cost;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[4], &time_cost),
+        env, "Invalid time cost was passed."
+    );
+
+    uint32_t memory_cost;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[5], &memory_cost),
+        env, "Invalid memory cost was passed."
+    );
+
+    uint32_t parallelism;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[6], &parallelism),
+        env, "Invalid parallelism was passed."
+    );
+
+    uint32_t hash_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[7], &hash_length),
+        env, "Invalid hash length was passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[8], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[9], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (ARGON2_MIN_PASSES > time_cost || ARGON2_MIN_LANES > parallelism || ARGON2_MAX_LANES < parallelism
+        || (uint64_t) 2 * ARGON2_SYNC_POINTS * parallelism > memory_cost
+        || ARGON2_MIN_HASH_LENGTH > hash_length || ARGON2_MIN_SALT_LENGTH > salt_length)
+    {
+        napi_throw_error(env, NULL, "Invalid Argon2 parameters.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "argon2::batch::argon2id";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    argon2_batch_data_t *batch_data = (argon2_batch_data_t *)calloc(1, sizeof (argon2_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    unsigned char scratch[PASSWORD_SCRATCH_LENGTH];
+    size_t password_length;
+    unsigned char *password;
+    unsigned char *allocated_password;
+    if (napi_ok != signun_get_bytes_or_string(env, argv[0], scratch, PASSWORD_SCRATCH_LENGTH, &password, &password_length, &allocated_password))
+    {
+        argon2_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Invalid buffer was passed as password.");
+        return NULL;
+    }
+
+    // The password only enters the prehash, so it is not kept past this call.
+    const bool is_initialized = argon2_addon_instance_init(&batch_data->instance, time_cost, memory_cost, parallelism, hash_length,
+        password, password_length, salt, salt_length, secret, secret_length, associated_data, associated_data_length);
+
+    signun_secure_zero(scratch, sizeof scratch);
+    if (allocated_password)
+    {
+        signun_secure_zero(allocated_password, password_length);
+        free(allocated_password);
+    }
+
+    if (!is_initialized)
+    {
+        argon2_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not allocate the Argon2 memory.");
+        return NULL;
+    }
+
+    batch_data->hash_length = hash_length;
+
+    napi_value js_hash;
+    if (napi_ok != napi_create_buffer(env, hash_length, (void **) &batch_data->hash, &js_hash))
+    {
+        argon2_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffer.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, parallelism, ARGON2_LANES_PER_CHUNK,
+        argon2_batch_execute, argon2_batch_complete, argon2_batch_finalize, &promise))
+    {
+        argon2_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    signun_batch_set_advance(&batch_data->batch, argon2_batch_advance, resource_identifier);
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, js_hash))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        argon2_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_PASSWORD_HASH, priority, cancel_token, resource_name);
+
+    return promise;
+}
@@ -1,6 +1,11 @@
 #include "blake2_addon/blake2_addon.h"
 
 #include "signun_util.h"
+#include "blake2_addon/blake2b_mac.h"
+#include "blake2_addon/blake2b_merkle.h"
+#include "blake2_addon/blake2b_merkle_accumulator.h"
+#include "blake2_addon/blake2b_stream.h"
+#include "blake2_addon/blake2b_work.h"
 #include "blake2_addon/signun_blake2b.h"
 
 
@@ -10,10 +15,31 @@ napi_status create_blake2_addon(napi_env env, napi_value base)
 
     RETURN_ON_FAILURE(napi_create_object(env, &blake2b_addon));
 
-    const size_t property_count = 2;
+    const size_t property_count = 23;
     napi_property_descriptor properties[] = {
         DECLARE_NAPI_METHOD("hash", blake2_addon_blake2b_hash_async, NULL),
-        DECLARE_NAPI_METHOD("keyedHash", blake2_addon_blake2b_keyed_hash_async, NULL)
+        DECLARE_NAPI_METHOD("keyedHash", blake2_addon_blake2b_keyed_hash_async, NULL),
+        DECLARE_NAPI_METHOD("macCreate", blake2_addon_blake2b_mac_create, NULL),
+        DECLARE_NAPI_METHOD("macSync", blake2_addon_blake2b_mac_sync, NULL),
+        DECLARE_NAPI_METHOD("mac", blake2_addon_blake2b_mac_async, NULL),
+        DECLARE_NAPI_METHOD("macBatch", blake2_addon_blake2b_mac_batch, NULL),
+        DECLARE_NAPI_METHOD("merkleRoot", blake2_addon_blake2b_merkle_root, NULL),
+        DECLARE_NAPI_METHOD("merkleAccumulatorCreate", blake2_addon_merkle_accumulator_create, NULL),
+        DECLARE_NAPI_METHOD("merkleAccumulatorSize", blake2_addon_merkle_accumulator_size, NULL),
+        DECLARE_NAPI_METHOD("merkleAccumulatorAppend", blake2_addon_merkle_accumulator_append, NULL),
+        DECLARE_NAPI_METHOD("merkleAccumulatorAppendMany", blake2_addon_merkle_accumulator_append_many, NULL),
+        DECLARE_NAPI_METHOD("merkleAccumulatorRoot", blake2_addon_merkle_accumulator_root, NULL),
+        DECLARE_NAPI_METHOD("merkleAccumulatorProof", blake2_addon_merkle_accumulator_proof, NULL),
+        DECLARE_NAPI_METHOD("merkleAccumulatorUpdate", blake2_addon_merkle_accumulator_update, NULL),
+        DECLARE_NAPI_METHOD("merkleAccumulatorSync", blake2_addon_merkle_accumulator_sync, NULL),
+        DECLARE_NAPI_METHOD("merkleAccumulatorClose", blake2_addon_merkle_accumulator_close, NULL),
+        DECLARE_NAPI_METHOD("streamCreate", blake2_addon_blake2b_stream_create, NULL),
+        DECLARE_NAPI_METHOD("streamUpdate", blake2_addon_blake2b_stream_update, NULL),
+        DECLARE_NAPI_METHOD("streamDepth", blake2_addon_blake2b_stream_depth, NULL),
+        DECLARE_NAPI_METHOD("streamDigest", blake2_addon_blake2b_stream_digest, NULL),
+        DECLARE_NAPI_METHOD("workValidateSync", blake2_addon_blake2b_work_validate_sync, NULL),
+        DECLARE_NAPI_METHOD("workValidateBatch", blake2_addon_blake2b_work_validate_batch, NULL),
+        DECLARE_NAPI_METHOD("workGenerate", blake2_addon_blake2b_work_generate, NULL)
     };
 
     RETURN_ON_FAILURE(napi_define_properties(env, blake2b_addon, property_count, properties));
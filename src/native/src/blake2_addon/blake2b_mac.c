@@ -0,0 +1,591 @@
+#include "blake2_addon/blake2b_mac.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "blake2.h"
+
+#include "signun_batch.h"
+#include "signun_pool.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+
+
+#define BLAKE2B_MAX_HASH_LENGTH 64
+#define BLAKE2B_MAX_KEY_LENGTH 64
+
+// Strings up to this length are encoded on the stack or into the callback data.
+#define MAC_SCRATCH_LENGTH 512
+
+#define MAC_POOL_HIGH_WATER_MARK 256
+
+// Messages are expected to be short, so chunks are long.
+#define MAC_BATCH_CHUNK_SIZE 4096
+
+/*
+ * The state after absorbing the key block and the prefix. Each message is
+ * hashed on a copy, so the midstate itself is never modified after creation
+ * and can be shared by any number of workers.
+ *
+ * blake2b_update keeps a full block buffered until more input arrives, since
+ * the last block is compressed differently. The key block, and a prefix
+ * ending on a block boundary, are therefore compressed ahead of time into
+ * compressed_state for non-empty messages, and state keeps them buffered for
+ * the empty message.
+ */
+typedef struct
+{
+    blake2b_state state;
+    blake2b_state compressed_state;
+    size_t hash_length;
+} blake2b_midstate_t;
+
+typedef struct
+{
+    signun_task_t task;
+
+    napi_deferred deferred;
+
+    blake2b_midstate_t midstate;
+
+    size_t data_length;
+    unsigned char *data;
+    unsigned char *allocated_data;
+    napi_ref data_ref;
+    unsigned char scratch[MAC_SCRATCH_LENGTH];
+
+    unsigned char hash[BLAKE2B_MAX_HASH_LENGTH];
+    int result;
+} mac_callback_data_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+
+    blake2b_midstate_t midstate;
+
+    const unsigned char *data;
+    // count + 1 offsets into data, message i spans [offsets[i], offsets[i + 1]).
+    const uint32_t *offsets;
+
+    unsigned char *hashes;
+} mac_batch_data_t;
+
+static const signun_pool_t mac_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_MAC, mac_callback_data_t, MAC_POOL_HIGH_WATER_MARK, true);
+
+static void release_mac_callback_data(napi_env env, mac_callback_data_t *callback_data)
+{
+    signun_unpin_bytes(env, &callback_data->data_ref);
+
+    if (callback_data->allocated_data)
+    {
+        signun_secure_zero(callback_data->allocated_data, callback_data->data_length);
+        free(callback_data->allocated_data);
+        callback_data->allocated_data = NULL;
+    }
+
+    signun_pool_release(env, &mac_callback_data_pool, callback_data);
+}
+
+static int midstate_hash(const blake2b_midstate_t *midstate, const unsigned char *data, size_t data_length, unsigned char *hash)
+{
+    blake2b_state state;
+    memcpy(&state, 0 < data_length ? &midstate->compressed_state : &midstate->state, sizeof (blake2b_state));
+
+    int result = blake2b_update(&state, data, data_length);
+    if (0 == result)
+    {
+        result = blake2b_final(&state, hash, midstate->hash_length);
+    }
+
+    signun_secure_zero(&state, sizeof (blake2b_state));
+
+    return result;
+}
+
+/*
+ * Copies state into compressed_state, compressing its buffered block if it is
+ * full. blake2b_update does so as soon as a single byte follows, and that
+ * byte is dropped again, leaving an empty buffer and the counter past the
+ * block.
+ */
+static int compress_buffered_block(const blake2b_state *state, blake2b_state *compressed_state)
+{
+    memcpy(compressed_state, state, sizeof (blake2b_state));
+
+    if (BLAKE2B_BLOCKBYTES != state->buflen)
+    {
+        return 0;
+    }
+
+    const unsigned char next = 0;
+    int result = blake2b_update(compressed_state, &next, 1);
+    compressed_state->buflen = 0;
+
+    return result;
+}
+
+static void midstate_finalize(napi_env env, void *data, void *hint)
+{
+    signun_secure_zero(data, sizeof (blake2b_midstate_t));
+    free(data);
+}
+
+static napi_status get_midstate(napi_env env, napi_value value, blake2b_midstate_t **midstate)
+{
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, value, &type));
+
+    if (napi_external != type)
+    {
+        return napi_invalid_arg;
+    }
+
+    return napi_get_value_external(env, value, (void **) midstate);
+}
+
+napi_value blake2_addon_blake2b_mac_create(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value argv[3];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    napi_value null_value;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_null(env, &null_value),
+        env, "Could not get null object"
+    );
+
+    bool is_key_null;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_strict_equals(env, argv[0], null_value, &is_key_null),
+        env, "Could not check if key is null"
+    );
+
+    size_t key_length = 0;
+    const unsigned char *key = NULL;
+    if (!is_key_null)
+    {
+        THROW_AND_RETURN_NULL_ON_FAILURE(
+            signun_get_bytes(env, argv[0], (void **) &key, &key_length),
+            env, "Invalid buffer was passed as key."
+        );
+    }
+
+    uint32_t hash_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[1], &hash_length),
+        env, "Invalid hash length was passed."
+    );
+
+    bool is_prefix_null;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_strict_equals(env, argv[2], null_value, &is_prefix_null),
+        env, "Could not check if prefix is null"
+    );
+
+    size_t prefix_length = 0;
+    const unsigned char *prefix = NULL;
+    if (!is_prefix_null)
+    {
+        THROW_AND_RETURN_NULL_ON_FAILURE(
+            signun_get_bytes(env, argv[2], (void **) &prefix, &prefix_length),
+            env, "Invalid buffer was passed as prefix."
+        );
+    }
+
+    if (0 == hash_length || BLAKE2B_MAX_HASH_LENGTH < hash_length || BLAKE2B_MAX_KEY_LENGTH < key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid key or hash length.");
+        return NULL;
+    }
+
+    blake2b_midstate_t *midstate = (blake2b_midstate_t *)calloc(1, sizeof (blake2b_midstate_t));
+    if (!midstate)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the midstate.");
+        return NULL;
+    }
+
+    midstate->hash_length = hash_length;
+
+    int result = 0 < key_length
+        ? blake2b_init_key(&midstate->state, hash_length, key, key_length)
+        : blake2b_init(&midstate->state, hash_length);
+
+    if (0 == result && 0 < prefix_length)
+    {
+        result = blake2b_update(&midstate->state, prefix, prefix_length);
+    }
+
+    if (0 == result)
+    {
+        result = compress_buffered_block(&midstate->state, &midstate->compressed_state);
+    }
+
+    if (0 != result)
+    {
+        midstate_finalize(env, midstate, NULL);
+        napi_throw_error(env, NULL, "Could not initialize the hash.");
+        return NULL;
+    }
+
+    napi_value js_midstate;
+    if (napi_ok != napi_create_external(env, midstate, midstate_finalize, NULL, &js_midstate))
+    {
+        midstate_finalize(env, midstate, NULL);
+        napi_throw_error(env, NULL, "Could not create the midstate.");
+        return NULL;
+    }
+
+    return js_midstate;
+}
+
+napi_value blake2_addon_blake2b_mac_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    blake2b_midstate_t *midstate;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_midstate(env, argv[0], &midstate),
+        env, "Invalid midstate was passed."
+    );
+
+    napi_value js_result;
+    unsigned char *hash;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer(env, midstate->hash_length, (void **) &hash, &js_result),
+        env, "Could not set the result buffer."
+    );
+
+    unsigned char scratch[MAC_SCRATCH_LENGTH];
+    unsigned char *allocated_data;
+    size_t data_length;
+    unsigned char *data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes_or_string(env, argv[1], scratch, MAC_SCRATCH_LENGTH, &data, &data_length, &allocated_data),
+        env, "Invalid buffer was passed as data."
+    );
+
+    const int result = midstate_hash(midstate, data, data_length, hash);
+
+    if (data == scratch)
+    {
+        signun_secure_zero(scratch, data_length);
+    }
+    else if (allocated_data)
+    {
+        signun_secure_zero(allocated_data, data_length);
+        free(allocated_data);
+    }
+
+    if (0 != result)
+    {
+        napi_throw_error(env, NULL, "Could not compute hash.");
+        return NULL;
+    }
+
+    return js_result;
+}
+
+static void mac_async_execute(napi_env env, void *data)
+{
+    mac_callback_data_t *callback_data = (mac_callback_data_t *) data;
+
+    callback_data->result = midstate_hash(&callback_data->midstate, callback_data->data, callback_data->data_length, callback_data->hash);
+}
+
+static void mac_async_complete(napi_env env, napi_status status, void *data)
+{
+    mac_callback_data_t *callback_data = (mac_callback_data_t *) data;
+
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
+    {
+        REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
+
+        release_mac_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        release_mac_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_ok != status)
+    {
+        REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
+
+        release_mac_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (0 != callback_data->result)
+    {
+        REJECT_WITH_ERROR(env, "Could not compute hash.", callback_data->deferred);
+
+        release_mac_callback_data(env, callback_data);
+
+        return;
+    }
+
+    napi_value js_result;
+    if (napi_ok != napi_create_buffer_copy(env, callback_data->midstate.hash_length, (void *)callback_data->hash, NULL, &js_result))
+    {
+        REJECT_WITH_ERROR(env, "Could not set the result buffer.", callback_data->deferred);
+
+        release_mac_callback_data(env, callback_data);
+
+        return;
+    }
+
+    napi_resolve_deferred(env, callback_data->deferred, js_result);
+
+    release_mac_callback_data(env, callback_data);
+}
+
+napi_value blake2_addon_blake2b_mac_async(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value argv[4];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    blake2b_midstate_t *midstate;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_midstate(env, argv[0], &midstate),
+        env, "Invalid midstate was passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[2], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[3], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    const char *resource_identifier = "blake2::async::mac";
+    napi_value mac_resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &mac_resource_name),
+        env, "Could not create resource name."
+    );
+
+    mac_callback_data_t *mac_callback_data = signun_pool_acquire(env, &mac_callback_data_pool);
+    if (!mac_callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+
+    // Copied, so that the midstate object can be collected while the work is in flight.
+    memcpy(&mac_callback_data->midstate, midstate, sizeof (blake2b_midstate_t));
+    mac_callback_data->data_ref = NULL;
+
+    if (napi_ok != signun_get_bytes_or_string(env, argv[1], mac_callback_data->scratch, MAC_SCRATCH_LENGTH,
+        &mac_callback_data->data, &mac_callback_data->data_length, &mac_callback_data->allocated_data)
+        || napi_ok != signun_pin_bytes(env, argv[1], &mac_callback_data->data_ref))
+    {
+        release_mac_callback_data(env, mac_callback_data);
+        napi_throw_error(env, NULL, "Invalid buffer was passed as data.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != napi_create_promise(env, &mac_callback_data->deferred, &promise))
+    {
+        release_mac_callback_data(env, mac_callback_data);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_task_create(env, &mac_callback_data->task, SIGNUN_OP_KEYED_HASH, priority, cancel_token, mac_resource_name, mac_async_execute, mac_async_complete))
+    {
+        REJECT_WITH_ERROR(env, "Could not create async work.", mac_callback_data->deferred);
+        release_mac_callback_data(env, mac_callback_data);
+        return promise;
+    }
+
+    napi_async_work mac_async_work = mac_callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &mac_callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", mac_callback_data->deferred);
+        release_mac_callback_data(env, mac_callback_data);
+        napi_delete_async_work(env, mac_async_work);
+        return promise;
+    }
+
+    if (napi_ok != queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Could not queue async work.", mac_callback_data->deferred);
+        release_mac_callback_data(env, mac_callback_data);
+        napi_delete_async_work(env, mac_async_work);
+        return promise;
+    }
+
+    return promise;
+}
+
+static void mac_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    mac_batch_data_t *batch_data = (mac_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        const uint32_t offset = batch_data->offsets[i];
+
+        if (0 != midstate_hash(&batch_data->midstate, &batch_data->data[offset], batch_data->offsets[i + 1] - offset,
+            &batch_data->hashes[i * batch_data->midstate.hash_length]))
+        {
+            signun_batch_chunk_fail(batch, chunk, "Could not compute hash.");
+            return;
+        }
+    }
+}
+
+static napi_status mac_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    return signun_batch_get_retained_value(env, batch, 2, result);
+}
+
+static void mac_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    mac_batch_data_t *batch_data = (mac_batch_data_t *) batch;
+
+    signun_secure_zero(&batch_data->midstate, sizeof (blake2b_midstate_t));
+    free(batch_data);
+}
+
+napi_value blake2_addon_blake2b_mac_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value argv[5];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    blake2b_midstate_t *midstate;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_midstate(env, argv[0], &midstate),
+        env, "Invalid midstate was passed."
+    );
+
+    size_t data_length;
+    const unsigned char *data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &data, &data_length),
+        env, "Invalid buffer was passed as data."
+    );
+
+    napi_typedarray_type offsets_type;
+    size_t offset_count;
+    void *offsets;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_typedarray_info(env, argv[2], &offsets_type, &offset_count, &offsets, NULL, NULL),
+        env, "Invalid array was passed as offsets."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (napi_uint32_array != offsets_type || 0 == offset_count)
+    {
+        napi_throw_error(env, NULL, "Invalid offsets.");
+        return NULL;
+    }
+
+    // Workers trust the offsets, so they are checked up front.
+    const uint32_t *message_offsets = (const uint32_t *) offsets;
+    for (size_t i = 1; i < offset_count; ++i)
+    {
+        if (message_offsets[i] < message_offsets[i - 1] || data_length < message_offsets[i])
+        {
+            napi_throw_error(env, NULL, "Invalid offsets.");
+            return NULL;
+        }
+    }
+
+    const size_t count = offset_count - 1;
+
+    const char *resource_identifier = "blake2::batch::mac";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    mac_batch_data_t *batch_data = (mac_batch_data_t *)calloc(1, sizeof (mac_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    memcpy(&batch_data->midstate, midstate, sizeof (blake2b_midstate_t));
+    batch_data->data = data;
+    batch_data->offsets = message_offsets;
+
+    napi_value js_hashes;
+    if (napi_ok != napi_create_buffer(env, count * midstate->hash_length, (void **) &batch_data->hashes, &js_hashes))
+    {
+        mac_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffer.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, MAC_BATCH_CHUNK_SIZE,
+        mac_batch_execute, mac_batch_complete, mac_batch_finalize, &promise))
+    {
+        mac_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[1])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[2])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_hashes))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        mac_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_MAC_BATCH, priority, cancel_token, resource_name);
+
+    return promise;
+}
@@ -0,0 +1,362 @@
+#include "blake2_addon/blake2b_merkle.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "blake2.h"
+
+#include "signun_batch.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+
+
+#define BLAKE2B_MAX_HASH_LENGTH 64
+
+// Enough for 2^32 leaves.
+#define MERKLE_MAX_LEVELS 34
+
+#define MERKLE_BATCH_CHUNK_SIZE 8192
+
+typedef struct
+{
+    signun_batch_t batch;
+
+    const unsigned char *leaves;
+    size_t leaf_length;
+    size_t leaf_hash_length;
+    size_t node_hash_length;
+    bool domain_separation;
+
+    const uint32_t *proof_indices;
+    size_t proof_count;
+
+    // Every level of the tree, from the leaf hashes up to the root.
+    unsigned char *nodes;
+    size_t level_count;
+    size_t level_sizes[MERKLE_MAX_LEVELS];
+    size_t level_offsets[MERKLE_MAX_LEVELS];
+    // The level being hashed by the current phase of the batch.
+    size_t level;
+} merkle_batch_data_t;
+
+static size_t level_hash_length(const merkle_batch_data_t *batch_data, size_t level)
+{
+    return 0 == level ? batch_data->leaf_hash_length : batch_data->node_hash_length;
+}
+
+static const unsigned char *level_node(const merkle_batch_data_t *batch_data, size_t level, size_t index)
+{
+    return &batch_data->nodes[batch_data->level_offsets[level] + index * level_hash_length(batch_data, level)];
+}
+
+int blake2_addon_merkle_hash(unsigned char *output, size_t output_length, bool domain_separation, unsigned char prefix,
+    const unsigned char *data, size_t data_length)
+{
+    blake2b_state state;
+
+    int result = blake2b_init(&state, output_length);
+    if (0 == result && domain_separation)
+    {
+        result = blake2b_update(&state, &prefix, 1);
+    }
+
+    if (0 == result)
+    {
+        result = blake2b_update(&state, data, data_length);
+    }
+
+    if (0 == result)
+    {
+        result = blake2b_final(&state, output, output_length);
+    }
+
+    return result;
+}
+
+/*
+ * A node without a sibling is hashed on its own, so that every level has
+ * nodes of the same length.
+ */
+static void merkle_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    merkle_batch_data_t *batch_data = (merkle_batch_data_t *) batch;
+    const size_t level = batch_data->level;
+    const size_t hash_length = level_hash_length(batch_data, level);
+    unsigned char *output = &batch_data->nodes[batch_data->level_offsets[level]];
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        int result;
+        if (0 == level)
+        {
+            result = blake2_addon_merkle_hash(&output[i * hash_length], hash_length, batch_data->domain_separation, BLAKE2B_MERKLE_LEAF_PREFIX,
+                &batch_data->leaves[i * batch_data->leaf_length], batch_data->leaf_length);
+        }
+        else
+        {
+            const size_t child_count = 2 * i + 1 < batch_data->level_sizes[level - 1] ? 2 : 1;
+
+            result = blake2_addon_merkle_hash(&output[i * hash_length], hash_length, batch_data->domain_separation, BLAKE2B_MERKLE_NODE_PREFIX,
+                level_node(batch_data, level - 1, 2 * i), child_count * level_hash_length(batch_data, level - 1));
+        }
+
+        if (0 != result)
+        {
+            signun_batch_chunk_fail(batch, chunk, "Could not compute hash.");
+            return;
+        }
+    }
+}
+
+static size_t merkle_batch_advance(signun_batch_t *batch)
+{
+    merkle_batch_data_t *batch_data = (merkle_batch_data_t *) batch;
+
+    if (batch_data->level + 1 >= batch_data->level_count)
+    {
+        return 0;
+    }
+
+    batch_data->level++;
+
+    return batch_data->level_sizes[batch_data->level];
+}
+
+/*
+ * A proof lists the siblings of the path from the leaf to the root, bottom
+ * up. Levels where the path has no sibling are skipped.
+ */
+static napi_status create_proof(napi_env env, const merkle_batch_data_t *batch_data, size_t leaf_index, napi_value *proof)
+{
+    size_t proof_length = 0;
+    for (size_t level = 0, index = leaf_index; level + 1 < batch_data->level_count; ++level, index /= 2)
+    {
+        if ((index ^ 1) < batch_data->level_sizes[level])
+        {
+            proof_length += level_hash_length(batch_data, level);
+        }
+    }
+
+    unsigned char *output;
+    RETURN_ON_FAILURE(napi_create_buffer(env, proof_length, (void **) &output, proof));
+
+    for (size_t level = 0, index = leaf_index; level + 1 < batch_data->level_count; ++level, index /= 2)
+    {
+        if ((index ^ 1) < batch_data->level_sizes[level])
+        {
+            const size_t hash_length = level_hash_length(batch_data, level);
+
+            memcpy(output, level_node(batch_data, level, index ^ 1), hash_length);
+            output += hash_length;
+        }
+    }
+
+    return napi_ok;
+}
+
+static napi_status merkle_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    merkle_batch_data_t *batch_data = (merkle_batch_data_t *) batch;
+    const size_t root_level = batch_data->level_count - 1;
+
+    napi_value js_root;
+    RETURN_ON_FAILURE(napi_create_buffer_copy(env, level_hash_length(batch_data, root_level), level_node(batch_data, root_level, 0), NULL, &js_root));
+
+    RETURN_ON_FAILURE(napi_create_object(env, result));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "root", js_root));
+
+    if (!batch_data->proof_indices)
+    {
+        return napi_ok;
+    }
+
+    napi_value js_proofs;
+    RETURN_ON_FAILURE(napi_create_array_with_length(env, batch_data->proof_count, &js_proofs));
+
+    for (size_t i = 0; i < batch_data->proof_count; ++i)
+    {
+        napi_value js_proof;
+        RETURN_ON_FAILURE(create_proof(env, batch_data, batch_data->proof_indices[i], &js_proof));
+        RETURN_ON_FAILURE(napi_set_element(env, js_proofs, i, js_proof));
+    }
+
+    return napi_set_named_property(env, *result, "proofs", js_proofs);
+}
+
+static void merkle_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    merkle_batch_data_t *batch_data = (merkle_batch_data_t *) batch;
+
+    free(batch_data->nodes);
+    free(batch_data);
+}
+
+napi_value blake2_addon_blake2b_merkle_root(napi_env env, napi_callback_info info)
+{
+    size_t argc = 8;
+    napi_value argv[8];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    size_t leaves_length;
+    const unsigned char *leaves;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &leaves, &leaves_length),
+        env, "Invalid buffer was passed as leaves."
+    );
+
+    uint32_t leaf_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[1], &leaf_length),
+        env, "Invalid leaf length was passed."
+    );
+
+    uint32_t leaf_hash_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[2], &leaf_hash_length),
+        env, "Invalid leaf hash length was passed."
+    );
+
+    uint32_t node_hash_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[3], &node_hash_length),
+        env, "Invalid node hash length was passed."
+    );
+
+    bool domain_separation;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[4], &domain_separation),
+        env, "Invalid bool was passed as domain separation flag."
+    );
+
+    napi_value null_value;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_null(env, &null_value),
+        env, "Could not get null object"
+    );
+
+    bool is_proof_indices_null;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_strict_equals(env, argv[5], null_value, &is_proof_indices_null),
+        env, "Could not check if proof indices are null"
+    );
+
+    size_t proof_count = 0;
+    const uint32_t *proof_indices = NULL;
+    if (!is_proof_indices_null)
+    {
+        napi_typedarray_type proof_indices_type;
+        THROW_AND_RETURN_NULL_ON_FAILURE(
+            napi_get_typedarray_info(env, argv[5], &proof_indices_type, &proof_count, (void **) &proof_indices, NULL, NULL),
+            env, "Invalid array was passed as proof indices."
+        );
+
+        if (napi_uint32_array != proof_indices_type)
+        {
+            napi_throw_error(env, NULL, "Invalid array was passed as proof indices.");
+            return NULL;
+        }
+    }
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[6], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[7], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (0 == leaf_length || 0 != leaves_length % leaf_length || 0 == leaves_length
+        || 0 == leaf_hash_length || BLAKE2B_MAX_HASH_LENGTH < leaf_hash_length
+        || 0 == node_hash_length || BLAKE2B_MAX_HASH_LENGTH < node_hash_length)
+    {
+        napi_throw_error(env, NULL, "Invalid leaf or hash length.");
+        return NULL;
+    }
+
+    const size_t leaf_count = leaves_length / leaf_length;
+
+    for (size_t i = 0; i < proof_count; ++i)
+    {
+        if (leaf_count <= proof_indices[i])
+        {
+            napi_throw_error(env, NULL, "Invalid proof index.");
+            return NULL;
+        }
+    }
+
+    const char *resource_identifier = "blake2::batch::merkleRoot";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    merkle_batch_data_t *batch_data = (merkle_batch_data_t *)calloc(1, sizeof (merkle_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->leaves = leaves;
+    batch_data->leaf_length = leaf_length;
+    batch_data->leaf_hash_length = leaf_hash_length;
+    batch_data->node_hash_length = node_hash_length;
+    batch_data->domain_separation = domain_separation;
+    batch_data->proof_indices = proof_indices;
+    batch_data->proof_count = proof_count;
+
+    size_t nodes_length = 0;
+    for (size_t level_size = leaf_count; ; level_size = (level_size + 1) / 2)
+    {
+        const size_t level = batch_data->level_count++;
+
+        batch_data->level_sizes[level] = level_size;
+        batch_data->level_offsets[level] = nodes_length;
+        nodes_length += level_size * level_hash_length(batch_data, level);
+
+        if (1 == level_size)
+        {
+            break;
+        }
+    }
+
+    batch_data->nodes = (unsigned char *)malloc(nodes_length);
+    if (!batch_data->nodes)
+    {
+        merkle_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not allocate the tree.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, leaf_count, MERKLE_BATCH_CHUNK_SIZE,
+        merkle_batch_execute, merkle_batch_complete, merkle_batch_finalize, &promise))
+    {
+        merkle_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    signun_batch_set_advance(&batch_data->batch, merkle_batch_advance, resource_identifier);
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[0])
+        || (proof_indices && napi_ok != signun_batch_retain(env, &batch_data->batch, argv[5])))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        merkle_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_MERKLE, priority, cancel_token, resource_name);
+
+    return promise;
+}
@@ -0,0 +1,972 @@
+#include "blake2_addon/blake2b_merkle_accumulator.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "blake2_addon/blake2b_merkle.h"
+#include "signun_batch.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+
+
+#define BLAKE2B_MAX_HASH_LENGTH 64
+
+#define ACCUMULATOR_MAGIC "SIGNUNMA"
+#define ACCUMULATOR_VERSION 1
+
+#define ACCUMULATOR_INITIAL_CAPACITY 1024
+#define ACCUMULATOR_MAX_LEAF_COUNT UINT32_MAX
+
+// Enough for a capacity of 2^32 leaves.
+#define ACCUMULATOR_MAX_LEVELS 34
+
+#define ACCUMULATOR_BATCH_CHUNK_SIZE 8192
+
+/*
+ * Stored at the start of the arena, so that a memory-mapped accumulator can
+ * be reopened as it was left.
+ */
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint8_t leaf_hash_length;
+    uint8_t node_hash_length;
+    uint8_t domain_separation;
+    uint8_t reserved;
+    uint64_t capacity;
+    uint64_t size;
+} merkle_accumulator_header_t;
+
+/*
+ * The header is followed by every level of the tree, each sized for the
+ * capacity, so that a node is found by its level and index alone. Growing
+ * doubles the capacity and spreads the levels out in place.
+ */
+typedef struct
+{
+    unsigned char *storage;
+    size_t storage_length;
+    // Only valid for memory-mapped accumulators, -1 otherwise.
+    int fd;
+
+    // Set while appendMany is in flight, during which the arena belongs to the workers.
+    bool is_busy;
+    bool is_closed;
+
+    size_t level_count;
+    size_t level_offsets[ACCUMULATOR_MAX_LEVELS];
+} merkle_accumulator_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+
+    merkle_accumulator_t *accumulator;
+
+    const unsigned char *leaves;
+    size_t leaf_length;
+    size_t first_index;
+    size_t new_size;
+
+    // The level being hashed by the current phase and the first node it hashes.
+    size_t level;
+    size_t level_start;
+
+    bool is_committed;
+} append_batch_data_t;
+
+static merkle_accumulator_header_t *get_header(const merkle_accumulator_t *accumulator)
+{
+    return (merkle_accumulator_header_t *) accumulator->storage;
+}
+
+static size_t level_hash_length(const merkle_accumulator_t *accumulator, size_t level)
+{
+    return 0 == level ? get_header(accumulator)->leaf_hash_length : get_header(accumulator)->node_hash_length;
+}
+
+static unsigned char *level_node(const merkle_accumulator_t *accumulator, size_t level, size_t index)
+{
+    return &accumulator->storage[accumulator->level_offsets[level] + index * level_hash_length(accumulator, level)];
+}
+
+static size_t level_size(size_t size, size_t level)
+{
+    return 0 == size ? 0 : ((size - 1) >> level) + 1;
+}
+
+static size_t layout_storage(size_t capacity, size_t leaf_hash_length, size_t node_hash_length, size_t *level_offsets, size_t *level_count)
+{
+    size_t length = sizeof (merkle_accumulator_header_t);
+
+    for (size_t level = 0; ; ++level)
+    {
+        level_offsets[level] = length;
+        length += (capacity >> level) * (0 == level ? leaf_hash_length : node_hash_length);
+
+        if (1 == capacity >> level)
+        {
+            *level_count = level + 1;
+            break;
+        }
+    }
+
+    return length;
+}
+
+static void init_header(merkle_accumulator_t *accumulator, size_t leaf_hash_length, size_t node_hash_length, bool domain_separation)
+{
+    merkle_accumulator_header_t *header = get_header(accumulator);
+
+    memset(header, 0, sizeof (merkle_accumulator_header_t));
+    memcpy(header->magic, ACCUMULATOR_MAGIC, sizeof (header->magic));
+    header->version = ACCUMULATOR_VERSION;
+    header->leaf_hash_length = (uint8_t) leaf_hash_length;
+    header->node_hash_length = (uint8_t) node_hash_length;
+    header->domain_separation = domain_separation;
+    header->capacity = ACCUMULATOR_INITIAL_CAPACITY;
+    header->size = 0;
+}
+
+static bool resize_storage(merkle_accumulator_t *accumulator, size_t storage_length)
+{
+    unsigned char *storage;
+
+    if (0 > accumulator->fd)
+    {
+        storage = (unsigned char *)realloc(accumulator->storage, storage_length);
+        if (!storage)
+        {
+            return false;
+        }
+    }
+    else
+    {
+#ifndef _WIN32
+        // The new mapping is created first, so that the old one is kept on failure.
+        if (0 != ftruncate(accumulator->fd, storage_length))
+        {
+            return false;
+        }
+
+        storage = (unsigned char *)mmap(NULL, storage_length, PROT_READ | PROT_WRITE, MAP_SHARED, accumulator->fd, 0);
+        if (MAP_FAILED == storage)
+        {
+            return false;
+        }
+
+        munmap(accumulator->storage, accumulator->storage_length);
+#else
+        return false;
+#endif
+    }
+
+    accumulator->storage = storage;
+    accumulator->storage_length = storage_length;
+
+    return true;
+}
+
+/*
+ * Levels only ever move towards the end of the arena, so moving them from
+ * the top down never overwrites a level that is yet to be moved.
+ */
+static bool reserve(merkle_accumulator_t *accumulator, size_t size)
+{
+    const size_t capacity = get_header(accumulator)->capacity;
+    if (size <= capacity)
+    {
+        return true;
+    }
+
+    if (ACCUMULATOR_MAX_LEAF_COUNT < size)
+    {
+        return false;
+    }
+
+    size_t new_capacity = capacity;
+    while (new_capacity < size)
+    {
+        new_capacity *= 2;
+    }
+
+    size_t new_level_offsets[ACCUMULATOR_MAX_LEVELS];
+    size_t new_level_count;
+    const size_t storage_length = layout_storage(new_capacity, get_header(accumulator)->leaf_hash_length,
+        get_header(accumulator)->node_hash_length, new_level_offsets, &new_level_count);
+
+    if (!resize_storage(accumulator, storage_length))
+    {
+        return false;
+    }
+
+    for (size_t level = accumulator->level_count; 0 < level--; )
+    {
+        memmove(&accumulator->storage[new_level_offsets[level]], &accumulator->storage[accumulator->level_offsets[level]],
+            (capacity >> level) * level_hash_length(accumulator, level));
+    }
+
+    memcpy(accumulator->level_offsets, new_level_offsets, sizeof (new_level_offsets));
+    accumulator->level_count = new_level_count;
+    get_header(accumulator)->capacity = new_capacity;
+
+    return true;
+}
+
+static int hash_leaf(const merkle_accumulator_t *accumulator, size_t index, const unsigned char *leaf, size_t leaf_length)
+{
+    return blake2_addon_merkle_hash(level_node(accumulator, 0, index), level_hash_length(accumulator, 0),
+        get_header(accumulator)->domain_separation, BLAKE2B_MERKLE_LEAF_PREFIX, leaf, leaf_length);
+}
+
+/*
+ * As with merkleRoot, a node without a sibling is hashed on its own.
+ */
+static int hash_node(const merkle_accumulator_t *accumulator, size_t size, size_t level, size_t index)
+{
+    const size_t child_count = 2 * index + 1 < level_size(size, level - 1) ? 2 : 1;
+
+    return blake2_addon_merkle_hash(level_node(accumulator, level, index), level_hash_length(accumulator, level),
+        get_header(accumulator)->domain_separation, BLAKE2B_MERKLE_NODE_PREFIX,
+        level_node(accumulator, level - 1, 2 * index), child_count * level_hash_length(accumulator, level - 1));
+}
+
+static int hash_path(const merkle_accumulator_t *accumulator, size_t size, size_t index)
+{
+    int result = 0;
+    for (size_t level = 1; 0 == result && 1 < level_size(size, level - 1); ++level)
+    {
+        index /= 2;
+        result = hash_node(accumulator, size, level, index);
+    }
+
+    return result;
+}
+
+static void close_storage(merkle_accumulator_t *accumulator)
+{
+    if (0 > accumulator->fd)
+    {
+        free(accumulator->storage);
+    }
+#ifndef _WIN32
+    else
+    {
+        munmap(accumulator->storage, accumulator->storage_length);
+        close(accumulator->fd);
+    }
+#endif
+
+    accumulator->storage = NULL;
+    accumulator->storage_length = 0;
+    accumulator->fd = -1;
+    accumulator->is_closed = true;
+}
+
+#ifndef _WIN32
+static const char *open_storage(merkle_accumulator_t *accumulator, const char *path,
+    size_t leaf_hash_length, size_t node_hash_length, bool domain_separation)
+{
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (0 > fd)
+    {
+        return "Could not open the accumulator file.";
+    }
+
+    // Two writers would corrupt each other's trees.
+    if (0 != flock(fd, LOCK_EX | LOCK_NB))
+    {
+        close(fd);
+        return "The accumulator file is in use.";
+    }
+
+    struct stat file_stat;
+    if (0 != fstat(fd, &file_stat))
+    {
+        close(fd);
+        return "Could not open the accumulator file.";
+    }
+
+    const bool is_new = 0 == file_stat.st_size;
+    size_t storage_length = is_new
+        ? layout_storage(ACCUMULATOR_INITIAL_CAPACITY, leaf_hash_length, node_hash_length, accumulator->level_offsets, &accumulator->level_count)
+        : (size_t) file_stat.st_size;
+
+    if (sizeof (merkle_accumulator_header_t) > storage_length || (is_new && 0 != ftruncate(fd, storage_length)))
+    {
+        close(fd);
+        return is_new ? "Could not open the accumulator file." : "The accumulator file is corrupted.";
+    }
+
+    unsigned char *storage = (unsigned char *)mmap(NULL, storage_length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == storage)
+    {
+        close(fd);
+        return "Could not map the accumulator file.";
+    }
+
+    accumulator->storage = storage;
+    accumulator->storage_length = storage_length;
+    accumulator->fd = fd;
+
+    if (is_new)
+    {
+        init_header(accumulator, leaf_hash_length, node_hash_length, domain_separation);
+        return NULL;
+    }
+
+    const merkle_accumulator_header_t *header = get_header(accumulator);
+    if (0 != memcmp(header->magic, ACCUMULATOR_MAGIC, sizeof (header->magic)) || ACCUMULATOR_VERSION != header->version)
+    {
+        close_storage(accumulator);
+        return "The accumulator file is corrupted.";
+    }
+
+    if (leaf_hash_length != header->leaf_hash_length || node_hash_length != header->node_hash_length
+        || domain_separation != (bool) header->domain_separation)
+    {
+        close_storage(accumulator);
+        return "The accumulator file does not match the options.";
+    }
+
+    const uint64_t capacity = header->capacity;
+    const bool is_valid_capacity = 0 < capacity && (uint64_t) ACCUMULATOR_MAX_LEAF_COUNT + 1 >= capacity && 0 == (capacity & (capacity - 1));
+
+    if (!is_valid_capacity || header->size > capacity
+        || storage_length != layout_storage(capacity, leaf_hash_length, node_hash_length, accumulator->level_offsets, &accumulator->level_count))
+    {
+        close_storage(accumulator);
+        return "The accumulator file is corrupted.";
+    }
+
+    return NULL;
+}
+#endif
+
+static void accumulator_finalize(napi_env env, void *data, void *hint)
+{
+    merkle_accumulator_t *accumulator = (merkle_accumulator_t *) data;
+
+    if (!accumulator->is_closed)
+    {
+        close_storage(accumulator);
+    }
+
+    free(accumulator);
+}
+
+static napi_status get_accumulator(napi_env env, napi_value value, merkle_accumulator_t **accumulator)
+{
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, value, &type));
+
+    if (napi_external != type)
+    {
+        return napi_invalid_arg;
+    }
+
+    return napi_get_value_external(env, value, (void **) accumulator);
+}
+
+/*
+ * Reads the accumulator argument and throws if it cannot be used right now.
+ */
+static merkle_accumulator_t *get_usable_accumulator(napi_env env, napi_value value)
+{
+    merkle_accumulator_t *accumulator;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_accumulator(env, value, &accumulator),
+        env, "Invalid accumulator was passed."
+    );
+
+    if (accumulator->is_closed)
+    {
+        napi_throw_error(env, NULL, "The accumulator is closed.");
+        return NULL;
+    }
+
+    if (accumulator->is_busy)
+    {
+        napi_throw_error(env, NULL, "The accumulator is busy.");
+        return NULL;
+    }
+
+    return accumulator;
+}
+
+napi_value blake2_addon_merkle_accumulator_create(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value argv[4];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    uint32_t leaf_hash_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[0], &leaf_hash_length),
+        env, "Invalid leaf hash length was passed."
+    );
+
+    uint32_t node_hash_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[1], &node_hash_length),
+        env, "Invalid node hash length was passed."
+    );
+
+    bool domain_separation;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[2], &domain_separation),
+        env, "Invalid bool was passed as domain separation flag."
+    );
+
+    napi_value null_value;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_null(env, &null_value),
+        env, "Could not get null object"
+    );
+
+    bool is_path_null;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_strict_equals(env, argv[3], null_value, &is_path_null),
+        env, "Could not check if path is null"
+    );
+
+    if (0 == leaf_hash_length || BLAKE2B_MAX_HASH_LENGTH < leaf_hash_length
+        || 0 == node_hash_length || BLAKE2B_MAX_HASH_LENGTH < node_hash_length)
+    {
+        napi_throw_error(env, NULL, "Invalid hash length.");
+        return NULL;
+    }
+
+    merkle_accumulator_t *accumulator = (merkle_accumulator_t *)calloc(1, sizeof (merkle_accumulator_t));
+    if (!accumulator)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the accumulator.");
+        return NULL;
+    }
+
+    accumulator->fd = -1;
+
+    if (is_path_null)
+    {
+        const size_t storage_length = layout_storage(ACCUMULATOR_INITIAL_CAPACITY, leaf_hash_length, node_hash_length,
+            accumulator->level_offsets, &accumulator->level_count);
+
+        accumulator->storage = (unsigned char *)malloc(storage_length);
+        if (!accumulator->storage)
+        {
+            free(accumulator);
+            napi_throw_error(env, NULL, "Could not allocate the accumulator.");
+            return NULL;
+        }
+
+        accumulator->storage_length = storage_length;
+        init_header(accumulator, leaf_hash_length, node_hash_length, domain_separation);
+    }
+    else
+    {
+#ifndef _WIN32
+        size_t path_length;
+        if (napi_ok != napi_get_value_string_utf8(env, argv[3], NULL, 0, &path_length))
+        {
+            free(accumulator);
+            napi_throw_error(env, NULL, "Invalid string was passed as path.");
+            return NULL;
+        }
+
+        char *path = (char *)malloc(path_length + 1);
+        if (!path)
+        {
+            free(accumulator);
+            napi_throw_error(env, NULL, "Could not allocate the path.");
+            return NULL;
+        }
+
+        napi_get_value_string_utf8(env, argv[3], path, path_length + 1, NULL);
+
+        const char *error_message = open_storage(accumulator, path, leaf_hash_length, node_hash_length, domain_separation);
+        free(path);
+
+        if (error_message)
+        {
+            free(accumulator);
+            napi_throw_error(env, NULL, error_message);
+            return NULL;
+        }
+#else
+        free(accumulator);
+        napi_throw_error(env, NULL, "Memory-mapped accumulators are not supported on this platform.");
+        return NULL;
+#endif
+    }
+
+    napi_value js_accumulator;
+    if (napi_ok != napi_create_external(env, accumulator, accumulator_finalize, NULL, &js_accumulator))
+    {
+        accumulator_finalize(env, accumulator, NULL);
+        napi_throw_error(env, NULL, "Could not create the accumulator.");
+        return NULL;
+    }
+
+    return js_accumulator;
+}
+
+napi_value blake2_addon_merkle_accumulator_size(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    merkle_accumulator_t *accumulator;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_accumulator(env, argv[0], &accumulator),
+        env, "Invalid accumulator was passed."
+    );
+
+    if (accumulator->is_closed)
+    {
+        napi_throw_error(env, NULL, "The accumulator is closed.");
+        return NULL;
+    }
+
+    // Only committed once appendMany completes, so it is safe to read while busy.
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_uint32(env, (uint32_t) get_header(accumulator)->size, &js_result),
+        env, "Could not set the result."
+    );
+
+    return js_result;
+}
+
+napi_value blake2_addon_merkle_accumulator_append(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    merkle_accumulator_t *accumulator = get_usable_accumulator(env, argv[0]);
+    if (!accumulator)
+    {
+        return NULL;
+    }
+
+    size_t leaf_length;
+    const unsigned char *leaf;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &leaf, &leaf_length),
+        env, "Invalid buffer was passed as leaf."
+    );
+
+    const size_t index = get_header(accumulator)->size;
+    if (!reserve(accumulator, index + 1))
+    {
+        napi_throw_error(env, NULL, "Could not grow the accumulator.");
+        return NULL;
+    }
+
+    if (0 != hash_leaf(accumulator, index, leaf, leaf_length) || 0 != hash_path(accumulator, index + 1, index))
+    {
+        napi_throw_error(env, NULL, "Could not compute hash.");
+        return NULL;
+    }
+
+    get_header(accumulator)->size = index + 1;
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_uint32(env, (uint32_t) index, &js_result),
+        env, "Could not set the result."
+    );
+
+    return js_result;
+}
+
+napi_value blake2_addon_merkle_accumulator_update(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value argv[3];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    merkle_accumulator_t *accumulator = get_usable_accumulator(env, argv[0]);
+    if (!accumulator)
+    {
+        return NULL;
+    }
+
+    uint32_t index;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[1], &index),
+        env, "Invalid leaf index was passed."
+    );
+
+    size_t leaf_length;
+    const unsigned char *leaf;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &leaf, &leaf_length),
+        env, "Invalid buffer was passed as leaf."
+    );
+
+    const size_t size = get_header(accumulator)->size;
+    if (size <= index)
+    {
+        napi_throw_error(env, NULL, "Invalid leaf index.");
+        return NULL;
+    }
+
+    if (0 != hash_leaf(accumulator, index, leaf, leaf_length) || 0 != hash_path(accumulator, size, index))
+    {
+        napi_throw_error(env, NULL, "Could not compute hash.");
+        return NULL;
+    }
+
+    return NULL;
+}
+
+napi_value blake2_addon_merkle_accumulator_root(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    merkle_accumulator_t *accumulator = get_usable_accumulator(env, argv[0]);
+    if (!accumulator)
+    {
+        return NULL;
+    }
+
+    const size_t size = get_header(accumulator)->size;
+
+    napi_value js_result;
+    if (0 == size)
+    {
+        THROW_AND_RETURN_NULL_ON_FAILURE(
+            napi_get_null(env, &js_result),
+            env, "Could not set the result."
+        );
+
+        return js_result;
+    }
+
+    size_t root_level = 0;
+    while (1 < level_size(size, root_level))
+    {
+        ++root_level;
+    }
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer_copy(env, level_hash_length(accumulator, root_level), level_node(accumulator, root_level, 0), NULL, &js_result),
+        env, "Could not set the result buffer."
+    );
+
+    return js_result;
+}
+
+/*
+ * Laid out as by merkleRoot: the siblings of the path from the leaf to the
+ * root, bottom up, skipping levels where the path has no sibling.
+ */
+napi_value blake2_addon_merkle_accumulator_proof(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    merkle_accumulator_t *accumulator = get_usable_accumulator(env, argv[0]);
+    if (!accumulator)
+    {
+        return NULL;
+    }
+
+    uint32_t leaf_index;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[1], &leaf_index),
+        env, "Invalid leaf index was passed."
+    );
+
+    const size_t size = get_header(accumulator)->size;
+    if (size <= leaf_index)
+    {
+        napi_throw_error(env, NULL, "Invalid leaf index.");
+        return NULL;
+    }
+
+    size_t proof_length = 0;
+    for (size_t level = 0, index = leaf_index; 1 < level_size(size, level); ++level, index /= 2)
+    {
+        if ((index ^ 1) < level_size(size, level))
+        {
+            proof_length += level_hash_length(accumulator, level);
+        }
+    }
+
+    napi_value js_result;
+    unsigned char *output;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer(env, proof_length, (void **) &output, &js_result),
+        env, "Could not set the result buffer."
+    );
+
+    for (size_t level = 0, index = leaf_index; 1 < level_size(size, level); ++level, index /= 2)
+    {
+        if ((index ^ 1) < level_size(size, level))
+        {
+            const size_t hash_length = level_hash_length(accumulator, level);
+
+            memcpy(output, level_node(accumulator, level, index ^ 1), hash_length);
+            output += hash_length;
+        }
+    }
+
+    return js_result;
+}
+
+static void append_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    append_batch_data_t *batch_data = (append_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        const int result = 0 == batch_data->level
+            ? hash_leaf(batch_data->accumulator, batch_data->first_index + i, &batch_data->leaves[i * batch_data->leaf_length], batch_data->leaf_length)
+            : hash_node(batch_data->accumulator, batch_data->new_size, batch_data->level, batch_data->level_start + i);
+
+        if (0 != result)
+        {
+            signun_batch_chunk_fail(batch, chunk, "Could not compute hash.");
+            return;
+        }
+    }
+}
+
+/*
+ * Only the ancestors of the appended leaves are hashed, one level per phase.
+ */
+static size_t append_batch_advance(signun_batch_t *batch)
+{
+    append_batch_data_t *batch_data = (append_batch_data_t *) batch;
+
+    if (1 >= level_size(batch_data->new_size, batch_data->level))
+    {
+        return 0;
+    }
+
+    batch_data->level++;
+    batch_data->level_start = batch_data->first_index >> batch_data->level;
+
+    return ((batch_data->new_size - 1) >> batch_data->level) - batch_data->level_start + 1;
+}
+
+static napi_status append_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    append_batch_data_t *batch_data = (append_batch_data_t *) batch;
+
+    get_header(batch_data->accumulator)->size = batch_data->new_size;
+    batch_data->is_committed = true;
+
+    return napi_create_uint32(env, (uint32_t) batch_data->first_index, result);
+}
+
+/*
+ * A failed or aborted append may have rehashed the ancestors of the last
+ * committed leaf against the new leaves, so they are restored.
+ */
+static void append_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    append_batch_data_t *batch_data = (append_batch_data_t *) batch;
+    merkle_accumulator_t *accumulator = batch_data->accumulator;
+
+    if (!batch_data->is_committed && 0 < batch_data->first_index)
+    {
+        hash_path(accumulator, batch_data->first_index, batch_data->first_index - 1);
+    }
+
+    accumulator->is_busy = false;
+
+    free(batch_data);
+}
+
+napi_value blake2_addon_merkle_accumulator_append_many(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value argv[5];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    merkle_accumulator_t *accumulator = get_usable_accumulator(env, argv[0]);
+    if (!accumulator)
+    {
+        return NULL;
+    }
+
+    size_t leaves_length;
+    const unsigned char *leaves;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &leaves, &leaves_length),
+        env, "Invalid buffer was passed as leaves."
+    );
+
+    uint32_t leaf_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[2], &leaf_length),
+        env, "Invalid leaf length was passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (0 == leaf_length || 0 == leaves_length || 0 != leaves_length % leaf_length)
+    {
+        napi_throw_error(env, NULL, "Invalid leaf length.");
+        return NULL;
+    }
+
+    const size_t first_index = get_header(accumulator)->size;
+    const size_t leaf_count = leaves_length / leaf_length;
+
+    if (!reserve(accumulator, first_index + leaf_count))
+    {
+        napi_throw_error(env, NULL, "Could not grow the accumulator.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "blake2::batch::merkleAccumulatorAppend";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    append_batch_data_t *batch_data = (append_batch_data_t *)calloc(1, sizeof (append_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->accumulator = accumulator;
+    batch_data->leaves = leaves;
+    batch_data->leaf_length = leaf_length;
+    batch_data->first_index = first_index;
+    batch_data->new_size = first_index + leaf_count;
+
+    // Cleared by the finalizer, however the batch ends.
+    accumulator->is_busy = true;
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, leaf_count, ACCUMULATOR_BATCH_CHUNK_SIZE,
+        append_batch_execute, append_batch_complete, append_batch_finalize, &promise))
+    {
+        append_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    signun_batch_set_advance(&batch_data->batch, append_batch_advance, resource_identifier);
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[1]))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        append_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_MERKLE, priority, cancel_token, resource_name);
+
+    return promise;
+}
+
+napi_value blake2_addon_merkle_accumulator_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    merkle_accumulator_t *accumulator = get_usable_accumulator(env, argv[0]);
+    if (!accumulator)
+    {
+        return NULL;
+    }
+
+#ifndef _WIN32
+    if (0 <= accumulator->fd && 0 != msync(accumulator->storage, accumulator->storage_length, MS_SYNC))
+    {
+        napi_throw_error(env, NULL, "Could not sync the accumulator file.");
+        return NULL;
+    }
+#endif
+
+    return NULL;
+}
+
+napi_value blake2_addon_merkle_accumulator_close(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    merkle_accumulator_t *accumulator;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_accumulator(env, argv[0], &accumulator),
+        env, "Invalid accumulator was passed."
+    );
+
+    if (accumulator->is_busy)
+    {
+        napi_throw_error(env, NULL, "The accumulator is busy.");
+        return NULL;
+    }
+
+    if (!accumulator->is_closed)
+    {
+        close_storage(accumulator);
+    }
+
+    return NULL;
+}
@@ -0,0 +1,472 @@
+#include "blake2_addon/blake2b_stream.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blake2.h"
+
+#include "signun_pool.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+
+
+#define BLAKE2B_MAX_HASH_LENGTH 64
+#define BLAKE2B_MAX_KEY_LENGTH 64
+
+#define STREAM_CHUNK_POOL_HIGH_WATER_MARK 256
+
+struct blake2b_stream_s;
+
+/*
+ * A chunk stays pinned through a reference from the moment it is written
+ * until it has been hashed, so it is never copied.
+ */
+typedef struct blake2b_stream_chunk_s
+{
+    signun_task_t task;
+
+    napi_deferred deferred;
+    napi_ref chunk_ref;
+
+    const unsigned char *data;
+    size_t data_length;
+    int result;
+
+    struct blake2b_stream_s *stream;
+    struct blake2b_stream_chunk_s *next;
+} blake2b_stream_chunk_t;
+
+/*
+ * Chunks are held in a FIFO and only the head is ever queued on the
+ * scheduler, so a stream occupies a single worker at a time and its state is
+ * updated in write order. The FIFO is only touched on the main thread.
+ */
+typedef struct blake2b_stream_s
+{
+    blake2b_state state;
+    size_t hash_length;
+
+    signun_priority_t priority;
+    signun_cancel_token_t *cancel_token;
+    napi_ref cancel_token_ref;
+
+    blake2b_stream_chunk_t *head;
+    blake2b_stream_chunk_t *tail;
+    uint32_t depth;
+
+    bool failed;
+    bool digested;
+    // Set when the stream was collected with a chunk in flight, which then frees it.
+    bool orphaned;
+} blake2b_stream_t;
+
+static const signun_pool_t stream_chunk_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_STREAM_CHUNK, blake2b_stream_chunk_t, STREAM_CHUNK_POOL_HIGH_WATER_MARK, false);
+
+static void free_stream(napi_env env, blake2b_stream_t *stream)
+{
+    if (stream->cancel_token_ref)
+    {
+        napi_delete_reference(env, stream->cancel_token_ref);
+    }
+
+    signun_secure_zero(stream, sizeof (blake2b_stream_t));
+    free(stream);
+}
+
+static void stream_finalize(napi_env env, void *data, void *hint)
+{
+    blake2b_stream_t *stream = (blake2b_stream_t *) data;
+
+    if (stream->head)
+    {
+        stream->orphaned = true;
+        return;
+    }
+
+    free_stream(env, stream);
+}
+
+static napi_status get_stream(napi_env env, napi_value value, blake2b_stream_t **stream)
+{
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, value, &type));
+
+    if (napi_external != type)
+    {
+        return napi_invalid_arg;
+    }
+
+    return napi_get_value_external(env, value, (void **) stream);
+}
+
+static blake2b_stream_chunk_t *pop_chunk(napi_env env, blake2b_stream_t *stream)
+{
+    blake2b_stream_chunk_t *chunk = stream->head;
+
+    stream->head = chunk->next;
+    if (!stream->head)
+    {
+        stream->tail = NULL;
+    }
+
+    stream->depth--;
+
+    napi_delete_reference(env, chunk->chunk_ref);
+
+    return chunk;
+}
+
+/*
+ * Rejects the chunks that were never queued, once an earlier one has failed
+ * or was aborted, as the state would no longer match the written data.
+ */
+static void reject_pending_chunks(napi_env env, blake2b_stream_t *stream, bool is_abort)
+{
+    while (stream->head)
+    {
+        blake2b_stream_chunk_t *chunk = pop_chunk(env, stream);
+
+        if (is_abort)
+        {
+            REJECT_WITH_ABORT_ERROR(env, chunk->deferred);
+        }
+        else
+        {
+            REJECT_WITH_ERROR(env, "An earlier chunk of the stream could not be hashed.", chunk->deferred);
+        }
+
+        signun_pool_release(env, &stream_chunk_pool, chunk);
+    }
+}
+
+static void stream_chunk_execute(napi_env env, void *data)
+{
+    blake2b_stream_chunk_t *chunk = (blake2b_stream_chunk_t *) data;
+
+    chunk->result = blake2b_update(&chunk->stream->state, chunk->data, chunk->data_length);
+}
+
+static void stream_chunk_complete(napi_env env, napi_status status, void *data);
+
+static void start_chunk(napi_env env, blake2b_stream_t *stream)
+{
+    blake2b_stream_chunk_t *chunk = stream->head;
+
+    napi_value resource_name;
+    if (napi_ok != napi_create_string_utf8(env, "blake2::stream::update", NAPI_AUTO_LENGTH, &resource_name)
+        || napi_ok != signun_task_create(env, &chunk->task, SIGNUN_OP_HASH, stream->priority, stream->cancel_token, resource_name,
+            stream_chunk_execute, stream_chunk_complete))
+    {
+        stream->failed = true;
+
+        pop_chunk(env, stream);
+        REJECT_WITH_ERROR(env, "Could not create async work.", chunk->deferred);
+        signun_pool_release(env, &stream_chunk_pool, chunk);
+
+        reject_pending_chunks(env, stream, false);
+        return;
+    }
+
+    napi_async_work async_work = chunk->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &chunk->task);
+    if (napi_ok != queue_status)
+    {
+        stream->failed = true;
+
+        pop_chunk(env, stream);
+        REJECT_WITH_ERROR(env, napi_queue_full == queue_status ? "Too many operations are in flight." : "Could not queue async work.", chunk->deferred);
+        signun_pool_release(env, &stream_chunk_pool, chunk);
+        napi_delete_async_work(env, async_work);
+
+        reject_pending_chunks(env, stream, false);
+    }
+}
+
+static void stream_chunk_complete(napi_env env, napi_status status, void *data)
+{
+    blake2b_stream_chunk_t *chunk = (blake2b_stream_chunk_t *) data;
+    blake2b_stream_t *stream = chunk->stream;
+
+    pop_chunk(env, stream);
+
+    if (napi_ok != napi_delete_async_work(env, chunk->task.async_work))
+    {
+        stream->failed = true;
+        REJECT_WITH_ERROR(env, "Could not delete async work.", chunk->deferred);
+    }
+    else if (napi_cancelled == status)
+    {
+        stream->failed = true;
+        REJECT_WITH_ABORT_ERROR(env, chunk->deferred);
+    }
+    else if (napi_ok != status)
+    {
+        stream->failed = true;
+        REJECT_WITH_ERROR(env, "The execution was cancelled.", chunk->deferred);
+    }
+    else if (0 != chunk->result)
+    {
+        stream->failed = true;
+        REJECT_WITH_ERROR(env, "Could not compute hash.", chunk->deferred);
+    }
+    else
+    {
+        napi_value js_undefined;
+        napi_get_undefined(env, &js_undefined);
+        napi_resolve_deferred(env, chunk->deferred, js_undefined);
+    }
+
+    signun_pool_release(env, &stream_chunk_pool, chunk);
+
+    if (stream->failed)
+    {
+        reject_pending_chunks(env, stream, napi_cancelled == status);
+    }
+    else if (stream->head)
+    {
+        start_chunk(env, stream);
+    }
+
+    if (stream->orphaned && !stream->head)
+    {
+        free_stream(env, stream);
+    }
+}
+
+napi_value blake2_addon_blake2b_stream_create(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value argv[4];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    uint32_t hash_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[0], &hash_length),
+        env, "Invalid hash length was passed."
+    );
+
+    napi_value null_value;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_null(env, &null_value),
+        env, "Could not get null object"
+    );
+
+    bool is_key_null;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_strict_equals(env, argv[1], null_value, &is_key_null),
+        env, "Could not check if key is null"
+    );
+
+    size_t key_length = 0;
+    const unsigned char *key = NULL;
+    if (!is_key_null)
+    {
+        THROW_AND_RETURN_NULL_ON_FAILURE(
+            signun_get_bytes(env, argv[1], (void **) &key, &key_length),
+            env, "Invalid buffer was passed as key."
+        );
+    }
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[2], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[3], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (0 == hash_length || BLAKE2B_MAX_HASH_LENGTH < hash_length || BLAKE2B_MAX_KEY_LENGTH < key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid key or hash length.");
+        return NULL;
+    }
+
+    blake2b_stream_t *stream = (blake2b_stream_t *)calloc(1, sizeof (blake2b_stream_t));
+    if (!stream)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the stream.");
+        return NULL;
+    }
+
+    stream->hash_length = hash_length;
+    stream->priority = priority;
+
+    const int result = 0 < key_length
+        ? blake2b_init_key(&stream->state, hash_length, key, key_length)
+        : blake2b_init(&stream->state, hash_length);
+
+    if (0 != result)
+    {
+        free_stream(env, stream);
+        napi_throw_error(env, NULL, "Could not initialize the hash.");
+        return NULL;
+    }
+
+    // Chunks are queued long after this call, so the token is kept alive by the stream.
+    if (cancel_token)
+    {
+        if (napi_ok != napi_create_reference(env, argv[3], 1, &stream->cancel_token_ref))
+        {
+            free_stream(env, stream);
+            napi_throw_error(env, NULL, "Could not retain the cancel token.");
+            return NULL;
+        }
+
+        stream->cancel_token = cancel_token;
+    }
+
+    napi_value js_stream;
+    if (napi_ok != napi_create_external(env, stream, stream_finalize, NULL, &js_stream))
+    {
+        free_stream(env, stream);
+        napi_throw_error(env, NULL, "Could not create the stream.");
+        return NULL;
+    }
+
+    return js_stream;
+}
+
+napi_value blake2_addon_blake2b_stream_update(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    blake2b_stream_t *stream;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_stream(env, argv[0], &stream),
+        env, "Invalid stream was passed."
+    );
+
+    size_t data_length;
+    const unsigned char *data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &data, &data_length),
+        env, "Invalid buffer was passed as data."
+    );
+
+    if (stream->failed || stream->digested)
+    {
+        napi_throw_error(env, NULL, stream->failed ? "The stream has failed." : "The digest has already been computed.");
+        return NULL;
+    }
+
+    blake2b_stream_chunk_t *chunk = signun_pool_acquire(env, &stream_chunk_pool);
+    if (!chunk)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the chunk.");
+        return NULL;
+    }
+
+    chunk->data = data;
+    chunk->data_length = data_length;
+    chunk->stream = stream;
+    chunk->next = NULL;
+
+    if (napi_ok != napi_create_reference(env, argv[1], 1, &chunk->chunk_ref))
+    {
+        signun_pool_release(env, &stream_chunk_pool, chunk);
+        napi_throw_error(env, NULL, "Could not retain the chunk.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != napi_create_promise(env, &chunk->deferred, &promise))
+    {
+        napi_delete_reference(env, chunk->chunk_ref);
+        signun_pool_release(env, &stream_chunk_pool, chunk);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (stream->tail)
+    {
+        stream->tail->next = chunk;
+        stream->tail = chunk;
+        stream->depth++;
+
+        return promise;
+    }
+
+    stream->head = stream->tail = chunk;
+    stream->depth++;
+
+    start_chunk(env, stream);
+
+    return promise;
+}
+
+napi_value blake2_addon_blake2b_stream_depth(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    blake2b_stream_t *stream;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_stream(env, argv[0], &stream),
+        env, "Invalid stream was passed."
+    );
+
+    napi_value js_depth;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_uint32(env, stream->depth, &js_depth),
+        env, "Could not set the depth."
+    );
+
+    return js_depth;
+}
+
+napi_value blake2_addon_blake2b_stream_digest(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    blake2b_stream_t *stream;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_stream(env, argv[0], &stream),
+        env, "Invalid stream was passed."
+    );
+
+    if (stream->failed || stream->digested || stream->head)
+    {
+        napi_throw_error(env, NULL, "The digest can only be computed once, after every chunk has been hashed.");
+        return NULL;
+    }
+
+    napi_value js_digest;
+    unsigned char *digest;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer(env, stream->hash_length, (void **) &digest, &js_digest),
+        env, "Could not create the result buffer."
+    );
+
+    if (0 != blake2b_final(&stream->state, digest, stream->hash_length))
+    {
+        napi_throw_error(env, NULL, "Could not compute hash.");
+        return NULL;
+    }
+
+    stream->digested = true;
+
+    return js_digest;
+}
@@ -0,0 +1,660 @@
+#include "blake2_addon/blake2b_work.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#endif
+
+#include <uv.h>
+
+#include "signun_batch.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+
+
+#define WORK_ROOT_LENGTH 32
+#define WORK_NONCE_LENGTH 8
+#define WORK_THRESHOLD_LENGTH 8
+
+// Each thread searches this many nonces per phase, then hands its worker back
+// to the scheduler, so that other operations are not starved by the search.
+#define WORK_CANDIDATES_PER_PHASE (1 << 18)
+
+// How often, in candidates, a thread checks whether to stop searching.
+#define WORK_POLL_INTERVAL 1024
+
+// Validating is cheap, so chunks are long.
+#define WORK_VALIDATE_BATCH_CHUNK_SIZE 4096
+
+// The parameter block of an unkeyed hash of 8 bytes: fanout and depth of 1.
+#define WORK_PARAMETER_BLOCK 0x01010008ULL
+
+// Every input is a single block of nonce || root.
+#define WORK_INPUT_LENGTH (WORK_NONCE_LENGTH + WORK_ROOT_LENGTH)
+
+/*
+ * The hash is computed for several nonces at once, one per lane of the widest
+ * vectors the build enables.
+ */
+#if defined(__AVX2__)
+
+#define WORK_LANES 4
+
+typedef __m256i work_vector_t;
+
+#define VADD(x, y) _mm256_add_epi64((x), (y))
+#define VXOR(x, y) _mm256_xor_si256((x), (y))
+#define VSET1(w) _mm256_set1_epi64x((long long) (w))
+#define VLOAD(words) _mm256_loadu_si256((const __m256i *) (words))
+#define VSTORE(words, x) _mm256_storeu_si256((__m256i *) (words), (x))
+
+#define ROTR32(x) _mm256_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+#define ROTR24(x) _mm256_shuffle_epi8((x), _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10, \
+    3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10))
+#define ROTR16(x) _mm256_shuffle_epi8((x), _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9, \
+    2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9))
+#define ROTR63(x) _mm256_xor_si256(_mm256_srli_epi64((x), 63), _mm256_add_epi64((x), (x)))
+
+#elif defined(__SSE2__)
+
+#define WORK_LANES 2
+
+typedef __m128i work_vector_t;
+
+#define VADD(x, y) _mm_add_epi64((x), (y))
+#define VXOR(x, y) _mm_xor_si128((x), (y))
+#define VSET1(w) _mm_set1_epi64x((long long) (w))
+#define VLOAD(words) _mm_loadu_si128((const __m128i *) (words))
+#define VSTORE(words, x) _mm_storeu_si128((__m128i *) (words), (x))
+
+#define ROTR32(x) _mm_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+#define ROTR63(x) _mm_xor_si128(_mm_srli_epi64((x), 63), _mm_add_epi64((x), (x)))
+
+#if defined(__SSSE3__)
+#define ROTR24(x) _mm_shuffle_epi8((x), _mm_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10))
+#define ROTR16(x) _mm_shuffle_epi8((x), _mm_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9))
+#else
+#define ROTR24(x) _mm_xor_si128(_mm_srli_epi64((x), 24), _mm_slli_epi64((x), 40))
+#define ROTR16(x) _mm_xor_si128(_mm_srli_epi64((x), 16), _mm_slli_epi64((x), 48))
+#endif
+
+#else
+
+#define WORK_LANES 1
+
+typedef uint64_t work_vector_t;
+
+#define VADD(x, y) ((x) + (y))
+#define VXOR(x, y) ((x) ^ (y))
+#define VSET1(w) ((uint64_t) (w))
+#define VLOAD(words) (*(words))
+#define VSTORE(words, x) (*(words) = (x))
+
+#define ROTR64(x, c) (((x) >> (c)) | ((x) << (64 - (c))))
+#define ROTR32(x) ROTR64((x), 32)
+#define ROTR24(x) ROTR64((x), 24)
+#define ROTR16(x) ROTR64((x), 16)
+#define ROTR63(x) ROTR64((x), 63)
+
+#endif
+
+typedef struct
+{
+    signun_batch_t batch;
+
+    uint64_t root[WORK_ROOT_LENGTH / 8];
+    uint64_t threshold;
+
+    // Thread k searches from base + k * stride + offset in the current phase.
+    uint64_t base;
+    uint64_t stride;
+    uint64_t offset;
+    size_t thread_count;
+
+    // Set once by the first thread to find a nonce and polled by the others,
+    // only ever accessed under the mutex.
+    uv_mutex_t mutex;
+    bool found;
+    unsigned char *nonce;
+} work_generate_batch_data_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+
+    const unsigned char *roots;
+    const unsigned char *nonces;
+    uint64_t threshold;
+
+    unsigned char *results;
+} work_validate_batch_data_t;
+
+static const uint64_t blake2b_iv[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+static const uint8_t blake2b_sigma[12][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+    { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+    { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+    { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+    { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+    { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+    { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+    { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+    { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 }
+};
+
+#define G(r, i, a, b, c, d)                                      \
+    do                                                           \
+    {                                                            \
+        a = VADD(VADD(a, b), m[blake2b_sigma[r][2 * i]]);        \
+        d = ROTR32(VXOR(d, a));                                  \
+        c = VADD(c, d);                                          \
+        b = ROTR24(VXOR(b, c));                                  \
+        a = VADD(VADD(a, b), m[blake2b_sigma[r][2 * i + 1]]);    \
+        d = ROTR16(VXOR(d, a));                                  \
+        c = VADD(c, d);                                          \
+        b = ROTR63(VXOR(b, c));                                  \
+    } while (0)
+
+#define ROUND(r)                                  \
+    do                                            \
+    {                                             \
+        G(r, 0, v[0], v[4], v[8], v[12]);         \
+        G(r, 1, v[1], v[5], v[9], v[13]);         \
+        G(r, 2, v[2], v[6], v[10], v[14]);        \
+        G(r, 3, v[3], v[7], v[11], v[15]);        \
+        G(r, 4, v[0], v[5], v[10], v[15]);        \
+        G(r, 5, v[1], v[6], v[11], v[12]);        \
+        G(r, 6, v[2], v[7], v[8], v[13]);         \
+        G(r, 7, v[3], v[4], v[9], v[14]);         \
+    } while (0)
+
+static inline uint64_t load64(const unsigned char *bytes)
+{
+    uint64_t word = 0;
+    for (int i = 7; i >= 0; --i)
+    {
+        word = (word << 8) | bytes[i];
+    }
+
+    return word;
+}
+
+static inline void store64(unsigned char *bytes, uint64_t word)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        bytes[i] = (unsigned char) (word >> (8 * i));
+    }
+}
+
+/*
+ * Computes blake2b(nonce || root, 8) as a little-endian integer, in every
+ * lane at once. The input fits a single, final block, so the compression is
+ * specialized for it: the counter and the flags are constants, and the
+ * message words past the root are zero.
+ */
+static inline void work_values(const work_vector_t *root, work_vector_t nonce, uint64_t values[WORK_LANES])
+{
+    const work_vector_t zero = VSET1(0);
+    const work_vector_t m[16] = {
+        nonce, root[0], root[1], root[2], root[3], zero, zero, zero,
+        zero, zero, zero, zero, zero, zero, zero, zero
+    };
+
+    const work_vector_t h0 = VSET1(blake2b_iv[0] ^ WORK_PARAMETER_BLOCK);
+    work_vector_t v[16] = {
+        h0, VSET1(blake2b_iv[1]), VSET1(blake2b_iv[2]), VSET1(blake2b_iv[3]),
+        VSET1(blake2b_iv[4]), VSET1(blake2b_iv[5]), VSET1(blake2b_iv[6]), VSET1(blake2b_iv[7]),
+        VSET1(blake2b_iv[0]), VSET1(blake2b_iv[1]), VSET1(blake2b_iv[2]), VSET1(blake2b_iv[3]),
+        VSET1(blake2b_iv[4] ^ WORK_INPUT_LENGTH), VSET1(blake2b_iv[5]), VSET1(~blake2b_iv[6]), VSET1(blake2b_iv[7])
+    };
+
+    ROUND(0);
+    ROUND(1);
+    ROUND(2);
+    ROUND(3);
+    ROUND(4);
+    ROUND(5);
+    ROUND(6);
+    ROUND(7);
+    ROUND(8);
+    ROUND(9);
+    ROUND(10);
+    ROUND(11);
+
+    VSTORE(values, VXOR(VXOR(h0, v[0]), v[8]));
+}
+
+static uint64_t work_value(const unsigned char *root, const unsigned char *nonce)
+{
+    work_vector_t root_vector[4];
+    for (size_t i = 0; i < 4; ++i)
+    {
+        root_vector[i] = VSET1(load64(&root[8 * i]));
+    }
+
+    uint64_t values[WORK_LANES];
+    work_values(root_vector, VSET1(load64(nonce)), values);
+
+    return values[0];
+}
+
+static napi_status get_fixed_bytes(napi_env env, napi_value value, size_t expected_length, const unsigned char **data)
+{
+    size_t length;
+    RETURN_ON_FAILURE(signun_get_bytes(env, value, (void **) data, &length));
+
+    return expected_length == length ? napi_ok : napi_invalid_arg;
+}
+
+napi_value blake2_addon_blake2b_work_validate_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value argv[3];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    const unsigned char *root;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_fixed_bytes(env, argv[0], WORK_ROOT_LENGTH, &root),
+        env, "Invalid buffer was passed as root."
+    );
+
+    const unsigned char *nonce;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_fixed_bytes(env, argv[1], WORK_NONCE_LENGTH, &nonce),
+        env, "Invalid buffer was passed as nonce."
+    );
+
+    const unsigned char *threshold;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_fixed_bytes(env, argv[2], WORK_THRESHOLD_LENGTH, &threshold),
+        env, "Invalid buffer was passed as threshold."
+    );
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_boolean(env, work_value(root, nonce) >= load64(threshold), &js_result),
+        env, "Could not create the result."
+    );
+
+    return js_result;
+}
+
+static void work_validate_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    work_validate_batch_data_t *batch_data = (work_validate_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; i += WORK_LANES)
+    {
+        uint64_t nonces[WORK_LANES];
+        uint64_t roots[4][WORK_LANES];
+
+        // The lanes past the end of the chunk repeat its last item.
+        for (size_t lane = 0; lane < WORK_LANES; ++lane)
+        {
+            const size_t item = i + lane < chunk->end ? i + lane : chunk->end - 1;
+
+            nonces[lane] = load64(&batch_data->nonces[item * WORK_NONCE_LENGTH]);
+            for (size_t word = 0; word < 4; ++word)
+            {
+                roots[word][lane] = load64(&batch_data->roots[item * WORK_ROOT_LENGTH + 8 * word]);
+            }
+        }
+
+        work_vector_t root_vector[4];
+        for (size_t word = 0; word < 4; ++word)
+        {
+            root_vector[word] = VLOAD(roots[word]);
+        }
+
+        uint64_t values[WORK_LANES];
+        work_values(root_vector, VLOAD(nonces), values);
+
+        for (size_t lane = 0; lane < WORK_LANES && i + lane < chunk->end; ++lane)
+        {
+            batch_data->results[i + lane] = values[lane] >= batch_data->threshold;
+        }
+    }
+}
+
+static napi_status work_validate_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    return signun_batch_get_retained_value(env, batch, 2, result);
+}
+
+static void work_validate_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    free(batch);
+}
+
+napi_value blake2_addon_blake2b_work_validate_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value argv[5];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    size_t roots_length;
+    const unsigned char *roots;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &roots, &roots_length),
+        env, "Invalid buffer was passed as roots."
+    );
+
+    size_t nonces_length;
+    const unsigned char *nonces;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &nonces, &nonces_length),
+        env, "Invalid buffer was passed as nonces."
+    );
+
+    const unsigned char *threshold;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_fixed_bytes(env, argv[2], WORK_THRESHOLD_LENGTH, &threshold),
+        env, "Invalid buffer was passed as threshold."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    const size_t count = nonces_length / WORK_NONCE_LENGTH;
+    if (0 != nonces_length % WORK_NONCE_LENGTH || count * WORK_ROOT_LENGTH != roots_length)
+    {
+        napi_throw_error(env, NULL, "The roots and the nonces must match.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "blake2::batch::workValidate";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    work_validate_batch_data_t *batch_data = (work_validate_batch_data_t *)calloc(1, sizeof (work_validate_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->roots = roots;
+    batch_data->nonces = nonces;
+    batch_data->threshold = load64(threshold);
+
+    napi_value js_results;
+    if (napi_ok != napi_create_buffer(env, count, (void **) &batch_data->results, &js_results))
+    {
+        work_validate_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffer.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, WORK_VALIDATE_BATCH_CHUNK_SIZE,
+        work_validate_batch_execute, work_validate_batch_complete, work_validate_batch_finalize, &promise))
+    {
+        work_validate_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[1])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_results))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        work_validate_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_WORK, priority, cancel_token, resource_name);
+
+    return promise;
+}
+
+static bool is_found(work_generate_batch_data_t *batch_data)
+{
+    uv_mutex_lock(&batch_data->mutex);
+    const bool found = batch_data->found;
+    uv_mutex_unlock(&batch_data->mutex);
+
+    return found;
+}
+
+static void work_generate_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    work_generate_batch_data_t *batch_data = (work_generate_batch_data_t *) batch;
+
+    work_vector_t root[4];
+    for (size_t i = 0; i < 4; ++i)
+    {
+        root[i] = VSET1(batch_data->root[i]);
+    }
+
+    const uint64_t start = batch_data->base + chunk->start * batch_data->stride + batch_data->offset;
+
+    uint64_t lane_nonces[WORK_LANES];
+    for (size_t lane = 0; lane < WORK_LANES; ++lane)
+    {
+        lane_nonces[lane] = start + lane;
+    }
+
+    work_vector_t nonces = VLOAD(lane_nonces);
+    const work_vector_t step = VSET1(WORK_LANES);
+
+    for (uint64_t searched = 0; searched < WORK_CANDIDATES_PER_PHASE; searched += WORK_POLL_INTERVAL)
+    {
+        // Another thread has found a nonce, or the search was aborted.
+        if (is_found(batch_data) || signun_task_is_cancelled(&chunk->task))
+        {
+            return;
+        }
+
+        for (uint64_t i = 0; i < WORK_POLL_INTERVAL; i += WORK_LANES)
+        {
+            uint64_t values[WORK_LANES];
+            work_values(root, nonces, values);
+
+            for (size_t lane = 0; lane < WORK_LANES; ++lane)
+            {
+                if (values[lane] < batch_data->threshold)
+                {
+                    continue;
+                }
+
+                uv_mutex_lock(&batch_data->mutex);
+                if (!batch_data->found)
+                {
+                    store64(batch_data->nonce, start + searched + i + lane);
+                    batch_data->found = true;
+                }
+                uv_mutex_unlock(&batch_data->mutex);
+
+                return;
+            }
+
+            nonces = VADD(nonces, step);
+        }
+    }
+}
+
+/*
+ * Moves every thread on to the next nonces of its range, unless one of them
+ * has found a nonce.
+ */
+static size_t work_generate_batch_advance(signun_batch_t *batch)
+{
+    work_generate_batch_data_t *batch_data = (work_generate_batch_data_t *) batch;
+
+    if (is_found(batch_data))
+    {
+        return 0;
+    }
+
+    batch_data->offset += WORK_CANDIDATES_PER_PHASE;
+
+    return batch_data->thread_count;
+}
+
+static napi_status work_generate_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    return signun_batch_get_retained_value(env, batch, 0, result);
+}
+
+static void work_generate_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    work_generate_batch_data_t *batch_data = (work_generate_batch_data_t *) batch;
+
+    uv_mutex_destroy(&batch_data->mutex);
+    free(batch_data);
+}
+
+napi_value blake2_addon_blake2b_work_generate(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value argv[5];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    const unsigned char *root;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_fixed_bytes(env, argv[0], WORK_ROOT_LENGTH, &root),
+        env, "Invalid buffer was passed as root."
+    );
+
+    const unsigned char *threshold;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_fixed_bytes(env, argv[1], WORK_THRESHOLD_LENGTH, &threshold),
+        env, "Invalid buffer was passed as threshold."
+    );
+
+    uint32_t thread_count;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[2], &thread_count),
+        env, "Invalid thread count was passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (0 == thread_count)
+    {
+        napi_throw_error(env, NULL, "Invalid thread count was passed.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "blake2::batch::workGenerate";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    work_generate_batch_data_t *batch_data = (work_generate_batch_data_t *)calloc(1, sizeof (work_generate_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    if (0 != uv_mutex_init(&batch_data->mutex))
+    {
+        free(batch_data);
+        napi_throw_error(env, NULL, "Could not create the mutex.");
+        return NULL;
+    }
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        batch_data->root[i] = load64(&root[8 * i]);
+    }
+
+    batch_data->threshold = load64(threshold);
+    batch_data->thread_count = thread_count;
+    batch_data->stride = UINT64_MAX / thread_count;
+
+    // A random starting point, so that concurrent searches for the same root do not repeat each other.
+    unsigned char base[8];
+    if (0 != uv_random(NULL, NULL, base, sizeof base, 0, NULL))
+    {
+        work_generate_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not generate the starting nonce.");
+        return NULL;
+    }
+
+    batch_data->base = load64(base);
+
+    napi_value js_nonce;
+    if (napi_ok != napi_create_buffer(env, WORK_NONCE_LENGTH, (void **) &batch_data->nonce, &js_nonce))
+    {
+        work_generate_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffer.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, thread_count, 1,
+        work_generate_batch_execute, work_generate_batch_complete, work_generate_batch_finalize, &promise))
+    {
+        work_generate_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    signun_batch_set_advance(&batch_data->batch, work_generate_batch_advance, resource_identifier);
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, js_nonce))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        work_generate_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_WORK, priority, cancel_token, resource_name);
+
+    return promise;
+}
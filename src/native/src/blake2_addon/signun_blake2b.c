@@ -5,19 +5,31 @@
 
 #include "blake2.h"
 
+#include "signun_pool.h"
+#include "signun_scheduler.h"
 #include "signun_util.h"
 
 
 #define BLAKE2B_MAX_HASH_LENGTH 64
 #define BLAKE2B_MAX_KEY_LENGTH 64
 
+// Strings up to this length are encoded into the callback data itself.
+#define HASH_SCRATCH_LENGTH 512
+
+#define HASH_POOL_HIGH_WATER_MARK 256
+#define KEYED_HASH_POOL_HIGH_WATER_MARK 256
+
 typedef struct
 {
+    signun_task_t task;
+
     napi_deferred deferred;
-    napi_async_work async_work;
 
-    unsigned int data_length;
+    size_t data_length;
     unsigned char *data;
+    unsigned char *allocated_data;
+    napi_ref data_ref;
+    unsigned char scratch[HASH_SCRATCH_LENGTH];
 
     unsigned int hash_length;
     unsigned char hash[BLAKE2B_MAX_HASH_LENGTH];
@@ -27,13 +39,17 @@ typedef struct
 
 typedef struct
 {
+    signun_task_t task;
+
     napi_deferred deferred;
-    napi_async_work async_work;
 
-    unsigned int data_length;
+    size_t data_length;
     unsigned char *data;
+    unsigned char *allocated_data;
+    napi_ref data_ref;
+    unsigned char scratch[HASH_SCRATCH_LENGTH];
 
-    unsigned int key_length;
+    size_t key_length;
     unsigned char key[BLAKE2B_MAX_KEY_LENGTH];
 
     unsigned int hash_length;
@@ -42,6 +58,66 @@ typedef struct
     int result;
 } keyed_hash_callback_data_t;
 
+static const signun_pool_t hash_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_HASH, hash_callback_data_t, HASH_POOL_HIGH_WATER_MARK, false);
+static const signun_pool_t keyed_hash_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_KEYED_HASH, keyed_hash_callback_data_t, KEYED_HASH_POOL_HIGH_WATER_MARK, true);
+
+static void release_hash_callback_data(napi_env env, hash_callback_data_t *callback_data)
+{
+    signun_unpin_bytes(env, &callback_data->data_ref);
+
+    free(callback_data->allocated_data);
+    callback_data->allocated_data = NULL;
+
+    signun_pool_release(env, &hash_callback_data_pool, callback_data);
+}
+
+static void release_keyed_hash_callback_data(napi_env env, keyed_hash_callback_data_t *callback_data)
+{
+    signun_unpin_bytes(env, &callback_data->data_ref);
+
+    if (callback_data->allocated_data)
+    {
+        signun_secure_zero(callback_data->allocated_data, callback_data->data_length);
+        free(callback_data->allocated_data);
+        callback_data->allocated_data = NULL;
+    }
+
+    signun_pool_release(env, &keyed_hash_callback_data_pool, callback_data);
+}
+
+int blake2_addon_blake2b_personal(unsigned char *output, size_t output_length, const unsigned char *personal, size_t personal_length,
+    const void *data, size_t data_length)
+{
+    if (0 == output_length || BLAKE2B_MAX_HASH_LENGTH < output_length || BLAKE2B_PERSONAL_LENGTH < personal_length)
+    {
+        return -1;
+    }
+
+    blake2b_param parameters;
+    memset(&parameters, 0, sizeof (blake2b_param));
+    parameters.digest_length = (uint8_t) output_length;
+    parameters.fanout = 1;
+    parameters.depth = 1;
+    if (personal_length)
+    {
+        memcpy(parameters.personal, personal, personal_length);
+    }
+
+    blake2b_state state;
+    int result = blake2b_init_param(&state, &parameters);
+    if (0 == result)
+    {
+        result = blake2b_update(&state, data, data_length);
+    }
+
+    if (0 == result)
+    {
+        result = blake2b_final(&state, output, output_length);
+    }
+
+    return result;
+}
+
 static void hash_async_execute(napi_env env, void *data)
 {
     hash_callback_data_t *callback_data = (hash_callback_data_t *) data;
@@ -55,11 +131,20 @@ static void hash_async_complete(napi_env env, napi_status status, void *data)
 {
     hash_callback_data_t *callback_data = (hash_callback_data_t *) data;
 
-    if (napi_ok != napi_delete_async_work(env, callback_data->async_work))
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
     {
         REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
 
-        free(callback_data);
+        release_hash_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        release_hash_callback_data(env, callback_data);
 
         return;
     }
@@ -68,7 +153,7 @@ static void hash_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
 
-        free(callback_data);
+        release_hash_callback_data(env, callback_data);
 
         return;
     }
@@ -77,7 +162,7 @@ static void hash_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "Could not compute hash.", callback_data->deferred);
 
-        free(callback_data);
+        release_hash_callback_data(env, callback_data);
 
         return;
     }
@@ -87,41 +172,41 @@ static void hash_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "Could not set the result buffer.", callback_data->deferred);
 
-        free(callback_data);
+        release_hash_callback_data(env, callback_data);
 
         return;
     }
 
     napi_resolve_deferred(env, callback_data->deferred, js_result);
 
-    free(callback_data);
+    release_hash_callback_data(env, callback_data);
 }
 
 napi_value blake2_addon_blake2b_hash_async(napi_env env, napi_callback_info info)
 {
-    size_t argc = 3;
-    napi_value argv[3];
+    size_t argc = 4;
+    napi_value argv[4];
     THROW_AND_RETURN_NULL_ON_FAILURE(
         napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
         env, "Could not read function arguments."
     );
 
-    unsigned char *data;
+    unsigned int hash_length;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[0], (void **) &data, NULL),
-        env, "Invalid buffer was passed as data."
+        napi_get_value_uint32(env, argv[1], &hash_length),
+        env, "Invalid hash length was passed."
     );
 
-    unsigned int data_length;
+    signun_priority_t priority;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_value_uint32(env, argv[1], &data_length),
-        env, "Invalid data length was passed."
+        signun_get_priority(env, argv[2], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
     );
 
-    unsigned int hash_length;
+    signun_cancel_token_t *cancel_token;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_value_uint32(env, argv[2], &hash_length),
-        env, "Invalid hash length was passed."
+        signun_get_cancel_token(env, argv[3], &cancel_token),
+        env, "Invalid cancel token was passed."
     );
 
     const char *resource_identifier = "blake2::async::hash";
@@ -131,35 +216,55 @@ napi_value blake2_addon_blake2b_hash_async(napi_env env, napi_callback_info info
         env, "Could not create resource name."
     );
 
-    hash_callback_data_t *hash_callback_data = (hash_callback_data_t *)malloc(sizeof (hash_callback_data_t));
+    hash_callback_data_t *hash_callback_data = signun_pool_acquire(env, &hash_callback_data_pool);
+    if (!hash_callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+    hash_callback_data->data_ref = NULL;
+
+    if (napi_ok != signun_get_bytes_or_string(env, argv[0], hash_callback_data->scratch, HASH_SCRATCH_LENGTH,
+        &hash_callback_data->data, &hash_callback_data->data_length, &hash_callback_data->allocated_data)
+        || napi_ok != signun_pin_bytes(env, argv[0], &hash_callback_data->data_ref))
+    {
+        release_hash_callback_data(env, hash_callback_data);
+        napi_throw_error(env, NULL, "Invalid buffer was passed as data.");
+        return NULL;
+    }
 
-    hash_callback_data->data_length = data_length;
-    hash_callback_data->data = data;
     hash_callback_data->hash_length = hash_length;
 
     napi_value promise;
     if (napi_ok != napi_create_promise(env, &hash_callback_data->deferred, &promise))
     {
-        free(hash_callback_data);
+        release_hash_callback_data(env, hash_callback_data);
         napi_throw_error(env, NULL, "Could not create result promise.");
         return NULL;
     }
 
-    napi_async_work hash_async_work;
-    if (napi_ok != napi_create_async_work(env, NULL, hash_resource_name, hash_async_execute, hash_async_complete, hash_callback_data, &hash_async_work))
+    if (napi_ok != signun_task_create(env, &hash_callback_data->task, SIGNUN_OP_HASH, priority, cancel_token, hash_resource_name, hash_async_execute, hash_async_complete))
     {
         REJECT_WITH_ERROR(env, "Could not create async work.", hash_callback_data->deferred);
-        free(hash_callback_data);
+        release_hash_callback_data(env, hash_callback_data);
         return promise;
     }
 
-    hash_callback_data->async_work = hash_async_work;
+    napi_async_work hash_async_work = hash_callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &hash_callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", hash_callback_data->deferred);
+        release_hash_callback_data(env, hash_callback_data);
+        napi_delete_async_work(env, hash_async_work);
+        return promise;
+    }
 
-    napi_status queue_status = napi_queue_async_work(env, hash_async_work);
     if (napi_ok != queue_status)
     {
         REJECT_WITH_ERROR(env, "Could not queue async work.", hash_callback_data->deferred);
-        free(hash_callback_data);
+        release_hash_callback_data(env, hash_callback_data);
         napi_delete_async_work(env, hash_async_work);
         return promise;
     }
@@ -180,11 +285,20 @@ static void keyed_hash_async_complete(napi_env env, napi_status status, void *da
 {
     keyed_hash_callback_data_t *callback_data = (keyed_hash_callback_data_t *) data;
 
-    if (napi_ok != napi_delete_async_work(env, callback_data->async_work))
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
     {
         REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
 
-        free(callback_data);
+        release_keyed_hash_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        release_keyed_hash_callback_data(env, callback_data);
 
         return;
     }
@@ -193,7 +307,7 @@ static void keyed_hash_async_complete(napi_env env, napi_status status, void *da
     {
         REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
 
-        free(callback_data);
+        release_keyed_hash_callback_data(env, callback_data);
 
         return;
     }
@@ -202,7 +316,7 @@ static void keyed_hash_async_complete(napi_env env, napi_status status, void *da
     {
         REJECT_WITH_ERROR(env, "Could not compute hash.", callback_data->deferred);
 
-        free(callback_data);
+        release_keyed_hash_callback_data(env, callback_data);
 
         return;
     }
@@ -212,14 +326,14 @@ static void keyed_hash_async_complete(napi_env env, napi_status status, void *da
     {
         REJECT_WITH_ERROR(env, "Could not set the result buffer.", callback_data->deferred);
 
-        free(callback_data);
+        release_keyed_hash_callback_data(env, callback_data);
 
         return;
     }
 
     napi_resolve_deferred(env, callback_data->deferred, js_result);
 
-    free(callback_data);
+    release_keyed_hash_callback_data(env, callback_data);
 }
 
 napi_value blake2_addon_blake2b_keyed_hash_async(napi_env env, napi_callback_info info)
@@ -231,35 +345,36 @@ napi_value blake2_addon_blake2b_keyed_hash_async(napi_env env, napi_callback_inf
         env, "Could not read function arguments."
     );
 
-    unsigned char *data;
+    size_t key_length;
+    unsigned char *key;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[0], (void **) &data, NULL),
-        env, "Invalid buffer was passed as data."
+        signun_get_bytes(env, argv[1], (void **) &key, &key_length),
+        env, "Invalid buffer was passed as key."
     );
 
-    unsigned int data_length;
+    unsigned int hash_length;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_value_uint32(env, argv[1], &data_length),
-        env, "Invalid data length was passed."
+        napi_get_value_uint32(env, argv[2], &hash_length),
+        env, "Invalid hash length was passed."
     );
 
-    unsigned char *key;
+    signun_priority_t priority;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[2], (void **) &key, NULL),
-        env, "Invalid buffer was passed as key."
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
     );
 
-    unsigned int key_length;
+    signun_cancel_token_t *cancel_token;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_value_uint32(env, argv[3], &key_length),
-        env, "Invalid data length was passed."
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
     );
 
-    unsigned int hash_length;
-    THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_value_uint32(env, argv[4], &hash_length),
-        env, "Invalid hash length was passed."
-    );
+    if (BLAKE2B_MAX_KEY_LENGTH < key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid key length.");
+        return NULL;
+    }
 
     const char *resource_identifier = "blake2::async::keyed_hash";
     napi_value keyed_hash_resource_name;
@@ -268,10 +383,23 @@ napi_value blake2_addon_blake2b_keyed_hash_async(napi_env env, napi_callback_inf
         env, "Could not create resource name."
     );
 
-    keyed_hash_callback_data_t *keyed_hash_callback_data = (keyed_hash_callback_data_t *)malloc(sizeof (keyed_hash_callback_data_t));
+    keyed_hash_callback_data_t *keyed_hash_callback_data = signun_pool_acquire(env, &keyed_hash_callback_data_pool);
+    if (!keyed_hash_callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+    keyed_hash_callback_data->data_ref = NULL;
+
+    if (napi_ok != signun_get_bytes_or_string(env, argv[0], keyed_hash_callback_data->scratch, HASH_SCRATCH_LENGTH,
+        &keyed_hash_callback_data->data, &keyed_hash_callback_data->data_length, &keyed_hash_callback_data->allocated_data)
+        || napi_ok != signun_pin_bytes(env, argv[0], &keyed_hash_callback_data->data_ref))
+    {
+        release_keyed_hash_callback_data(env, keyed_hash_callback_data);
+        napi_throw_error(env, NULL, "Invalid buffer was passed as data.");
+        return NULL;
+    }
 
-    keyed_hash_callback_data->data_length = data_length;
-    keyed_hash_callback_data->data = data;
     keyed_hash_callback_data->key_length = key_length;
     memcpy(keyed_hash_callback_data->key, key, key_length);
     keyed_hash_callback_data->hash_length = hash_length;
@@ -279,26 +407,33 @@ napi_value blake2_addon_blake2b_keyed_hash_async(napi_env env, napi_callback_inf
     napi_value promise;
     if (napi_ok != napi_create_promise(env, &keyed_hash_callback_data->deferred, &promise))
     {
-        free(keyed_hash_callback_data);
+        release_keyed_hash_callback_data(env, keyed_hash_callback_data);
         napi_throw_error(env, NULL, "Could not create result promise.");
         return NULL;
     }
 
-    napi_async_work keyed_hash_async_work;
-    if (napi_ok != napi_create_async_work(env, NULL, keyed_hash_resource_name, keyed_hash_async_execute, keyed_hash_async_complete, keyed_hash_callback_data, &keyed_hash_async_work))
+    if (napi_ok != signun_task_create(env, &keyed_hash_callback_data->task, SIGNUN_OP_KEYED_HASH, priority, cancel_token, keyed_hash_resource_name, keyed_hash_async_execute, keyed_hash_async_complete))
     {
         REJECT_WITH_ERROR(env, "Could not create async work.", keyed_hash_callback_data->deferred);
-        free(keyed_hash_callback_data);
+        release_keyed_hash_callback_data(env, keyed_hash_callback_data);
         return promise;
     }
 
-    keyed_hash_callback_data->async_work = keyed_hash_async_work;
+    napi_async_work keyed_hash_async_work = keyed_hash_callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &keyed_hash_callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", keyed_hash_callback_data->deferred);
+        release_keyed_hash_callback_data(env, keyed_hash_callback_data);
+        napi_delete_async_work(env, keyed_hash_async_work);
+        return promise;
+    }
 
-    napi_status queue_status = napi_queue_async_work(env, keyed_hash_async_work);
     if (napi_ok != queue_status)
     {
         REJECT_WITH_ERROR(env, "Could not queue async work.", keyed_hash_callback_data->deferred);
-        free(keyed_hash_callback_data);
+        release_keyed_hash_callback_data(env, keyed_hash_callback_data);
         napi_delete_async_work(env, keyed_hash_async_work);
         return promise;
     }
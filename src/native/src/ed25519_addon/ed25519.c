@@ -0,0 +1,253 @@
+#include "ed25519_addon/ed25519.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "blake2.h"
+#include "crypto/curve25519/internal.h"
+
+#include "signun_sha512.h"
+#include "signun_util.h"
+
+
+#define HASH_LENGTH 64
+
+/*
+ * The field, group and scalar arithmetic is BoringSSL's ref10 / fiat-crypto
+ * curve25519 as vendored by ring, in dependencies/curve25519. ring declares
+ * these exports on the Rust side only, hence the prototypes here.
+ */
+void x25519_fe_invert(fe *out, const fe *z);
+uint8_t x25519_fe_isnegative(const fe *f);
+void x25519_fe_mul_ttt(fe *h, const fe *f, const fe *g);
+void x25519_fe_neg(fe *f);
+void x25519_fe_tobytes(uint8_t s[32], const fe *h);
+int x25519_ge_frombytes_vartime(ge_p3 *h, const uint8_t s[32]);
+void x25519_ge_scalarmult_base(ge_p3 *h, const uint8_t a[32], int use_adx);
+void x25519_ge_double_scalarmult_vartime(ge_p2 *r, const uint8_t *a, const ge_p3 *A, const uint8_t *b);
+void x25519_sc_reduce(uint8_t s[64]);
+void x25519_sc_muladd(uint8_t *s, const uint8_t *a, const uint8_t *b, const uint8_t *c);
+
+typedef struct
+{
+    ed25519_addon_hash_type_t type;
+
+    union
+    {
+        blake2b_state blake2b;
+        signun_sha512_t sha512;
+    } state;
+} hash_t;
+
+// The order of the base point, 2^252 + 27742317777372353535851937790883648493.
+static const unsigned char L[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+
+/*
+ * Encodes x = X / Z, y = Y / Z as y with the sign of x in its top bit. Takes
+ * the coordinates apart, as ge_p2 and ge_p3 only share their layout.
+ */
+static void encode_point(unsigned char *s, const fe *X, const fe *Y, const fe *Z)
+{
+    fe recip, x, y;
+
+    x25519_fe_invert(&recip, Z);
+    x25519_fe_mul_ttt(&x, X, &recip);
+    x25519_fe_mul_ttt(&y, Y, &recip);
+
+    x25519_fe_tobytes(s, &y);
+    s[31] ^= (unsigned char) (x25519_fe_isnegative(&x) << 7);
+}
+
+/*
+ * Decodes a point as specified by RFC 8032, which on top of what the vendored
+ * decoder checks rejects y >= p and a negative zero x.
+ */
+static bool decode_point(ge_p3 *h, const unsigned char *s)
+{
+    if (!x25519_ge_frombytes_vartime(h, s))
+    {
+        return false;
+    }
+
+    unsigned char canonical[32];
+    x25519_fe_tobytes(canonical, &h->Y);
+    if (0 != memcmp(canonical, s, 31) || canonical[31] != (s[31] & 0x7f))
+    {
+        return false;
+    }
+
+    if (s[31] >> 7)
+    {
+        unsigned char x[32];
+        x25519_fe_tobytes(x, &h->X);
+
+        unsigned char bits = 0;
+        for (int i = 0; i < 32; ++i)
+        {
+            bits |= x[i];
+        }
+
+        if (0 == bits)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool sc_is_canonical(const unsigned char *s)
+{
+    for (int i = 31; i >= 0; --i)
+    {
+        if (s[i] != L[i])
+        {
+            return s[i] < L[i];
+        }
+    }
+
+    return false;
+}
+
+static void hash_init(hash_t *hash, ed25519_addon_hash_type_t type)
+{
+    hash->type = type;
+
+    if (ED25519_HASH_SHA512 == type)
+    {
+        signun_sha512_init(&hash->state.sha512);
+    }
+    else
+    {
+        blake2b_init(&hash->state.blake2b, HASH_LENGTH);
+    }
+}
+
+static void hash_update(hash_t *hash, const unsigned char *data, size_t length)
+{
+    if (ED25519_HASH_SHA512 == hash->type)
+    {
+        signun_sha512_update(&hash->state.sha512, data, length);
+    }
+    else
+    {
+        blake2b_update(&hash->state.blake2b, data, length);
+    }
+}
+
+static void hash_final(hash_t *hash, unsigned char *digest)
+{
+    if (ED25519_HASH_SHA512 == hash->type)
+    {
+        signun_sha512_final(&hash->state.sha512, digest);
+    }
+    else
+    {
+        blake2b_final(&hash->state.blake2b, digest, HASH_LENGTH);
+        signun_secure_zero(&hash->state.blake2b, sizeof (blake2b_state));
+    }
+}
+
+/*
+ * Hashes the seed into the clamped secret scalar and the nonce prefix.
+ */
+static void expand_seed(unsigned char *expanded, const unsigned char *seed, ed25519_addon_hash_type_t hash_type)
+{
+    hash_t hash;
+    hash_init(&hash, hash_type);
+    hash_update(&hash, seed, ED25519_SEED_LENGTH);
+    hash_final(&hash, expanded);
+
+    expanded[0] &= 248;
+    expanded[31] &= 127;
+    expanded[31] |= 64;
+}
+
+void ed25519_addon_public_key_create(unsigned char *public_key, const unsigned char *seed, ed25519_addon_hash_type_t hash_type)
+{
+    unsigned char expanded[HASH_LENGTH];
+    expand_seed(expanded, seed, hash_type);
+
+    ge_p3 a;
+    x25519_ge_scalarmult_base(&a, expanded, 0);
+    encode_point(public_key, &a.X, &a.Y, &a.Z);
+
+    signun_secure_zero(expanded, HASH_LENGTH);
+}
+
+void ed25519_addon_sign(unsigned char *signature, const unsigned char *message, size_t message_length,
+    const unsigned char *seed, ed25519_addon_hash_type_t hash_type)
+{
+    unsigned char expanded[HASH_LENGTH];
+    expand_seed(expanded, seed, hash_type);
+
+    ge_p3 point;
+    unsigned char public_key[ED25519_PUBLIC_KEY_LENGTH];
+    x25519_ge_scalarmult_base(&point, expanded, 0);
+    encode_point(public_key, &point.X, &point.Y, &point.Z);
+
+    // r = H(prefix || M) mod L, R = r * B
+    hash_t hash;
+    unsigned char nonce[HASH_LENGTH];
+    hash_init(&hash, hash_type);
+    hash_update(&hash, &expanded[32], 32);
+    hash_update(&hash, message, message_length);
+    hash_final(&hash, nonce);
+    x25519_sc_reduce(nonce);
+
+    x25519_ge_scalarmult_base(&point, nonce, 0);
+    encode_point(signature, &point.X, &point.Y, &point.Z);
+
+    // k = H(R || A || M) mod L, S = (k * a + r) mod L
+    unsigned char challenge[HASH_LENGTH];
+    hash_init(&hash, hash_type);
+    hash_update(&hash, signature, 32);
+    hash_update(&hash, public_key, ED25519_PUBLIC_KEY_LENGTH);
+    hash_update(&hash, message, message_length);
+    hash_final(&hash, challenge);
+    x25519_sc_reduce(challenge);
+
+    x25519_sc_muladd(&signature[32], challenge, expanded, nonce);
+
+    signun_secure_zero(expanded, HASH_LENGTH);
+    signun_secure_zero(nonce, HASH_LENGTH);
+}
+
+bool ed25519_addon_verify(const unsigned char *signature, const unsigned char *message, size_t message_length,
+    const unsigned char *public_key, ed25519_addon_hash_type_t hash_type)
+{
+    if (!sc_is_canonical(&signature[32]))
+    {
+        return false;
+    }
+
+    ge_p3 a;
+    if (!decode_point(&a, public_key))
+    {
+        return false;
+    }
+
+    hash_t hash;
+    unsigned char challenge[HASH_LENGTH];
+    hash_init(&hash, hash_type);
+    hash_update(&hash, signature, 32);
+    hash_update(&hash, public_key, ED25519_PUBLIC_KEY_LENGTH);
+    hash_update(&hash, message, message_length);
+    hash_final(&hash, challenge);
+    x25519_sc_reduce(challenge);
+
+    // R' = k * (-A) + S * B, which has to encode to R.
+    x25519_fe_neg(&a.X);
+    x25519_fe_neg(&a.T);
+
+    ge_p2 r;
+    x25519_ge_double_scalarmult_vartime(&r, challenge, &a, &signature[32]);
+
+    unsigned char encoded_r[32];
+    encode_point(encoded_r, &r.X, &r.Y, &r.Z);
+
+    return 0 == memcmp(encoded_r, signature, 32);
+}
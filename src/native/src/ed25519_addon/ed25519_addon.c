@@ -0,0 +1,32 @@
+#include "ed25519_addon/ed25519_addon.h"
+
+#include "signun_util.h"
+#include "ed25519_addon/public_key_create.h"
+#include "ed25519_addon/sign.h"
+#include "ed25519_addon/verify.h"
+
+
+napi_status create_ed25519_addon(napi_env env, napi_value base)
+{
+    napi_value addon;
+
+    RETURN_ON_FAILURE(napi_create_object(env, &addon));
+
+    const size_t property_count = 7;
+    napi_property_descriptor properties[] = {
+        DECLARE_NAPI_METHOD("publicKeyCreateSync", ed25519_addon_public_key_create_sync, NULL),
+        DECLARE_NAPI_METHOD("signSync", ed25519_addon_sign_sync, NULL),
+        DECLARE_NAPI_METHOD("verifySync", ed25519_addon_verify_sync, NULL),
+
+        DECLARE_NAPI_METHOD("publicKeyCreate", ed25519_addon_public_key_create_async, NULL),
+        DECLARE_NAPI_METHOD("sign", ed25519_addon_sign_async, NULL),
+        DECLARE_NAPI_METHOD("verify", ed25519_addon_verify_async, NULL),
+
+        DECLARE_NAPI_METHOD("verifyBatch", ed25519_addon_verify_batch, NULL)
+    };
+
+    RETURN_ON_FAILURE(napi_define_properties(env, addon, property_count, properties));
+    RETURN_ON_FAILURE(napi_set_named_property(env, base, "ed25519", addon));
+
+    return napi_ok;
+}
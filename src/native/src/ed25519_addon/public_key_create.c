@@ -0,0 +1,214 @@
+#include "ed25519_addon/public_key_create.h"
+
+#include <string.h>
+
+#include "signun_pool.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+#include "ed25519_addon/ed25519.h"
+#include "ed25519_addon/util.h"
+
+
+#define PUBLIC_KEY_CREATE_POOL_HIGH_WATER_MARK 256
+
+typedef struct
+{
+    signun_task_t task;
+
+    napi_deferred deferred;
+
+    unsigned char seed[ED25519_SEED_LENGTH];
+    ed25519_addon_hash_type_t hash_type;
+
+    unsigned char public_key[ED25519_PUBLIC_KEY_LENGTH];
+} public_key_create_callback_data_t;
+
+static const signun_pool_t public_key_create_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_ED25519_PUBLIC_KEY_CREATE, public_key_create_callback_data_t, PUBLIC_KEY_CREATE_POOL_HIGH_WATER_MARK, true);
+
+napi_value ed25519_addon_public_key_create_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    size_t seed_length;
+    const unsigned char *seed;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &seed, &seed_length),
+        env, "Invalid buffer was passed as a seed."
+    );
+
+    ed25519_addon_hash_type_t hash_type;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        ed25519_addon_get_hash_type(env, argv[1], &hash_type),
+        env, "Invalid hash was passed."
+    );
+
+    if (ED25519_SEED_LENGTH != seed_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    unsigned char public_key[ED25519_PUBLIC_KEY_LENGTH];
+    ed25519_addon_public_key_create(public_key, seed, hash_type);
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer_copy(env, ED25519_PUBLIC_KEY_LENGTH, (void *)public_key, NULL, &js_result),
+        env, "Could not set the result buffer."
+    );
+
+    return js_result;
+}
+
+static void public_key_create_async_execute(napi_env env, void *data)
+{
+    public_key_create_callback_data_t *callback_data = (public_key_create_callback_data_t *) data;
+
+    ed25519_addon_public_key_create(callback_data->public_key, callback_data->seed, callback_data->hash_type);
+}
+
+static void public_key_create_async_complete(napi_env env, napi_status status, void *data)
+{
+    public_key_create_callback_data_t *callback_data = (public_key_create_callback_data_t *) data;
+
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
+    {
+        REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
+
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_ok != status)
+    {
+        REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
+
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    napi_value js_result;
+    if (napi_ok != napi_create_buffer_copy(env, ED25519_PUBLIC_KEY_LENGTH, (void *)callback_data->public_key, NULL, &js_result))
+    {
+        REJECT_WITH_ERROR(env, "Could not set the result buffer.", callback_data->deferred);
+
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    napi_resolve_deferred(env, callback_data->deferred, js_result);
+
+    signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
+}
+
+napi_value ed25519_addon_public_key_create_async(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value argv[4];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    size_t seed_length;
+    const unsigned char *seed;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &seed, &seed_length),
+        env, "Invalid buffer was passed as a seed."
+    );
+
+    ed25519_addon_hash_type_t hash_type;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        ed25519_addon_get_hash_type(env, argv[1], &hash_type),
+        env, "Invalid hash was passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[2], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[3], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (ED25519_SEED_LENGTH != seed_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "ed25519::async::createPublicKey";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    public_key_create_callback_data_t *callback_data = signun_pool_acquire(env, &public_key_create_callback_data_pool);
+    if (!callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+
+    callback_data->hash_type = hash_type;
+    memcpy(callback_data->seed, seed, ED25519_SEED_LENGTH);
+
+    napi_value promise;
+    if (napi_ok != napi_create_promise(env, &callback_data->deferred, &promise))
+    {
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_task_create(env, &callback_data->task, SIGNUN_OP_PUBLIC_KEY_CREATE, priority, cancel_token, resource_name,
+        public_key_create_async_execute, public_key_create_async_complete))
+    {
+        REJECT_WITH_ERROR(env, "Could not create async work.", callback_data->deferred);
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
+        return promise;
+    }
+
+    napi_async_work async_work = callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", callback_data->deferred);
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    if (napi_ok != queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Could not queue async work.", callback_data->deferred);
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    return promise;
+}
@@ -0,0 +1,254 @@
+#include "ed25519_addon/sign.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "signun_pool.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+#include "ed25519_addon/ed25519.h"
+#include "ed25519_addon/util.h"
+
+
+#define SIGN_POOL_HIGH_WATER_MARK 256
+
+typedef struct
+{
+    signun_task_t task;
+
+    napi_deferred deferred;
+
+    size_t message_length;
+    unsigned char *message;
+    unsigned char *allocated_message;
+    napi_ref message_ref;
+    unsigned char scratch[ED25519_MESSAGE_SCRATCH_LENGTH];
+
+    unsigned char seed[ED25519_SEED_LENGTH];
+    ed25519_addon_hash_type_t hash_type;
+
+    unsigned char signature[ED25519_SIGNATURE_LENGTH];
+} sign_callback_data_t;
+
+static const signun_pool_t sign_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_ED25519_SIGN, sign_callback_data_t, SIGN_POOL_HIGH_WATER_MARK, true);
+
+static void release_sign_callback_data(napi_env env, sign_callback_data_t *callback_data)
+{
+    signun_unpin_bytes(env, &callback_data->message_ref);
+
+    free(callback_data->allocated_message);
+    callback_data->allocated_message = NULL;
+
+    signun_pool_release(env, &sign_callback_data_pool, callback_data);
+}
+
+napi_value ed25519_addon_sign_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value argv[3];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    size_t seed_length;
+    const unsigned char *seed;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &seed, &seed_length),
+        env, "Invalid buffer was passed as a seed."
+    );
+
+    ed25519_addon_hash_type_t hash_type;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        ed25519_addon_get_hash_type(env, argv[2], &hash_type),
+        env, "Invalid hash was passed."
+    );
+
+    if (ED25519_SEED_LENGTH != seed_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    unsigned char scratch[ED25519_MESSAGE_SCRATCH_LENGTH];
+    size_t message_length;
+    unsigned char *message;
+    unsigned char *allocated_message;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes_or_string(env, argv[0], scratch, ED25519_MESSAGE_SCRATCH_LENGTH, &message, &message_length, &allocated_message),
+        env, "Invalid buffer was passed as message."
+    );
+
+    unsigned char signature[ED25519_SIGNATURE_LENGTH];
+    ed25519_addon_sign(signature, message, message_length, seed, hash_type);
+    free(allocated_message);
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer_copy(env, ED25519_SIGNATURE_LENGTH, (void *)signature, NULL, &js_result),
+        env, "Could not set the result buffer."
+    );
+
+    return js_result;
+}
+
+static void sign_async_execute(napi_env env, void *data)
+{
+    sign_callback_data_t *callback_data = (sign_callback_data_t *) data;
+
+    ed25519_addon_sign(callback_data->signature, callback_data->message, callback_data->message_length,
+        callback_data->seed, callback_data->hash_type);
+}
+
+static void sign_async_complete(napi_env env, napi_status status, void *data)
+{
+    sign_callback_data_t *callback_data = (sign_callback_data_t *) data;
+
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
+    {
+        REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
+
+        release_sign_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        release_sign_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_ok != status)
+    {
+        REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
+
+        release_sign_callback_data(env, callback_data);
+
+        return;
+    }
+
+    napi_value js_result;
+    if (napi_ok != napi_create_buffer_copy(env, ED25519_SIGNATURE_LENGTH, (void *)callback_data->signature, NULL, &js_result))
+    {
+        REJECT_WITH_ERROR(env, "Could not set the result buffer.", callback_data->deferred);
+
+        release_sign_callback_data(env, callback_data);
+
+        return;
+    }
+
+    napi_resolve_deferred(env, callback_data->deferred, js_result);
+
+    release_sign_callback_data(env, callback_data);
+}
+
+napi_value ed25519_addon_sign_async(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value argv[5];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    size_t seed_length;
+    const unsigned char *seed;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &seed, &seed_length),
+        env, "Invalid buffer was passed as a seed."
+    );
+
+    ed25519_addon_hash_type_t hash_type;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        ed25519_addon_get_hash_type(env, argv[2], &hash_type),
+        env, "Invalid hash was passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (ED25519_SEED_LENGTH != seed_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "ed25519::async::sign";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    sign_callback_data_t *callback_data = signun_pool_acquire(env, &sign_callback_data_pool);
+    if (!callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+
+    callback_data->allocated_message = NULL;
+    callback_data->message_ref = NULL;
+
+    if (napi_ok != signun_get_bytes_or_string(env, argv[0], callback_data->scratch, ED25519_MESSAGE_SCRATCH_LENGTH,
+        &callback_data->message, &callback_data->message_length, &callback_data->allocated_message)
+        || napi_ok != signun_pin_bytes(env, argv[0], &callback_data->message_ref))
+    {
+        release_sign_callback_data(env, callback_data);
+        napi_throw_error(env, NULL, "Invalid buffer was passed as message.");
+        return NULL;
+    }
+
+    callback_data->hash_type = hash_type;
+    memcpy(callback_data->seed, seed, ED25519_SEED_LENGTH);
+
+    napi_value promise;
+    if (napi_ok != napi_create_promise(env, &callback_data->deferred, &promise))
+    {
+        release_sign_callback_data(env, callback_data);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_task_create(env, &callback_data->task, SIGNUN_OP_SIGN, priority, cancel_token, resource_name,
+        sign_async_execute, sign_async_complete))
+    {
+        REJECT_WITH_ERROR(env, "Could not create async work.", callback_data->deferred);
+        release_sign_callback_data(env, callback_data);
+        return promise;
+    }
+
+    napi_async_work async_work = callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", callback_data->deferred);
+        release_sign_callback_data(env, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    if (napi_ok != queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Could not queue async work.", callback_data->deferred);
+        release_sign_callback_data(env, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    return promise;
+}
@@ -0,0 +1,21 @@
+#include "ed25519_addon/util.h"
+
+#include <stdint.h>
+
+#include "signun_util.h"
+
+
+napi_status ed25519_addon_get_hash_type(napi_env env, napi_value value, ed25519_addon_hash_type_t *hash_type)
+{
+    uint32_t raw_hash_type;
+    RETURN_ON_FAILURE(napi_get_value_uint32(env, value, &raw_hash_type));
+
+    if (ED25519_HASH_TYPE_COUNT <= raw_hash_type)
+    {
+        return napi_invalid_arg;
+    }
+
+    *hash_type = (ed25519_addon_hash_type_t) raw_hash_type;
+
+    return napi_ok;
+}
@@ -0,0 +1,429 @@
+#include "ed25519_addon/verify.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "signun_batch.h"
+#include "signun_pool.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+#include "ed25519_addon/ed25519.h"
+#include "ed25519_addon/util.h"
+
+
+#define VERIFY_POOL_HIGH_WATER_MARK 256
+
+// A portable Ed25519 verification takes a few times as long as one of
+// secp256k1, so the chunks are smaller to keep cancellation as responsive.
+#define VERIFY_BATCH_CHUNK_SIZE 32
+
+typedef struct
+{
+    signun_task_t task;
+
+    napi_deferred deferred;
+
+    size_t message_length;
+    unsigned char *message;
+    unsigned char *allocated_message;
+    napi_ref message_ref;
+    unsigned char scratch[ED25519_MESSAGE_SCRATCH_LENGTH];
+
+    unsigned char signature[ED25519_SIGNATURE_LENGTH];
+    unsigned char public_key[ED25519_PUBLIC_KEY_LENGTH];
+    ed25519_addon_hash_type_t hash_type;
+
+    bool result;
+} verify_callback_data_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+
+    // count + 1 offsets into messages, message i spans [offsets[i], offsets[i + 1]).
+    const unsigned char *messages;
+    const uint32_t *offsets;
+
+    const unsigned char *signatures;
+    const unsigned char *public_keys;
+    ed25519_addon_hash_type_t hash_type;
+
+    unsigned char *results;
+} verify_batch_data_t;
+
+static const signun_pool_t verify_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_ED25519_VERIFY, verify_callback_data_t, VERIFY_POOL_HIGH_WATER_MARK, false);
+
+static void release_verify_callback_data(napi_env env, verify_callback_data_t *callback_data)
+{
+    signun_unpin_bytes(env, &callback_data->message_ref);
+
+    free(callback_data->allocated_message);
+    callback_data->allocated_message = NULL;
+
+    signun_pool_release(env, &verify_callback_data_pool, callback_data);
+}
+
+napi_value ed25519_addon_verify_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value argv[4];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    size_t signature_length;
+    const unsigned char *signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &signature, &signature_length),
+        env, "Invalid buffer was passed as signature."
+    );
+
+    size_t public_key_length;
+    const unsigned char *public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &public_key, &public_key_length),
+        env, "Invalid buffer was passed as public key."
+    );
+
+    ed25519_addon_hash_type_t hash_type;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        ed25519_addon_get_hash_type(env, argv[3], &hash_type),
+        env, "Invalid hash was passed."
+    );
+
+    if (ED25519_SIGNATURE_LENGTH != signature_length || ED25519_PUBLIC_KEY_LENGTH != public_key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    unsigned char scratch[ED25519_MESSAGE_SCRATCH_LENGTH];
+    size_t message_length;
+    unsigned char *message;
+    unsigned char *allocated_message;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes_or_string(env, argv[0], scratch, ED25519_MESSAGE_SCRATCH_LENGTH, &message, &message_length, &allocated_message),
+        env, "Invalid buffer was passed as message."
+    );
+
+    const bool result = ed25519_addon_verify(signature, message, message_length, public_key, hash_type);
+    free(allocated_message);
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_boolean(env, result, &js_result),
+        env, "Could not create the result."
+    );
+
+    return js_result;
+}
+
+static void verify_async_execute(napi_env env, void *data)
+{
+    verify_callback_data_t *callback_data = (verify_callback_data_t *) data;
+
+    callback_data->result = ed25519_addon_verify(callback_data->signature, callback_data->message, callback_data->message_length,
+        callback_data->public_key, callback_data->hash_type);
+}
+
+static void verify_async_complete(napi_env env, napi_status status, void *data)
+{
+    verify_callback_data_t *callback_data = (verify_callback_data_t *) data;
+
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
+    {
+        REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
+
+        release_verify_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        release_verify_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_ok != status)
+    {
+        REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
+
+        release_verify_callback_data(env, callback_data);
+
+        return;
+    }
+
+    napi_value js_result;
+    if (napi_ok != napi_get_boolean(env, callback_data->result, &js_result))
+    {
+        REJECT_WITH_ERROR(env, "Could not create the result.", callback_data->deferred);
+
+        release_verify_callback_data(env, callback_data);
+
+        return;
+    }
+
+    napi_resolve_deferred(env, callback_data->deferred, js_result);
+
+    release_verify_callback_data(env, callback_data);
+}
+
+napi_value ed25519_addon_verify_async(napi_env env, napi_callback_info info)
+{
+    size_t argc = 6;
+    napi_value argv[6];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    size_t signature_length;
+    const unsigned char *signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &signature, &signature_length),
+        env, "Invalid buffer was passed as signature."
+    );
+
+    size_t public_key_length;
+    const unsigned char *public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &public_key, &public_key_length),
+        env, "Invalid buffer was passed as public key."
+    );
+
+    ed25519_addon_hash_type_t hash_type;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        ed25519_addon_get_hash_type(env, argv[3], &hash_type),
+        env, "Invalid hash was passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[4], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[5], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (ED25519_SIGNATURE_LENGTH != signature_length || ED25519_PUBLIC_KEY_LENGTH != public_key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "ed25519::async::verify";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    verify_callback_data_t *callback_data = signun_pool_acquire(env, &verify_callback_data_pool);
+    if (!callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+
+    callback_data->allocated_message = NULL;
+    callback_data->message_ref = NULL;
+
+    if (napi_ok != signun_get_bytes_or_string(env, argv[0], callback_data->scratch, ED25519_MESSAGE_SCRATCH_LENGTH,
+        &callback_data->message, &callback_data->message_length, &callback_data->allocated_message)
+        || napi_ok != signun_pin_bytes(env, argv[0], &callback_data->message_ref))
+    {
+        release_verify_callback_data(env, callback_data);
+        napi_throw_error(env, NULL, "Invalid buffer was passed as message.");
+        return NULL;
+    }
+
+    callback_data->hash_type = hash_type;
+    memcpy(callback_data->signature, signature, ED25519_SIGNATURE_LENGTH);
+    memcpy(callback_data->public_key, public_key, ED25519_PUBLIC_KEY_LENGTH);
+
+    napi_value promise;
+    if (napi_ok != napi_create_promise(env, &callback_data->deferred, &promise))
+    {
+        release_verify_callback_data(env, callback_data);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_task_create(env, &callback_data->task, SIGNUN_OP_VERIFY, priority, cancel_token, resource_name,
+        verify_async_execute, verify_async_complete))
+    {
+        REJECT_WITH_ERROR(env, "Could not create async work.", callback_data->deferred);
+        release_verify_callback_data(env, callback_data);
+        return promise;
+    }
+
+    napi_async_work async_work = callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", callback_data->deferred);
+        release_verify_callback_data(env, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    if (napi_ok != queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Could not queue async work.", callback_data->deferred);
+        release_verify_callback_data(env, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    return promise;
+}
+
+static void verify_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    verify_batch_data_t *batch_data = (verify_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        const uint32_t offset = batch_data->offsets[i];
+
+        batch_data->results[i] = ed25519_addon_verify(&batch_data->signatures[i * ED25519_SIGNATURE_LENGTH],
+            &batch_data->messages[offset], batch_data->offsets[i + 1] - offset,
+            &batch_data->public_keys[i * ED25519_PUBLIC_KEY_LENGTH], batch_data->hash_type) ? 1 : 0;
+    }
+}
+
+static napi_status verify_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    return signun_batch_get_retained_value(env, batch, 4, result);
+}
+
+static void verify_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    free(batch);
+}
+
+napi_value ed25519_addon_verify_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 8;
+    napi_value argv[8];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    const unsigned char *messages;
+    const uint32_t *offsets;
+    size_t count;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_packed_bytes(env, argv[0], argv[1], &messages, &offsets, &count),
+        env, "Invalid messages were passed."
+    );
+
+    size_t signatures_length;
+    const unsigned char *signatures;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &signatures, &signatures_length),
+        env, "Invalid buffer was passed as signatures."
+    );
+
+    size_t public_keys_length;
+    const unsigned char *public_keys;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[3], (void **) &public_keys, &public_keys_length),
+        env, "Invalid buffer was passed as public keys."
+    );
+
+    ed25519_addon_hash_type_t hash_type;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        ed25519_addon_get_hash_type(env, argv[4], &hash_type),
+        env, "Invalid hash was passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[5], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[6], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (count * ED25519_SIGNATURE_LENGTH != signatures_length)
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as signatures.");
+        return NULL;
+    }
+
+    if (count * ED25519_PUBLIC_KEY_LENGTH != public_keys_length)
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as public keys.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "ed25519::batch::verify";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    verify_batch_data_t *batch_data = (verify_batch_data_t *)calloc(1, sizeof (verify_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->messages = messages;
+    batch_data->offsets = offsets;
+    batch_data->signatures = signatures;
+    batch_data->public_keys = public_keys;
+    batch_data->hash_type = hash_type;
+
+    napi_value js_results;
+    if (napi_ok != napi_create_buffer(env, count, (void **) &batch_data->results, &js_results))
+    {
+        verify_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffer.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, VERIFY_BATCH_CHUNK_SIZE,
+        verify_batch_execute, verify_batch_complete, verify_batch_finalize, &promise))
+    {
+        verify_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[1])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[2])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[3])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_results)
+        || napi_ok != signun_batch_set_listener(env, &batch_data->batch, argv[7], batch_data->results, 1))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        verify_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_VERIFY_BATCH, priority, cancel_token, resource_name);
+
+    return promise;
+}
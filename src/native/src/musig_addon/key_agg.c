@@ -0,0 +1,143 @@
+#include "musig_addon/key_agg.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "secp256k1.h"
+#include "secp256k1_extrakeys.h"
+#include "secp256k1_musig.h"
+
+#include "signun_util.h"
+#include "secp256k1_addon/util.h"
+#include "musig_addon/util.h"
+
+
+static void key_agg_finalize(napi_env env, void *data, void *hint)
+{
+    free(data);
+}
+
+napi_status musig_addon_get_key_agg(napi_env env, napi_value value, musig_addon_key_agg_t **key_agg)
+{
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, value, &type));
+
+    if (napi_external != type)
+    {
+        return napi_invalid_arg;
+    }
+
+    return napi_get_value_external(env, value, (void **) key_agg);
+}
+
+/*
+ * Aggregates compressed public keys, packed back-to-back. Every key is
+ * parsed once, and the keys are optionally sorted
+ * first, so that the aggregate does not depend on the order of the signers.
+ */
+napi_value musig_addon_key_agg(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_public_keys_length;
+    const unsigned char *raw_public_keys;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &raw_public_keys, &raw_public_keys_length),
+        env, "Invalid buffer was passed as public keys."
+    );
+
+    bool sort;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[1], &sort),
+        env, "Invalid bool was passed as sort flag."
+    );
+
+    const size_t count = raw_public_keys_length / COMPRESSED_PUBLIC_KEY_LENGTH;
+    if (0 == count || 0 != raw_public_keys_length % COMPRESSED_PUBLIC_KEY_LENGTH)
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as public keys.");
+        return NULL;
+    }
+
+    musig_addon_key_agg_t *key_agg = (musig_addon_key_agg_t *)calloc(1, sizeof (musig_addon_key_agg_t));
+    secp256k1_pubkey *public_keys = (secp256k1_pubkey *)malloc(count * sizeof (secp256k1_pubkey));
+    const secp256k1_pubkey **public_key_pointers = (const secp256k1_pubkey **)malloc(count * sizeof (secp256k1_pubkey *));
+    if (!key_agg || !public_keys || !public_key_pointers)
+    {
+        free(key_agg);
+        free(public_keys);
+        free(public_key_pointers);
+        napi_throw_error(env, NULL, "Could not allocate the key aggregate.");
+        return NULL;
+    }
+
+    bool success = true;
+    for (size_t i = 0; success && i < count; ++i)
+    {
+        success = secp256k1_ec_pubkey_parse(callback_data->secp256k1context, &public_keys[i],
+            &raw_public_keys[i * COMPRESSED_PUBLIC_KEY_LENGTH], COMPRESSED_PUBLIC_KEY_LENGTH);
+        public_key_pointers[i] = &public_keys[i];
+    }
+
+    if (success && sort)
+    {
+        success = secp256k1_ec_pubkey_sort(callback_data->secp256k1context, public_key_pointers, count);
+    }
+
+    secp256k1_xonly_pubkey public_key;
+    success = success
+        && secp256k1_musig_pubkey_agg(callback_data->secp256k1context, &public_key, &key_agg->cache, public_key_pointers, count)
+        && secp256k1_xonly_pubkey_serialize(callback_data->secp256k1context, key_agg->public_key, &public_key);
+
+    free(public_keys);
+    free(public_key_pointers);
+
+    if (!success)
+    {
+        free(key_agg);
+        napi_throw_error(env, NULL, "Could not aggregate the public keys.");
+        return NULL;
+    }
+
+    key_agg->signer_count = count;
+
+    napi_value js_key_agg;
+    if (napi_ok != napi_create_external(env, key_agg, key_agg_finalize, NULL, &js_key_agg))
+    {
+        free(key_agg);
+        napi_throw_error(env, NULL, "Could not create the key aggregate.");
+        return NULL;
+    }
+
+    return js_key_agg;
+}
+
+napi_value musig_addon_key_agg_public_key(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    musig_addon_key_agg_t *key_agg;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        musig_addon_get_key_agg(env, argv[0], &key_agg),
+        env, "Invalid key aggregate was passed."
+    );
+
+    napi_value js_public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer_copy(env, XONLY_PUBLIC_KEY_LENGTH, key_agg->public_key, NULL, &js_public_key),
+        env, "Could not set the result buffer."
+    );
+
+    return js_public_key;
+}
@@ -0,0 +1,35 @@
+#include "musig_addon/musig_addon.h"
+
+#include "signun_util.h"
+#include "musig_addon/key_agg.h"
+#include "musig_addon/session.h"
+#include "musig_addon/verify.h"
+
+
+napi_status create_musig_addon(napi_env env, napi_value base, secp256k1_addon_callback_data_t *callback_data)
+{
+    napi_value addon;
+
+    RETURN_ON_FAILURE(napi_create_object(env, &addon));
+
+    const size_t property_count = 11;
+    napi_property_descriptor properties[] = {
+        DECLARE_NAPI_METHOD("keyAgg", musig_addon_key_agg, callback_data),
+        DECLARE_NAPI_METHOD("keyAggPublicKey", musig_addon_key_agg_public_key, callback_data),
+        DECLARE_NAPI_METHOD("sessionCreate", musig_addon_session_create, callback_data),
+        DECLARE_NAPI_METHOD("sessionPublicNonce", musig_addon_session_public_nonce, callback_data),
+        DECLARE_NAPI_METHOD("sessionProcessNonces", musig_addon_session_process_nonces, callback_data),
+        DECLARE_NAPI_METHOD("sessionSign", musig_addon_session_sign, callback_data),
+        DECLARE_NAPI_METHOD("sessionVerifyPartial", musig_addon_session_verify_partial, callback_data),
+        DECLARE_NAPI_METHOD("sessionAggregate", musig_addon_session_aggregate, callback_data),
+        DECLARE_NAPI_METHOD("verifySync", musig_addon_verify_sync, callback_data),
+
+        DECLARE_NAPI_METHOD("verify", musig_addon_verify_async, callback_data),
+        DECLARE_NAPI_METHOD("verifyBatch", musig_addon_verify_batch, callback_data)
+    };
+
+    RETURN_ON_FAILURE(napi_define_properties(env, addon, property_count, properties));
+    RETURN_ON_FAILURE(napi_set_named_property(env, base, "musig", addon));
+
+    return napi_ok;
+}
@@ -0,0 +1,475 @@
+#include "musig_addon/session.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <uv.h>
+
+#include "secp256k1.h"
+#include "secp256k1_extrakeys.h"
+#include "secp256k1_musig.h"
+
+#include "signun_util.h"
+#include "secp256k1_addon/util.h"
+#include "musig_addon/key_agg.h"
+#include "musig_addon/util.h"
+
+
+#define SESSION_RANDOMNESS_LENGTH 32
+
+/*
+ * The state of one signer in one signing session. The secret nonce can only
+ * ever be used for a single partial signature, so a session signs at most
+ * once, after which its secrets are wiped.
+ */
+typedef struct
+{
+    // Copied, so that the key aggregate object can be collected while the session is alive.
+    musig_addon_key_agg_t key_agg;
+
+    secp256k1_keypair keypair;
+    secp256k1_musig_secnonce secnonce;
+    unsigned char public_nonce[PUBLIC_NONCE_LENGTH];
+    unsigned char message[MESSAGE_LENGTH];
+
+    // Set once the public nonces of every signer have been processed.
+    secp256k1_musig_session session;
+    bool is_processed;
+    bool is_signed;
+} musig_session_t;
+
+static void session_finalize(napi_env env, void *data, void *hint)
+{
+    signun_secure_zero(data, sizeof (musig_session_t));
+    free(data);
+}
+
+static napi_status get_session(napi_env env, napi_value value, musig_session_t **session)
+{
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, value, &type));
+
+    if (napi_external != type)
+    {
+        return napi_invalid_arg;
+    }
+
+    return napi_get_value_external(env, value, (void **) session);
+}
+
+/*
+ * Parses count items of item_length bytes each, packed back-to-back, into an
+ * array of pointers as taken by the aggregation functions. The items and
+ * the pointers share a single allocation.
+ */
+static void **parse_packed(const secp256k1_context *ctx, const unsigned char *input, size_t count, size_t item_length, size_t item_size,
+    int (*parse)(const secp256k1_context *, void *, const unsigned char *))
+{
+    void **pointers = (void **)malloc(count * (sizeof (void *) + item_size));
+    if (!pointers)
+    {
+        return NULL;
+    }
+
+    unsigned char *items = (unsigned char *) &pointers[count];
+    for (size_t i = 0; i < count; ++i)
+    {
+        pointers[i] = &items[i * item_size];
+
+        if (!parse(ctx, pointers[i], &input[i * item_length]))
+        {
+            free(pointers);
+            return NULL;
+        }
+    }
+
+    return pointers;
+}
+
+static int parse_public_nonce(const secp256k1_context *ctx, void *nonce, const unsigned char *input)
+{
+    return secp256k1_musig_pubnonce_parse(ctx, (secp256k1_musig_pubnonce *) nonce, input);
+}
+
+static int parse_partial_signature(const secp256k1_context *ctx, void *signature, const unsigned char *input)
+{
+    return secp256k1_musig_partial_sig_parse(ctx, (secp256k1_musig_partial_sig *) signature, input);
+}
+
+/*
+ * Starts a session for a signer of a key aggregate, generating its nonce
+ * from fresh randomness, the private key, the message and the aggregate.
+ */
+napi_value musig_addon_session_create(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value argv[3];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    musig_addon_key_agg_t *key_agg;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        musig_addon_get_key_agg(env, argv[0], &key_agg),
+        env, "Invalid key aggregate was passed."
+    );
+
+    size_t private_key_length;
+    const unsigned char *private_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &private_key, &private_key_length),
+        env, "Invalid buffer was passed as private key."
+    );
+
+    size_t message_length;
+    const unsigned char *message;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &message, &message_length),
+        env, "Invalid buffer was passed as message."
+    );
+
+    if (KEY_LENGTH != private_key_length || MESSAGE_LENGTH != message_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    musig_session_t *session = (musig_session_t *)calloc(1, sizeof (musig_session_t));
+    if (!session)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the session.");
+        return NULL;
+    }
+
+    memcpy(&session->key_agg, key_agg, sizeof (musig_addon_key_agg_t));
+    memcpy(session->message, message, MESSAGE_LENGTH);
+
+    unsigned char randomness[SESSION_RANDOMNESS_LENGTH];
+    secp256k1_pubkey public_key;
+    secp256k1_musig_pubnonce public_nonce;
+
+    const bool success = 0 == uv_random(NULL, NULL, randomness, SESSION_RANDOMNESS_LENGTH, 0, NULL)
+        && secp256k1_keypair_create(callback_data->secp256k1context, &session->keypair, private_key)
+        && secp256k1_keypair_pub(callback_data->secp256k1context, &public_key, &session->keypair)
+        && secp256k1_musig_nonce_gen(callback_data->secp256k1context, &session->secnonce, &public_nonce, randomness,
+            private_key, &public_key, session->message, &session->key_agg.cache, NULL)
+        && secp256k1_musig_pubnonce_serialize(callback_data->secp256k1context, session->public_nonce, &public_nonce);
+
+    signun_secure_zero(randomness, SESSION_RANDOMNESS_LENGTH);
+
+    if (!success)
+    {
+        session_finalize(env, session, NULL);
+        napi_throw_error(env, NULL, "Could not generate the nonce.");
+        return NULL;
+    }
+
+    napi_value js_session;
+    if (napi_ok != napi_create_external(env, session, session_finalize, NULL, &js_session))
+    {
+        session_finalize(env, session, NULL);
+        napi_throw_error(env, NULL, "Could not create the session.");
+        return NULL;
+    }
+
+    return js_session;
+}
+
+napi_value musig_addon_session_public_nonce(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    musig_session_t *session;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_session(env, argv[0], &session),
+        env, "Invalid session was passed."
+    );
+
+    napi_value js_public_nonce;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer_copy(env, PUBLIC_NONCE_LENGTH, session->public_nonce, NULL, &js_public_nonce),
+        env, "Could not set the result buffer."
+    );
+
+    return js_public_nonce;
+}
+
+/*
+ * Aggregates the public nonces of every signer, packed back-to-back, and
+ * derives the state shared by the partial signatures of the session.
+ */
+napi_value musig_addon_session_process_nonces(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    musig_session_t *session;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_session(env, argv[0], &session),
+        env, "Invalid session was passed."
+    );
+
+    size_t raw_public_nonces_length;
+    const unsigned char *raw_public_nonces;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &raw_public_nonces, &raw_public_nonces_length),
+        env, "Invalid buffer was passed as public nonces."
+    );
+
+    if (session->is_processed)
+    {
+        napi_throw_error(env, NULL, "The nonces of the session have already been processed.");
+        return NULL;
+    }
+
+    const size_t count = session->key_agg.signer_count;
+    if (count * PUBLIC_NONCE_LENGTH != raw_public_nonces_length)
+    {
+        napi_throw_error(env, NULL, "There must be one public nonce per signer.");
+        return NULL;
+    }
+
+    // Leaving out the nonce of this session would produce a partial signature no one can use.
+    bool has_own_nonce = false;
+    for (size_t i = 0; !has_own_nonce && i < count; ++i)
+    {
+        has_own_nonce = 0 == memcmp(&raw_public_nonces[i * PUBLIC_NONCE_LENGTH], session->public_nonce, PUBLIC_NONCE_LENGTH);
+    }
+
+    if (!has_own_nonce)
+    {
+        napi_throw_error(env, NULL, "The public nonces must include the nonce of the session.");
+        return NULL;
+    }
+
+    void **public_nonces = parse_packed(callback_data->secp256k1context, raw_public_nonces, count, PUBLIC_NONCE_LENGTH,
+        sizeof (secp256k1_musig_pubnonce), parse_public_nonce);
+    if (!public_nonces)
+    {
+        napi_throw_error(env, NULL, "Could not parse the public nonces.");
+        return NULL;
+    }
+
+    secp256k1_musig_aggnonce aggregate_nonce;
+    const bool success = secp256k1_musig_nonce_agg(callback_data->secp256k1context, &aggregate_nonce,
+            (const secp256k1_musig_pubnonce * const *) public_nonces, count)
+        && secp256k1_musig_nonce_process(callback_data->secp256k1context, &session->session, &aggregate_nonce,
+            session->message, &session->key_agg.cache);
+
+    free(public_nonces);
+
+    if (!success)
+    {
+        napi_throw_error(env, NULL, "Could not process the public nonces.");
+        return NULL;
+    }
+
+    session->is_processed = true;
+
+    return NULL;
+}
+
+napi_value musig_addon_session_sign(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    musig_session_t *session;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_session(env, argv[0], &session),
+        env, "Invalid session was passed."
+    );
+
+    if (!session->is_processed)
+    {
+        napi_throw_error(env, NULL, "The nonces of the session must be processed first.");
+        return NULL;
+    }
+
+    if (session->is_signed)
+    {
+        napi_throw_error(env, NULL, "The session has already signed.");
+        return NULL;
+    }
+
+    // Whatever the outcome, the secret nonce is never used again.
+    session->is_signed = true;
+
+    secp256k1_musig_partial_sig partial_signature;
+    unsigned char raw_partial_signature[PARTIAL_SIGNATURE_LENGTH];
+    const bool success = secp256k1_musig_partial_sign(callback_data->secp256k1context, &partial_signature, &session->secnonce,
+            &session->keypair, &session->key_agg.cache, &session->session)
+        && secp256k1_musig_partial_sig_serialize(callback_data->secp256k1context, raw_partial_signature, &partial_signature);
+
+    signun_secure_zero(&session->keypair, sizeof (secp256k1_keypair));
+    signun_secure_zero(&session->secnonce, sizeof (secp256k1_musig_secnonce));
+
+    if (!success)
+    {
+        napi_throw_error(env, NULL, "Could not sign.");
+        return NULL;
+    }
+
+    napi_value js_partial_signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer_copy(env, PARTIAL_SIGNATURE_LENGTH, raw_partial_signature, NULL, &js_partial_signature),
+        env, "Could not set the result buffer."
+    );
+
+    return js_partial_signature;
+}
+
+napi_value musig_addon_session_verify_partial(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value argv[4];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    musig_session_t *session;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_session(env, argv[0], &session),
+        env, "Invalid session was passed."
+    );
+
+    size_t raw_partial_signature_length;
+    const unsigned char *raw_partial_signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &raw_partial_signature, &raw_partial_signature_length),
+        env, "Invalid buffer was passed as partial signature."
+    );
+
+    size_t raw_public_nonce_length;
+    const unsigned char *raw_public_nonce;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &raw_public_nonce, &raw_public_nonce_length),
+        env, "Invalid buffer was passed as public nonce."
+    );
+
+    size_t raw_public_key_length;
+    const unsigned char *raw_public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[3], (void **) &raw_public_key, &raw_public_key_length),
+        env, "Invalid buffer was passed as public key."
+    );
+
+    if (!session->is_processed)
+    {
+        napi_throw_error(env, NULL, "The nonces of the session must be processed first.");
+        return NULL;
+    }
+
+    if (PARTIAL_SIGNATURE_LENGTH != raw_partial_signature_length || PUBLIC_NONCE_LENGTH != raw_public_nonce_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    secp256k1_musig_partial_sig partial_signature;
+    secp256k1_musig_pubnonce public_nonce;
+    secp256k1_pubkey public_key;
+    const bool result = secp256k1_musig_partial_sig_parse(callback_data->secp256k1context, &partial_signature, raw_partial_signature)
+        && secp256k1_musig_pubnonce_parse(callback_data->secp256k1context, &public_nonce, raw_public_nonce)
+        && secp256k1_ec_pubkey_parse(callback_data->secp256k1context, &public_key, raw_public_key, raw_public_key_length)
+        && secp256k1_musig_partial_sig_verify(callback_data->secp256k1context, &partial_signature, &public_nonce, &public_key,
+            &session->key_agg.cache, &session->session);
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_boolean(env, result, &js_result),
+        env, "Could not set the result."
+    );
+
+    return js_result;
+}
+
+/*
+ * Sums the partial signatures of every signer, packed back-to-back, into a
+ * BIP340 signature for the aggregate public key. The partial signatures are
+ * not verified, so an invalid one yields an invalid signature.
+ */
+napi_value musig_addon_session_aggregate(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    musig_session_t *session;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_session(env, argv[0], &session),
+        env, "Invalid session was passed."
+    );
+
+    size_t raw_partial_signatures_length;
+    const unsigned char *raw_partial_signatures;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &raw_partial_signatures, &raw_partial_signatures_length),
+        env, "Invalid buffer was passed as partial signatures."
+    );
+
+    if (!session->is_processed)
+    {
+        napi_throw_error(env, NULL, "The nonces of the session must be processed first.");
+        return NULL;
+    }
+
+    const size_t count = session->key_agg.signer_count;
+    if (count * PARTIAL_SIGNATURE_LENGTH != raw_partial_signatures_length)
+    {
+        napi_throw_error(env, NULL, "There must be one partial signature per signer.");
+        return NULL;
+    }
+
+    void **partial_signatures = parse_packed(callback_data->secp256k1context, raw_partial_signatures, count, PARTIAL_SIGNATURE_LENGTH,
+        sizeof (secp256k1_musig_partial_sig), parse_partial_signature);
+    if (!partial_signatures)
+    {
+        napi_throw_error(env, NULL, "Could not parse the partial signatures.");
+        return NULL;
+    }
+
+    unsigned char signature[SCHNORR_SIGNATURE_LENGTH];
+    const bool success = secp256k1_musig_partial_sig_agg(callback_data->secp256k1context, signature, &session->session,
+        (const secp256k1_musig_partial_sig * const *) partial_signatures, count);
+
+    free(partial_signatures);
+
+    if (!success)
+    {
+        napi_throw_error(env, NULL, "Could not aggregate the partial signatures.");
+        return NULL;
+    }
+
+    napi_value js_signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer_copy(env, SCHNORR_SIGNATURE_LENGTH, signature, NULL, &js_signature),
+        env, "Could not set the result buffer."
+    );
+
+    return js_signature;
+}
@@ -0,0 +1,408 @@
+#include "musig_addon/verify.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "secp256k1.h"
+#include "secp256k1_extrakeys.h"
+#include "secp256k1_schnorrsig.h"
+
+#include "signun_batch.h"
+#include "signun_pool.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+#include "secp256k1_addon/signature_cache.h"
+#include "secp256k1_addon/util.h"
+#include "musig_addon/util.h"
+
+
+#define VERIFY_POOL_HIGH_WATER_MARK 256
+
+// As for ECDSA, small enough for an abort or an interactive task to get through quickly.
+#define VERIFY_BATCH_CHUNK_SIZE 128
+
+typedef struct
+{
+    signun_task_t task;
+
+    napi_deferred deferred;
+    secp256k1_context *secp256k1context;
+
+    unsigned char message[MESSAGE_LENGTH];
+    unsigned char signature[SCHNORR_SIGNATURE_LENGTH];
+    unsigned char public_key[XONLY_PUBLIC_KEY_LENGTH];
+
+    bool result;
+} verify_callback_data_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+    secp256k1_context *secp256k1context;
+
+    const unsigned char *messages;
+    const unsigned char *signatures;
+    const unsigned char *public_keys;
+
+    unsigned char *results;
+} verify_batch_data_t;
+
+static const signun_pool_t verify_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_MUSIG_VERIFY, verify_callback_data_t, VERIFY_POOL_HIGH_WATER_MARK, false);
+
+/*
+ * Verifies a BIP340 signature against an x-only public key, such as a MuSig2
+ * aggregate, through the signature cache of ECDSA verification.
+ */
+static bool schnorr_verify(const secp256k1_context *ctx, const unsigned char *message, const unsigned char *signature,
+    const unsigned char *raw_public_key)
+{
+    secp256k1_addon_signature_cache_key_t cache_key;
+    if (secp256k1_addon_signature_cache_lookup(&cache_key, message, signature, SCHNORR_SIGNATURE_LENGTH,
+        raw_public_key, XONLY_PUBLIC_KEY_LENGTH, SIGNATURE_CACHE_FLAG_SCHNORR))
+    {
+        return true;
+    }
+
+    secp256k1_xonly_pubkey public_key;
+    if (!secp256k1_xonly_pubkey_parse(ctx, &public_key, raw_public_key)
+        || !secp256k1_schnorrsig_verify(ctx, signature, message, MESSAGE_LENGTH, &public_key))
+    {
+        return false;
+    }
+
+    secp256k1_addon_signature_cache_insert(&cache_key);
+
+    return true;
+}
+
+napi_value musig_addon_verify_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value argv[3];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t message_length;
+    const unsigned char *message;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &message, &message_length),
+        env, "Invalid buffer was passed as message."
+    );
+
+    size_t signature_length;
+    const unsigned char *signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &signature, &signature_length),
+        env, "Invalid buffer was passed as signature."
+    );
+
+    size_t public_key_length;
+    const unsigned char *public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &public_key, &public_key_length),
+        env, "Invalid buffer was passed as public key."
+    );
+
+    if (MESSAGE_LENGTH != message_length || SCHNORR_SIGNATURE_LENGTH != signature_length || XONLY_PUBLIC_KEY_LENGTH != public_key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_boolean(env, schnorr_verify(callback_data->secp256k1context, message, signature, public_key), &js_result),
+        env, "Could not set the result."
+    );
+
+    return js_result;
+}
+
+static void verify_async_execute(napi_env env, void *data)
+{
+    verify_callback_data_t *callback_data = (verify_callback_data_t *) data;
+
+    callback_data->result = schnorr_verify(callback_data->secp256k1context, callback_data->message, callback_data->signature,
+        callback_data->public_key);
+}
+
+static void verify_async_complete(napi_env env, napi_status status, void *data)
+{
+    verify_callback_data_t *callback_data = (verify_callback_data_t *) data;
+
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
+    {
+        REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
+
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_ok != status)
+    {
+        REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
+
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    napi_value js_result;
+    if (napi_ok != napi_get_boolean(env, callback_data->result, &js_result))
+    {
+        REJECT_WITH_ERROR(env, "Could not set the result.", callback_data->deferred);
+
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    napi_resolve_deferred(env, callback_data->deferred, js_result);
+
+    signun_pool_release(env, &verify_callback_data_pool, callback_data);
+}
+
+napi_value musig_addon_verify_async(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value argv[5];
+    secp256k1_addon_callback_data_t *current_callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t message_length;
+    const unsigned char *message;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &message, &message_length),
+        env, "Invalid buffer was passed as message."
+    );
+
+    size_t signature_length;
+    const unsigned char *signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &signature, &signature_length),
+        env, "Invalid buffer was passed as signature."
+    );
+
+    size_t public_key_length;
+    const unsigned char *public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &public_key, &public_key_length),
+        env, "Invalid buffer was passed as public key."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (MESSAGE_LENGTH != message_length || SCHNORR_SIGNATURE_LENGTH != signature_length || XONLY_PUBLIC_KEY_LENGTH != public_key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "musig::async::verify";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    verify_callback_data_t *callback_data = signun_pool_acquire(env, &verify_callback_data_pool);
+    if (!callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+
+    callback_data->secp256k1context = current_callback_data->secp256k1context;
+    memcpy(callback_data->message, message, MESSAGE_LENGTH);
+    memcpy(callback_data->signature, signature, SCHNORR_SIGNATURE_LENGTH);
+    memcpy(callback_data->public_key, public_key, XONLY_PUBLIC_KEY_LENGTH);
+
+    napi_value promise;
+    if (napi_ok != napi_create_promise(env, &callback_data->deferred, &promise))
+    {
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_task_create(env, &callback_data->task, SIGNUN_OP_VERIFY, priority, cancel_token, resource_name,
+        verify_async_execute, verify_async_complete))
+    {
+        REJECT_WITH_ERROR(env, "Could not create async work.", callback_data->deferred);
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
+        return promise;
+    }
+
+    napi_async_work async_work = callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", callback_data->deferred);
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    if (napi_ok != queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Could not queue async work.", callback_data->deferred);
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    return promise;
+}
+
+static void verify_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    verify_batch_data_t *batch_data = (verify_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        batch_data->results[i] = schnorr_verify(batch_data->secp256k1context, &batch_data->messages[i * MESSAGE_LENGTH],
+            &batch_data->signatures[i * SCHNORR_SIGNATURE_LENGTH], &batch_data->public_keys[i * XONLY_PUBLIC_KEY_LENGTH]) ? 1 : 0;
+    }
+}
+
+static napi_status verify_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    return signun_batch_get_retained_value(env, batch, 3, result);
+}
+
+static void verify_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    free(batch);
+}
+
+napi_value musig_addon_verify_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 6;
+    napi_value argv[6];
+    secp256k1_addon_callback_data_t *current_callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t messages_length;
+    const unsigned char *messages;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &messages, &messages_length),
+        env, "Invalid buffer was passed as messages."
+    );
+
+    size_t signatures_length;
+    const unsigned char *signatures;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &signatures, &signatures_length),
+        env, "Invalid buffer was passed as signatures."
+    );
+
+    size_t public_keys_length;
+    const unsigned char *public_keys;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &public_keys, &public_keys_length),
+        env, "Invalid buffer was passed as public keys."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    const size_t count = messages_length / MESSAGE_LENGTH;
+    if (0 != messages_length % MESSAGE_LENGTH || count * SCHNORR_SIGNATURE_LENGTH != signatures_length
+        || count * XONLY_PUBLIC_KEY_LENGTH != public_keys_length)
+    {
+        napi_throw_error(env, NULL, "There must be one signature and one public key per message.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "musig::batch::verify";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    verify_batch_data_t *batch_data = (verify_batch_data_t *)calloc(1, sizeof (verify_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->secp256k1context = current_callback_data->secp256k1context;
+    batch_data->messages = messages;
+    batch_data->signatures = signatures;
+    batch_data->public_keys = public_keys;
+
+    napi_value js_results;
+    if (napi_ok != napi_create_buffer(env, count, (void **) &batch_data->results, &js_results))
+    {
+        verify_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffer.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, VERIFY_BATCH_CHUNK_SIZE,
+        verify_batch_execute, verify_batch_complete, verify_batch_finalize, &promise))
+    {
+        verify_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[1])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[2])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_results)
+        || napi_ok != signun_batch_set_listener(env, &batch_data->batch, argv[5], batch_data->results, 1))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        verify_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_VERIFY_BATCH, priority, cancel_token, resource_name);
+
+    return promise;
+}
@@ -0,0 +1,819 @@
+#include "secp256k1_addon/derive.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <uv.h>
+
+#include "secp256k1.h"
+
+#include "signun_batch.h"
+#include "signun_pool.h"
+#include "signun_scheduler.h"
+#include "signun_sha512.h"
+#include "signun_util.h"
+#include "secp256k1_addon/util.h"
+
+
+#define CHAIN_CODE_LENGTH 32
+#define HARDENED_INDEX 0x80000000u
+// BIP32 serializes the depth into a single byte.
+#define DERIVE_MAX_DEPTH 255
+// Private parents are identified by 0x00 || key, public ones by their compressed key.
+#define PARENT_IDENTIFIER_LENGTH 33
+#define CHILD_DATA_LENGTH (PARENT_IDENTIFIER_LENGTH + 4)
+
+#define DERIVE_CACHE_SIZE 1024
+#define DERIVE_POOL_HIGH_WATER_MARK 256
+#define DERIVE_BATCH_CHUNK_SIZE 256
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+static const unsigned char master_key_hmac_key[] = "Bitcoin seed";
+
+typedef struct
+{
+    bool is_private;
+    bool has_public_key;
+    unsigned char private_key[KEY_LENGTH];
+    unsigned char public_key[COMPRESSED_PUBLIC_KEY_LENGTH];
+    unsigned char chain_code[CHAIN_CODE_LENGTH];
+} derive_node_t;
+
+typedef enum
+{
+    DERIVE_SUCCESS,
+    DERIVE_HARDENED_FROM_PUBLIC,
+    DERIVE_INVALID_CHILD
+} derive_result_t;
+
+/*
+ * Children of the parents on a path, so that paths sharing a prefix, such as
+ * the accounts of a wallet, only derive it once. Leaves are not cached, as
+ * they are rarely derived twice and would only push the parents out.
+ *
+ * Direct-mapped and shared by every worker, hence the mutex. Entries hold
+ * private keys, so they are wiped rather than just overwritten.
+ */
+typedef struct
+{
+    bool is_used;
+    unsigned char parent_identifier[PARENT_IDENTIFIER_LENGTH];
+    unsigned char parent_chain_code[CHAIN_CODE_LENGTH];
+    uint32_t index;
+    derive_node_t child;
+} derive_cache_entry_t;
+
+typedef struct
+{
+    signun_task_t task;
+
+    napi_deferred deferred;
+    secp256k1_context *secp256k1context;
+
+    derive_node_t node;
+    size_t index_count;
+    uint32_t indices[DERIVE_MAX_DEPTH];
+
+    derive_result_t result;
+} derive_callback_data_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+    secp256k1_context *secp256k1context;
+
+    derive_node_t root;
+    size_t index_count;
+    uint32_t indices[DERIVE_MAX_DEPTH];
+    uint32_t start;
+
+    size_t key_length;
+    unsigned char *keys;
+    unsigned char *chain_codes;
+} derive_batch_data_t;
+
+static derive_cache_entry_t derive_cache[DERIVE_CACHE_SIZE];
+static uv_mutex_t derive_cache_mutex;
+static uv_once_t derive_cache_once = UV_ONCE_INIT;
+
+static const signun_pool_t derive_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_DERIVE, derive_callback_data_t, DERIVE_POOL_HIGH_WATER_MARK, true);
+
+static void init_derive_cache(void)
+{
+    uv_mutex_init(&derive_cache_mutex);
+}
+
+static const char *derive_result_message(derive_result_t result)
+{
+    return DERIVE_HARDENED_FROM_PUBLIC == result
+        ? "Cannot derive a hardened child from a public key."
+        : "Could not derive the child key.";
+}
+
+static bool derive_node_public_key(const secp256k1_context *ctx, derive_node_t *node)
+{
+    if (node->has_public_key)
+    {
+        return true;
+    }
+
+    secp256k1_pubkey public_key;
+    if (0 == secp256k1_ec_pubkey_create(ctx, &public_key, node->private_key))
+    {
+        return false;
+    }
+
+    size_t public_key_length = COMPRESSED_PUBLIC_KEY_LENGTH;
+    secp256k1_ec_pubkey_serialize(ctx, node->public_key, &public_key_length, &public_key, SECP256K1_EC_COMPRESSED);
+    node->has_public_key = true;
+
+    return true;
+}
+
+static void write_index(unsigned char *output, uint32_t index)
+{
+    output[0] = (unsigned char) (index >> 24);
+    output[1] = (unsigned char) (index >> 16);
+    output[2] = (unsigned char) (index >> 8);
+    output[3] = (unsigned char) index;
+}
+
+static void derive_parent_identifier(const derive_node_t *parent, unsigned char *identifier)
+{
+    if (parent->is_private)
+    {
+        identifier[0] = 0x00;
+        memcpy(&identifier[1], parent->private_key, KEY_LENGTH);
+    }
+    else
+    {
+        memcpy(identifier, parent->public_key, COMPRESSED_PUBLIC_KEY_LENGTH);
+    }
+}
+
+static derive_result_t derive_child(const secp256k1_context *ctx, derive_node_t *parent, uint32_t index, derive_node_t *child)
+{
+    unsigned char data[CHILD_DATA_LENGTH];
+    unsigned char mac[SIGNUN_SHA512_DIGEST_LENGTH];
+    derive_result_t result = DERIVE_SUCCESS;
+
+    if (HARDENED_INDEX <= index)
+    {
+        if (!parent->is_private)
+        {
+            return DERIVE_HARDENED_FROM_PUBLIC;
+        }
+
+        derive_parent_identifier(parent, data);
+    }
+    else
+    {
+        if (parent->is_private && !derive_node_public_key(ctx, parent))
+        {
+            return DERIVE_INVALID_CHILD;
+        }
+
+        memcpy(data, parent->public_key, COMPRESSED_PUBLIC_KEY_LENGTH);
+    }
+
+    write_index(&data[PARENT_IDENTIFIER_LENGTH], index);
+
+    signun_hmac_sha512(parent->chain_code, CHAIN_CODE_LENGTH, data, CHILD_DATA_LENGTH, mac);
+
+    child->is_private = parent->is_private;
+    child->has_public_key = false;
+    memcpy(child->chain_code, &mac[KEY_LENGTH], CHAIN_CODE_LENGTH);
+
+    if (parent->is_private)
+    {
+        memcpy(child->private_key, parent->private_key, KEY_LENGTH);
+
+        if (0 == secp256k1_ec_seckey_tweak_add(ctx, child->private_key, mac))
+        {
+            result = DERIVE_INVALID_CHILD;
+        }
+    }
+    else
+    {
+        secp256k1_pubkey public_key;
+        if (0 == secp256k1_ec_pubkey_parse(ctx, &public_key, parent->public_key, COMPRESSED_PUBLIC_KEY_LENGTH)
+            || 0 == secp256k1_ec_pubkey_tweak_add(ctx, &public_key, mac))
+        {
+            result = DERIVE_INVALID_CHILD;
+        }
+        else
+        {
+            size_t public_key_length = COMPRESSED_PUBLIC_KEY_LENGTH;
+            secp256k1_ec_pubkey_serialize(ctx, child->public_key, &public_key_length, &public_key, SECP256K1_EC_COMPRESSED);
+            child->has_public_key = true;
+        }
+    }
+
+    signun_secure_zero(data, sizeof data);
+    signun_secure_zero(mac, sizeof mac);
+
+    return result;
+}
+
+static size_t derive_cache_slot(const unsigned char *parent_identifier, const unsigned char *parent_chain_code, uint32_t index)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    for (size_t i = 0; i < PARENT_IDENTIFIER_LENGTH; ++i)
+    {
+        hash = (hash ^ parent_identifier[i]) * FNV_PRIME;
+    }
+
+    for (size_t i = 0; i < CHAIN_CODE_LENGTH; ++i)
+    {
+        hash = (hash ^ parent_chain_code[i]) * FNV_PRIME;
+    }
+
+    hash = (hash ^ index) * FNV_PRIME;
+
+    return (size_t) (hash % DERIVE_CACHE_SIZE);
+}
+
+static derive_result_t derive_child_cached(const secp256k1_context *ctx, derive_node_t *parent, uint32_t index, derive_node_t *child)
+{
+    unsigned char parent_identifier[PARENT_IDENTIFIER_LENGTH];
+    derive_parent_identifier(parent, parent_identifier);
+
+    const size_t slot = derive_cache_slot(parent_identifier, parent->chain_code, index);
+    derive_cache_entry_t *entry = &derive_cache[slot];
+    bool is_hit = false;
+
+    uv_once(&derive_cache_once, init_derive_cache);
+
+    uv_mutex_lock(&derive_cache_mutex);
+    if (entry->is_used && entry->index == index
+        && 0 == memcmp(entry->parent_identifier, parent_identifier, PARENT_IDENTIFIER_LENGTH)
+        && 0 == memcmp(entry->parent_chain_code, parent->chain_code, CHAIN_CODE_LENGTH))
+    {
+        *child = entry->child;
+        is_hit = true;
+    }
+    uv_mutex_unlock(&derive_cache_mutex);
+
+    if (is_hit)
+    {
+        signun_secure_zero(parent_identifier, sizeof parent_identifier);
+        return DERIVE_SUCCESS;
+    }
+
+    derive_result_t result = derive_child(ctx, parent, index, child);
+
+    // Cached nodes are parents, which need their public key for any
+    // non-hardened child, so it is computed once here.
+    if (DERIVE_SUCCESS == result && derive_node_public_key(ctx, child))
+    {
+        uv_mutex_lock(&derive_cache_mutex);
+        signun_secure_zero(entry, sizeof (derive_cache_entry_t));
+        entry->is_used = true;
+        memcpy(entry->parent_identifier, parent_identifier, PARENT_IDENTIFIER_LENGTH);
+        memcpy(entry->parent_chain_code, parent->chain_code, CHAIN_CODE_LENGTH);
+        entry->index = index;
+        entry->child = *child;
+        uv_mutex_unlock(&derive_cache_mutex);
+    }
+
+    signun_secure_zero(parent_identifier, sizeof parent_identifier);
+
+    return result;
+}
+
+/*
+ * Derives the node in place, going through the cache for the first
+ * cached_count steps.
+ */
+static derive_result_t derive_path(const secp256k1_context *ctx, derive_node_t *node, const uint32_t *indices, size_t index_count, size_t cached_count)
+{
+    derive_node_t child;
+    derive_result_t result = DERIVE_SUCCESS;
+
+    for (size_t i = 0; i < index_count && DERIVE_SUCCESS == result; ++i)
+    {
+        result = i < cached_count
+            ? derive_child_cached(ctx, node, indices[i], &child)
+            : derive_child(ctx, node, indices[i], &child);
+
+        if (DERIVE_SUCCESS == result)
+        {
+            *node = child;
+        }
+    }
+
+    signun_secure_zero(&child, sizeof child);
+
+    return result;
+}
+
+/*
+ * Reads a node from a private key, or a compressed or uncompressed public
+ * key, and a chain code. Throws on failure.
+ */
+static bool get_derive_node(napi_env env, const secp256k1_context *ctx, napi_value js_key, napi_value js_chain_code, derive_node_t *node)
+{
+    size_t key_length;
+    const unsigned char *key;
+    if (napi_ok != signun_get_bytes(env, js_key, (void **) &key, &key_length))
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as a key.");
+        return false;
+    }
+
+    size_t chain_code_length;
+    const unsigned char *chain_code;
+    if (napi_ok != signun_get_bytes(env, js_chain_code, (void **) &chain_code, &chain_code_length)
+        || CHAIN_CODE_LENGTH != chain_code_length)
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as a chain code.");
+        return false;
+    }
+
+    memset(node, 0, sizeof (derive_node_t));
+    memcpy(node->chain_code, chain_code, CHAIN_CODE_LENGTH);
+
+    if (KEY_LENGTH == key_length)
+    {
+        if (0 == secp256k1_ec_seckey_verify(ctx, key))
+        {
+            napi_throw_error(env, NULL, "Invalid private key was passed.");
+            return false;
+        }
+
+        node->is_private = true;
+        memcpy(node->private_key, key, KEY_LENGTH);
+
+        return true;
+    }
+
+    secp256k1_pubkey public_key;
+    if (0 == secp256k1_ec_pubkey_parse(ctx, &public_key, key, key_length))
+    {
+        napi_throw_error(env, NULL, "Could not parse the public key.");
+        return false;
+    }
+
+    size_t public_key_length = COMPRESSED_PUBLIC_KEY_LENGTH;
+    secp256k1_ec_pubkey_serialize(ctx, node->public_key, &public_key_length, &public_key, SECP256K1_EC_COMPRESSED);
+    node->has_public_key = true;
+
+    return true;
+}
+
+/*
+ * Reads an array of child indices. Throws on failure.
+ */
+static bool get_derive_path(napi_env env, napi_value js_path, uint32_t *indices, size_t *index_count)
+{
+    uint32_t length;
+    if (napi_ok != napi_get_array_length(env, js_path, &length) || DERIVE_MAX_DEPTH < length)
+    {
+        napi_throw_error(env, NULL, "Invalid array was passed as path.");
+        return false;
+    }
+
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        napi_value js_index;
+        if (napi_ok != napi_get_element(env, js_path, i, &js_index)
+            || napi_ok != napi_get_value_uint32(env, js_index, &indices[i]))
+        {
+            napi_throw_error(env, NULL, "Invalid index was passed in path.");
+            return false;
+        }
+    }
+
+    *index_count = length;
+
+    return true;
+}
+
+static napi_status create_node_object(napi_env env, const derive_node_t *node, napi_value *result)
+{
+    napi_value js_key;
+    napi_value js_chain_code;
+
+    RETURN_ON_FAILURE(napi_create_object(env, result));
+
+    if (node->is_private)
+    {
+        RETURN_ON_FAILURE(napi_create_buffer_copy(env, KEY_LENGTH, (void *)node->private_key, NULL, &js_key));
+        RETURN_ON_FAILURE(napi_set_named_property(env, *result, "privateKey", js_key));
+    }
+    else
+    {
+        RETURN_ON_FAILURE(napi_create_buffer_copy(env, COMPRESSED_PUBLIC_KEY_LENGTH, (void *)node->public_key, NULL, &js_key));
+        RETURN_ON_FAILURE(napi_set_named_property(env, *result, "publicKey", js_key));
+    }
+
+    RETURN_ON_FAILURE(napi_create_buffer_copy(env, CHAIN_CODE_LENGTH, (void *)node->chain_code, NULL, &js_chain_code));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "chainCode", js_chain_code));
+
+    return napi_ok;
+}
+
+napi_value secp256k1_addon_derive_master_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t seed_length;
+    const unsigned char *seed;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &seed, &seed_length),
+        env, "Invalid buffer was passed as seed."
+    );
+
+    unsigned char mac[SIGNUN_SHA512_DIGEST_LENGTH];
+    signun_hmac_sha512(master_key_hmac_key, sizeof master_key_hmac_key - 1, seed, seed_length, mac);
+
+    derive_node_t node = { .is_private = true };
+    memcpy(node.private_key, mac, KEY_LENGTH);
+    memcpy(node.chain_code, &mac[KEY_LENGTH], CHAIN_CODE_LENGTH);
+    signun_secure_zero(mac, sizeof mac);
+
+    if (0 == secp256k1_ec_seckey_verify(callback_data->secp256k1context, node.private_key))
+    {
+        signun_secure_zero(&node, sizeof node);
+        napi_throw_error(env, NULL, "The seed does not produce a valid master key.");
+        return NULL;
+    }
+
+    napi_value js_result;
+    napi_status status = create_node_object(env, &node, &js_result);
+    signun_secure_zero(&node, sizeof node);
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(status, env, "Could not create the result node.");
+
+    return js_result;
+}
+
+napi_value secp256k1_addon_derive_path_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value argv[3];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t index_count;
+    uint32_t indices[DERIVE_MAX_DEPTH];
+    if (!get_derive_path(env, argv[2], indices, &index_count))
+    {
+        return NULL;
+    }
+
+    derive_node_t node;
+    if (!get_derive_node(env, callback_data->secp256k1context, argv[0], argv[1], &node))
+    {
+        signun_secure_zero(&node, sizeof node);
+        return NULL;
+    }
+
+    const size_t cached_count = 0 < index_count ? index_count - 1 : 0;
+    derive_result_t result = derive_path(callback_data->secp256k1context, &node, indices, index_count, cached_count);
+    if (DERIVE_SUCCESS != result)
+    {
+        signun_secure_zero(&node, sizeof node);
+        napi_throw_error(env, NULL, derive_result_message(result));
+        return NULL;
+    }
+
+    napi_value js_result;
+    napi_status status = create_node_object(env, &node, &js_result);
+    signun_secure_zero(&node, sizeof node);
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(status, env, "Could not create the result node.");
+
+    return js_result;
+}
+
+static void derive_path_async_execute(napi_env env, void *data)
+{
+    derive_callback_data_t *callback_data = (derive_callback_data_t *) data;
+
+    const size_t cached_count = 0 < callback_data->index_count ? callback_data->index_count - 1 : 0;
+
+    callback_data->result = derive_path(callback_data->secp256k1context, &callback_data->node, callback_data->indices, callback_data->index_count, cached_count);
+}
+
+static void derive_path_async_complete(napi_env env, napi_status status, void *data)
+{
+    derive_callback_data_t *callback_data = (derive_callback_data_t *) data;
+
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
+    {
+        REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
+
+        signun_pool_release(env, &derive_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        signun_pool_release(env, &derive_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_ok != status)
+    {
+        REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
+
+        signun_pool_release(env, &derive_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (DERIVE_SUCCESS != callback_data->result)
+    {
+        REJECT_WITH_ERROR(env, derive_result_message(callback_data->result), callback_data->deferred);
+
+        signun_pool_release(env, &derive_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    napi_value js_result;
+    if (napi_ok != create_node_object(env, &callback_data->node, &js_result))
+    {
+        REJECT_WITH_ERROR(env, "Could not create the result node.", callback_data->deferred);
+
+        signun_pool_release(env, &derive_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    napi_resolve_deferred(env, callback_data->deferred, js_result);
+
+    signun_pool_release(env, &derive_callback_data_pool, callback_data);
+}
+
+napi_value secp256k1_addon_derive_path_async(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value argv[5];
+    secp256k1_addon_callback_data_t *current_callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
+        env, "Could not read function arguments."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    const char *resource_identifier = "secp256k1::async::derivePath";
+    napi_value derive_resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &derive_resource_name),
+        env, "Could not create resource name."
+    );
+
+    derive_callback_data_t *derive_callback_data = signun_pool_acquire(env, &derive_callback_data_pool);
+    if (!derive_callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+
+    derive_callback_data->secp256k1context = current_callback_data->secp256k1context;
+
+    if (!get_derive_path(env, argv[2], derive_callback_data->indices, &derive_callback_data->index_count)
+        || !get_derive_node(env, current_callback_data->secp256k1context, argv[0], argv[1], &derive_callback_data->node))
+    {
+        signun_pool_release(env, &derive_callback_data_pool, derive_callback_data);
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != napi_create_promise(env, &derive_callback_data->deferred, &promise))
+    {
+        signun_pool_release(env, &derive_callback_data_pool, derive_callback_data);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_task_create(env, &derive_callback_data->task, SIGNUN_OP_DERIVE, priority, cancel_token, derive_resource_name, derive_path_async_execute, derive_path_async_complete))
+    {
+        REJECT_WITH_ERROR(env, "Could not create async work.", derive_callback_data->deferred);
+        signun_pool_release(env, &derive_callback_data_pool, derive_callback_data);
+        return promise;
+    }
+
+    napi_async_work derive_async_work = derive_callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &derive_callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", derive_callback_data->deferred);
+        signun_pool_release(env, &derive_callback_data_pool, derive_callback_data);
+        napi_delete_async_work(env, derive_async_work);
+        return promise;
+    }
+
+    if (napi_ok != queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Could not queue async work.", derive_callback_data->deferred);
+        signun_pool_release(env, &derive_callback_data_pool, derive_callback_data);
+        napi_delete_async_work(env, derive_async_work);
+        return promise;
+    }
+
+    return promise;
+}
+
+static void derive_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    derive_batch_data_t *batch_data = (derive_batch_data_t *) batch;
+
+    // Every chunk derives the parent on its own, which only costs the first
+    // one to get there, as the rest is served by the cache.
+    derive_node_t parent = batch_data->root;
+    derive_node_t child;
+
+    derive_result_t result = derive_path(batch_data->secp256k1context, &parent, batch_data->indices, batch_data->index_count, batch_data->index_count);
+
+    for (size_t i = chunk->start; i < chunk->end && DERIVE_SUCCESS == result; ++i)
+    {
+        result = derive_child(batch_data->secp256k1context, &parent, batch_data->start + (uint32_t) i, &child);
+
+        if (DERIVE_SUCCESS == result)
+        {
+            memcpy(&batch_data->keys[i * batch_data->key_length], child.is_private ? child.private_key : child.public_key, batch_data->key_length);
+            memcpy(&batch_data->chain_codes[i * CHAIN_CODE_LENGTH], child.chain_code, CHAIN_CODE_LENGTH);
+        }
+    }
+
+    if (DERIVE_SUCCESS != result)
+    {
+        signun_batch_chunk_fail(batch, chunk, derive_result_message(result));
+    }
+
+    signun_secure_zero(&parent, sizeof parent);
+    signun_secure_zero(&child, sizeof child);
+}
+
+static napi_status derive_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    derive_batch_data_t *batch_data = (derive_batch_data_t *) batch;
+
+    napi_value js_keys;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 0, &js_keys));
+
+    napi_value js_chain_codes;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 1, &js_chain_codes));
+
+    RETURN_ON_FAILURE(napi_create_object(env, result));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, batch_data->root.is_private ? "privateKeys" : "publicKeys", js_keys));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "chainCodes", js_chain_codes));
+
+    return napi_ok;
+}
+
+static void derive_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    derive_batch_data_t *batch_data = (derive_batch_data_t *) batch;
+
+    signun_secure_zero(&batch_data->root, sizeof (derive_node_t));
+    free(batch_data);
+}
+
+napi_value secp256k1_addon_derive_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 7;
+    napi_value argv[7];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    uint32_t start;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[3], &start),
+        env, "Invalid number was passed as start index."
+    );
+
+    uint32_t count;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[4], &count),
+        env, "Invalid number was passed as count."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[5], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[6], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if ((uint64_t) start + count > 0x100000000ULL)
+    {
+        napi_throw_error(env, NULL, "The index range is out of bounds.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "secp256k1::batch::derive";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    derive_batch_data_t *batch_data = (derive_batch_data_t *)calloc(1, sizeof (derive_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->secp256k1context = callback_data->secp256k1context;
+    batch_data->start = start;
+
+    if (!get_derive_path(env, argv[2], batch_data->indices, &batch_data->index_count)
+        || !get_derive_node(env, callback_data->secp256k1context, argv[0], argv[1], &batch_data->root))
+    {
+        derive_batch_finalize(env, &batch_data->batch);
+        return NULL;
+    }
+
+    if (!batch_data->root.is_private && 0 < count && HARDENED_INDEX <= (uint64_t) start + count - 1)
+    {
+        derive_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, derive_result_message(DERIVE_HARDENED_FROM_PUBLIC));
+        return NULL;
+    }
+
+    batch_data->key_length = batch_data->root.is_private ? KEY_LENGTH : COMPRESSED_PUBLIC_KEY_LENGTH;
+
+    napi_value js_keys;
+    napi_value js_chain_codes;
+    if (napi_ok != napi_create_buffer(env, (size_t) count * batch_data->key_length, (void **) &batch_data->keys, &js_keys)
+        || napi_ok != napi_create_buffer(env, (size_t) count * CHAIN_CODE_LENGTH, (void **) &batch_data->chain_codes, &js_chain_codes))
+    {
+        derive_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffers.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, DERIVE_BATCH_CHUNK_SIZE,
+        derive_batch_execute, derive_batch_complete, derive_batch_finalize, &promise))
+    {
+        derive_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, js_keys)
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_chain_codes))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        derive_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_DERIVE_BATCH, priority, cancel_token, resource_name);
+
+    return promise;
+}
+
+napi_value secp256k1_addon_clear_derivation_cache(napi_env env, napi_callback_info info)
+{
+    uv_once(&derive_cache_once, init_derive_cache);
+
+    uv_mutex_lock(&derive_cache_mutex);
+    signun_secure_zero(derive_cache, sizeof derive_cache);
+    uv_mutex_unlock(&derive_cache_mutex);
+
+    return NULL;
+}
@@ -0,0 +1,436 @@
+#include "secp256k1_addon/ecdh.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "secp256k1.h"
+#include "secp256k1_ecdh.h"
+
+#include "signun_batch.h"
+#include "signun_pool.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+#include "secp256k1_addon/public_key_convert.h"
+#include "secp256k1_addon/util.h"
+
+
+#define ECDH_POOL_HIGH_WATER_MARK 256
+#define ECDH_BATCH_CHUNK_SIZE 128
+
+typedef struct
+{
+    signun_task_t task;
+
+    napi_deferred deferred;
+    secp256k1_context *secp256k1context;
+
+    size_t raw_public_key_length;
+    unsigned char raw_public_key[SERIALIZED_PUBLIC_KEY_LENGTH];
+    unsigned char private_key[KEY_LENGTH];
+    bool is_raw;
+
+    bool success;
+    unsigned char secret[SHARED_POINT_LENGTH];
+} ecdh_callback_data_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+    secp256k1_context *secp256k1context;
+
+    const unsigned char *raw_public_keys;
+    size_t raw_public_key_length;
+    unsigned char private_key[KEY_LENGTH];
+
+    unsigned char *secrets;
+    unsigned char *valid;
+} ecdh_batch_data_t;
+
+static const signun_pool_t ecdh_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_ECDH, ecdh_callback_data_t, ECDH_POOL_HIGH_WATER_MARK, true);
+
+/*
+ * Hands out the shared point as is, for custom hash functions, which are run
+ * by the JavaScript side.
+ */
+static int copy_point_hash_function(unsigned char *output, const unsigned char *x32, const unsigned char *y32, void *data)
+{
+    memcpy(output, x32, 32);
+    memcpy(&output[32], y32, 32);
+
+    return 1;
+}
+
+static bool compute_shared_secret(const secp256k1_context *ctx, unsigned char *output, const unsigned char *raw_public_key, size_t raw_public_key_length,
+    const unsigned char *private_key, bool is_raw)
+{
+    secp256k1_pubkey public_key;
+    if (!secp256k1_addon_public_key_parse(ctx, &public_key, raw_public_key, raw_public_key_length))
+    {
+        return false;
+    }
+
+    return 1 == secp256k1_ecdh(ctx, output, &public_key, private_key, is_raw ? copy_point_hash_function : secp256k1_ecdh_hash_function_default, NULL);
+}
+
+napi_value secp256k1_addon_ecdh_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value argv[3];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_public_key_length;
+    const unsigned char *raw_public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &raw_public_key, &raw_public_key_length),
+        env, "Invalid buffer was passed as a public key."
+    );
+
+    size_t private_key_length;
+    const unsigned char *private_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &private_key, &private_key_length),
+        env, "Invalid buffer was passed as a private key."
+    );
+
+    bool is_raw;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[2], &is_raw),
+        env, "Invalid bool was passed as raw flag."
+    );
+
+    unsigned char secret[SHARED_POINT_LENGTH];
+    if (!compute_shared_secret(callback_data->secp256k1context, secret, raw_public_key, raw_public_key_length, private_key, is_raw))
+    {
+        signun_secure_zero(secret, sizeof secret);
+        napi_throw_error(env, NULL, "Could not compute the shared secret.");
+        return NULL;
+    }
+
+    napi_value js_result;
+    napi_status status = napi_create_buffer_copy(env, is_raw ? SHARED_POINT_LENGTH : SHARED_SECRET_LENGTH, (void *)secret, NULL, &js_result);
+    signun_secure_zero(secret, sizeof secret);
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(status, env, "Could not set the result buffer.");
+
+    return js_result;
+}
+
+static void ecdh_async_execute(napi_env env, void *data)
+{
+    ecdh_callback_data_t *callback_data = (ecdh_callback_data_t *) data;
+
+    callback_data->success = compute_shared_secret(callback_data->secp256k1context, callback_data->secret,
+        callback_data->raw_public_key, callback_data->raw_public_key_length, callback_data->private_key, callback_data->is_raw);
+}
+
+static void ecdh_async_complete(napi_env env, napi_status status, void *data)
+{
+    ecdh_callback_data_t *callback_data = (ecdh_callback_data_t *) data;
+
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
+    {
+        REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
+
+        signun_pool_release(env, &ecdh_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        signun_pool_release(env, &ecdh_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_ok != status)
+    {
+        REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
+
+        signun_pool_release(env, &ecdh_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (!callback_data->success)
+    {
+        REJECT_WITH_ERROR(env, "Could not compute the shared secret.", callback_data->deferred);
+
+        signun_pool_release(env, &ecdh_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    napi_value js_result;
+    if (napi_ok != napi_create_buffer_copy(env, callback_data->is_raw ? SHARED_POINT_LENGTH : SHARED_SECRET_LENGTH, (void *)callback_data->secret, NULL, &js_result))
+    {
+        REJECT_WITH_ERROR(env, "Could not set the result buffer.", callback_data->deferred);
+
+        signun_pool_release(env, &ecdh_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    napi_resolve_deferred(env, callback_data->deferred, js_result);
+
+    signun_pool_release(env, &ecdh_callback_data_pool, callback_data);
+}
+
+napi_value secp256k1_addon_ecdh_async(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value argv[5];
+    secp256k1_addon_callback_data_t *current_callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_public_key_length;
+    const unsigned char *raw_public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &raw_public_key, &raw_public_key_length),
+        env, "Invalid buffer was passed as a public key."
+    );
+
+    size_t private_key_length;
+    const unsigned char *private_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &private_key, &private_key_length),
+        env, "Invalid buffer was passed as a private key."
+    );
+
+    bool is_raw;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[2], &is_raw),
+        env, "Invalid bool was passed as raw flag."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (SERIALIZED_PUBLIC_KEY_LENGTH < raw_public_key_length || KEY_LENGTH != private_key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid key length.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "secp256k1::async::ecdh";
+    napi_value ecdh_resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &ecdh_resource_name),
+        env, "Could not create resource name."
+    );
+
+    ecdh_callback_data_t *ecdh_callback_data = signun_pool_acquire(env, &ecdh_callback_data_pool);
+    if (!ecdh_callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+
+    ecdh_callback_data->secp256k1context = current_callback_data->secp256k1context;
+    ecdh_callback_data->raw_public_key_length = raw_public_key_length;
+    memcpy(ecdh_callback_data->raw_public_key, raw_public_key, raw_public_key_length);
+    memcpy(ecdh_callback_data->private_key, private_key, KEY_LENGTH);
+    ecdh_callback_data->is_raw = is_raw;
+
+    napi_value promise;
+    if (napi_ok != napi_create_promise(env, &ecdh_callback_data->deferred, &promise))
+    {
+        signun_pool_release(env, &ecdh_callback_data_pool, ecdh_callback_data);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_task_create(env, &ecdh_callback_data->task, SIGNUN_OP_ECDH, priority, cancel_token, ecdh_resource_name, ecdh_async_execute, ecdh_async_complete))
+    {
+        REJECT_WITH_ERROR(env, "Could not create async work.", ecdh_callback_data->deferred);
+        signun_pool_release(env, &ecdh_callback_data_pool, ecdh_callback_data);
+        return promise;
+    }
+
+    napi_async_work ecdh_async_work = ecdh_callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &ecdh_callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", ecdh_callback_data->deferred);
+        signun_pool_release(env, &ecdh_callback_data_pool, ecdh_callback_data);
+        napi_delete_async_work(env, ecdh_async_work);
+        return promise;
+    }
+
+    if (napi_ok != queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Could not queue async work.", ecdh_callback_data->deferred);
+        signun_pool_release(env, &ecdh_callback_data_pool, ecdh_callback_data);
+        napi_delete_async_work(env, ecdh_async_work);
+        return promise;
+    }
+
+    return promise;
+}
+
+static void ecdh_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    ecdh_batch_data_t *batch_data = (ecdh_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        unsigned char *secret = &batch_data->secrets[i * SHARED_SECRET_LENGTH];
+
+        if (!compute_shared_secret(batch_data->secp256k1context, secret, &batch_data->raw_public_keys[i * batch_data->raw_public_key_length],
+            batch_data->raw_public_key_length, batch_data->private_key, false))
+        {
+            memset(secret, 0, SHARED_SECRET_LENGTH);
+            batch_data->valid[i] = 0;
+            continue;
+        }
+
+        batch_data->valid[i] = 1;
+    }
+}
+
+static napi_status ecdh_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    napi_value js_secrets;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 1, &js_secrets));
+
+    napi_value js_valid;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 2, &js_valid));
+
+    RETURN_ON_FAILURE(napi_create_object(env, result));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "secrets", js_secrets));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "valid", js_valid));
+
+    return napi_ok;
+}
+
+static void ecdh_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    ecdh_batch_data_t *batch_data = (ecdh_batch_data_t *) batch;
+
+    signun_secure_zero(batch_data->private_key, KEY_LENGTH);
+    free(batch_data);
+}
+
+napi_value secp256k1_addon_ecdh_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value argv[5];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_public_keys_length;
+    const unsigned char *raw_public_keys;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &raw_public_keys, &raw_public_keys_length),
+        env, "Invalid buffer was passed as public keys."
+    );
+
+    uint32_t raw_public_key_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[1], &raw_public_key_length),
+        env, "Invalid number was passed as public key length."
+    );
+
+    size_t private_key_length;
+    const unsigned char *private_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &private_key, &private_key_length),
+        env, "Invalid buffer was passed as a private key."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if ((XONLY_PUBLIC_KEY_LENGTH != raw_public_key_length && COMPRESSED_PUBLIC_KEY_LENGTH != raw_public_key_length
+            && SERIALIZED_PUBLIC_KEY_LENGTH != raw_public_key_length)
+        || 0 != raw_public_keys_length % raw_public_key_length || KEY_LENGTH != private_key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid key length.");
+        return NULL;
+    }
+
+    const size_t count = raw_public_keys_length / raw_public_key_length;
+
+    const char *resource_identifier = "secp256k1::batch::ecdh";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    ecdh_batch_data_t *batch_data = (ecdh_batch_data_t *)calloc(1, sizeof (ecdh_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->secp256k1context = callback_data->secp256k1context;
+    batch_data->raw_public_keys = raw_public_keys;
+    batch_data->raw_public_key_length = raw_public_key_length;
+    memcpy(batch_data->private_key, private_key, KEY_LENGTH);
+
+    napi_value js_secrets;
+    napi_value js_valid;
+    if (napi_ok != napi_create_buffer(env, count * SHARED_SECRET_LENGTH, (void **) &batch_data->secrets, &js_secrets)
+        || napi_ok != napi_create_buffer(env, count, (void **) &batch_data->valid, &js_valid))
+    {
+        ecdh_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffers.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, ECDH_BATCH_CHUNK_SIZE,
+        ecdh_batch_execute, ecdh_batch_complete, ecdh_batch_finalize, &promise))
+    {
+        ecdh_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_secrets)
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_valid))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        ecdh_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_ECDH_BATCH, priority, cancel_token, resource_name);
+
+    return promise;
+}
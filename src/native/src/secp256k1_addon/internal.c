@@ -0,0 +1,253 @@
+/*
+ * Compiles the secp256k1 library itself, by including its single translation
+ * unit like its own tests and benchmarks do, so that the functions below can
+ * use its internal group and scalar arithmetic. They follow the internal API
+ * of the pinned revision, and have to be revisited when the pin moves.
+ */
+#include "secp256k1.c"
+
+#include "secp256k1_addon/internal.h"
+
+#include <stdlib.h>
+
+#include <uv.h>
+
+#include "secp256k1_addon/util.h"
+
+
+#define SCALAR_BITS 256
+
+// Public keys get narrow windows, to keep pinning them cheap. The generator
+// is shared by every verification, so its wider windows halve its additions.
+#define WINDOW_TABLE_BITS 4
+#define GENERATOR_TABLE_BITS 8
+
+#define WINDOW_COUNT(bits) (SCALAR_BITS / (bits))
+#define WINDOW_DIGIT_COUNT(bits) ((1 << (bits)) - 1)
+#define WINDOW_TABLE_LENGTH(bits) (WINDOW_COUNT(bits) * WINDOW_DIGIT_COUNT(bits))
+
+struct secp256k1_addon_window_table_s
+{
+    secp256k1_ge_storage points[WINDOW_TABLE_LENGTH(WINDOW_TABLE_BITS)];
+};
+
+static secp256k1_ge_storage *generator_table = NULL;
+static uv_once_t generator_table_once = UV_ONCE_INIT;
+
+
+bool secp256k1_addon_ec_pubkey_create_all(const secp256k1_context *ctx, secp256k1_pubkey *public_keys, const unsigned char *private_keys, size_t count)
+{
+    secp256k1_gej *jacobian_points = (secp256k1_gej *) malloc(count * sizeof (secp256k1_gej));
+    secp256k1_ge *points = (secp256k1_ge *) malloc(count * sizeof (secp256k1_ge));
+    if (!jacobian_points || !points)
+    {
+        free(jacobian_points);
+        free(points);
+        return false;
+    }
+
+    int is_valid = 1;
+    for (size_t i = 0; i < count; ++i)
+    {
+        secp256k1_scalar scalar;
+        const int is_scalar_valid = secp256k1_scalar_set_b32_seckey(&scalar, &private_keys[i * KEY_LENGTH]);
+
+        // As in secp256k1_ec_pubkey_create, an invalid key is swapped for one
+        // so that the multiplication takes the same time.
+        secp256k1_scalar_cmov(&scalar, &secp256k1_scalar_one, !is_scalar_valid);
+        is_valid &= is_scalar_valid;
+
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &jacobian_points[i], &scalar);
+        secp256k1_scalar_clear(&scalar);
+    }
+
+    // The projective blinding of secp256k1_ecmult_gen randomizes the Z
+    // coordinates, so inverting them in variable time is safe.
+    secp256k1_ge_set_all_gej_var(points, jacobian_points, count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        secp256k1_pubkey_save(&public_keys[i], &points[i]);
+    }
+
+    free(jacobian_points);
+    free(points);
+
+    return 1 == is_valid;
+}
+
+/*
+ * Fills the table with digit * 2^(bits * window) * point for every nonzero
+ * digit of every window, in affine coordinates through a single inversion.
+ */
+static bool build_window_table(secp256k1_ge_storage *table, const secp256k1_ge *point, unsigned int bits)
+{
+    const size_t digit_count = WINDOW_DIGIT_COUNT(bits);
+    const size_t length = WINDOW_TABLE_LENGTH(bits);
+
+    secp256k1_gej *jacobian_points = (secp256k1_gej *) malloc(length * sizeof (secp256k1_gej));
+    secp256k1_ge *points = (secp256k1_ge *) malloc(length * sizeof (secp256k1_ge));
+    if (!jacobian_points || !points)
+    {
+        free(jacobian_points);
+        free(points);
+        return false;
+    }
+
+    secp256k1_gej base;
+    secp256k1_gej_set_ge(&base, point);
+
+    for (size_t window = 0; window < WINDOW_COUNT(bits); ++window)
+    {
+        secp256k1_gej *row = &jacobian_points[window * digit_count];
+
+        row[0] = base;
+        for (size_t digit = 1; digit < digit_count; ++digit)
+        {
+            secp256k1_gej_add_var(&row[digit], &row[digit - 1], &base, NULL);
+        }
+
+        for (unsigned int i = 0; i < bits; ++i)
+        {
+            secp256k1_gej_double_var(&base, &base, NULL);
+        }
+    }
+
+    secp256k1_ge_set_all_gej_var(points, jacobian_points, length);
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        secp256k1_ge_to_storage(&table[i], &points[i]);
+    }
+
+    free(jacobian_points);
+    free(points);
+
+    return true;
+}
+
+static void build_generator_table(void)
+{
+    secp256k1_ge_storage *table = (secp256k1_ge_storage *) malloc(WINDOW_TABLE_LENGTH(GENERATOR_TABLE_BITS) * sizeof (secp256k1_ge_storage));
+    if (table && !build_window_table(table, &secp256k1_ge_const_g, GENERATOR_TABLE_BITS))
+    {
+        free(table);
+        table = NULL;
+    }
+
+    generator_table = table;
+}
+
+/*
+ * Adds scalar * point to r, one table entry per nonzero digit. Variable time,
+ * as verification only handles public data.
+ */
+static void ecmult_window(secp256k1_gej *r, const secp256k1_ge_storage *table, unsigned int bits, const secp256k1_scalar *scalar)
+{
+    const size_t digit_count = WINDOW_DIGIT_COUNT(bits);
+
+    unsigned char scalar_bytes[32];
+    secp256k1_scalar_get_b32(scalar_bytes, scalar);
+
+    for (size_t window = 0; window < WINDOW_COUNT(bits); ++window)
+    {
+        // Windows never straddle bytes, as bits divides 8.
+        const size_t offset = window * bits;
+        const size_t digit = (scalar_bytes[31 - offset / 8] >> (offset % 8)) & digit_count;
+
+        if (0 != digit)
+        {
+            secp256k1_ge point;
+            secp256k1_ge_from_storage(&point, &table[window * digit_count + digit - 1]);
+            secp256k1_gej_add_ge_var(r, r, &point, NULL);
+        }
+    }
+}
+
+size_t secp256k1_addon_window_table_size(void)
+{
+    return sizeof (secp256k1_addon_window_table_t);
+}
+
+secp256k1_addon_window_table_t *secp256k1_addon_window_table_create(const secp256k1_context *ctx, const secp256k1_pubkey *public_key)
+{
+    uv_once(&generator_table_once, build_generator_table);
+
+    secp256k1_ge point;
+    if (!generator_table || !secp256k1_pubkey_load(ctx, &point, public_key))
+    {
+        return NULL;
+    }
+
+    secp256k1_addon_window_table_t *table = (secp256k1_addon_window_table_t *) malloc(sizeof (secp256k1_addon_window_table_t));
+    if (table && !build_window_table(table->points, &point, WINDOW_TABLE_BITS))
+    {
+        free(table);
+        return NULL;
+    }
+
+    return table;
+}
+
+void secp256k1_addon_window_table_destroy(secp256k1_addon_window_table_t *table)
+{
+    free(table);
+}
+
+/*
+ * Follows secp256k1_ecdsa_verify and secp256k1_ecdsa_sig_verify, with both
+ * multiplications looked up in window tables instead of secp256k1_ecmult.
+ */
+bool secp256k1_addon_ecdsa_verify_window(const secp256k1_context *ctx, const secp256k1_ecdsa_signature *signature,
+    const unsigned char *message, const secp256k1_addon_window_table_t *table)
+{
+    secp256k1_scalar r;
+    secp256k1_scalar s;
+    secp256k1_scalar m;
+    secp256k1_scalar_set_b32(&m, message, NULL);
+    secp256k1_ecdsa_signature_load(ctx, &r, &s, signature);
+
+    if (secp256k1_scalar_is_high(&s) || secp256k1_scalar_is_zero(&r) || secp256k1_scalar_is_zero(&s))
+    {
+        return false;
+    }
+
+    // R = (m / s) * G + (r / s) * P
+    secp256k1_scalar sn;
+    secp256k1_scalar u1;
+    secp256k1_scalar u2;
+    secp256k1_scalar_inverse_var(&sn, &s);
+    secp256k1_scalar_mul(&u1, &sn, &m);
+    secp256k1_scalar_mul(&u2, &sn, &r);
+
+    secp256k1_gej pr;
+    secp256k1_gej_set_infinity(&pr);
+    ecmult_window(&pr, generator_table, GENERATOR_TABLE_BITS, &u1);
+    ecmult_window(&pr, table->points, WINDOW_TABLE_BITS, &u2);
+
+    if (secp256k1_gej_is_infinity(&pr))
+    {
+        return false;
+    }
+
+    // The X coordinate of R has to be r, or r plus the order if that is
+    // still below the field size.
+    unsigned char c[32];
+    secp256k1_fe xr;
+    secp256k1_scalar_get_b32(c, &r);
+    (void) secp256k1_fe_set_b32_limit(&xr, c);
+
+    if (secp256k1_gej_eq_x_var(&xr, &pr))
+    {
+        return true;
+    }
+
+    if (secp256k1_fe_cmp_var(&xr, &secp256k1_ecdsa_const_p_minus_order) >= 0)
+    {
+        return false;
+    }
+
+    secp256k1_fe_add(&xr, &secp256k1_ecdsa_const_order_as_fe);
+
+    return secp256k1_gej_eq_x_var(&xr, &pr);
+}
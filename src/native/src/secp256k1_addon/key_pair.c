@@ -0,0 +1,275 @@
+#include "secp256k1_addon/key_pair.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <uv.h>
+
+#include "secp256k1.h"
+
+#include "signun_batch.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+#include "secp256k1_addon/internal.h"
+#include "secp256k1_addon/util.h"
+
+
+#define KEY_PAIR_BATCH_CHUNK_SIZE 256
+
+// A random scalar is out of range with a probability of about 2^-128, so
+// running out of attempts means that the entropy source is broken.
+#define KEY_PAIR_MAX_ATTEMPTS 16
+
+typedef struct
+{
+    signun_batch_t batch;
+    secp256k1_context *secp256k1context;
+
+    size_t public_key_length;
+    unsigned char *private_keys;
+    unsigned char *public_keys;
+} key_pair_batch_data_t;
+
+/*
+ * Draws private keys from the operating system, through getrandom on Linux,
+ * until one is a valid scalar.
+ */
+static bool draw_private_key(const secp256k1_context *ctx, unsigned char *private_key)
+{
+    for (int i = 0; i < KEY_PAIR_MAX_ATTEMPTS; ++i)
+    {
+        if (0 != uv_random(NULL, NULL, private_key, KEY_LENGTH, 0, NULL))
+        {
+            break;
+        }
+
+        if (1 == secp256k1_ec_seckey_verify(ctx, private_key))
+        {
+            return true;
+        }
+    }
+
+    signun_secure_zero(private_key, KEY_LENGTH);
+    return false;
+}
+
+static void serialize_public_key(const secp256k1_context *ctx, unsigned char *output, size_t public_key_length, const secp256k1_pubkey *public_key)
+{
+    const unsigned int serialization_flags = COMPRESSED_PUBLIC_KEY_LENGTH == public_key_length ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED;
+    secp256k1_ec_pubkey_serialize(ctx, output, &public_key_length, public_key, serialization_flags);
+}
+
+static bool generate_key_pair(const secp256k1_context *ctx, unsigned char *private_key, unsigned char *public_key, size_t public_key_length)
+{
+    if (!draw_private_key(ctx, private_key))
+    {
+        return false;
+    }
+
+    secp256k1_pubkey parsed_public_key;
+    if (0 == secp256k1_ec_pubkey_create(ctx, &parsed_public_key, private_key))
+    {
+        signun_secure_zero(private_key, KEY_LENGTH);
+        return false;
+    }
+
+    serialize_public_key(ctx, public_key, public_key_length, &parsed_public_key);
+
+    return true;
+}
+
+static napi_status create_key_pair_object(napi_env env, napi_value js_private_key, napi_value js_public_key, napi_value *result)
+{
+    RETURN_ON_FAILURE(napi_create_object(env, result));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "privateKey", js_private_key));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "publicKey", js_public_key));
+
+    return napi_ok;
+}
+
+napi_value secp256k1_addon_generate_key_pair_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    bool is_compressed;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[0], &is_compressed),
+        env, "Invalid bool was passed as compressed flag."
+    );
+
+    const size_t public_key_length = is_compressed ? COMPRESSED_PUBLIC_KEY_LENGTH : SERIALIZED_PUBLIC_KEY_LENGTH;
+
+    napi_value js_private_key;
+    unsigned char *private_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer(env, KEY_LENGTH, (void **) &private_key, &js_private_key),
+        env, "Could not create the private key buffer."
+    );
+
+    napi_value js_public_key;
+    unsigned char *public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer(env, public_key_length, (void **) &public_key, &js_public_key),
+        env, "Could not create the public key buffer."
+    );
+
+    if (!generate_key_pair(callback_data->secp256k1context, private_key, public_key, public_key_length))
+    {
+        napi_throw_error(env, NULL, "Could not generate a key pair.");
+        return NULL;
+    }
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        create_key_pair_object(env, js_private_key, js_public_key, &js_result),
+        env, "Could not create the result object."
+    );
+
+    return js_result;
+}
+
+/*
+ * Draws the private keys of the whole chunk first, so that their public keys
+ * share a single field inversion.
+ */
+static void key_pair_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    key_pair_batch_data_t *batch_data = (key_pair_batch_data_t *) batch;
+
+    const size_t count = chunk->end - chunk->start;
+    unsigned char *private_keys = &batch_data->private_keys[chunk->start * KEY_LENGTH];
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!draw_private_key(batch_data->secp256k1context, &private_keys[i * KEY_LENGTH]))
+        {
+            signun_secure_zero(private_keys, count * KEY_LENGTH);
+            signun_batch_chunk_fail(batch, chunk, "Could not generate a key pair.");
+            return;
+        }
+    }
+
+    secp256k1_pubkey public_keys[KEY_PAIR_BATCH_CHUNK_SIZE];
+    if (!secp256k1_addon_ec_pubkey_create_all(batch_data->secp256k1context, public_keys, private_keys, count))
+    {
+        signun_secure_zero(private_keys, count * KEY_LENGTH);
+        signun_batch_chunk_fail(batch, chunk, "Could not generate a key pair.");
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        serialize_public_key(batch_data->secp256k1context, &batch_data->public_keys[(chunk->start + i) * batch_data->public_key_length],
+            batch_data->public_key_length, &public_keys[i]);
+    }
+}
+
+static napi_status key_pair_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    napi_value js_private_keys;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 0, &js_private_keys));
+
+    napi_value js_public_keys;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 1, &js_public_keys));
+
+    RETURN_ON_FAILURE(napi_create_object(env, result));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "privateKeys", js_private_keys));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "publicKeys", js_public_keys));
+
+    return napi_ok;
+}
+
+static void key_pair_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    free(batch);
+}
+
+napi_value secp256k1_addon_generate_key_pairs(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value argv[4];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    uint32_t count;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[0], &count),
+        env, "Invalid number was passed as count."
+    );
+
+    bool is_compressed;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[1], &is_compressed),
+        env, "Invalid bool was passed as compressed flag."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[2], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[3], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    const char *resource_identifier = "secp256k1::batch::generateKeyPairs";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    key_pair_batch_data_t *batch_data = (key_pair_batch_data_t *)calloc(1, sizeof (key_pair_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->secp256k1context = callback_data->secp256k1context;
+    batch_data->public_key_length = is_compressed ? COMPRESSED_PUBLIC_KEY_LENGTH : SERIALIZED_PUBLIC_KEY_LENGTH;
+
+    napi_value js_private_keys;
+    napi_value js_public_keys;
+    if (napi_ok != napi_create_buffer(env, count * KEY_LENGTH, (void **) &batch_data->private_keys, &js_private_keys)
+        || napi_ok != napi_create_buffer(env, count * batch_data->public_key_length, (void **) &batch_data->public_keys, &js_public_keys))
+    {
+        key_pair_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffers.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, KEY_PAIR_BATCH_CHUNK_SIZE,
+        key_pair_batch_execute, key_pair_batch_complete, key_pair_batch_finalize, &promise))
+    {
+        key_pair_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, js_private_keys)
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_public_keys))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        key_pair_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_KEY_PAIR, priority, cancel_token, resource_name);
+
+    return promise;
+}
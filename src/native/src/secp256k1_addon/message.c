@@ -0,0 +1,1075 @@
+#include "secp256k1_addon/message.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "secp256k1.h"
+
+#include "signun_batch.h"
+#include "signun_pool.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+#include "blake2_addon/signun_blake2b.h"
+#include "secp256k1_addon/public_key_pin.h"
+#include "secp256k1_addon/signature_cache.h"
+#include "secp256k1_addon/sign.h"
+#include "secp256k1_addon/util.h"
+
+
+#define MESSAGE_POOL_HIGH_WATER_MARK 256
+
+// Strings up to this length are encoded into the callback data itself.
+#define MESSAGE_SCRATCH_LENGTH 512
+
+// Hashing a payload is cheap next to an ECDSA operation, so the chunks are
+// sized like the ones of signBatch and verifyBatch.
+#define MESSAGE_BATCH_CHUNK_SIZE 128
+
+typedef struct
+{
+    signun_task_t task;
+
+    napi_deferred deferred;
+    secp256k1_context *secp256k1context;
+
+    size_t payload_length;
+    unsigned char *payload;
+    unsigned char *allocated_payload;
+    napi_ref payload_ref;
+    unsigned char scratch[MESSAGE_SCRATCH_LENGTH];
+
+    size_t personal_length;
+    unsigned char personal[BLAKE2B_PERSONAL_LENGTH];
+
+    unsigned char private_key[KEY_LENGTH];
+    unsigned char data[DATA_LENGTH];
+    bool is_data_null;
+    secp256k1_addon_nonce_type_t nonce_type;
+    unsigned char tag[ALGORITHM_LENGTH];
+
+    bool success;
+
+    unsigned char signature[SIGNATURE_LENGTH];
+    int recovery_id;
+} sign_message_callback_data_t;
+
+typedef struct
+{
+    signun_task_t task;
+
+    napi_deferred deferred;
+    secp256k1_context *secp256k1context;
+
+    size_t payload_length;
+    unsigned char *payload;
+    unsigned char *allocated_payload;
+    napi_ref payload_ref;
+    unsigned char scratch[MESSAGE_SCRATCH_LENGTH];
+
+    size_t personal_length;
+    unsigned char personal[BLAKE2B_PERSONAL_LENGTH];
+
+    unsigned char raw_signature[SIGNATURE_LENGTH];
+    size_t raw_public_key_length;
+    unsigned char raw_public_key[SERIALIZED_PUBLIC_KEY_LENGTH];
+
+    bool result;
+} verify_message_callback_data_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+    secp256k1_context *secp256k1context;
+
+    // count + 1 offsets into payloads, payload i spans [offsets[i], offsets[i + 1]).
+    const unsigned char *payloads;
+    const uint32_t *offsets;
+
+    size_t personal_length;
+    unsigned char personal[BLAKE2B_PERSONAL_LENGTH];
+
+    unsigned char private_key[KEY_LENGTH];
+    unsigned char data[DATA_LENGTH];
+    bool is_data_null;
+    secp256k1_addon_nonce_type_t nonce_type;
+    unsigned char tag[ALGORITHM_LENGTH];
+
+    unsigned char *signatures;
+    unsigned char *recoveries;
+    unsigned char *valid;
+} sign_message_batch_data_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+    secp256k1_context *secp256k1context;
+
+    const unsigned char *payloads;
+    const uint32_t *offsets;
+
+    size_t personal_length;
+    unsigned char personal[BLAKE2B_PERSONAL_LENGTH];
+
+    const unsigned char *raw_signatures;
+    const unsigned char *raw_public_keys;
+    size_t raw_public_key_length;
+
+    unsigned char *results;
+} verify_message_batch_data_t;
+
+static const signun_pool_t sign_message_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_SIGN_MESSAGE, sign_message_callback_data_t, MESSAGE_POOL_HIGH_WATER_MARK, true);
+static const signun_pool_t verify_message_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_VERIFY_MESSAGE, verify_message_callback_data_t, MESSAGE_POOL_HIGH_WATER_MARK, false);
+
+static void release_sign_message_callback_data(napi_env env, sign_message_callback_data_t *callback_data)
+{
+    signun_unpin_bytes(env, &callback_data->payload_ref);
+
+    free(callback_data->allocated_payload);
+    callback_data->allocated_payload = NULL;
+
+    signun_pool_release(env, &sign_message_callback_data_pool, callback_data);
+}
+
+static void release_verify_message_callback_data(napi_env env, verify_message_callback_data_t *callback_data)
+{
+    signun_unpin_bytes(env, &callback_data->payload_ref);
+
+    free(callback_data->allocated_payload);
+    callback_data->allocated_payload = NULL;
+
+    signun_pool_release(env, &verify_message_callback_data_pool, callback_data);
+}
+
+/*
+ * The digest is BLAKE2b-256 of the payload, personalized if personal is set,
+ * which is what blake2b.hash(payload, 32) returns for an unpersonalized one.
+ */
+static bool message_digest(unsigned char *digest, const unsigned char *personal, size_t personal_length,
+    const unsigned char *payload, size_t payload_length)
+{
+    return 0 == blake2_addon_blake2b_personal(digest, MESSAGE_LENGTH, personal, personal_length, payload, payload_length);
+}
+
+static bool verify_digest(const secp256k1_context *ctx, const unsigned char *digest, const unsigned char *raw_signature,
+    const unsigned char *raw_public_key, size_t raw_public_key_length)
+{
+    secp256k1_addon_signature_cache_key_t cache_key;
+    if (secp256k1_addon_signature_cache_lookup(&cache_key, digest, raw_signature, SIGNATURE_LENGTH, raw_public_key, raw_public_key_length, 0))
+    {
+        return true;
+    }
+
+    secp256k1_ecdsa_signature signature;
+    if (0 == secp256k1_ecdsa_signature_parse_compact(ctx, &signature, raw_signature))
+    {
+        return false;
+    }
+
+    if (!secp256k1_addon_ecdsa_verify_public_key(ctx, &signature, digest, raw_public_key, raw_public_key_length))
+    {
+        return false;
+    }
+
+    secp256k1_addon_signature_cache_insert(&cache_key);
+
+    return true;
+}
+
+/*
+ * Reads a personalization string, which is null or at most BLAKE2B_PERSONAL_LENGTH bytes.
+ */
+static napi_status get_personal(napi_env env, napi_value js_personal, unsigned char *personal, size_t *personal_length)
+{
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, js_personal, &type));
+
+    *personal_length = 0;
+    if (napi_null == type)
+    {
+        return napi_ok;
+    }
+
+    const unsigned char *raw_personal;
+    RETURN_ON_FAILURE(signun_get_bytes(env, js_personal, (void **) &raw_personal, personal_length));
+
+    if (BLAKE2B_PERSONAL_LENGTH < *personal_length)
+    {
+        return napi_invalid_arg;
+    }
+
+    memcpy(personal, raw_personal, *personal_length);
+
+    return napi_ok;
+}
+
+/*
+ * Reads the extra nonce data, which is null or DATA_LENGTH bytes.
+ */
+static napi_status get_nonce_data(napi_env env, napi_value js_data, unsigned char *data, bool *is_data_null)
+{
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, js_data, &type));
+
+    *is_data_null = napi_null == type;
+    if (*is_data_null)
+    {
+        return napi_ok;
+    }
+
+    size_t raw_data_length;
+    const unsigned char *raw_data;
+    RETURN_ON_FAILURE(signun_get_bytes(env, js_data, (void **) &raw_data, &raw_data_length));
+
+    if (DATA_LENGTH != raw_data_length)
+    {
+        return napi_invalid_arg;
+    }
+
+    memcpy(data, raw_data, DATA_LENGTH);
+
+    return napi_ok;
+}
+
+static napi_status create_signature_object(napi_env env, const unsigned char *signature, int recovery_id, napi_value *result)
+{
+    napi_value js_signature;
+    RETURN_ON_FAILURE(napi_create_buffer_copy(env, SIGNATURE_LENGTH, (const void *) signature, NULL, &js_signature));
+
+    napi_value js_recovery;
+    RETURN_ON_FAILURE(napi_create_int32(env, recovery_id, &js_recovery));
+
+    RETURN_ON_FAILURE(napi_create_object(env, result));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "signature", js_signature));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "recovery", js_recovery));
+
+    return napi_ok;
+}
+
+napi_value secp256k1_addon_sign_message_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 6;
+    napi_value argv[6];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t private_key_length;
+    const unsigned char *private_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &private_key, &private_key_length),
+        env, "Invalid buffer was passed as a private key."
+    );
+
+    size_t personal_length;
+    unsigned char personal[BLAKE2B_PERSONAL_LENGTH];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_personal(env, argv[2], personal, &personal_length),
+        env, "Invalid buffer was passed as personalization."
+    );
+
+    bool is_data_null;
+    unsigned char data[DATA_LENGTH];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_nonce_data(env, argv[3], data, &is_data_null),
+        env, "Invalid buffer was passed as data."
+    );
+
+    secp256k1_addon_nonce_type_t nonce_type;
+    unsigned char tag[ALGORITHM_LENGTH] = { 0 };
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        secp256k1_addon_get_nonce_options(env, argv[4], argv[5], &nonce_type, tag),
+        env, "Invalid nonce options were passed."
+    );
+
+    if (KEY_LENGTH != private_key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    unsigned char scratch[MESSAGE_SCRATCH_LENGTH];
+    size_t payload_length;
+    unsigned char *payload;
+    unsigned char *allocated_payload;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes_or_string(env, argv[0], scratch, MESSAGE_SCRATCH_LENGTH, &payload, &payload_length, &allocated_payload),
+        env, "Invalid buffer was passed as payload."
+    );
+
+    unsigned char digest[MESSAGE_LENGTH];
+    const bool is_digested = message_digest(digest, personal, personal_length, payload, payload_length);
+    free(allocated_payload);
+
+    unsigned char signature[SIGNATURE_LENGTH];
+    int recovery_id;
+    if (!is_digested || !secp256k1_addon_sign_with_nonce(callback_data->secp256k1context, signature, &recovery_id, digest, private_key,
+        is_data_null ? NULL : data, nonce_type, tag))
+    {
+        napi_throw_error(env, NULL, "Could not sign the message.");
+        return NULL;
+    }
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        create_signature_object(env, signature, recovery_id, &js_result),
+        env, "Could not create the result object."
+    );
+
+    return js_result;
+}
+
+static void sign_message_async_execute(napi_env env, void *data)
+{
+    sign_message_callback_data_t *callback_data = (sign_message_callback_data_t *) data;
+
+    unsigned char digest[MESSAGE_LENGTH];
+    callback_data->success = message_digest(digest, callback_data->personal, callback_data->personal_length,
+            callback_data->payload, callback_data->payload_length)
+        && secp256k1_addon_sign_with_nonce(callback_data->secp256k1context, callback_data->signature, &callback_data->recovery_id,
+            digest, callback_data->private_key, callback_data->is_data_null ? NULL : callback_data->data,
+            callback_data->nonce_type, callback_data->tag);
+}
+
+static void sign_message_async_complete(napi_env env, napi_status status, void *data)
+{
+    sign_message_callback_data_t *callback_data = (sign_message_callback_data_t *) data;
+
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
+    {
+        REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
+
+        release_sign_message_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        release_sign_message_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_ok != status)
+    {
+        REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
+
+        release_sign_message_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (!callback_data->success)
+    {
+        REJECT_WITH_ERROR(env, "Could not sign the message.", callback_data->deferred);
+
+        release_sign_message_callback_data(env, callback_data);
+
+        return;
+    }
+
+    napi_value js_result;
+    if (napi_ok != create_signature_object(env, callback_data->signature, callback_data->recovery_id, &js_result))
+    {
+        REJECT_WITH_ERROR(env, "Could not create the result object.", callback_data->deferred);
+
+        release_sign_message_callback_data(env, callback_data);
+
+        return;
+    }
+
+    napi_resolve_deferred(env, callback_data->deferred, js_result);
+
+    release_sign_message_callback_data(env, callback_data);
+}
+
+napi_value secp256k1_addon_sign_message_async(napi_env env, napi_callback_info info)
+{
+    size_t argc = 8;
+    napi_value argv[8];
+    secp256k1_addon_callback_data_t *current_callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t private_key_length;
+    const unsigned char *private_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &private_key, &private_key_length),
+        env, "Invalid buffer was passed as a private key."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[6], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[7], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (KEY_LENGTH != private_key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "secp256k1::async::signMessage";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    sign_message_callback_data_t *callback_data = signun_pool_acquire(env, &sign_message_callback_data_pool);
+    if (!callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+
+    callback_data->allocated_payload = NULL;
+    callback_data->payload_ref = NULL;
+
+    const char *error_message = NULL;
+    if (napi_ok != get_personal(env, argv[2], callback_data->personal, &callback_data->personal_length))
+    {
+        error_message = "Invalid buffer was passed as personalization.";
+    }
+    else if (napi_ok != get_nonce_data(env, argv[3], callback_data->data, &callback_data->is_data_null))
+    {
+        error_message = "Invalid buffer was passed as data.";
+    }
+    else if (napi_ok != secp256k1_addon_get_nonce_options(env, argv[4], argv[5], &callback_data->nonce_type, callback_data->tag))
+    {
+        error_message = "Invalid nonce options were passed.";
+    }
+    else if (napi_ok != signun_get_bytes_or_string(env, argv[0], callback_data->scratch, MESSAGE_SCRATCH_LENGTH,
+        &callback_data->payload, &callback_data->payload_length, &callback_data->allocated_payload)
+        || napi_ok != signun_pin_bytes(env, argv[0], &callback_data->payload_ref))
+    {
+        error_message = "Invalid buffer was passed as payload.";
+    }
+
+    if (error_message)
+    {
+        release_sign_message_callback_data(env, callback_data);
+        napi_throw_error(env, NULL, error_message);
+        return NULL;
+    }
+
+    callback_data->secp256k1context = current_callback_data->secp256k1context;
+    memcpy(callback_data->private_key, private_key, KEY_LENGTH);
+
+    napi_value promise;
+    if (napi_ok != napi_create_promise(env, &callback_data->deferred, &promise))
+    {
+        release_sign_message_callback_data(env, callback_data);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_task_create(env, &callback_data->task, SIGNUN_OP_SIGN, priority, cancel_token, resource_name,
+        sign_message_async_execute, sign_message_async_complete))
+    {
+        REJECT_WITH_ERROR(env, "Could not create async work.", callback_data->deferred);
+        release_sign_message_callback_data(env, callback_data);
+        return promise;
+    }
+
+    napi_async_work async_work = callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", callback_data->deferred);
+        release_sign_message_callback_data(env, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    if (napi_ok != queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Could not queue async work.", callback_data->deferred);
+        release_sign_message_callback_data(env, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    return promise;
+}
+
+static void sign_message_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    sign_message_batch_data_t *batch_data = (sign_message_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        unsigned char *signature = &batch_data->signatures[i * SIGNATURE_LENGTH];
+        const uint32_t offset = batch_data->offsets[i];
+        unsigned char digest[MESSAGE_LENGTH];
+        int recovery_id;
+
+        if (!message_digest(digest, batch_data->personal, batch_data->personal_length, &batch_data->payloads[offset], batch_data->offsets[i + 1] - offset)
+            || !secp256k1_addon_sign_with_nonce(batch_data->secp256k1context, signature, &recovery_id, digest, batch_data->private_key,
+                batch_data->is_data_null ? NULL : batch_data->data, batch_data->nonce_type, batch_data->tag))
+        {
+            memset(signature, 0, SIGNATURE_LENGTH);
+            batch_data->recoveries[i] = 0;
+            batch_data->valid[i] = 0;
+            continue;
+        }
+
+        batch_data->recoveries[i] = (unsigned char) recovery_id;
+        batch_data->valid[i] = 1;
+    }
+}
+
+static napi_status sign_message_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    napi_value js_signatures;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 2, &js_signatures));
+
+    napi_value js_recoveries;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 3, &js_recoveries));
+
+    napi_value js_valid;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 4, &js_valid));
+
+    RETURN_ON_FAILURE(napi_create_object(env, result));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "signatures", js_signatures));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "recoveries", js_recoveries));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "valid", js_valid));
+
+    return napi_ok;
+}
+
+static void sign_message_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    sign_message_batch_data_t *batch_data = (sign_message_batch_data_t *) batch;
+
+    signun_secure_zero(batch_data->private_key, KEY_LENGTH);
+    free(batch_data);
+}
+
+napi_value secp256k1_addon_sign_message_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 9;
+    napi_value argv[9];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    const unsigned char *payloads;
+    const uint32_t *offsets;
+    size_t count;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_packed_bytes(env, argv[0], argv[1], &payloads, &offsets, &count),
+        env, "Invalid payloads were passed."
+    );
+
+    size_t private_key_length;
+    const unsigned char *private_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &private_key, &private_key_length),
+        env, "Invalid buffer was passed as a private key."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[7], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[8], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (KEY_LENGTH != private_key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "secp256k1::batch::signMessage";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    sign_message_batch_data_t *batch_data = (sign_message_batch_data_t *)calloc(1, sizeof (sign_message_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    const char *error_message = NULL;
+    if (napi_ok != get_personal(env, argv[3], batch_data->personal, &batch_data->personal_length))
+    {
+        error_message = "Invalid buffer was passed as personalization.";
+    }
+    else if (napi_ok != get_nonce_data(env, argv[4], batch_data->data, &batch_data->is_data_null))
+    {
+        error_message = "Invalid buffer was passed as data.";
+    }
+    else if (napi_ok != secp256k1_addon_get_nonce_options(env, argv[5], argv[6], &batch_data->nonce_type, batch_data->tag))
+    {
+        error_message = "Invalid nonce options were passed.";
+    }
+
+    if (error_message)
+    {
+        sign_message_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, error_message);
+        return NULL;
+    }
+
+    batch_data->secp256k1context = callback_data->secp256k1context;
+    batch_data->payloads = payloads;
+    batch_data->offsets = offsets;
+    memcpy(batch_data->private_key, private_key, KEY_LENGTH);
+
+    napi_value js_signatures;
+    napi_value js_recoveries;
+    napi_value js_valid;
+    if (napi_ok != napi_create_buffer(env, count * SIGNATURE_LENGTH, (void **) &batch_data->signatures, &js_signatures)
+        || napi_ok != napi_create_buffer(env, count, (void **) &batch_data->recoveries, &js_recoveries)
+        || napi_ok != napi_create_buffer(env, count, (void **) &batch_data->valid, &js_valid))
+    {
+        sign_message_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffers.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, MESSAGE_BATCH_CHUNK_SIZE,
+        sign_message_batch_execute, sign_message_batch_complete, sign_message_batch_finalize, &promise))
+    {
+        sign_message_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[1])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_signatures)
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_recoveries)
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_valid))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        sign_message_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_SIGN_BATCH, priority, cancel_token, resource_name);
+
+    return promise;
+}
+
+napi_value secp256k1_addon_verify_message_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value argv[4];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_signature_length;
+    const unsigned char *raw_signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &raw_signature, &raw_signature_length),
+        env, "Invalid buffer was passed as signature."
+    );
+
+    size_t raw_public_key_length;
+    const unsigned char *raw_public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &raw_public_key, &raw_public_key_length),
+        env, "Invalid buffer was passed as a public key."
+    );
+
+    size_t personal_length;
+    unsigned char personal[BLAKE2B_PERSONAL_LENGTH];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_personal(env, argv[3], personal, &personal_length),
+        env, "Invalid buffer was passed as personalization."
+    );
+
+    if (SIGNATURE_LENGTH != raw_signature_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    unsigned char scratch[MESSAGE_SCRATCH_LENGTH];
+    size_t payload_length;
+    unsigned char *payload;
+    unsigned char *allocated_payload;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes_or_string(env, argv[0], scratch, MESSAGE_SCRATCH_LENGTH, &payload, &payload_length, &allocated_payload),
+        env, "Invalid buffer was passed as payload."
+    );
+
+    unsigned char digest[MESSAGE_LENGTH];
+    const bool is_digested = message_digest(digest, personal, personal_length, payload, payload_length);
+    free(allocated_payload);
+
+    if (!is_digested)
+    {
+        napi_throw_error(env, NULL, "Could not hash the payload.");
+        return NULL;
+    }
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_boolean(env, verify_digest(callback_data->secp256k1context, digest, raw_signature, raw_public_key, raw_public_key_length), &js_result),
+        env, "Could not set the result."
+    );
+
+    return js_result;
+}
+
+static void verify_message_async_execute(napi_env env, void *data)
+{
+    verify_message_callback_data_t *callback_data = (verify_message_callback_data_t *) data;
+
+    unsigned char digest[MESSAGE_LENGTH];
+    callback_data->result = message_digest(digest, callback_data->personal, callback_data->personal_length,
+            callback_data->payload, callback_data->payload_length)
+        && verify_digest(callback_data->secp256k1context, digest, callback_data->raw_signature,
+            callback_data->raw_public_key, callback_data->raw_public_key_length);
+}
+
+static void verify_message_async_complete(napi_env env, napi_status status, void *data)
+{
+    verify_message_callback_data_t *callback_data = (verify_message_callback_data_t *) data;
+
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
+    {
+        REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
+
+        release_verify_message_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        release_verify_message_callback_data(env, callback_data);
+
+        return;
+    }
+
+    if (napi_ok != status)
+    {
+        REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
+
+        release_verify_message_callback_data(env, callback_data);
+
+        return;
+    }
+
+    napi_value js_result;
+    if (napi_ok != napi_get_boolean(env, callback_data->result, &js_result))
+    {
+        REJECT_WITH_ERROR(env, "Could not set the result.", callback_data->deferred);
+
+        release_verify_message_callback_data(env, callback_data);
+
+        return;
+    }
+
+    napi_resolve_deferred(env, callback_data->deferred, js_result);
+
+    release_verify_message_callback_data(env, callback_data);
+}
+
+napi_value secp256k1_addon_verify_message_async(napi_env env, napi_callback_info info)
+{
+    size_t argc = 6;
+    napi_value argv[6];
+    secp256k1_addon_callback_data_t *current_callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_signature_length;
+    const unsigned char *raw_signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &raw_signature, &raw_signature_length),
+        env, "Invalid buffer was passed as signature."
+    );
+
+    size_t raw_public_key_length;
+    const unsigned char *raw_public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &raw_public_key, &raw_public_key_length),
+        env, "Invalid buffer was passed as a public key."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[4], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[5], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (SIGNATURE_LENGTH != raw_signature_length || SERIALIZED_PUBLIC_KEY_LENGTH < raw_public_key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "secp256k1::async::verifyMessage";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    verify_message_callback_data_t *callback_data = signun_pool_acquire(env, &verify_message_callback_data_pool);
+    if (!callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+
+    callback_data->allocated_payload = NULL;
+    callback_data->payload_ref = NULL;
+
+    const char *error_message = NULL;
+    if (napi_ok != get_personal(env, argv[3], callback_data->personal, &callback_data->personal_length))
+    {
+        error_message = "Invalid buffer was passed as personalization.";
+    }
+    else if (napi_ok != signun_get_bytes_or_string(env, argv[0], callback_data->scratch, MESSAGE_SCRATCH_LENGTH,
+        &callback_data->payload, &callback_data->payload_length, &callback_data->allocated_payload)
+        || napi_ok != signun_pin_bytes(env, argv[0], &callback_data->payload_ref))
+    {
+        error_message = "Invalid buffer was passed as payload.";
+    }
+
+    if (error_message)
+    {
+        release_verify_message_callback_data(env, callback_data);
+        napi_throw_error(env, NULL, error_message);
+        return NULL;
+    }
+
+    callback_data->secp256k1context = current_callback_data->secp256k1context;
+    memcpy(callback_data->raw_signature, raw_signature, SIGNATURE_LENGTH);
+    memcpy(callback_data->raw_public_key, raw_public_key, raw_public_key_length);
+    callback_data->raw_public_key_length = raw_public_key_length;
+
+    napi_value promise;
+    if (napi_ok != napi_create_promise(env, &callback_data->deferred, &promise))
+    {
+        release_verify_message_callback_data(env, callback_data);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_task_create(env, &callback_data->task, SIGNUN_OP_VERIFY, priority, cancel_token, resource_name,
+        verify_message_async_execute, verify_message_async_complete))
+    {
+        REJECT_WITH_ERROR(env, "Could not create async work.", callback_data->deferred);
+        release_verify_message_callback_data(env, callback_data);
+        return promise;
+    }
+
+    napi_async_work async_work = callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", callback_data->deferred);
+        release_verify_message_callback_data(env, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    if (napi_ok != queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Could not queue async work.", callback_data->deferred);
+        release_verify_message_callback_data(env, callback_data);
+        napi_delete_async_work(env, async_work);
+        return promise;
+    }
+
+    return promise;
+}
+
+static void verify_message_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    verify_message_batch_data_t *batch_data = (verify_message_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        const uint32_t offset = batch_data->offsets[i];
+        unsigned char digest[MESSAGE_LENGTH];
+
+        batch_data->results[i] = message_digest(digest, batch_data->personal, batch_data->personal_length,
+                &batch_data->payloads[offset], batch_data->offsets[i + 1] - offset)
+            && verify_digest(batch_data->secp256k1context, digest, &batch_data->raw_signatures[i * SIGNATURE_LENGTH],
+                &batch_data->raw_public_keys[i * batch_data->raw_public_key_length], batch_data->raw_public_key_length) ? 1 : 0;
+    }
+}
+
+static napi_status verify_message_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    return signun_batch_get_retained_value(env, batch, 4, result);
+}
+
+static void verify_message_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    free(batch);
+}
+
+napi_value secp256k1_addon_verify_message_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 8;
+    napi_value argv[8];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    const unsigned char *payloads;
+    const uint32_t *offsets;
+    size_t count;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_packed_bytes(env, argv[0], argv[1], &payloads, &offsets, &count),
+        env, "Invalid payloads were passed."
+    );
+
+    size_t raw_signatures_length;
+    const unsigned char *raw_signatures;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &raw_signatures, &raw_signatures_length),
+        env, "Invalid buffer was passed as signatures."
+    );
+
+    size_t raw_public_keys_length;
+    const unsigned char *raw_public_keys;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[3], (void **) &raw_public_keys, &raw_public_keys_length),
+        env, "Invalid buffer was passed as public keys."
+    );
+
+    size_t personal_length;
+    unsigned char personal[BLAKE2B_PERSONAL_LENGTH];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_personal(env, argv[4], personal, &personal_length),
+        env, "Invalid buffer was passed as personalization."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[5], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[6], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    const size_t raw_public_key_length = 0 == count ? 0 : raw_public_keys_length / count;
+
+    if (count * SIGNATURE_LENGTH != raw_signatures_length)
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as signatures.");
+        return NULL;
+    }
+
+    if (0 != count && (raw_public_keys_length != count * raw_public_key_length
+        || (COMPRESSED_PUBLIC_KEY_LENGTH != raw_public_key_length && SERIALIZED_PUBLIC_KEY_LENGTH != raw_public_key_length)))
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as public keys.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "secp256k1::batch::verifyMessage";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    verify_message_batch_data_t *batch_data = (verify_message_batch_data_t *)calloc(1, sizeof (verify_message_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->secp256k1context = callback_data->secp256k1context;
+    batch_data->payloads = payloads;
+    batch_data->offsets = offsets;
+    batch_data->personal_length = personal_length;
+    memcpy(batch_data->personal, personal, personal_length);
+    batch_data->raw_signatures = raw_signatures;
+    batch_data->raw_public_keys = raw_public_keys;
+    batch_data->raw_public_key_length = raw_public_key_length;
+
+    napi_value js_results;
+    if (napi_ok != napi_create_buffer(env, count, (void **) &batch_data->results, &js_results))
+    {
+        verify_message_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffer.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, MESSAGE_BATCH_CHUNK_SIZE,
+        verify_message_batch_execute, verify_message_batch_complete, verify_message_batch_finalize, &promise))
+    {
+        verify_message_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[1])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[2])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[3])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_results)
+        || napi_ok != signun_batch_set_listener(env, &batch_data->batch, argv[7], batch_data->results, 1))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        verify_message_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_VERIFY_BATCH, priority, cancel_token, resource_name);
+
+    return promise;
+}
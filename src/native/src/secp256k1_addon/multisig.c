@@ -0,0 +1,528 @@
+#include "secp256k1_addon/multisig.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "secp256k1.h"
+
+#include "signun_batch.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+#include "secp256k1_addon/public_key_pin.h"
+#include "secp256k1_addon/signature_cache.h"
+#include "secp256k1_addon/util.h"
+
+
+// A check takes up to one verification per public key, so chunks hold fewer
+// checks than those of verifyBatch.
+#define VERIFY_MULTISIG_BATCH_CHUNK_SIZE 16
+
+typedef struct
+{
+    const unsigned char *raw_signatures;
+    const uint32_t *signature_offsets;
+    size_t signature_count;
+
+    const unsigned char *raw_public_keys;
+    const uint32_t *public_key_offsets;
+    size_t public_key_count;
+
+    bool is_der;
+    bool normalize;
+} multisig_check_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+    secp256k1_context *secp256k1context;
+
+    const unsigned char *messages;
+    const unsigned char *raw_signatures;
+    const unsigned char *raw_public_keys;
+    bool is_der;
+    bool normalize;
+
+    // Copied, count + 1 starts of the signatures and the public keys of every
+    // check, into the copied offsets of the items. A single allocation.
+    size_t *signature_starts;
+    size_t *public_key_starts;
+    uint32_t *signature_offsets;
+    uint32_t *public_key_offsets;
+
+    unsigned char *results;
+    // The results of a single check.
+    unsigned char result;
+} verify_multisig_data_t;
+
+static bool parse_signature(const secp256k1_context *ctx, secp256k1_ecdsa_signature *signature, const unsigned char *raw_signature,
+    size_t raw_signature_length, bool is_der, bool normalize)
+{
+    const int parsed = is_der
+        ? secp256k1_ecdsa_signature_parse_der(ctx, signature, raw_signature, raw_signature_length)
+        : secp256k1_ecdsa_signature_parse_compact(ctx, signature, raw_signature);
+
+    if (parsed && normalize)
+    {
+        secp256k1_ecdsa_signature_normalize(ctx, signature, signature);
+    }
+
+    return parsed;
+}
+
+/*
+ * Matches the signatures to the public keys in order, like CHECKMULTISIG:
+ * every signature must be valid for a public key following the one of the
+ * previous signature. As keys are only ever passed over, each is parsed and
+ * verified at most once, and the check stops as soon as the keys left are
+ * fewer than the signatures left.
+ */
+static bool verify_multisig(const secp256k1_context *ctx, const unsigned char *message, const multisig_check_t *check)
+{
+    const unsigned char flags = (check->is_der ? SIGNATURE_CACHE_FLAG_DER : 0) | (check->normalize ? SIGNATURE_CACHE_FLAG_NORMALIZE : 0);
+
+    size_t key_index = 0;
+    for (size_t signature_index = 0; signature_index < check->signature_count; ++signature_index)
+    {
+        const uint32_t signature_offset = check->signature_offsets[signature_index];
+        const size_t raw_signature_length = check->signature_offsets[signature_index + 1] - signature_offset;
+        const unsigned char *raw_signature = &check->raw_signatures[signature_offset];
+
+        // Only parsed once a key needs it, as cache hits do without.
+        bool is_signature_parsed = false;
+        secp256k1_ecdsa_signature signature;
+
+        bool is_matched = false;
+        while (!is_matched)
+        {
+            if (check->signature_count - signature_index > check->public_key_count - key_index)
+            {
+                return false;
+            }
+
+            const uint32_t public_key_offset = check->public_key_offsets[key_index];
+            const size_t raw_public_key_length = check->public_key_offsets[key_index + 1] - public_key_offset;
+            const unsigned char *raw_public_key = &check->raw_public_keys[public_key_offset];
+            ++key_index;
+
+            secp256k1_addon_signature_cache_key_t cache_key;
+            if (secp256k1_addon_signature_cache_lookup(&cache_key, message, raw_signature, raw_signature_length,
+                raw_public_key, raw_public_key_length, flags))
+            {
+                is_matched = true;
+                continue;
+            }
+
+            if (!is_signature_parsed)
+            {
+                // A signature that does not parse matches no key.
+                if (!parse_signature(ctx, &signature, raw_signature, raw_signature_length, check->is_der, check->normalize))
+                {
+                    return false;
+                }
+
+                is_signature_parsed = true;
+            }
+
+            if (secp256k1_addon_ecdsa_verify_public_key(ctx, &signature, message, raw_public_key, raw_public_key_length))
+            {
+                secp256k1_addon_signature_cache_insert(&cache_key);
+                is_matched = true;
+            }
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Reads the packed signatures and public keys of the checks, and checks
+ * the length of each, so that workers can trust them.
+ */
+static napi_status get_multisig_items(napi_env env, napi_value *argv, bool is_der, multisig_check_t *items)
+{
+    RETURN_ON_FAILURE(signun_get_packed_bytes(env, argv[0], argv[1], &items->raw_signatures, &items->signature_offsets,
+        &items->signature_count));
+
+    RETURN_ON_FAILURE(signun_get_packed_bytes(env, argv[2], argv[3], &items->raw_public_keys, &items->public_key_offsets,
+        &items->public_key_count));
+
+    for (size_t i = 0; i < items->signature_count; ++i)
+    {
+        const size_t length = items->signature_offsets[i + 1] - items->signature_offsets[i];
+        if (is_der ? (0 == length || DER_SIGNATURE_MAX_LENGTH < length) : (SIGNATURE_LENGTH != length))
+        {
+            return napi_invalid_arg;
+        }
+    }
+
+    for (size_t i = 0; i < items->public_key_count; ++i)
+    {
+        const size_t length = items->public_key_offsets[i + 1] - items->public_key_offsets[i];
+        if (COMPRESSED_PUBLIC_KEY_LENGTH != length && SERIALIZED_PUBLIC_KEY_LENGTH != length)
+        {
+            return napi_invalid_arg;
+        }
+    }
+
+    items->is_der = is_der;
+
+    return napi_ok;
+}
+
+static void get_check(const verify_multisig_data_t *data, size_t i, multisig_check_t *check)
+{
+    check->raw_signatures = data->raw_signatures;
+    check->signature_offsets = &data->signature_offsets[data->signature_starts[i]];
+    check->signature_count = data->signature_starts[i + 1] - data->signature_starts[i];
+
+    check->raw_public_keys = data->raw_public_keys;
+    check->public_key_offsets = &data->public_key_offsets[data->public_key_starts[i]];
+    check->public_key_count = data->public_key_starts[i + 1] - data->public_key_starts[i];
+
+    check->is_der = data->is_der;
+    check->normalize = data->normalize;
+}
+
+/*
+ * Copies the offsets of the items, as the batch only retains the buffers,
+ * and lays the checks out over them, counts holding the number of
+ * signatures and the number of public keys of every check, interleaved.
+ * Without counts, all the items make up a single check.
+ */
+static bool init_multisig_data(verify_multisig_data_t *data, const multisig_check_t *items, const uint32_t *counts, size_t count)
+{
+    const size_t starts_size = 2 * (count + 1) * sizeof (size_t);
+    const size_t offsets_size = (items->signature_count + items->public_key_count + 2) * sizeof (uint32_t);
+
+    data->signature_starts = (size_t *)malloc(starts_size + offsets_size);
+    if (!data->signature_starts)
+    {
+        return false;
+    }
+
+    data->public_key_starts = &data->signature_starts[count + 1];
+    data->signature_offsets = (uint32_t *) &data->public_key_starts[count + 1];
+    data->public_key_offsets = &data->signature_offsets[items->signature_count + 1];
+
+    memcpy(data->signature_offsets, items->signature_offsets, (items->signature_count + 1) * sizeof (uint32_t));
+    memcpy(data->public_key_offsets, items->public_key_offsets, (items->public_key_count + 1) * sizeof (uint32_t));
+
+    data->signature_starts[0] = 0;
+    data->public_key_starts[0] = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        data->signature_starts[i + 1] = data->signature_starts[i] + (counts ? counts[2 * i] : items->signature_count);
+        data->public_key_starts[i + 1] = data->public_key_starts[i] + (counts ? counts[2 * i + 1] : items->public_key_count);
+    }
+
+    data->raw_signatures = items->raw_signatures;
+    data->raw_public_keys = items->raw_public_keys;
+    data->is_der = items->is_der;
+    data->normalize = items->normalize;
+
+    return items->signature_count == data->signature_starts[count] && items->public_key_count == data->public_key_starts[count];
+}
+
+static void verify_multisig_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    verify_multisig_data_t *data = (verify_multisig_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        multisig_check_t check;
+        get_check(data, i, &check);
+
+        data->results[i] = verify_multisig(data->secp256k1context, &data->messages[i * MESSAGE_LENGTH], &check) ? 1 : 0;
+    }
+}
+
+static napi_status verify_multisig_async_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    verify_multisig_data_t *data = (verify_multisig_data_t *) batch;
+
+    return napi_get_boolean(env, 1 == data->result, result);
+}
+
+static napi_status verify_multisig_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    return signun_batch_get_retained_value(env, batch, 3, result);
+}
+
+static void verify_multisig_finalize(napi_env env, signun_batch_t *batch)
+{
+    verify_multisig_data_t *data = (verify_multisig_data_t *) batch;
+
+    free(data->signature_starts);
+    free(data);
+}
+
+napi_value secp256k1_addon_verify_multisig_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 7;
+    napi_value argv[7];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t message_length;
+    const unsigned char *message;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &message, &message_length),
+        env, "Invalid buffer was passed as message."
+    );
+
+    bool is_der;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[5], &is_der),
+        env, "Invalid bool was passed as DER flag."
+    );
+
+    multisig_check_t check;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[6], &check.normalize),
+        env, "Invalid bool was passed as normalize flag."
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_multisig_items(env, &argv[1], is_der, &check),
+        env, "Invalid signatures or public keys were passed."
+    );
+
+    if (MESSAGE_LENGTH != message_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_boolean(env, verify_multisig(callback_data->secp256k1context, message, &check), &js_result),
+        env, "Could not set the result."
+    );
+
+    return js_result;
+}
+
+napi_value secp256k1_addon_verify_multisig_async(napi_env env, napi_callback_info info)
+{
+    size_t argc = 9;
+    napi_value argv[9];
+    secp256k1_addon_callback_data_t *current_callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t message_length;
+    const unsigned char *message;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &message, &message_length),
+        env, "Invalid buffer was passed as message."
+    );
+
+    bool is_der;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[5], &is_der),
+        env, "Invalid bool was passed as DER flag."
+    );
+
+    multisig_check_t items;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[6], &items.normalize),
+        env, "Invalid bool was passed as normalize flag."
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_multisig_items(env, &argv[1], is_der, &items),
+        env, "Invalid signatures or public keys were passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[7], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[8], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (MESSAGE_LENGTH != message_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "secp256k1::async::verifyMultisig";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    verify_multisig_data_t *data = (verify_multisig_data_t *)calloc(1, sizeof (verify_multisig_data_t));
+    if (!data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    data->secp256k1context = current_callback_data->secp256k1context;
+    data->messages = message;
+    data->results = &data->result;
+
+    if (!init_multisig_data(data, &items, NULL, 1))
+    {
+        verify_multisig_finalize(env, &data->batch);
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &data->batch, 1, 1,
+        verify_multisig_execute, verify_multisig_async_complete, verify_multisig_finalize, &promise))
+    {
+        verify_multisig_finalize(env, &data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &data->batch, argv[1])
+        || napi_ok != signun_batch_retain(env, &data->batch, argv[3]))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", data->batch.deferred);
+        signun_batch_discard(env, &data->batch);
+        verify_multisig_finalize(env, &data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &data->batch, SIGNUN_OP_VERIFY, priority, cancel_token, resource_name);
+
+    return promise;
+}
+
+napi_value secp256k1_addon_verify_multisig_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 11;
+    napi_value argv[11];
+    secp256k1_addon_callback_data_t *current_callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t messages_length;
+    const unsigned char *messages;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &messages, &messages_length),
+        env, "Invalid buffer was passed as messages."
+    );
+
+    napi_typedarray_type counts_type;
+    size_t counts_length;
+    void *raw_counts;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_typedarray_info(env, argv[5], &counts_type, &counts_length, &raw_counts, NULL, NULL),
+        env, "Invalid counts were passed."
+    );
+
+    bool is_der;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[6], &is_der),
+        env, "Invalid bool was passed as DER flag."
+    );
+
+    multisig_check_t items;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[7], &items.normalize),
+        env, "Invalid bool was passed as normalize flag."
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        get_multisig_items(env, &argv[1], is_der, &items),
+        env, "Invalid signatures or public keys were passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[8], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[9], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    const size_t count = messages_length / MESSAGE_LENGTH;
+    if (0 != messages_length % MESSAGE_LENGTH || napi_uint32_array != counts_type || 2 * count != counts_length)
+    {
+        napi_throw_error(env, NULL, "There must be a signature count and a public key count per message.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "secp256k1::batch::verifyMultisig";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    verify_multisig_data_t *data = (verify_multisig_data_t *)calloc(1, sizeof (verify_multisig_data_t));
+    if (!data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    data->secp256k1context = current_callback_data->secp256k1context;
+    data->messages = messages;
+
+    if (!init_multisig_data(data, &items, (const uint32_t *) raw_counts, count))
+    {
+        verify_multisig_finalize(env, &data->batch);
+        napi_throw_error(env, NULL, "The counts must add up to the signatures and the public keys.");
+        return NULL;
+    }
+
+    napi_value js_results;
+    if (napi_ok != napi_create_buffer(env, count, (void **) &data->results, &js_results))
+    {
+        verify_multisig_finalize(env, &data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffer.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &data->batch, count, VERIFY_MULTISIG_BATCH_CHUNK_SIZE,
+        verify_multisig_execute, verify_multisig_batch_complete, verify_multisig_finalize, &promise))
+    {
+        verify_multisig_finalize(env, &data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &data->batch, argv[1])
+        || napi_ok != signun_batch_retain(env, &data->batch, argv[3])
+        || napi_ok != signun_batch_retain(env, &data->batch, js_results)
+        || napi_ok != signun_batch_set_listener(env, &data->batch, argv[10], data->results, 1))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", data->batch.deferred);
+        signun_batch_discard(env, &data->batch);
+        verify_multisig_finalize(env, &data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &data->batch, SIGNUN_OP_VERIFY_BATCH, priority, cancel_token, resource_name);
+
+    return promise;
+}
@@ -5,21 +5,28 @@
 
 #include "secp256k1.h"
 
+#include "signun_pool.h"
+#include "signun_scheduler.h"
 #include "signun_util.h"
 #include "secp256k1_addon/util.h"
 
 
+#define PRIVATE_KEY_VERIFY_POOL_HIGH_WATER_MARK 256
+
 typedef struct
 {
+    signun_task_t task;
+
     napi_deferred deferred;
     secp256k1_context *secp256k1context;
-    napi_async_work async_work;
 
     unsigned char private_key[KEY_LENGTH];
 
     bool is_verified;
 } private_key_verify_callback_data_t;
 
+static const signun_pool_t private_key_verify_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_PRIVATE_KEY_VERIFY, private_key_verify_callback_data_t, PRIVATE_KEY_VERIFY_POOL_HIGH_WATER_MARK, true);
+
 napi_value secp256k1_addon_private_key_verify_sync(napi_env env, napi_callback_info info)
 {
     size_t argc = 1;
@@ -33,7 +40,7 @@ napi_value secp256k1_addon_private_key_verify_sync(napi_env env, napi_callback_i
     size_t private_key_length;
     const unsigned char *private_key;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[0], (void **) &private_key, &private_key_length),
+        signun_get_bytes(env, argv[0], (void **) &private_key, &private_key_length),
         env, "Invalid buffer was passed as a private key."
     );
 
@@ -58,11 +65,20 @@ static void private_key_verify_async_complete(napi_env env, napi_status status,
 {
     private_key_verify_callback_data_t *callback_data = (private_key_verify_callback_data_t *) data;
 
-    if (napi_ok != napi_delete_async_work(env, callback_data->async_work))
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
     {
         REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &private_key_verify_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        signun_pool_release(env, &private_key_verify_callback_data_pool, callback_data);
 
         return;
     }
@@ -71,7 +87,7 @@ static void private_key_verify_async_complete(napi_env env, napi_status status,
     {
         REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &private_key_verify_callback_data_pool, callback_data);
 
         return;
     }
@@ -81,20 +97,20 @@ static void private_key_verify_async_complete(napi_env env, napi_status status,
     {
         REJECT_WITH_ERROR(env, "Could not get a boolean.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &private_key_verify_callback_data_pool, callback_data);
 
         return;
     }
 
     napi_resolve_deferred(env, callback_data->deferred, js_result);
 
-    free(callback_data);
+    signun_pool_release(env, &private_key_verify_callback_data_pool, callback_data);
 }
 
 napi_value secp256k1_addon_private_key_verify_async(napi_env env, napi_callback_info info)
 {
-    size_t argc = 1;
-    napi_value argv[1];
+    size_t argc = 3;
+    napi_value argv[3];
     secp256k1_addon_callback_data_t *current_callback_data;
     THROW_AND_RETURN_NULL_ON_FAILURE(
         napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
@@ -104,10 +120,22 @@ napi_value secp256k1_addon_private_key_verify_async(napi_env env, napi_callback_
     size_t private_key_length;
     unsigned char *private_key;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[0], (void **) &private_key, &private_key_length),
+        signun_get_bytes(env, argv[0], (void **) &private_key, &private_key_length),
         env, "Invalid buffer was passed as a private key."
     );
 
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[1], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[2], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
     napi_value null_value;
     THROW_AND_RETURN_NULL_ON_FAILURE(
         napi_get_null(env, &null_value),
@@ -121,7 +149,12 @@ napi_value secp256k1_addon_private_key_verify_async(napi_env env, napi_callback_
         env, "Could not create resource name."
     );
 
-    private_key_verify_callback_data_t *verify_callback_data = (private_key_verify_callback_data_t *)malloc(sizeof (private_key_verify_callback_data_t));
+    private_key_verify_callback_data_t *verify_callback_data = signun_pool_acquire(env, &private_key_verify_callback_data_pool);
+    if (!verify_callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
     verify_callback_data->secp256k1context = current_callback_data->secp256k1context;
 
     memcpy(verify_callback_data->private_key, private_key, KEY_LENGTH);
@@ -129,26 +162,33 @@ napi_value secp256k1_addon_private_key_verify_async(napi_env env, napi_callback_
     napi_value promise;
     if (napi_ok != napi_create_promise(env, &verify_callback_data->deferred, &promise))
     {
-        free(verify_callback_data);
+        signun_pool_release(env, &private_key_verify_callback_data_pool, verify_callback_data);
         napi_throw_error(env, NULL, "Could not create result promise.");
         return NULL;
     }
 
-    napi_async_work verify_async_work;
-    if (napi_ok != napi_create_async_work(env, NULL, verify_resource_name, private_key_verify_async_execute, private_key_verify_async_complete, verify_callback_data, &verify_async_work))
+    if (napi_ok != signun_task_create(env, &verify_callback_data->task, SIGNUN_OP_PRIVATE_KEY_VERIFY, priority, cancel_token, verify_resource_name, private_key_verify_async_execute, private_key_verify_async_complete))
     {
         REJECT_WITH_ERROR(env, "Could not create async work.", verify_callback_data->deferred);
-        free(verify_callback_data);
+        signun_pool_release(env, &private_key_verify_callback_data_pool, verify_callback_data);
         return promise;
     }
 
-    verify_callback_data->async_work = verify_async_work;
+    napi_async_work verify_async_work = verify_callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &verify_callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", verify_callback_data->deferred);
+        signun_pool_release(env, &private_key_verify_callback_data_pool, verify_callback_data);
+        napi_delete_async_work(env, verify_async_work);
+        return promise;
+    }
 
-    napi_status queue_status = napi_queue_async_work(env, verify_async_work);
     if (napi_ok != queue_status)
     {
         REJECT_WITH_ERROR(env, "Could not queue async work.", verify_callback_data->deferred);
-        free(verify_callback_data);
+        signun_pool_release(env, &private_key_verify_callback_data_pool, verify_callback_data);
         napi_delete_async_work(env, verify_async_work);
         return promise;
     }
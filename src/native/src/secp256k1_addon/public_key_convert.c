@@ -0,0 +1,446 @@
+#include "secp256k1_addon/public_key_convert.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "signun_batch.h"
+#include "signun_pool.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+#include "secp256k1_addon/util.h"
+
+
+// Decompression takes a square root per key, so chunks are kept shorter
+// than those of the signature conversions.
+#define PUBLIC_KEY_CONVERT_BATCH_CHUNK_SIZE 1024
+#define PUBLIC_KEY_CONVERT_POOL_HIGH_WATER_MARK 256
+
+#define EVEN_PUBLIC_KEY_PREFIX 0x02
+
+typedef struct
+{
+    signun_task_t task;
+
+    napi_deferred deferred;
+    secp256k1_context *secp256k1context;
+
+    size_t input_public_key_length;
+    unsigned char input[SERIALIZED_PUBLIC_KEY_LENGTH];
+    size_t output_public_key_length;
+
+    bool success;
+    unsigned char public_key[SERIALIZED_PUBLIC_KEY_LENGTH];
+} public_key_convert_callback_data_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+    secp256k1_context *secp256k1context;
+
+    const unsigned char *input;
+    size_t input_public_key_length;
+    size_t output_public_key_length;
+
+    unsigned char *public_keys;
+    unsigned char *valid;
+} public_key_convert_batch_data_t;
+
+static const signun_pool_t public_key_convert_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_PUBLIC_KEY_CONVERT, public_key_convert_callback_data_t, PUBLIC_KEY_CONVERT_POOL_HIGH_WATER_MARK, false);
+
+static bool is_public_key_length(size_t length)
+{
+    return XONLY_PUBLIC_KEY_LENGTH == length
+        || COMPRESSED_PUBLIC_KEY_LENGTH == length
+        || SERIALIZED_PUBLIC_KEY_LENGTH == length;
+}
+
+bool secp256k1_addon_public_key_parse(const secp256k1_context *ctx, secp256k1_pubkey *public_key, const unsigned char *input, size_t input_length)
+{
+    if (XONLY_PUBLIC_KEY_LENGTH == input_length)
+    {
+        unsigned char compressed_public_key[COMPRESSED_PUBLIC_KEY_LENGTH];
+        compressed_public_key[0] = EVEN_PUBLIC_KEY_PREFIX;
+        memcpy(&compressed_public_key[1], input, XONLY_PUBLIC_KEY_LENGTH);
+
+        return secp256k1_ec_pubkey_parse(ctx, public_key, compressed_public_key, COMPRESSED_PUBLIC_KEY_LENGTH);
+    }
+
+    return secp256k1_ec_pubkey_parse(ctx, public_key, input, input_length);
+}
+
+void secp256k1_addon_public_key_serialize(const secp256k1_context *ctx, unsigned char *output, size_t output_length, const secp256k1_pubkey *public_key)
+{
+    size_t serialized_public_key_length = SERIALIZED_PUBLIC_KEY_LENGTH;
+    unsigned char serialized_public_key[SERIALIZED_PUBLIC_KEY_LENGTH];
+
+    if (SERIALIZED_PUBLIC_KEY_LENGTH == output_length)
+    {
+        secp256k1_ec_pubkey_serialize(ctx, output, &serialized_public_key_length, public_key, SECP256K1_EC_UNCOMPRESSED);
+        return;
+    }
+
+    secp256k1_ec_pubkey_serialize(ctx, serialized_public_key, &serialized_public_key_length, public_key, SECP256K1_EC_COMPRESSED);
+
+    // X-only keys are compressed keys without the prefix.
+    memcpy(output, &serialized_public_key[COMPRESSED_PUBLIC_KEY_LENGTH - output_length], output_length);
+}
+
+napi_value secp256k1_addon_public_key_convert_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_public_key_length;
+    const unsigned char *raw_public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &raw_public_key, &raw_public_key_length),
+        env, "Invalid buffer was passed as a public key."
+    );
+
+    uint32_t output_public_key_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[1], &output_public_key_length),
+        env, "Invalid number was passed as output length."
+    );
+
+    if (!is_public_key_length(raw_public_key_length) || !is_public_key_length(output_public_key_length))
+    {
+        napi_throw_error(env, NULL, "Invalid public key length.");
+        return NULL;
+    }
+
+    secp256k1_pubkey public_key;
+    if (!secp256k1_addon_public_key_parse(callback_data->secp256k1context, &public_key, raw_public_key, raw_public_key_length))
+    {
+        napi_throw_error(env, NULL, "Could not parse the public key.");
+        return NULL;
+    }
+
+    unsigned char serialized_public_key[SERIALIZED_PUBLIC_KEY_LENGTH];
+    secp256k1_addon_public_key_serialize(callback_data->secp256k1context, serialized_public_key, output_public_key_length, &public_key);
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer_copy(env, output_public_key_length, (void *)serialized_public_key, NULL, &js_result),
+        env, "Could not set the result buffer."
+    );
+
+    return js_result;
+}
+
+static void public_key_convert_async_execute(napi_env env, void *data)
+{
+    public_key_convert_callback_data_t *callback_data = (public_key_convert_callback_data_t *) data;
+
+    secp256k1_pubkey public_key;
+    callback_data->success = secp256k1_addon_public_key_parse(callback_data->secp256k1context, &public_key,
+        callback_data->input, callback_data->input_public_key_length);
+
+    if (callback_data->success)
+    {
+        secp256k1_addon_public_key_serialize(callback_data->secp256k1context, callback_data->public_key,
+            callback_data->output_public_key_length, &public_key);
+    }
+}
+
+static void public_key_convert_async_complete(napi_env env, napi_status status, void *data)
+{
+    public_key_convert_callback_data_t *callback_data = (public_key_convert_callback_data_t *) data;
+
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
+    {
+        REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
+
+        signun_pool_release(env, &public_key_convert_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        signun_pool_release(env, &public_key_convert_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_ok != status)
+    {
+        REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
+
+        signun_pool_release(env, &public_key_convert_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (!callback_data->success)
+    {
+        REJECT_WITH_ERROR(env, "Could not parse the public key.", callback_data->deferred);
+
+        signun_pool_release(env, &public_key_convert_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    napi_value js_result;
+    if (napi_ok != napi_create_buffer_copy(env, callback_data->output_public_key_length, (void *)callback_data->public_key, NULL, &js_result))
+    {
+        REJECT_WITH_ERROR(env, "Could not set the result buffer.", callback_data->deferred);
+
+        signun_pool_release(env, &public_key_convert_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    napi_resolve_deferred(env, callback_data->deferred, js_result);
+
+    signun_pool_release(env, &public_key_convert_callback_data_pool, callback_data);
+}
+
+napi_value secp256k1_addon_public_key_convert_async(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value argv[4];
+    secp256k1_addon_callback_data_t *current_callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_public_key_length;
+    const unsigned char *raw_public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &raw_public_key, &raw_public_key_length),
+        env, "Invalid buffer was passed as a public key."
+    );
+
+    uint32_t output_public_key_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[1], &output_public_key_length),
+        env, "Invalid number was passed as output length."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[2], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[3], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (!is_public_key_length(raw_public_key_length) || !is_public_key_length(output_public_key_length))
+    {
+        napi_throw_error(env, NULL, "Invalid public key length.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "secp256k1::async::publicKeyConvert";
+    napi_value public_key_convert_resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &public_key_convert_resource_name),
+        env, "Could not create resource name."
+    );
+
+    public_key_convert_callback_data_t *public_key_convert_callback_data = signun_pool_acquire(env, &public_key_convert_callback_data_pool);
+    if (!public_key_convert_callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
+
+    public_key_convert_callback_data->secp256k1context = current_callback_data->secp256k1context;
+    public_key_convert_callback_data->input_public_key_length = raw_public_key_length;
+    memcpy(public_key_convert_callback_data->input, raw_public_key, raw_public_key_length);
+    public_key_convert_callback_data->output_public_key_length = output_public_key_length;
+
+    napi_value promise;
+    if (napi_ok != napi_create_promise(env, &public_key_convert_callback_data->deferred, &promise))
+    {
+        signun_pool_release(env, &public_key_convert_callback_data_pool, public_key_convert_callback_data);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_task_create(env, &public_key_convert_callback_data->task, SIGNUN_OP_PUBLIC_KEY_BATCH, priority, cancel_token,
+        public_key_convert_resource_name, public_key_convert_async_execute, public_key_convert_async_complete))
+    {
+        REJECT_WITH_ERROR(env, "Could not create async work.", public_key_convert_callback_data->deferred);
+        signun_pool_release(env, &public_key_convert_callback_data_pool, public_key_convert_callback_data);
+        return promise;
+    }
+
+    napi_async_work public_key_convert_async_work = public_key_convert_callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &public_key_convert_callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", public_key_convert_callback_data->deferred);
+        signun_pool_release(env, &public_key_convert_callback_data_pool, public_key_convert_callback_data);
+        napi_delete_async_work(env, public_key_convert_async_work);
+        return promise;
+    }
+
+    if (napi_ok != queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Could not queue async work.", public_key_convert_callback_data->deferred);
+        signun_pool_release(env, &public_key_convert_callback_data_pool, public_key_convert_callback_data);
+        napi_delete_async_work(env, public_key_convert_async_work);
+        return promise;
+    }
+
+    return promise;
+}
+
+static void public_key_convert_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    public_key_convert_batch_data_t *batch_data = (public_key_convert_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        unsigned char *output = &batch_data->public_keys[i * batch_data->output_public_key_length];
+
+        secp256k1_pubkey public_key;
+        if (!secp256k1_addon_public_key_parse(batch_data->secp256k1context, &public_key, &batch_data->input[i * batch_data->input_public_key_length], batch_data->input_public_key_length))
+        {
+            memset(output, 0, batch_data->output_public_key_length);
+            batch_data->valid[i] = 0;
+            continue;
+        }
+
+        secp256k1_addon_public_key_serialize(batch_data->secp256k1context, output, batch_data->output_public_key_length, &public_key);
+        batch_data->valid[i] = 1;
+    }
+}
+
+static napi_status public_key_convert_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    napi_value js_public_keys;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 1, &js_public_keys));
+
+    napi_value js_valid;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 2, &js_valid));
+
+    RETURN_ON_FAILURE(napi_create_object(env, result));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "publicKeys", js_public_keys));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "valid", js_valid));
+
+    return napi_ok;
+}
+
+static void public_key_convert_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    free(batch);
+}
+
+napi_value secp256k1_addon_public_key_convert_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value argv[5];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t input_length;
+    const unsigned char *input;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &input, &input_length),
+        env, "Invalid buffer was passed as public keys."
+    );
+
+    uint32_t input_public_key_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[1], &input_public_key_length),
+        env, "Invalid number was passed as input length."
+    );
+
+    uint32_t output_public_key_length;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[2], &output_public_key_length),
+        env, "Invalid number was passed as output length."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (!is_public_key_length(input_public_key_length) || !is_public_key_length(output_public_key_length)
+        || 0 != input_length % input_public_key_length)
+    {
+        napi_throw_error(env, NULL, "Invalid public key length.");
+        return NULL;
+    }
+
+    const size_t count = input_length / input_public_key_length;
+
+    const char *resource_identifier = "secp256k1::batch::publicKeyConvert";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    public_key_convert_batch_data_t *batch_data = (public_key_convert_batch_data_t *)calloc(1, sizeof (public_key_convert_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->secp256k1context = callback_data->secp256k1context;
+    batch_data->input = input;
+    batch_data->input_public_key_length = input_public_key_length;
+    batch_data->output_public_key_length = output_public_key_length;
+
+    napi_value js_public_keys;
+    napi_value js_valid;
+    if (napi_ok != napi_create_buffer(env, count * output_public_key_length, (void **) &batch_data->public_keys, &js_public_keys)
+        || napi_ok != napi_create_buffer(env, count, (void **) &batch_data->valid, &js_valid))
+    {
+        public_key_convert_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffers.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, PUBLIC_KEY_CONVERT_BATCH_CHUNK_SIZE,
+        public_key_convert_batch_execute, public_key_convert_batch_complete, public_key_convert_batch_finalize, &promise))
+    {
+        public_key_convert_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_public_keys)
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_valid))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        public_key_convert_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_PUBLIC_KEY_BATCH, priority, cancel_token, resource_name);
+
+    return promise;
+}
@@ -5,15 +5,20 @@
 
 #include "secp256k1.h"
 
+#include "signun_pool.h"
+#include "signun_scheduler.h"
 #include "signun_util.h"
 #include "secp256k1_addon/util.h"
 
 
+#define PUBLIC_KEY_CREATE_POOL_HIGH_WATER_MARK 256
+
 typedef struct
 {
+    signun_task_t task;
+
     napi_deferred deferred;
     secp256k1_context *secp256k1context;
-    napi_async_work async_work;
 
     unsigned char private_key[KEY_LENGTH];
     bool is_compressed;
@@ -23,6 +28,8 @@ typedef struct
     unsigned char public_key[SERIALIZED_PUBLIC_KEY_LENGTH];
 } public_key_create_callback_data_t;
 
+static const signun_pool_t public_key_create_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_PUBLIC_KEY_CREATE, public_key_create_callback_data_t, PUBLIC_KEY_CREATE_POOL_HIGH_WATER_MARK, true);
+
 napi_value secp256k1_addon_public_key_create_sync(napi_env env, napi_callback_info info)
 {
     size_t argc = 2;
@@ -36,7 +43,7 @@ napi_value secp256k1_addon_public_key_create_sync(napi_env env, napi_callback_in
     size_t private_key_length;
     const unsigned char *private_key;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[0], (void **) &private_key, &private_key_length),
+        signun_get_bytes(env, argv[0], (void **) &private_key, &private_key_length),
         env, "Invalid buffer was passed as a private key."
     );
 
@@ -91,11 +98,20 @@ static void public_key_create_async_complete(napi_env env, napi_status status, v
 {
     public_key_create_callback_data_t *callback_data = (public_key_create_callback_data_t *) data;
 
-    if (napi_ok != napi_delete_async_work(env, callback_data->async_work))
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
     {
         REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
 
         return;
     }
@@ -104,7 +120,7 @@ static void public_key_create_async_complete(napi_env env, napi_status status, v
     {
         REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
 
         return;
     }
@@ -113,7 +129,7 @@ static void public_key_create_async_complete(napi_env env, napi_status status, v
     {
         REJECT_WITH_ERROR(env, "Could not create the public key.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
 
         return;
     }
@@ -123,20 +139,20 @@ static void public_key_create_async_complete(napi_env env, napi_status status, v
     {
         REJECT_WITH_ERROR(env, "Could not set the result buffer.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
 
         return;
     }
 
     napi_resolve_deferred(env, callback_data->deferred, js_result);
 
-    free(callback_data);
+    signun_pool_release(env, &public_key_create_callback_data_pool, callback_data);
 }
 
 napi_value secp256k1_addon_public_key_create_async(napi_env env, napi_callback_info info)
 {
-    size_t argc = 2;
-    napi_value argv[2];
+    size_t argc = 4;
+    napi_value argv[4];
     secp256k1_addon_callback_data_t *current_callback_data;
     THROW_AND_RETURN_NULL_ON_FAILURE(
         napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
@@ -146,7 +162,7 @@ napi_value secp256k1_addon_public_key_create_async(napi_env env, napi_callback_i
     size_t private_key_length;
     unsigned char *private_key;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[0], (void **) &private_key, &private_key_length),
+        signun_get_bytes(env, argv[0], (void **) &private_key, &private_key_length),
         env, "Invalid buffer was passed as a private key."
     );
 
@@ -156,6 +172,18 @@ napi_value secp256k1_addon_public_key_create_async(napi_env env, napi_callback_i
         env, "Invalid bool was passed as compressed flag."
     );
 
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[2], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[3], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
     napi_value null_value;
     THROW_AND_RETURN_NULL_ON_FAILURE(
         napi_get_null(env, &null_value),
@@ -169,7 +197,12 @@ napi_value secp256k1_addon_public_key_create_async(napi_env env, napi_callback_i
         env, "Could not create resource name."
     );
 
-    public_key_create_callback_data_t *create_callback_data = (public_key_create_callback_data_t *)malloc(sizeof (public_key_create_callback_data_t));
+    public_key_create_callback_data_t *create_callback_data = signun_pool_acquire(env, &public_key_create_callback_data_pool);
+    if (!create_callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
     create_callback_data->is_compressed = is_compressed;
     create_callback_data->public_key_length = SERIALIZED_PUBLIC_KEY_LENGTH;
     create_callback_data->secp256k1context = current_callback_data->secp256k1context;
@@ -179,26 +212,33 @@ napi_value secp256k1_addon_public_key_create_async(napi_env env, napi_callback_i
     napi_value promise;
     if (napi_ok != napi_create_promise(env, &create_callback_data->deferred, &promise))
     {
-        free(create_callback_data);
+        signun_pool_release(env, &public_key_create_callback_data_pool, create_callback_data);
         napi_throw_error(env, NULL, "Could not create result promise.");
         return NULL;
     }
 
-    napi_async_work create_async_work;
-    if (napi_ok != napi_create_async_work(env, NULL, create_resource_name, public_key_create_async_execute, public_key_create_async_complete, create_callback_data, &create_async_work))
+    if (napi_ok != signun_task_create(env, &create_callback_data->task, SIGNUN_OP_PUBLIC_KEY_CREATE, priority, cancel_token, create_resource_name, public_key_create_async_execute, public_key_create_async_complete))
     {
         REJECT_WITH_ERROR(env, "Could not create async work.", create_callback_data->deferred);
-        free(create_callback_data);
+        signun_pool_release(env, &public_key_create_callback_data_pool, create_callback_data);
         return promise;
     }
 
-    create_callback_data->async_work = create_async_work;
+    napi_async_work create_async_work = create_callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &create_callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", create_callback_data->deferred);
+        signun_pool_release(env, &public_key_create_callback_data_pool, create_callback_data);
+        napi_delete_async_work(env, create_async_work);
+        return promise;
+    }
 
-    napi_status queue_status = napi_queue_async_work(env, create_async_work);
     if (napi_ok != queue_status)
     {
         REJECT_WITH_ERROR(env, "Could not queue async work.", create_callback_data->deferred);
-        free(create_callback_data);
+        signun_pool_release(env, &public_key_create_callback_data_pool, create_callback_data);
         napi_delete_async_work(env, create_async_work);
         return promise;
     }
@@ -0,0 +1,415 @@
+#include "secp256k1_addon/public_key_pin.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <uv.h>
+
+#include "signun_util.h"
+#include "secp256k1_addon/internal.h"
+#include "secp256k1_addon/util.h"
+
+
+// A few hundred public keys.
+#define PINNED_PUBLIC_KEYS_DEFAULT_MAX_BYTES (16 * 1024 * 1024)
+
+// Keys are bucketed by the last byte of their X coordinate, which is at the
+// same offset in both serializations.
+#define PINNED_PUBLIC_KEY_BUCKET_COUNT 256
+#define PINNED_PUBLIC_KEY_BUCKET_OFFSET 32
+
+typedef struct pinned_public_key_s
+{
+    // The recency list, from the most to the least recently used key.
+    struct pinned_public_key_s *previous;
+    struct pinned_public_key_s *next;
+    struct pinned_public_key_s *bucket_next;
+
+    // Both serializations are kept, so that a lookup is a plain comparison
+    // whichever form the key is passed in.
+    unsigned char compressed[COMPRESSED_PUBLIC_KEY_LENGTH];
+    unsigned char uncompressed[SERIALIZED_PUBLIC_KEY_LENGTH];
+
+    // Held by the pin and by every verification using the table, so that an
+    // evicted key outlives the verifications in flight.
+    unsigned int ref_count;
+    secp256k1_addon_window_table_t *table;
+} pinned_public_key_t;
+
+typedef struct
+{
+    pinned_public_key_t *buckets[PINNED_PUBLIC_KEY_BUCKET_COUNT];
+    pinned_public_key_t *most_recent;
+    pinned_public_key_t *least_recent;
+
+    size_t count;
+    size_t bytes;
+    size_t max_bytes;
+    uint64_t evictions;
+} pinned_public_keys_t;
+
+static pinned_public_keys_t pinned_public_keys = { .max_bytes = PINNED_PUBLIC_KEYS_DEFAULT_MAX_BYTES };
+static uv_mutex_t pinned_public_keys_mutex;
+static uv_once_t pinned_public_keys_once = UV_ONCE_INIT;
+
+static void init_pinned_public_keys(void)
+{
+    uv_mutex_init(&pinned_public_keys_mutex);
+}
+
+static size_t pinned_public_key_size(void)
+{
+    return sizeof (pinned_public_key_t) + secp256k1_addon_window_table_size();
+}
+
+static void free_pinned_public_key(pinned_public_key_t *entry)
+{
+    secp256k1_addon_window_table_destroy(entry->table);
+    free(entry);
+}
+
+/*
+ * The functions below must be called with the mutex held.
+ */
+static void release(pinned_public_key_t *entry)
+{
+    if (0 == --entry->ref_count)
+    {
+        free_pinned_public_key(entry);
+    }
+}
+
+static pinned_public_key_t *find(const unsigned char *input, size_t input_length)
+{
+    if (COMPRESSED_PUBLIC_KEY_LENGTH != input_length && SERIALIZED_PUBLIC_KEY_LENGTH != input_length)
+    {
+        return NULL;
+    }
+
+    pinned_public_key_t *entry = pinned_public_keys.buckets[input[PINNED_PUBLIC_KEY_BUCKET_OFFSET]];
+    for (; entry; entry = entry->bucket_next)
+    {
+        const unsigned char *serialized = COMPRESSED_PUBLIC_KEY_LENGTH == input_length ? entry->compressed : entry->uncompressed;
+        if (0 == memcmp(serialized, input, input_length))
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static void unlink_recent(pinned_public_key_t *entry)
+{
+    if (entry->previous)
+    {
+        entry->previous->next = entry->next;
+    }
+    else
+    {
+        pinned_public_keys.most_recent = entry->next;
+    }
+
+    if (entry->next)
+    {
+        entry->next->previous = entry->previous;
+    }
+    else
+    {
+        pinned_public_keys.least_recent = entry->previous;
+    }
+
+    entry->previous = NULL;
+    entry->next = NULL;
+}
+
+static void link_most_recent(pinned_public_key_t *entry)
+{
+    entry->next = pinned_public_keys.most_recent;
+
+    if (entry->next)
+    {
+        entry->next->previous = entry;
+    }
+    else
+    {
+        pinned_public_keys.least_recent = entry;
+    }
+
+    pinned_public_keys.most_recent = entry;
+}
+
+static void touch(pinned_public_key_t *entry)
+{
+    unlink_recent(entry);
+    link_most_recent(entry);
+}
+
+static void unpin(pinned_public_key_t *entry)
+{
+    pinned_public_key_t **link = &pinned_public_keys.buckets[entry->compressed[PINNED_PUBLIC_KEY_BUCKET_OFFSET]];
+    while (*link != entry)
+    {
+        link = &(*link)->bucket_next;
+    }
+
+    *link = entry->bucket_next;
+    unlink_recent(entry);
+
+    --pinned_public_keys.count;
+    pinned_public_keys.bytes -= pinned_public_key_size();
+
+    release(entry);
+}
+
+static void evict(void)
+{
+    while (pinned_public_keys.max_bytes < pinned_public_keys.bytes)
+    {
+        unpin(pinned_public_keys.least_recent);
+        ++pinned_public_keys.evictions;
+    }
+}
+
+bool secp256k1_addon_ecdsa_verify_public_key(const secp256k1_context *ctx, const secp256k1_ecdsa_signature *signature,
+    const unsigned char *message, const unsigned char *raw_public_key, size_t raw_public_key_length)
+{
+    uv_once(&pinned_public_keys_once, init_pinned_public_keys);
+
+    uv_mutex_lock(&pinned_public_keys_mutex);
+
+    pinned_public_key_t *entry = 0 < pinned_public_keys.count
+        ? find(raw_public_key, raw_public_key_length)
+        : NULL;
+
+    if (entry)
+    {
+        touch(entry);
+        ++entry->ref_count;
+    }
+
+    uv_mutex_unlock(&pinned_public_keys_mutex);
+
+    if (!entry)
+    {
+        secp256k1_pubkey public_key;
+        return secp256k1_ec_pubkey_parse(ctx, &public_key, raw_public_key, raw_public_key_length)
+            && secp256k1_ecdsa_verify(ctx, signature, message, &public_key);
+    }
+
+    const bool result = secp256k1_addon_ecdsa_verify_window(ctx, signature, message, entry->table);
+
+    uv_mutex_lock(&pinned_public_keys_mutex);
+    release(entry);
+    uv_mutex_unlock(&pinned_public_keys_mutex);
+
+    return result;
+}
+
+napi_value secp256k1_addon_pin_public_key(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_public_key_length;
+    const unsigned char *raw_public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &raw_public_key, &raw_public_key_length),
+        env, "Invalid buffer was passed as a public key."
+    );
+
+    secp256k1_pubkey public_key;
+    if (0 == secp256k1_ec_pubkey_parse(callback_data->secp256k1context, &public_key, raw_public_key, raw_public_key_length))
+    {
+        napi_throw_error(env, NULL, "Could not parse the public key.");
+        return NULL;
+    }
+
+    pinned_public_key_t *entry = (pinned_public_key_t *)calloc(1, sizeof (pinned_public_key_t));
+    if (!entry)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the pinned public key.");
+        return NULL;
+    }
+
+    size_t compressed_length = COMPRESSED_PUBLIC_KEY_LENGTH;
+    secp256k1_ec_pubkey_serialize(callback_data->secp256k1context, entry->compressed, &compressed_length, &public_key, SECP256K1_EC_COMPRESSED);
+
+    size_t uncompressed_length = SERIALIZED_PUBLIC_KEY_LENGTH;
+    secp256k1_ec_pubkey_serialize(callback_data->secp256k1context, entry->uncompressed, &uncompressed_length, &public_key, SECP256K1_EC_UNCOMPRESSED);
+
+    uv_once(&pinned_public_keys_once, init_pinned_public_keys);
+
+    // Pinning a key again only marks it as recently used.
+    uv_mutex_lock(&pinned_public_keys_mutex);
+
+    pinned_public_key_t *pinned = find(entry->compressed, COMPRESSED_PUBLIC_KEY_LENGTH);
+    if (pinned)
+    {
+        touch(pinned);
+    }
+
+    const bool fits = pinned_public_key_size() <= pinned_public_keys.max_bytes;
+
+    uv_mutex_unlock(&pinned_public_keys_mutex);
+
+    if (pinned)
+    {
+        free(entry);
+        return NULL;
+    }
+
+    if (!fits)
+    {
+        free(entry);
+        napi_throw_error(env, NULL, "A pinned public key does not fit in maxBytes.");
+        return NULL;
+    }
+
+    // Built outside of the lock, as it takes about a thousand additions.
+    entry->table = secp256k1_addon_window_table_create(callback_data->secp256k1context, &public_key);
+    if (!entry->table)
+    {
+        free(entry);
+        napi_throw_error(env, NULL, "Could not allocate the window table.");
+        return NULL;
+    }
+
+    entry->ref_count = 1;
+
+    uv_mutex_lock(&pinned_public_keys_mutex);
+
+    // Another thread may have pinned the same key in the meantime.
+    pinned = find(entry->compressed, COMPRESSED_PUBLIC_KEY_LENGTH);
+    if (!pinned)
+    {
+        pinned_public_key_t **bucket = &pinned_public_keys.buckets[entry->compressed[PINNED_PUBLIC_KEY_BUCKET_OFFSET]];
+        entry->bucket_next = *bucket;
+        *bucket = entry;
+        link_most_recent(entry);
+
+        ++pinned_public_keys.count;
+        pinned_public_keys.bytes += pinned_public_key_size();
+
+        evict();
+    }
+
+    uv_mutex_unlock(&pinned_public_keys_mutex);
+
+    if (pinned)
+    {
+        free_pinned_public_key(entry);
+    }
+
+    return NULL;
+}
+
+napi_value secp256k1_addon_unpin_public_key(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_public_key_length;
+    const unsigned char *raw_public_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &raw_public_key, &raw_public_key_length),
+        env, "Invalid buffer was passed as a public key."
+    );
+
+    uv_once(&pinned_public_keys_once, init_pinned_public_keys);
+
+    uv_mutex_lock(&pinned_public_keys_mutex);
+
+    pinned_public_key_t *entry = find(raw_public_key, raw_public_key_length);
+    if (entry)
+    {
+        unpin(entry);
+    }
+
+    uv_mutex_unlock(&pinned_public_keys_mutex);
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_boolean(env, NULL != entry, &js_result),
+        env, "Could not set the result."
+    );
+
+    return js_result;
+}
+
+napi_value secp256k1_addon_pinned_public_keys_configure(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    double max_bytes;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_double(env, argv[0], &max_bytes),
+        env, "Invalid number was passed as size."
+    );
+
+    uv_once(&pinned_public_keys_once, init_pinned_public_keys);
+
+    uv_mutex_lock(&pinned_public_keys_mutex);
+
+    pinned_public_keys.max_bytes = (size_t) max_bytes;
+    pinned_public_keys.evictions = 0;
+    evict();
+
+    uv_mutex_unlock(&pinned_public_keys_mutex);
+
+    return NULL;
+}
+
+static napi_status set_number_property(napi_env env, napi_value object, const char *name, double value)
+{
+    napi_value js_value;
+    RETURN_ON_FAILURE(napi_create_double(env, value, &js_value));
+
+    return napi_set_named_property(env, object, name, js_value);
+}
+
+napi_value secp256k1_addon_pinned_public_keys_stats(napi_env env, napi_callback_info info)
+{
+    uv_once(&pinned_public_keys_once, init_pinned_public_keys);
+
+    uv_mutex_lock(&pinned_public_keys_mutex);
+
+    const double count = (double) pinned_public_keys.count;
+    const double bytes = (double) pinned_public_keys.bytes;
+    const double max_bytes = (double) pinned_public_keys.max_bytes;
+    const double evictions = (double) pinned_public_keys.evictions;
+
+    uv_mutex_unlock(&pinned_public_keys_mutex);
+
+    napi_value js_stats;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_object(env, &js_stats),
+        env, "Could not create the result object."
+    );
+
+    if (napi_ok != set_number_property(env, js_stats, "count", count)
+        || napi_ok != set_number_property(env, js_stats, "bytes", bytes)
+        || napi_ok != set_number_property(env, js_stats, "maxBytes", max_bytes)
+        || napi_ok != set_number_property(env, js_stats, "evictions", evictions))
+    {
+        napi_throw_error(env, NULL, "Could not set the result.");
+        return NULL;
+    }
+
+    return js_stats;
+}
@@ -1,9 +1,19 @@
 #include "secp256k1_addon/secp256k1_addon.h"
 
 #include "signun_util.h"
+#include "musig_addon/musig_addon.h"
+#include "secp256k1_addon/derive.h"
+#include "secp256k1_addon/ecdh.h"
+#include "secp256k1_addon/key_pair.h"
+#include "secp256k1_addon/message.h"
+#include "secp256k1_addon/multisig.h"
 #include "secp256k1_addon/private_key_verify.h"
+#include "secp256k1_addon/public_key_convert.h"
 #include "secp256k1_addon/public_key_create.h"
+#include "secp256k1_addon/public_key_pin.h"
 #include "secp256k1_addon/sign.h"
+#include "secp256k1_addon/signature.h"
+#include "secp256k1_addon/signature_cache.h"
 #include "secp256k1_addon/verify.h"
 #include "secp256k1_addon/util.h"
 
@@ -18,21 +28,62 @@ napi_status create_secp256k1_addon(napi_env env, napi_value base)
 
     RETURN_ON_FAILURE(napi_create_object(env, &addon));
 
-    const size_t property_count = 8;
+    const size_t property_count = 46;
     napi_property_descriptor properties[] = {
         DECLARE_NAPI_METHOD("privateKeyVerifySync", secp256k1_addon_private_key_verify_sync, &callback_data),
         DECLARE_NAPI_METHOD("publicKeyCreateSync", secp256k1_addon_public_key_create_sync, &callback_data),
         DECLARE_NAPI_METHOD("signSync", secp256k1_addon_sign_sync, &callback_data),
         DECLARE_NAPI_METHOD("verifySync", secp256k1_addon_verify_sync, &callback_data),
+        DECLARE_NAPI_METHOD("verifyMultisigSync", secp256k1_addon_verify_multisig_sync, &callback_data),
+        DECLARE_NAPI_METHOD("signMessageSync", secp256k1_addon_sign_message_sync, &callback_data),
+        DECLARE_NAPI_METHOD("verifyMessageSync", secp256k1_addon_verify_message_sync, &callback_data),
+        DECLARE_NAPI_METHOD("deriveMasterSync", secp256k1_addon_derive_master_sync, &callback_data),
+        DECLARE_NAPI_METHOD("derivePathSync", secp256k1_addon_derive_path_sync, &callback_data),
+        DECLARE_NAPI_METHOD("generateKeyPairSync", secp256k1_addon_generate_key_pair_sync, &callback_data),
+        DECLARE_NAPI_METHOD("ecdhSync", secp256k1_addon_ecdh_sync, &callback_data),
+        DECLARE_NAPI_METHOD("publicKeyConvertSync", secp256k1_addon_public_key_convert_sync, &callback_data),
+        DECLARE_NAPI_METHOD("configureSignatureCache", secp256k1_addon_signature_cache_configure, &callback_data),
+        DECLARE_NAPI_METHOD("saveSignatureCache", secp256k1_addon_signature_cache_save, &callback_data),
+        DECLARE_NAPI_METHOD("signatureCacheStats", secp256k1_addon_signature_cache_stats, &callback_data),
+        DECLARE_NAPI_METHOD("clearSignatureCache", secp256k1_addon_signature_cache_clear, &callback_data),
+        DECLARE_NAPI_METHOD("pinPublicKey", secp256k1_addon_pin_public_key, &callback_data),
+        DECLARE_NAPI_METHOD("unpinPublicKey", secp256k1_addon_unpin_public_key, &callback_data),
+        DECLARE_NAPI_METHOD("configurePinnedPublicKeys", secp256k1_addon_pinned_public_keys_configure, &callback_data),
+        DECLARE_NAPI_METHOD("pinnedPublicKeyStats", secp256k1_addon_pinned_public_keys_stats, &callback_data),
+        DECLARE_NAPI_METHOD("signatureImportSync", secp256k1_addon_signature_import_sync, &callback_data),
+        DECLARE_NAPI_METHOD("signatureExportSync", secp256k1_addon_signature_export_sync, &callback_data),
+        DECLARE_NAPI_METHOD("signatureNormalizeSync", secp256k1_addon_signature_normalize_sync, &callback_data),
 
         DECLARE_NAPI_METHOD("privateKeyVerify", secp256k1_addon_private_key_verify_async, &callback_data),
         DECLARE_NAPI_METHOD("publicKeyCreate", secp256k1_addon_public_key_create_async, &callback_data),
         DECLARE_NAPI_METHOD("sign", secp256k1_addon_sign_async, &callback_data),
-        DECLARE_NAPI_METHOD("verify", secp256k1_addon_verify_async, &callback_data)
+        DECLARE_NAPI_METHOD("verify", secp256k1_addon_verify_async, &callback_data),
+        DECLARE_NAPI_METHOD("verifyMultisig", secp256k1_addon_verify_multisig_async, &callback_data),
+        DECLARE_NAPI_METHOD("signMessage", secp256k1_addon_sign_message_async, &callback_data),
+        DECLARE_NAPI_METHOD("verifyMessage", secp256k1_addon_verify_message_async, &callback_data),
+
+        DECLARE_NAPI_METHOD("ecdh", secp256k1_addon_ecdh_async, &callback_data),
+        DECLARE_NAPI_METHOD("publicKeyConvert", secp256k1_addon_public_key_convert_async, &callback_data),
+        DECLARE_NAPI_METHOD("derivePath", secp256k1_addon_derive_path_async, &callback_data),
+        DECLARE_NAPI_METHOD("deriveBatch", secp256k1_addon_derive_batch, &callback_data),
+        DECLARE_NAPI_METHOD("clearDerivationCache", secp256k1_addon_clear_derivation_cache, &callback_data),
+        DECLARE_NAPI_METHOD("generateKeyPairs", secp256k1_addon_generate_key_pairs, &callback_data),
+        DECLARE_NAPI_METHOD("ecdhBatch", secp256k1_addon_ecdh_batch, &callback_data),
+        DECLARE_NAPI_METHOD("publicKeyConvertBatch", secp256k1_addon_public_key_convert_batch, &callback_data),
+        DECLARE_NAPI_METHOD("signBatch", secp256k1_addon_sign_batch, &callback_data),
+        DECLARE_NAPI_METHOD("signatureImportBatch", secp256k1_addon_signature_import_batch, &callback_data),
+        DECLARE_NAPI_METHOD("signatureExportBatch", secp256k1_addon_signature_export_batch, &callback_data),
+        DECLARE_NAPI_METHOD("signatureNormalizeBatch", secp256k1_addon_signature_normalize_batch, &callback_data),
+        DECLARE_NAPI_METHOD("verifyBatch", secp256k1_addon_verify_batch, &callback_data),
+        DECLARE_NAPI_METHOD("verifyMultisigBatch", secp256k1_addon_verify_multisig_batch, &callback_data),
+        DECLARE_NAPI_METHOD("signMessageBatch", secp256k1_addon_sign_message_batch, &callback_data),
+        DECLARE_NAPI_METHOD("verifyMessageBatch", secp256k1_addon_verify_message_batch, &callback_data)
     };
 
     RETURN_ON_FAILURE(napi_define_properties(env, addon, property_count, properties));
     RETURN_ON_FAILURE(napi_set_named_property(env, base, "secp256k1", addon));
 
+    RETURN_ON_FAILURE(create_musig_addon(env, base, &callback_data));
+
     return napi_ok;
 }
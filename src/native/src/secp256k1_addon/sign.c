@@ -6,10 +6,19 @@
 #include "secp256k1.h"
 #include "secp256k1_recovery.h"
 
+#include "signun_batch.h"
+#include "signun_pool.h"
+#include "signun_scheduler.h"
 #include "signun_util.h"
 #include "secp256k1_addon/util.h"
 
 
+#define SIGN_POOL_HIGH_WATER_MARK 256
+#define SIGN_BATCH_CHUNK_SIZE 128
+
+// R values below 2^255 are one byte shorter in DER.
+#define LOW_R_LIMIT 0x80
+
 typedef struct
 {
     void *original_data;
@@ -19,14 +28,40 @@ typedef struct
 
 typedef struct
 {
+    const unsigned char *data;
+    const unsigned char *tag;
+} tagged_nonce_data_t;
+
+typedef struct
+{
+    signun_batch_t batch;
+    secp256k1_context *secp256k1context;
+
+    const unsigned char *messages;
+    unsigned char private_key[KEY_LENGTH];
+    unsigned char data[DATA_LENGTH];
+    bool is_data_null;
+    secp256k1_addon_nonce_type_t nonce_type;
+    unsigned char tag[ALGORITHM_LENGTH];
+
+    unsigned char *signatures;
+    unsigned char *recoveries;
+    unsigned char *valid;
+} sign_batch_data_t;
+
+typedef struct
+{
+    signun_task_t task;
+
     napi_deferred deferred;
     secp256k1_context *secp256k1context;
-    napi_async_work async_work;
 
     unsigned char message[MESSAGE_LENGTH];
     unsigned char private_key[KEY_LENGTH];
     unsigned char data[DATA_LENGTH];
     bool is_data_null;
+    secp256k1_addon_nonce_type_t nonce_type;
+    unsigned char tag[ALGORITHM_LENGTH];
 
     bool success;
 
@@ -34,6 +69,8 @@ typedef struct
     int recovery_id;
 } sign_callback_data_t;
 
+static const signun_pool_t sign_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_SIGN, sign_callback_data_t, SIGN_POOL_HIGH_WATER_MARK, true);
+
 static int wrapped_js_nonce_fn(unsigned char *nonce, const unsigned char *message, const unsigned char *key, const unsigned char *algorithm, void *data, unsigned int attempt)
 {
     custom_nonce_closure_t *nonce_closure_ptr = (custom_nonce_closure_t *) data;
@@ -111,7 +148,7 @@ static int wrapped_js_nonce_fn(unsigned char *nonce, const unsigned char *messag
     size_t nonce_length;
     const unsigned char *nonce_buffer_ptr;
     RETURN_VALUE_ON_FAILURE(
-        napi_get_buffer_info(env, nonce_buffer, (void **) &nonce_buffer_ptr, &nonce_length), NONCE_FAILED
+        signun_get_bytes(env, nonce_buffer, (void **) &nonce_buffer_ptr, &nonce_length), NONCE_FAILED
     );
     if (nonce_length != NONCE_LENGTH)
     {
@@ -123,10 +160,106 @@ static int wrapped_js_nonce_fn(unsigned char *nonce, const unsigned char *messag
     return NONCE_SUCCESS;
 }
 
+/*
+ * RFC6979 with the tag passed as the algorithm, which secp256k1 mixes into
+ * the nonce derivation, so that different uses of a key never share nonces.
+ */
+static int tagged_rfc6979_nonce_fn(unsigned char *nonce, const unsigned char *message, const unsigned char *key, const unsigned char *algorithm, void *data, unsigned int attempt)
+{
+    tagged_nonce_data_t *tagged_data = (tagged_nonce_data_t *) data;
+
+    return secp256k1_nonce_function_rfc6979(nonce, message, key, tagged_data->tag, (void *)tagged_data->data, attempt);
+}
+
+bool secp256k1_addon_sign_with_nonce(const secp256k1_context *ctx, unsigned char *output, int *recovery_id, const unsigned char *message, const unsigned char *private_key,
+    const unsigned char *data, secp256k1_addon_nonce_type_t nonce_type, const unsigned char *tag)
+{
+    secp256k1_ecdsa_recoverable_signature signature;
+
+    if (SIGN_NONCE_RFC6979_TAGGED == nonce_type)
+    {
+        tagged_nonce_data_t tagged_data = { data, tag };
+        if (0 == secp256k1_ecdsa_sign_recoverable(ctx, &signature, message, private_key, tagged_rfc6979_nonce_fn, &tagged_data))
+        {
+            return false;
+        }
+
+        secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, output, recovery_id, &signature);
+
+        return true;
+    }
+
+    if (0 == secp256k1_ecdsa_sign_recoverable(ctx, &signature, message, private_key, secp256k1_nonce_function_rfc6979, (void *)data))
+    {
+        return false;
+    }
+
+    secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, output, recovery_id, &signature);
+
+    // Grinds for a low R by mixing a counter into the extra entropy of
+    // RFC6979, so that the entropy of the caller is kept. Without any, this
+    // is the counter alone, as in Bitcoin Core.
+    unsigned char counter[DATA_LENGTH] = { 0 };
+    bool success = true;
+    for (uint32_t i = 1; success && SIGN_NONCE_LOW_R == nonce_type && LOW_R_LIMIT <= output[0]; ++i)
+    {
+        if (data)
+        {
+            memcpy(counter, data, DATA_LENGTH);
+        }
+
+        counter[0] ^= i & 0xff;
+        counter[1] ^= (i >> 8) & 0xff;
+        counter[2] ^= (i >> 16) & 0xff;
+        counter[3] ^= (i >> 24) & 0xff;
+
+        success = 0 != secp256k1_ecdsa_sign_recoverable(ctx, &signature, message, private_key, secp256k1_nonce_function_rfc6979, counter);
+        if (success)
+        {
+            secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, output, recovery_id, &signature);
+        }
+    }
+
+    signun_secure_zero(counter, DATA_LENGTH);
+
+    return success;
+}
+
+napi_status secp256k1_addon_get_nonce_options(napi_env env, napi_value js_nonce_type, napi_value js_tag, secp256k1_addon_nonce_type_t *nonce_type, unsigned char *tag)
+{
+    uint32_t raw_nonce_type;
+    RETURN_ON_FAILURE(napi_get_value_uint32(env, js_nonce_type, &raw_nonce_type));
+
+    if (SIGN_NONCE_TYPE_COUNT <= raw_nonce_type)
+    {
+        return napi_invalid_arg;
+    }
+
+    *nonce_type = (secp256k1_addon_nonce_type_t) raw_nonce_type;
+
+    if (SIGN_NONCE_RFC6979_TAGGED != *nonce_type)
+    {
+        return napi_ok;
+    }
+
+    size_t tag_length;
+    const unsigned char *raw_tag;
+    RETURN_ON_FAILURE(signun_get_bytes(env, js_tag, (void **) &raw_tag, &tag_length));
+
+    if (ALGORITHM_LENGTH != tag_length)
+    {
+        return napi_invalid_arg;
+    }
+
+    memcpy(tag, raw_tag, ALGORITHM_LENGTH);
+
+    return napi_ok;
+}
+
 napi_value secp256k1_addon_sign_sync(napi_env env, napi_callback_info info)
 {
-    size_t argc = 4;
-    napi_value argv[4];
+    size_t argc = 6;
+    napi_value argv[6];
     secp256k1_addon_callback_data_t *callback_data;
     THROW_AND_RETURN_NULL_ON_FAILURE(
         napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
@@ -136,14 +269,14 @@ napi_value secp256k1_addon_sign_sync(napi_env env, napi_callback_info info)
     size_t message_length;
     const unsigned char *message;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[0], (void **) &message, &message_length),
+        signun_get_bytes(env, argv[0], (void **) &message, &message_length),
         env, "Invalid buffer was passed as message."
     );
 
     size_t private_key_length;
     const unsigned char *private_key;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[1], (void **) &private_key, &private_key_length),
+        signun_get_bytes(env, argv[1], (void **) &private_key, &private_key_length),
         env, "Invalid buffer was passed as a private key."
     );
 
@@ -175,34 +308,44 @@ napi_value secp256k1_addon_sign_sync(napi_env env, napi_callback_info info)
     else
     {
         THROW_AND_RETURN_NULL_ON_FAILURE(
-            napi_get_buffer_info(env, argv[3], (void **) &data, &data_length),
+            signun_get_bytes(env, argv[3], (void **) &data, &data_length),
             env, "Invalid buffer was passed as data."
         );
     }
 
-    secp256k1_ecdsa_recoverable_signature signature;
-    int sign_status;
+    secp256k1_addon_nonce_type_t nonce_type;
+    unsigned char tag[ALGORITHM_LENGTH] = { 0 };
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        secp256k1_addon_get_nonce_options(env, argv[4], argv[5], &nonce_type, tag),
+        env, "Invalid nonce options were passed."
+    );
+
+    size_t compact_output_length = 64;
+    unsigned char compact_output[64];
+    int recovery_id;
+    bool sign_status;
     if (is_noncefn_null)
-    {    
-        sign_status = secp256k1_ecdsa_sign_recoverable(callback_data->secp256k1context, &signature, message, private_key, secp256k1_nonce_function_rfc6979, data);
+    {
+        sign_status = secp256k1_addon_sign_with_nonce(callback_data->secp256k1context, compact_output, &recovery_id, message, private_key, data, nonce_type, tag);
     }
     else
     {
+        secp256k1_ecdsa_recoverable_signature signature;
         custom_nonce_closure_t nonce_closure = { data, env, argv[2] };
         sign_status = secp256k1_ecdsa_sign_recoverable(callback_data->secp256k1context, &signature, message, private_key, wrapped_js_nonce_fn, &nonce_closure);
+
+        if (sign_status)
+        {
+            secp256k1_ecdsa_recoverable_signature_serialize_compact(callback_data->secp256k1context, &compact_output[0], &recovery_id, &signature);
+        }
     }
-    
-    if (0 == sign_status)
+
+    if (!sign_status)
     {
         napi_throw_error(env, NULL, "Could not sign the mesage.");
         return NULL;
     }
 
-    size_t compact_output_length = 64;
-    unsigned char compact_output[64];
-    int recovery_id;
-    secp256k1_ecdsa_recoverable_signature_serialize_compact(callback_data->secp256k1context, &compact_output[0], &recovery_id, &signature);
-
     napi_value js_signature;
     THROW_AND_RETURN_NULL_ON_FAILURE(
         napi_create_buffer_copy(env, compact_output_length, (void *)compact_output, NULL, &js_signature),
@@ -238,32 +381,30 @@ static void sign_async_execute(napi_env env, void *data)
 {
     sign_callback_data_t *callback_data = (sign_callback_data_t *) data;
 
-    secp256k1_ecdsa_recoverable_signature signature;
-
     // Custom noncefn is not supported yet.
-    int sign_status = secp256k1_ecdsa_sign_recoverable(callback_data->secp256k1context, &signature, callback_data->message, callback_data->private_key, secp256k1_nonce_function_rfc6979, callback_data->data);
-    
-    if (0 == sign_status)
-    {
-        callback_data->success = false;
-
-        return;
-    }
-
-    secp256k1_ecdsa_recoverable_signature_serialize_compact(callback_data->secp256k1context, &callback_data->signature[0], &callback_data->recovery_id, &signature); 
-
-    callback_data->success = true;
+    callback_data->success = secp256k1_addon_sign_with_nonce(callback_data->secp256k1context, callback_data->signature, &callback_data->recovery_id,
+        callback_data->message, callback_data->private_key, callback_data->is_data_null ? NULL : callback_data->data,
+        callback_data->nonce_type, callback_data->tag);
 }
 
 static void sign_async_complete(napi_env env, napi_status status, void *data)
 {
     sign_callback_data_t *callback_data = (sign_callback_data_t *) data;
 
-    if (napi_ok != napi_delete_async_work(env, callback_data->async_work))
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
     {
         REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &sign_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        signun_pool_release(env, &sign_callback_data_pool, callback_data);
 
         return;
     }
@@ -272,7 +413,7 @@ static void sign_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &sign_callback_data_pool, callback_data);
 
         return;
     }
@@ -281,7 +422,7 @@ static void sign_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "Could not sign the message.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &sign_callback_data_pool, callback_data);
 
         return;
     }
@@ -291,7 +432,7 @@ static void sign_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "Could not set the signature buffer", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &sign_callback_data_pool, callback_data);
 
         return;
     };
@@ -301,7 +442,7 @@ static void sign_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "Could not set the recovery id.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &sign_callback_data_pool, callback_data);
 
         return;
     }
@@ -311,7 +452,7 @@ static void sign_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "Could not create the result object.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &sign_callback_data_pool, callback_data);
 
         return;
     }
@@ -320,7 +461,7 @@ static void sign_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "Could not set named property: 'signature'.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &sign_callback_data_pool, callback_data);
 
         return;
     }
@@ -329,20 +470,20 @@ static void sign_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "Could not set named property: 'recovery'.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &sign_callback_data_pool, callback_data);
 
         return;
     }
 
     napi_resolve_deferred(env, callback_data->deferred, js_result);
 
-    free(callback_data);
+    signun_pool_release(env, &sign_callback_data_pool, callback_data);
 }
 
 napi_value secp256k1_addon_sign_async(napi_env env, napi_callback_info info)
 {
-    size_t argc = 4;
-    napi_value argv[4];
+    size_t argc = 8;
+    napi_value argv[8];
     secp256k1_addon_callback_data_t *current_callback_data;
     THROW_AND_RETURN_NULL_ON_FAILURE(
         napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
@@ -352,14 +493,14 @@ napi_value secp256k1_addon_sign_async(napi_env env, napi_callback_info info)
     size_t message_length;
     const unsigned char *message;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[0], (void **) &message, &message_length),
+        signun_get_bytes(env, argv[0], (void **) &message, &message_length),
         env, "Invalid buffer was passed as message."
     );
 
     size_t private_key_length;
     const unsigned char *private_key;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[1], (void **) &private_key, &private_key_length),
+        signun_get_bytes(env, argv[1], (void **) &private_key, &private_key_length),
         env, "Invalid buffer was passed as a private key."
     );
 
@@ -391,11 +532,30 @@ napi_value secp256k1_addon_sign_async(napi_env env, napi_callback_info info)
     else
     {
         THROW_AND_RETURN_NULL_ON_FAILURE(
-            napi_get_buffer_info(env, argv[3], (void **) &data, &data_length),
+            signun_get_bytes(env, argv[3], (void **) &data, &data_length),
             env, "Invalid buffer was passed as data."
         );
     }
 
+    secp256k1_addon_nonce_type_t nonce_type;
+    unsigned char tag[ALGORITHM_LENGTH] = { 0 };
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        secp256k1_addon_get_nonce_options(env, argv[4], argv[5], &nonce_type, tag),
+        env, "Invalid nonce options were passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[6], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[7], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
     const char *resource_identifier = "secp256k1::async::sign";
     napi_value sign_resource_name;
     THROW_AND_RETURN_NULL_ON_FAILURE(
@@ -403,7 +563,12 @@ napi_value secp256k1_addon_sign_async(napi_env env, napi_callback_info info)
         env, "Could not create resource name."
     );
 
-    sign_callback_data_t *sign_callback_data = (sign_callback_data_t *)malloc(sizeof (sign_callback_data_t));
+    sign_callback_data_t *sign_callback_data = signun_pool_acquire(env, &sign_callback_data_pool);
+    if (!sign_callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
     
     sign_callback_data->secp256k1context = current_callback_data->secp256k1context;
 
@@ -413,34 +578,228 @@ napi_value secp256k1_addon_sign_async(napi_env env, napi_callback_info info)
     {
         memcpy(&sign_callback_data->data[0], data, DATA_LENGTH);
     }
-    sign_callback_data->is_data_null = data;
+    sign_callback_data->is_data_null = !data;
+    sign_callback_data->nonce_type = nonce_type;
+    memcpy(sign_callback_data->tag, tag, ALGORITHM_LENGTH);
 
     napi_value promise;
     if (napi_ok != napi_create_promise(env, &sign_callback_data->deferred, &promise))
     {
-        free(sign_callback_data);
+        signun_pool_release(env, &sign_callback_data_pool, sign_callback_data);
         napi_throw_error(env, NULL, "Could not create result promise.");
         return NULL;
     }
 
-    napi_async_work sign_async_work;
-    if (napi_ok != napi_create_async_work(env, NULL, sign_resource_name, sign_async_execute, sign_async_complete, sign_callback_data, &sign_async_work))
+    if (napi_ok != signun_task_create(env, &sign_callback_data->task, SIGNUN_OP_SIGN, priority, cancel_token, sign_resource_name, sign_async_execute, sign_async_complete))
     {
         REJECT_WITH_ERROR(env, "Could not create async work.", sign_callback_data->deferred);
-        free(sign_callback_data);
+        signun_pool_release(env, &sign_callback_data_pool, sign_callback_data);
         return promise;
     }
 
-    sign_callback_data->async_work = sign_async_work;
+    napi_async_work sign_async_work = sign_callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &sign_callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", sign_callback_data->deferred);
+        signun_pool_release(env, &sign_callback_data_pool, sign_callback_data);
+        napi_delete_async_work(env, sign_async_work);
+        return promise;
+    }
 
-    napi_status queue_status = napi_queue_async_work(env, sign_async_work);
     if (napi_ok != queue_status)
     {
         REJECT_WITH_ERROR(env, "Could not queue async work.", sign_callback_data->deferred);
-        free(sign_callback_data);
+        signun_pool_release(env, &sign_callback_data_pool, sign_callback_data);
         napi_delete_async_work(env, sign_async_work);
         return promise;
     }
     
     return promise;
 }
+
+static void sign_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    sign_batch_data_t *batch_data = (sign_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        unsigned char *signature = &batch_data->signatures[i * SIGNATURE_LENGTH];
+        int recovery_id;
+
+        if (!secp256k1_addon_sign_with_nonce(batch_data->secp256k1context, signature, &recovery_id, &batch_data->messages[i * MESSAGE_LENGTH], batch_data->private_key,
+            batch_data->is_data_null ? NULL : batch_data->data, batch_data->nonce_type, batch_data->tag))
+        {
+            memset(signature, 0, SIGNATURE_LENGTH);
+            batch_data->recoveries[i] = 0;
+            batch_data->valid[i] = 0;
+            continue;
+        }
+
+        batch_data->recoveries[i] = (unsigned char) recovery_id;
+        batch_data->valid[i] = 1;
+    }
+}
+
+static napi_status sign_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    napi_value js_signatures;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 1, &js_signatures));
+
+    napi_value js_recoveries;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 2, &js_recoveries));
+
+    napi_value js_valid;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 3, &js_valid));
+
+    RETURN_ON_FAILURE(napi_create_object(env, result));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "signatures", js_signatures));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "recoveries", js_recoveries));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "valid", js_valid));
+
+    return napi_ok;
+}
+
+static void sign_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    sign_batch_data_t *batch_data = (sign_batch_data_t *) batch;
+
+    signun_secure_zero(batch_data->private_key, KEY_LENGTH);
+    free(batch_data);
+}
+
+napi_value secp256k1_addon_sign_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 7;
+    napi_value argv[7];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t messages_length;
+    const unsigned char *messages;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &messages, &messages_length),
+        env, "Invalid buffer was passed as messages."
+    );
+
+    size_t private_key_length;
+    const unsigned char *private_key;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &private_key, &private_key_length),
+        env, "Invalid buffer was passed as a private key."
+    );
+
+    napi_value null_value;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_null(env, &null_value),
+        env, "Could not get null object"
+    );
+
+    bool is_data_null;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_strict_equals(env, argv[2], null_value, &is_data_null),
+        env, "Could not check if data is null"
+    );
+
+    size_t data_length = DATA_LENGTH;
+    const unsigned char *data = NULL;
+    if (!is_data_null)
+    {
+        THROW_AND_RETURN_NULL_ON_FAILURE(
+            signun_get_bytes(env, argv[2], (void **) &data, &data_length),
+            env, "Invalid buffer was passed as data."
+        );
+    }
+
+    secp256k1_addon_nonce_type_t nonce_type;
+    unsigned char tag[ALGORITHM_LENGTH] = { 0 };
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        secp256k1_addon_get_nonce_options(env, argv[3], argv[4], &nonce_type, tag),
+        env, "Invalid nonce options were passed."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[5], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[6], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (0 != messages_length % MESSAGE_LENGTH || KEY_LENGTH != private_key_length || DATA_LENGTH != data_length)
+    {
+        napi_throw_error(env, NULL, "Invalid input length.");
+        return NULL;
+    }
+
+    const size_t count = messages_length / MESSAGE_LENGTH;
+
+    const char *resource_identifier = "secp256k1::batch::sign";
+    napi_value resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name),
+        env, "Could not create resource name."
+    );
+
+    sign_batch_data_t *batch_data = (sign_batch_data_t *)calloc(1, sizeof (sign_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->secp256k1context = callback_data->secp256k1context;
+    batch_data->messages = messages;
+    memcpy(batch_data->private_key, private_key, KEY_LENGTH);
+    if (data)
+    {
+        memcpy(batch_data->data, data, DATA_LENGTH);
+    }
+    batch_data->is_data_null = !data;
+    batch_data->nonce_type = nonce_type;
+    memcpy(batch_data->tag, tag, ALGORITHM_LENGTH);
+
+    napi_value js_signatures;
+    napi_value js_recoveries;
+    napi_value js_valid;
+    if (napi_ok != napi_create_buffer(env, count * SIGNATURE_LENGTH, (void **) &batch_data->signatures, &js_signatures)
+        || napi_ok != napi_create_buffer(env, count, (void **) &batch_data->recoveries, &js_recoveries)
+        || napi_ok != napi_create_buffer(env, count, (void **) &batch_data->valid, &js_valid))
+    {
+        sign_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffers.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, SIGN_BATCH_CHUNK_SIZE,
+        sign_batch_execute, sign_batch_complete, sign_batch_finalize, &promise))
+    {
+        sign_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_signatures)
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_recoveries)
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_valid))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        sign_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_SIGN_BATCH, priority, cancel_token, resource_name);
+
+    return promise;
+}
@@ -0,0 +1,571 @@
+#include "secp256k1_addon/signature.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "secp256k1.h"
+
+#include "signun_batch.h"
+#include "signun_scheduler.h"
+#include "signun_util.h"
+#include "secp256k1_addon/util.h"
+
+
+#define SIGNATURE_BATCH_CHUNK_SIZE 4096
+
+#define DER_SEQUENCE_TAG 0x30
+#define DER_LONG_LENGTH_ONE_BYTE 0x81
+
+typedef struct
+{
+    signun_batch_t batch;
+    secp256k1_context *secp256k1context;
+
+    const unsigned char *input;
+    // Import only, where signatures differ in length.
+    size_t *offsets;
+
+    // Import and normalize write straight into the result buffers.
+    unsigned char *signatures;
+    unsigned char *valid;
+
+    // Export serializes into fixed-size slots, which are packed on completion.
+    unsigned char *der_signatures;
+    size_t *der_signature_lengths;
+} signature_batch_data_t;
+
+bool secp256k1_addon_scan_der_signatures(const unsigned char *input, size_t input_length, size_t *offsets, size_t *count)
+{
+    size_t position = 0;
+    size_t found = 0;
+
+    while (position < input_length)
+    {
+        const size_t remaining = input_length - position;
+
+        if (2 > remaining || DER_SEQUENCE_TAG != input[position])
+        {
+            return false;
+        }
+
+        size_t length;
+        if (0x80 > input[position + 1])
+        {
+            length = 2 + input[position + 1];
+        }
+        else if (DER_LONG_LENGTH_ONE_BYTE == input[position + 1] && 3 <= remaining)
+        {
+            length = 3 + input[position + 2];
+        }
+        else
+        {
+            return false;
+        }
+
+        if (length > remaining)
+        {
+            return false;
+        }
+
+        if (offsets)
+        {
+            offsets[found] = position;
+        }
+
+        found++;
+        position += length;
+    }
+
+    if (offsets)
+    {
+        offsets[found] = position;
+    }
+
+    *count = found;
+
+    return true;
+}
+
+napi_value secp256k1_addon_signature_import_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t der_signature_length;
+    const unsigned char *der_signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &der_signature, &der_signature_length),
+        env, "Invalid buffer was passed as signature."
+    );
+
+    secp256k1_ecdsa_signature signature;
+    if (0 == secp256k1_ecdsa_signature_parse_der(callback_data->secp256k1context, &signature, der_signature, der_signature_length))
+    {
+        napi_throw_error(env, NULL, "Could not parse the signature.");
+        return NULL;
+    }
+
+    unsigned char serialized_signature[SIGNATURE_LENGTH];
+    secp256k1_ecdsa_signature_serialize_compact(callback_data->secp256k1context, &serialized_signature[0], &signature);
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer_copy(env, SIGNATURE_LENGTH, (void *)serialized_signature, NULL, &js_result),
+        env, "Could not set the result buffer."
+    );
+
+    return js_result;
+}
+
+napi_value secp256k1_addon_signature_export_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_signature_length;
+    const unsigned char *raw_signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &raw_signature, &raw_signature_length),
+        env, "Invalid buffer was passed as signature."
+    );
+
+    secp256k1_ecdsa_signature signature;
+    if (0 == secp256k1_ecdsa_signature_parse_compact(callback_data->secp256k1context, &signature, raw_signature))
+    {
+        napi_throw_error(env, NULL, "Could not parse the signature.");
+        return NULL;
+    }
+
+    size_t der_signature_length = DER_SIGNATURE_MAX_LENGTH;
+    unsigned char der_signature[DER_SIGNATURE_MAX_LENGTH];
+    if (0 == secp256k1_ecdsa_signature_serialize_der(callback_data->secp256k1context, &der_signature[0], &der_signature_length, &signature))
+    {
+        napi_throw_error(env, NULL, "Could not serialize the signature.");
+        return NULL;
+    }
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer_copy(env, der_signature_length, (void *)der_signature, NULL, &js_result),
+        env, "Could not set the result buffer."
+    );
+
+    return js_result;
+}
+
+napi_value secp256k1_addon_signature_normalize_sync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    secp256k1_addon_callback_data_t *callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t raw_signature_length;
+    const unsigned char *raw_signature;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &raw_signature, &raw_signature_length),
+        env, "Invalid buffer was passed as signature."
+    );
+
+    secp256k1_ecdsa_signature signature;
+    if (0 == secp256k1_ecdsa_signature_parse_compact(callback_data->secp256k1context, &signature, raw_signature))
+    {
+        napi_throw_error(env, NULL, "Could not parse the signature.");
+        return NULL;
+    }
+
+    secp256k1_ecdsa_signature_normalize(callback_data->secp256k1context, &signature, &signature);
+
+    unsigned char serialized_signature[SIGNATURE_LENGTH];
+    secp256k1_ecdsa_signature_serialize_compact(callback_data->secp256k1context, &serialized_signature[0], &signature);
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_buffer_copy(env, SIGNATURE_LENGTH, (void *)serialized_signature, NULL, &js_result),
+        env, "Could not set the result buffer."
+    );
+
+    return js_result;
+}
+
+static void signature_import_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    signature_batch_data_t *batch_data = (signature_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        const size_t offset = batch_data->offsets[i];
+        unsigned char *serialized_signature = &batch_data->signatures[i * SIGNATURE_LENGTH];
+
+        secp256k1_ecdsa_signature signature;
+        if (0 == secp256k1_ecdsa_signature_parse_der(batch_data->secp256k1context, &signature, &batch_data->input[offset], batch_data->offsets[i + 1] - offset))
+        {
+            memset(serialized_signature, 0, SIGNATURE_LENGTH);
+            batch_data->valid[i] = 0;
+            continue;
+        }
+
+        secp256k1_ecdsa_signature_serialize_compact(batch_data->secp256k1context, serialized_signature, &signature);
+        batch_data->valid[i] = 1;
+    }
+}
+
+static void signature_export_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    signature_batch_data_t *batch_data = (signature_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        secp256k1_ecdsa_signature signature;
+        if (0 == secp256k1_ecdsa_signature_parse_compact(batch_data->secp256k1context, &signature, &batch_data->input[i * SIGNATURE_LENGTH]))
+        {
+            signun_batch_chunk_fail(batch, chunk, "Could not parse the signature.");
+            return;
+        }
+
+        batch_data->der_signature_lengths[i] = DER_SIGNATURE_MAX_LENGTH;
+        if (0 == secp256k1_ecdsa_signature_serialize_der(batch_data->secp256k1context, &batch_data->der_signatures[i * DER_SIGNATURE_MAX_LENGTH], &batch_data->der_signature_lengths[i], &signature))
+        {
+            signun_batch_chunk_fail(batch, chunk, "Could not serialize the signature.");
+            return;
+        }
+    }
+}
+
+static void signature_normalize_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    signature_batch_data_t *batch_data = (signature_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        secp256k1_ecdsa_signature signature;
+        if (0 == secp256k1_ecdsa_signature_parse_compact(batch_data->secp256k1context, &signature, &batch_data->input[i * SIGNATURE_LENGTH]))
+        {
+            signun_batch_chunk_fail(batch, chunk, "Could not parse the signature.");
+            return;
+        }
+
+        secp256k1_ecdsa_signature_normalize(batch_data->secp256k1context, &signature, &signature);
+        secp256k1_ecdsa_signature_serialize_compact(batch_data->secp256k1context, &batch_data->signatures[i * SIGNATURE_LENGTH], &signature);
+    }
+}
+
+static napi_status signature_import_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    napi_value js_signatures;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 1, &js_signatures));
+
+    napi_value js_valid;
+    RETURN_ON_FAILURE(signun_batch_get_retained_value(env, batch, 2, &js_valid));
+
+    RETURN_ON_FAILURE(napi_create_object(env, result));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "signatures", js_signatures));
+    RETURN_ON_FAILURE(napi_set_named_property(env, *result, "valid", js_valid));
+
+    return napi_ok;
+}
+
+static napi_status signature_export_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    signature_batch_data_t *batch_data = (signature_batch_data_t *) batch;
+
+    size_t total_length = 0;
+    for (size_t i = 0; i < batch->item_count; ++i)
+    {
+        total_length += batch_data->der_signature_lengths[i];
+    }
+
+    unsigned char *packed;
+    RETURN_ON_FAILURE(napi_create_buffer(env, total_length, (void **) &packed, result));
+
+    for (size_t i = 0; i < batch->item_count; ++i)
+    {
+        memcpy(packed, &batch_data->der_signatures[i * DER_SIGNATURE_MAX_LENGTH], batch_data->der_signature_lengths[i]);
+        packed += batch_data->der_signature_lengths[i];
+    }
+
+    return napi_ok;
+}
+
+static napi_status signature_normalize_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    return signun_batch_get_retained_value(env, batch, 1, result);
+}
+
+static void signature_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    signature_batch_data_t *batch_data = (signature_batch_data_t *) batch;
+
+    free(batch_data->offsets);
+    free(batch_data->der_signatures);
+    free(batch_data->der_signature_lengths);
+    free(batch_data);
+}
+
+/*
+ * Reads the arguments shared by every signature batch: the packed input, the
+ * priority and the cancel token. Throws on failure.
+ */
+static bool get_signature_batch_arguments(napi_env env, napi_callback_info info, secp256k1_addon_callback_data_t **callback_data,
+    napi_value *js_input, const unsigned char **input, size_t *input_length, signun_priority_t *priority, signun_cancel_token_t **cancel_token)
+{
+    size_t argc = 3;
+    napi_value argv[3];
+    if (napi_ok != napi_get_cb_info(env, info, &argc, argv, NULL, (void **) callback_data))
+    {
+        napi_throw_error(env, NULL, "Could not read function arguments.");
+        return false;
+    }
+
+    *js_input = argv[0];
+    if (napi_ok != signun_get_bytes(env, argv[0], (void **) input, input_length))
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as signatures.");
+        return false;
+    }
+
+    if (napi_ok != signun_get_priority(env, argv[1], SIGNUN_PRIORITY_BULK, priority))
+    {
+        napi_throw_error(env, NULL, "Invalid priority was passed.");
+        return false;
+    }
+
+    if (napi_ok != signun_get_cancel_token(env, argv[2], cancel_token))
+    {
+        napi_throw_error(env, NULL, "Invalid cancel token was passed.");
+        return false;
+    }
+
+    return true;
+}
+
+static signature_batch_data_t *create_signature_batch_data(secp256k1_addon_callback_data_t *callback_data, const unsigned char *input)
+{
+    signature_batch_data_t *batch_data = (signature_batch_data_t *)calloc(1, sizeof (signature_batch_data_t));
+    if (!batch_data)
+    {
+        return NULL;
+    }
+
+    batch_data->secp256k1context = callback_data->secp256k1context;
+    batch_data->input = input;
+
+    return batch_data;
+}
+
+/*
+ * Retains the input and queues the batch, or discards it if that fails.
+ */
+static napi_value queue_signature_batch(napi_env env, signature_batch_data_t *batch_data, napi_value promise,
+    signun_priority_t priority, signun_cancel_token_t *cancel_token, const char *resource_identifier)
+{
+    napi_value resource_name;
+    if (napi_ok != napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &resource_name))
+    {
+        REJECT_WITH_ERROR(env, "Could not create resource name.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        signature_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_SIGNATURE_BATCH, priority, cancel_token, resource_name);
+
+    return promise;
+}
+
+napi_value secp256k1_addon_signature_import_batch(napi_env env, napi_callback_info info)
+{
+    secp256k1_addon_callback_data_t *callback_data;
+    napi_value js_input;
+    const unsigned char *input;
+    size_t input_length;
+    signun_priority_t priority;
+    signun_cancel_token_t *cancel_token;
+    if (!get_signature_batch_arguments(env, info, &callback_data, &js_input, &input, &input_length, &priority, &cancel_token))
+    {
+        return NULL;
+    }
+
+    size_t count;
+    if (!secp256k1_addon_scan_der_signatures(input, input_length, NULL, &count))
+    {
+        napi_throw_error(env, NULL, "Could not find the boundaries of the DER signatures.");
+        return NULL;
+    }
+
+    signature_batch_data_t *batch_data = create_signature_batch_data(callback_data, input);
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->offsets = (size_t *)malloc((count + 1) * sizeof (size_t));
+    if (!batch_data->offsets)
+    {
+        signature_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    secp256k1_addon_scan_der_signatures(input, input_length, batch_data->offsets, &count);
+
+    napi_value js_signatures;
+    napi_value js_valid;
+    if (napi_ok != napi_create_buffer(env, count * SIGNATURE_LENGTH, (void **) &batch_data->signatures, &js_signatures)
+        || napi_ok != napi_create_buffer(env, count, (void **) &batch_data->valid, &js_valid))
+    {
+        signature_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffers.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, SIGNATURE_BATCH_CHUNK_SIZE,
+        signature_import_batch_execute, signature_import_batch_complete, signature_batch_finalize, &promise))
+    {
+        signature_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, js_input)
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_signatures)
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_valid))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        signature_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    return queue_signature_batch(env, batch_data, promise, priority, cancel_token, "secp256k1::batch::signatureImport");
+}
+
+napi_value secp256k1_addon_signature_export_batch(napi_env env, napi_callback_info info)
+{
+    secp256k1_addon_callback_data_t *callback_data;
+    napi_value js_input;
+    const unsigned char *input;
+    size_t input_length;
+    signun_priority_t priority;
+    signun_cancel_token_t *cancel_token;
+    if (!get_signature_batch_arguments(env, info, &callback_data, &js_input, &input, &input_length, &priority, &cancel_token))
+    {
+        return NULL;
+    }
+
+    if (0 != input_length % SIGNATURE_LENGTH)
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as signatures.");
+        return NULL;
+    }
+
+    const size_t count = input_length / SIGNATURE_LENGTH;
+
+    signature_batch_data_t *batch_data = create_signature_batch_data(callback_data, input);
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    // Zero-sized allocations may legitimately return NULL.
+    batch_data->der_signatures = (unsigned char *)malloc(count * DER_SIGNATURE_MAX_LENGTH + 1);
+    batch_data->der_signature_lengths = (size_t *)malloc(count * sizeof (size_t) + 1);
+    if (!batch_data->der_signatures || !batch_data->der_signature_lengths)
+    {
+        signature_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, SIGNATURE_BATCH_CHUNK_SIZE,
+        signature_export_batch_execute, signature_export_batch_complete, signature_batch_finalize, &promise))
+    {
+        signature_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, js_input))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        signature_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    return queue_signature_batch(env, batch_data, promise, priority, cancel_token, "secp256k1::batch::signatureExport");
+}
+
+napi_value secp256k1_addon_signature_normalize_batch(napi_env env, napi_callback_info info)
+{
+    secp256k1_addon_callback_data_t *callback_data;
+    napi_value js_input;
+    const unsigned char *input;
+    size_t input_length;
+    signun_priority_t priority;
+    signun_cancel_token_t *cancel_token;
+    if (!get_signature_batch_arguments(env, info, &callback_data, &js_input, &input, &input_length, &priority, &cancel_token))
+    {
+        return NULL;
+    }
+
+    if (0 != input_length % SIGNATURE_LENGTH)
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as signatures.");
+        return NULL;
+    }
+
+    const size_t count = input_length / SIGNATURE_LENGTH;
+
+    signature_batch_data_t *batch_data = create_signature_batch_data(callback_data, input);
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    napi_value js_signatures;
+    if (napi_ok != napi_create_buffer(env, input_length, (void **) &batch_data->signatures, &js_signatures))
+    {
+        signature_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffers.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, SIGNATURE_BATCH_CHUNK_SIZE,
+        signature_normalize_batch_execute, signature_normalize_batch_complete, signature_batch_finalize, &promise))
+    {
+        signature_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, js_input)
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_signatures))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        signature_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    return queue_signature_batch(env, batch_data, promise, priority, cancel_token, "secp256k1::batch::signatureNormalize");
+}
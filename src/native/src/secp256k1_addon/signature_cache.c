@@ -0,0 +1,628 @@
+#include "secp256k1_addon/signature_cache.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <uv.h>
+
+#include "blake2.h"
+
+#include "signun_util.h"
+#include "secp256k1_addon/util.h"
+
+
+/*
+ * A cuckoo filter over salted BLAKE2b digests of verified triples. Every
+ * triple has two candidate buckets, the second derived from the first and
+ * the fingerprint alone, so that entries can be relocated without knowing
+ * the triple they came from. A bucket fills a cache line.
+ */
+#define SIGNATURE_CACHE_SLOTS 4
+#define SIGNATURE_CACHE_FINGERPRINT_LENGTH 16
+#define SIGNATURE_CACHE_SALT_LENGTH 32
+
+// Relocations tried before the last displaced entry is dropped.
+#define SIGNATURE_CACHE_MAX_KICKS 16
+
+#define SIGNATURE_CACHE_MAGIC "SIGNUNSC"
+#define SIGNATURE_CACHE_MAGIC_LENGTH 8
+#define SIGNATURE_CACHE_VERSION 1
+
+// Flags, signature length and public key length, then the triple itself.
+#define SIGNATURE_CACHE_MAX_INPUT_LENGTH (3 + MESSAGE_LENGTH + DER_SIGNATURE_MAX_LENGTH + SERIALIZED_PUBLIC_KEY_LENGTH)
+
+typedef struct
+{
+    unsigned char fingerprints[SIGNATURE_CACHE_SLOTS][SIGNATURE_CACHE_FINGERPRINT_LENGTH];
+} signature_cache_bucket_t;
+
+typedef struct
+{
+    char magic[SIGNATURE_CACHE_MAGIC_LENGTH];
+    uint32_t version;
+    uint32_t slot_count;
+    uint64_t bucket_count;
+    uint64_t entry_count;
+    unsigned char salt[SIGNATURE_CACHE_SALT_LENGTH];
+} signature_cache_file_header_t;
+
+typedef struct
+{
+    unsigned char salt[SIGNATURE_CACHE_SALT_LENGTH];
+    uint64_t bucket_count;
+    uint64_t entry_count;
+    unsigned int kick_cursor;
+    signature_cache_bucket_t *buckets;
+} signature_cache_t;
+
+typedef struct
+{
+    uint64_t lookups;
+    uint64_t hits;
+    uint64_t insertions;
+    uint64_t evictions;
+} signature_cache_stats_t;
+
+static signature_cache_t *signature_cache = NULL;
+static uv_rwlock_t signature_cache_lock;
+
+// Lookups share the read lock, so the counters have a lock of their own.
+static signature_cache_stats_t signature_cache_stats;
+static uv_mutex_t signature_cache_stats_mutex;
+
+static uv_once_t signature_cache_once = UV_ONCE_INIT;
+
+static void init_signature_cache(void)
+{
+    uv_rwlock_init(&signature_cache_lock);
+    uv_mutex_init(&signature_cache_stats_mutex);
+}
+
+static void count(uint64_t *counter)
+{
+    uv_mutex_lock(&signature_cache_stats_mutex);
+    ++*counter;
+    uv_mutex_unlock(&signature_cache_stats_mutex);
+}
+
+static uint64_t load_index(const unsigned char *input)
+{
+    uint64_t value;
+    memcpy(&value, input, sizeof (uint64_t));
+
+    return value;
+}
+
+static uint64_t alternate_bucket(const signature_cache_t *cache, uint64_t bucket, const unsigned char *fingerprint)
+{
+    return (bucket ^ (load_index(fingerprint) * 0x9e3779b97f4a7c15ULL)) & (cache->bucket_count - 1);
+}
+
+static bool bucket_contains(const signature_cache_bucket_t *bucket, const unsigned char *fingerprint)
+{
+    for (size_t i = 0; i < SIGNATURE_CACHE_SLOTS; ++i)
+    {
+        if (0 == memcmp(bucket->fingerprints[i], fingerprint, SIGNATURE_CACHE_FINGERPRINT_LENGTH))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Fingerprints are never all zero, so an all zero slot is empty.
+static bool bucket_insert(signature_cache_bucket_t *bucket, const unsigned char *fingerprint)
+{
+    static const unsigned char empty[SIGNATURE_CACHE_FINGERPRINT_LENGTH] = { 0 };
+
+    for (size_t i = 0; i < SIGNATURE_CACHE_SLOTS; ++i)
+    {
+        if (0 == memcmp(bucket->fingerprints[i], empty, SIGNATURE_CACHE_FINGERPRINT_LENGTH))
+        {
+            memcpy(bucket->fingerprints[i], fingerprint, SIGNATURE_CACHE_FINGERPRINT_LENGTH);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void free_signature_cache(signature_cache_t *cache)
+{
+    if (cache)
+    {
+        free(cache->buckets);
+        free(cache);
+    }
+}
+
+bool secp256k1_addon_signature_cache_lookup(secp256k1_addon_signature_cache_key_t *key, const unsigned char *message,
+    const unsigned char *signature, size_t signature_length, const unsigned char *public_key, size_t public_key_length, unsigned char flags)
+{
+    key->is_set = false;
+
+    if (DER_SIGNATURE_MAX_LENGTH < signature_length || SERIALIZED_PUBLIC_KEY_LENGTH < public_key_length)
+    {
+        return false;
+    }
+
+    uv_once(&signature_cache_once, init_signature_cache);
+
+    unsigned char input[SIGNATURE_CACHE_MAX_INPUT_LENGTH];
+    input[0] = flags;
+    input[1] = (unsigned char) signature_length;
+    input[2] = (unsigned char) public_key_length;
+    memcpy(&input[3], message, MESSAGE_LENGTH);
+    memcpy(&input[3 + MESSAGE_LENGTH], signature, signature_length);
+    memcpy(&input[3 + MESSAGE_LENGTH + signature_length], public_key, public_key_length);
+
+    const size_t input_length = 3 + MESSAGE_LENGTH + signature_length + public_key_length;
+
+    uv_rwlock_rdlock(&signature_cache_lock);
+
+    const signature_cache_t *cache = signature_cache;
+    bool is_hit = false;
+    if (cache && 0 == blake2b(key->digest, SIGNATURE_CACHE_KEY_LENGTH, input, input_length, cache->salt, SIGNATURE_CACHE_SALT_LENGTH))
+    {
+        key->digest[0] |= 0x01;
+        key->is_set = true;
+
+        const uint64_t bucket = load_index(&key->digest[SIGNATURE_CACHE_FINGERPRINT_LENGTH]) & (cache->bucket_count - 1);
+
+        is_hit = bucket_contains(&cache->buckets[bucket], key->digest)
+            || bucket_contains(&cache->buckets[alternate_bucket(cache, bucket, key->digest)], key->digest);
+    }
+
+    uv_rwlock_rdunlock(&signature_cache_lock);
+
+    if (key->is_set)
+    {
+        uv_mutex_lock(&signature_cache_stats_mutex);
+        signature_cache_stats.lookups++;
+        signature_cache_stats.hits += is_hit ? 1 : 0;
+        uv_mutex_unlock(&signature_cache_stats_mutex);
+    }
+
+    return is_hit;
+}
+
+void secp256k1_addon_signature_cache_insert(const secp256k1_addon_signature_cache_key_t *key)
+{
+    if (!key->is_set)
+    {
+        return;
+    }
+
+    uv_rwlock_wrlock(&signature_cache_lock);
+
+    // The cache may have been reconfigured since the lookup, in which case
+    // the key is salted differently and merely takes up a slot.
+    signature_cache_t *cache = signature_cache;
+    if (!cache)
+    {
+        uv_rwlock_wrunlock(&signature_cache_lock);
+        return;
+    }
+
+    uint64_t bucket = load_index(&key->digest[SIGNATURE_CACHE_FINGERPRINT_LENGTH]) & (cache->bucket_count - 1);
+    const uint64_t other_bucket = alternate_bucket(cache, bucket, key->digest);
+
+    if (bucket_contains(&cache->buckets[bucket], key->digest) || bucket_contains(&cache->buckets[other_bucket], key->digest))
+    {
+        uv_rwlock_wrunlock(&signature_cache_lock);
+        return;
+    }
+
+    bool is_evicted = false;
+    if (!bucket_insert(&cache->buckets[bucket], key->digest) && !bucket_insert(&cache->buckets[other_bucket], key->digest))
+    {
+        unsigned char fingerprint[SIGNATURE_CACHE_FINGERPRINT_LENGTH];
+        memcpy(fingerprint, key->digest, SIGNATURE_CACHE_FINGERPRINT_LENGTH);
+
+        bucket = cache->kick_cursor & 1 ? other_bucket : bucket;
+
+        is_evicted = true;
+        for (int kick = 0; kick < SIGNATURE_CACHE_MAX_KICKS && is_evicted; ++kick)
+        {
+            unsigned char *slot = cache->buckets[bucket].fingerprints[cache->kick_cursor++ % SIGNATURE_CACHE_SLOTS];
+
+            unsigned char displaced[SIGNATURE_CACHE_FINGERPRINT_LENGTH];
+            memcpy(displaced, slot, SIGNATURE_CACHE_FINGERPRINT_LENGTH);
+            memcpy(slot, fingerprint, SIGNATURE_CACHE_FINGERPRINT_LENGTH);
+            memcpy(fingerprint, displaced, SIGNATURE_CACHE_FINGERPRINT_LENGTH);
+
+            bucket = alternate_bucket(cache, bucket, fingerprint);
+            is_evicted = !bucket_insert(&cache->buckets[bucket], fingerprint);
+        }
+    }
+
+    if (!is_evicted)
+    {
+        cache->entry_count++;
+    }
+
+    uv_rwlock_wrunlock(&signature_cache_lock);
+
+    count(&signature_cache_stats.insertions);
+    if (is_evicted)
+    {
+        count(&signature_cache_stats.evictions);
+    }
+}
+
+static char *get_path(napi_env env, napi_value js_path)
+{
+    size_t path_length;
+    if (napi_ok != napi_get_value_string_utf8(env, js_path, NULL, 0, &path_length))
+    {
+        return NULL;
+    }
+
+    char *path = (char *)malloc(path_length + 1);
+    if (path)
+    {
+        napi_get_value_string_utf8(env, js_path, path, path_length + 1, NULL);
+    }
+
+    return path;
+}
+
+/*
+ * Whether a loaded file could have been written by another user. The file is
+ * not authenticated, and a forged entry would make an invalid signature pass,
+ * so it has to be as trusted as the code that loads it.
+ */
+static bool is_writable_by_others(FILE *file)
+{
+#ifdef _WIN32
+    (void) file;
+
+    return false;
+#else
+    struct stat file_stat;
+
+    return 0 != fstat(fileno(file), &file_stat)
+        || file_stat.st_uid != geteuid()
+        || 0 != (file_stat.st_mode & (S_IWGRP | S_IWOTH));
+#endif
+}
+
+/*
+ * Opens a file for writing that only the current user can read or write,
+ * whatever the umask, without following a symbolic link at its path.
+ */
+static FILE *open_private_file(const char *path)
+{
+#ifdef _WIN32
+    return fopen(path, "wb");
+#else
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_NOFOLLOW
+    flags |= O_NOFOLLOW;
+#endif
+
+    int fd = open(path, flags, S_IRUSR | S_IWUSR);
+    if (-1 == fd)
+    {
+        return NULL;
+    }
+
+    // A file left behind by an earlier crash keeps its mode through O_TRUNC.
+    FILE *file = 0 == fchmod(fd, S_IRUSR | S_IWUSR) ? fdopen(fd, "wb") : NULL;
+    if (!file)
+    {
+        close(fd);
+    }
+
+    return file;
+#endif
+}
+
+/*
+ * Fills the cache from a file written by save, if there is one. The salt is
+ * read along with the entries, as the fingerprints depend on it.
+ */
+static const char *load_signature_cache(signature_cache_t *cache, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        return NULL;
+    }
+
+    signature_cache_file_header_t header;
+    const char *error_message = NULL;
+    if (is_writable_by_others(file))
+    {
+        error_message = "The signature cache file may be written by other users.";
+    }
+    else if (1 != fread(&header, sizeof (signature_cache_file_header_t), 1, file)
+        || 0 != memcmp(header.magic, SIGNATURE_CACHE_MAGIC, SIGNATURE_CACHE_MAGIC_LENGTH)
+        || SIGNATURE_CACHE_VERSION != header.version
+        || SIGNATURE_CACHE_SLOTS != header.slot_count)
+    {
+        error_message = "The signature cache file is invalid.";
+    }
+    else if (cache->bucket_count != header.bucket_count)
+    {
+        error_message = "The signature cache file was saved with a different size.";
+    }
+    else if (cache->bucket_count != fread(cache->buckets, sizeof (signature_cache_bucket_t), cache->bucket_count, file))
+    {
+        error_message = "The signature cache file is truncated.";
+    }
+    else
+    {
+        memcpy(cache->salt, header.salt, SIGNATURE_CACHE_SALT_LENGTH);
+        cache->entry_count = header.entry_count;
+    }
+
+    fclose(file);
+
+    if (error_message)
+    {
+        memset(cache->buckets, 0, cache->bucket_count * sizeof (signature_cache_bucket_t));
+    }
+
+    return error_message;
+}
+
+napi_value secp256k1_addon_signature_cache_configure(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    double max_bytes;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_double(env, argv[0], &max_bytes),
+        env, "Invalid number was passed as size."
+    );
+
+    napi_valuetype path_type;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_typeof(env, argv[1], &path_type),
+        env, "Invalid string was passed as path."
+    );
+
+    uv_once(&signature_cache_once, init_signature_cache);
+
+    signature_cache_t *cache = NULL;
+    if (sizeof (signature_cache_bucket_t) <= max_bytes)
+    {
+        cache = (signature_cache_t *)calloc(1, sizeof (signature_cache_t));
+        if (!cache)
+        {
+            napi_throw_error(env, NULL, "Could not allocate the signature cache.");
+            return NULL;
+        }
+
+        // The largest power of two number of buckets that fits.
+        cache->bucket_count = 1;
+        while (cache->bucket_count * 2 * sizeof (signature_cache_bucket_t) <= max_bytes)
+        {
+            cache->bucket_count *= 2;
+        }
+
+        cache->buckets = (signature_cache_bucket_t *)calloc(cache->bucket_count, sizeof (signature_cache_bucket_t));
+        if (!cache->buckets || 0 != uv_random(NULL, NULL, cache->salt, SIGNATURE_CACHE_SALT_LENGTH, 0, NULL))
+        {
+            free_signature_cache(cache);
+            napi_throw_error(env, NULL, "Could not allocate the signature cache.");
+            return NULL;
+        }
+
+        if (napi_string == path_type)
+        {
+            char *path = get_path(env, argv[1]);
+            if (!path)
+            {
+                free_signature_cache(cache);
+                napi_throw_error(env, NULL, "Invalid string was passed as path.");
+                return NULL;
+            }
+
+            const char *error_message = load_signature_cache(cache, path);
+            free(path);
+
+            if (error_message)
+            {
+                free_signature_cache(cache);
+                napi_throw_error(env, NULL, error_message);
+                return NULL;
+            }
+        }
+    }
+
+    uv_rwlock_wrlock(&signature_cache_lock);
+
+    signature_cache_t *previous_cache = signature_cache;
+    signature_cache = cache;
+
+    uv_rwlock_wrunlock(&signature_cache_lock);
+
+    free_signature_cache(previous_cache);
+
+    uv_mutex_lock(&signature_cache_stats_mutex);
+    memset(&signature_cache_stats, 0, sizeof (signature_cache_stats_t));
+    uv_mutex_unlock(&signature_cache_stats_mutex);
+
+    return NULL;
+}
+
+napi_value secp256k1_addon_signature_cache_save(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+        env, "Could not read function arguments."
+    );
+
+    char *path = get_path(env, argv[0]);
+    if (!path)
+    {
+        napi_throw_error(env, NULL, "Invalid string was passed as path.");
+        return NULL;
+    }
+
+    // Written next to the target and renamed, so a crash never leaves a torn file behind.
+    char *temporary_path = (char *)malloc(strlen(path) + sizeof (".tmp"));
+    if (!temporary_path)
+    {
+        free(path);
+        napi_throw_error(env, NULL, "Could not allocate the path.");
+        return NULL;
+    }
+
+    strcpy(temporary_path, path);
+    strcat(temporary_path, ".tmp");
+
+    uv_once(&signature_cache_once, init_signature_cache);
+
+    uv_rwlock_rdlock(&signature_cache_lock);
+
+    const signature_cache_t *cache = signature_cache;
+    const char *error_message = NULL;
+    if (!cache)
+    {
+        error_message = "The signature cache is not enabled.";
+    }
+    else
+    {
+        signature_cache_file_header_t header;
+        memset(&header, 0, sizeof (signature_cache_file_header_t));
+        memcpy(header.magic, SIGNATURE_CACHE_MAGIC, SIGNATURE_CACHE_MAGIC_LENGTH);
+        header.version = SIGNATURE_CACHE_VERSION;
+        header.slot_count = SIGNATURE_CACHE_SLOTS;
+        header.bucket_count = cache->bucket_count;
+        header.entry_count = cache->entry_count;
+        memcpy(header.salt, cache->salt, SIGNATURE_CACHE_SALT_LENGTH);
+
+        FILE *file = open_private_file(temporary_path);
+        if (!file)
+        {
+            error_message = "Could not open the signature cache file.";
+        }
+        else
+        {
+            const bool is_written = 1 == fwrite(&header, sizeof (signature_cache_file_header_t), 1, file)
+                && cache->bucket_count == fwrite(cache->buckets, sizeof (signature_cache_bucket_t), cache->bucket_count, file);
+
+            if (0 != fclose(file) || !is_written)
+            {
+                error_message = "Could not write the signature cache file.";
+                remove(temporary_path);
+            }
+        }
+    }
+
+    uv_rwlock_rdunlock(&signature_cache_lock);
+
+#ifdef _WIN32
+    if (!error_message)
+    {
+        remove(path);
+    }
+#endif
+
+    if (!error_message && 0 != rename(temporary_path, path))
+    {
+        error_message = "Could not write the signature cache file.";
+        remove(temporary_path);
+    }
+
+    free(temporary_path);
+    free(path);
+
+    if (error_message)
+    {
+        napi_throw_error(env, NULL, error_message);
+    }
+
+    return NULL;
+}
+
+static napi_status set_number_property(napi_env env, napi_value object, const char *name, double value)
+{
+    napi_value js_value;
+    RETURN_ON_FAILURE(napi_create_double(env, value, &js_value));
+
+    return napi_set_named_property(env, object, name, js_value);
+}
+
+napi_value secp256k1_addon_signature_cache_stats(napi_env env, napi_callback_info info)
+{
+    uv_once(&signature_cache_once, init_signature_cache);
+
+    uv_rwlock_rdlock(&signature_cache_lock);
+
+    const bool is_enabled = NULL != signature_cache;
+    const double capacity = is_enabled ? (double) (signature_cache->bucket_count * SIGNATURE_CACHE_SLOTS) : 0;
+    const double size = is_enabled ? (double) signature_cache->entry_count : 0;
+
+    uv_rwlock_rdunlock(&signature_cache_lock);
+
+    uv_mutex_lock(&signature_cache_stats_mutex);
+    const signature_cache_stats_t stats = signature_cache_stats;
+    uv_mutex_unlock(&signature_cache_stats_mutex);
+
+    napi_value js_stats;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_object(env, &js_stats),
+        env, "Could not create the result object."
+    );
+
+    napi_value js_enabled;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_boolean(env, is_enabled, &js_enabled),
+        env, "Could not set the result."
+    );
+
+    if (napi_ok != napi_set_named_property(env, js_stats, "enabled", js_enabled)
+        || napi_ok != set_number_property(env, js_stats, "capacity", capacity)
+        || napi_ok != set_number_property(env, js_stats, "size", size)
+        || napi_ok != set_number_property(env, js_stats, "lookups", (double) stats.lookups)
+        || napi_ok != set_number_property(env, js_stats, "hits", (double) stats.hits)
+        || napi_ok != set_number_property(env, js_stats, "insertions", (double) stats.insertions)
+        || napi_ok != set_number_property(env, js_stats, "evictions", (double) stats.evictions))
+    {
+        napi_throw_error(env, NULL, "Could not set the result.");
+        return NULL;
+    }
+
+    return js_stats;
+}
+
+napi_value secp256k1_addon_signature_cache_clear(napi_env env, napi_callback_info info)
+{
+    uv_once(&signature_cache_once, init_signature_cache);
+
+    uv_rwlock_wrlock(&signature_cache_lock);
+
+    if (signature_cache)
+    {
+        memset(signature_cache->buckets, 0, signature_cache->bucket_count * sizeof (signature_cache_bucket_t));
+        signature_cache->entry_count = 0;
+    }
+
+    uv_rwlock_wrunlock(&signature_cache_lock);
+
+    uv_mutex_lock(&signature_cache_stats_mutex);
+    memset(&signature_cache_stats, 0, sizeof (signature_cache_stats_t));
+    uv_mutex_unlock(&signature_cache_stats_mutex);
+
+    return NULL;
+}
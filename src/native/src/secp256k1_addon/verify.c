@@ -5,15 +5,27 @@
 
 #include "secp256k1.h"
 
+#include "signun_batch.h"
+#include "signun_pool.h"
+#include "signun_scheduler.h"
 #include "signun_util.h"
+#include "secp256k1_addon/public_key_pin.h"
+#include "secp256k1_addon/signature.h"
+#include "secp256k1_addon/signature_cache.h"
 #include "secp256k1_addon/util.h"
 
 
+#define VERIFY_POOL_HIGH_WATER_MARK 256
+
+// Small enough for an abort or an interactive task to get through quickly.
+#define VERIFY_BATCH_CHUNK_SIZE 128
+
 typedef struct
 {
+    signun_task_t task;
+
     napi_deferred deferred;
     secp256k1_context *secp256k1context;
-    napi_async_work async_work;
 
     unsigned char message[MESSAGE_LENGTH];
     unsigned char raw_signature[SIGNATURE_LENGTH];
@@ -24,6 +36,34 @@ typedef struct
     bool result;
 } verify_callback_data_t;
 
+typedef struct
+{
+    signun_batch_t batch;
+    secp256k1_context *secp256k1context;
+
+    const unsigned char *messages;
+    const unsigned char *raw_signatures;
+    // Only set for DER signatures, compact ones are SIGNATURE_LENGTH apart.
+    size_t *der_signature_offsets;
+    bool normalize;
+    const unsigned char *raw_public_keys;
+    size_t raw_public_key_length;
+
+    unsigned char *results;
+} verify_batch_data_t;
+
+static const signun_pool_t verify_callback_data_pool = SIGNUN_POOL_INIT(SIGNUN_POOL_VERIFY, verify_callback_data_t, VERIFY_POOL_HIGH_WATER_MARK, false);
+
+/*
+ * Tells an unparsable public key from an invalid signature, only once the
+ * verification has failed, as pinned keys are verified without parsing.
+ */
+static bool is_public_key_valid(const secp256k1_context *ctx, const unsigned char *raw_public_key, size_t raw_public_key_length)
+{
+    secp256k1_pubkey public_key;
+    return 1 == secp256k1_ec_pubkey_parse(ctx, &public_key, raw_public_key, raw_public_key_length);
+}
+
 napi_value secp256k1_addon_verify_sync(napi_env env, napi_callback_info info)
 {
     size_t argc = 3;
@@ -37,38 +77,53 @@ napi_value secp256k1_addon_verify_sync(napi_env env, napi_callback_info info)
     size_t message_length;
     const unsigned char *message;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[0], (void **) &message, &message_length),
+        signun_get_bytes(env, argv[0], (void **) &message, &message_length),
         env, "Invalid buffer was passed as message."
     );
     
     size_t raw_signature_length;
     const unsigned char *raw_signature;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[1], (void **) &raw_signature, &raw_signature_length),
+        signun_get_bytes(env, argv[1], (void **) &raw_signature, &raw_signature_length),
         env, "Invalid buffer was passed as signature."
     );
 
     size_t raw_public_key_length;
     const unsigned char *raw_public_key;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[2], (void **) &raw_public_key, &raw_public_key_length),
+        signun_get_bytes(env, argv[2], (void **) &raw_public_key, &raw_public_key_length),
         env, "Invalid buffer was passed as a public key."
     );
 
+    napi_value js_result;
+    secp256k1_addon_signature_cache_key_t cache_key;
+    if (secp256k1_addon_signature_cache_lookup(&cache_key, message, raw_signature, SIGNATURE_LENGTH, raw_public_key, raw_public_key_length, 0))
+    {
+        THROW_AND_RETURN_NULL_ON_FAILURE(
+            napi_get_boolean(env, true, &js_result),
+            env, "Could not set the result."
+        );
+
+        return js_result;
+    }
+
     secp256k1_ecdsa_signature signature;
     if (0 == secp256k1_ecdsa_signature_parse_compact(callback_data->secp256k1context, &signature, raw_signature))
     {
         napi_throw_error(env, NULL, "Could not parse the signature.");
     }
 
-    secp256k1_pubkey public_key;
-    if (0 == secp256k1_ec_pubkey_parse(callback_data->secp256k1context, &public_key, raw_public_key, raw_public_key_length))
+    const bool verify_result = secp256k1_addon_ecdsa_verify_public_key(callback_data->secp256k1context, &signature, message,
+        raw_public_key, raw_public_key_length);
+    if (verify_result)
+    {
+        secp256k1_addon_signature_cache_insert(&cache_key);
+    }
+    else if (!is_public_key_valid(callback_data->secp256k1context, raw_public_key, raw_public_key_length))
     {
         napi_throw_error(env, NULL, "Could not parse the public key.");
     }
 
-    napi_value js_result;
-    const int verify_result = secp256k1_ecdsa_verify(callback_data->secp256k1context, &signature, message, &public_key);
     THROW_AND_RETURN_NULL_ON_FAILURE(
         napi_get_boolean(env, verify_result, &js_result),
         env, "Could not set the result."
@@ -81,34 +136,51 @@ static void verify_async_execute(napi_env env, void *data)
 {
     verify_callback_data_t *callback_data = (verify_callback_data_t *) data;
 
-    secp256k1_ecdsa_signature signature;
-    if (0 == secp256k1_ecdsa_signature_parse_compact(callback_data->secp256k1context, &signature, callback_data->raw_signature))
+    secp256k1_addon_signature_cache_key_t cache_key;
+    if (secp256k1_addon_signature_cache_lookup(&cache_key, callback_data->message, callback_data->raw_signature, SIGNATURE_LENGTH,
+        callback_data->raw_public_key, callback_data->raw_public_key_length, 0))
     {
-        callback_data->success = false;
+        callback_data->success = true;
+        callback_data->result = true;
         return;
     }
 
-    secp256k1_pubkey public_key;
-    if (0 == secp256k1_ec_pubkey_parse(callback_data->secp256k1context, &public_key, callback_data->raw_public_key, callback_data->raw_public_key_length))
+    secp256k1_ecdsa_signature signature;
+    if (0 == secp256k1_ecdsa_signature_parse_compact(callback_data->secp256k1context, &signature, callback_data->raw_signature))
     {
         callback_data->success = false;
         return;
     }
 
-    callback_data->success = true;
+    callback_data->result = secp256k1_addon_ecdsa_verify_public_key(callback_data->secp256k1context, &signature, callback_data->message,
+        callback_data->raw_public_key, callback_data->raw_public_key_length);
+    if (callback_data->result)
+    {
+        secp256k1_addon_signature_cache_insert(&cache_key);
+    }
 
-    callback_data->result = secp256k1_ecdsa_verify(callback_data->secp256k1context, &signature, callback_data->message, &public_key);
+    callback_data->success = callback_data->result
+        || is_public_key_valid(callback_data->secp256k1context, callback_data->raw_public_key, callback_data->raw_public_key_length);
 }
 
 static void verify_async_complete(napi_env env, napi_status status, void *data)
 {
     verify_callback_data_t *callback_data = (verify_callback_data_t *) data;
 
-    if (napi_ok != napi_delete_async_work(env, callback_data->async_work))
+    if (napi_ok != napi_delete_async_work(env, callback_data->task.async_work))
     {
         REJECT_WITH_ERROR(env, "Could not delete async work.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
+
+        return;
+    }
+
+    if (napi_cancelled == status)
+    {
+        REJECT_WITH_ABORT_ERROR(env, callback_data->deferred);
+
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
 
         return;
     }
@@ -117,7 +189,7 @@ static void verify_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "The execution was cancelled.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
 
         return;
     }
@@ -126,7 +198,7 @@ static void verify_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "Could not verify the signature.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
 
         return;
     }
@@ -136,20 +208,20 @@ static void verify_async_complete(napi_env env, napi_status status, void *data)
     {
         REJECT_WITH_ERROR(env, "Could not get a boolean.", callback_data->deferred);
 
-        free(callback_data);
+        signun_pool_release(env, &verify_callback_data_pool, callback_data);
 
         return;
     }
 
     napi_resolve_deferred(env, callback_data->deferred, js_result);
 
-    free(callback_data);
+    signun_pool_release(env, &verify_callback_data_pool, callback_data);
 }
 
 napi_value secp256k1_addon_verify_async(napi_env env, napi_callback_info info)
 {
-    size_t argc = 3;
-    napi_value argv[3];
+    size_t argc = 5;
+    napi_value argv[5];
     secp256k1_addon_callback_data_t *current_callback_data;
     THROW_AND_RETURN_NULL_ON_FAILURE(
         napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
@@ -159,24 +231,36 @@ napi_value secp256k1_addon_verify_async(napi_env env, napi_callback_info info)
     size_t message_length;
     const unsigned char *message;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[0], (void **) &message, &message_length),
+        signun_get_bytes(env, argv[0], (void **) &message, &message_length),
         env, "Invalid buffer was passed as message."
     );
     
     size_t raw_signature_length;
     const unsigned char *raw_signature;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[1], (void **) &raw_signature, &raw_signature_length),
+        signun_get_bytes(env, argv[1], (void **) &raw_signature, &raw_signature_length),
         env, "Invalid buffer was passed as signature."
     );
 
     size_t raw_public_key_length;
     const unsigned char *raw_public_key;
     THROW_AND_RETURN_NULL_ON_FAILURE(
-        napi_get_buffer_info(env, argv[2], (void **) &raw_public_key, &raw_public_key_length),
+        signun_get_bytes(env, argv[2], (void **) &raw_public_key, &raw_public_key_length),
         env, "Invalid buffer was passed as a public key."
     );
 
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[3], SIGNUN_PRIORITY_INTERACTIVE, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[4], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
     napi_value null_value;
     THROW_AND_RETURN_NULL_ON_FAILURE(
         napi_get_null(env, &null_value),
@@ -190,7 +274,12 @@ napi_value secp256k1_addon_verify_async(napi_env env, napi_callback_info info)
         env, "Could not create resource name."
     );
 
-    verify_callback_data_t *verify_callback_data = (verify_callback_data_t *)malloc(sizeof (verify_callback_data_t));
+    verify_callback_data_t *verify_callback_data = signun_pool_acquire(env, &verify_callback_data_pool);
+    if (!verify_callback_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the callback data.");
+        return NULL;
+    }
     
     verify_callback_data->secp256k1context = current_callback_data->secp256k1context;
 
@@ -202,29 +291,261 @@ napi_value secp256k1_addon_verify_async(napi_env env, napi_callback_info info)
     napi_value promise;
     if (napi_ok != napi_create_promise(env, &verify_callback_data->deferred, &promise))
     {
-        free(verify_callback_data);
+        signun_pool_release(env, &verify_callback_data_pool, verify_callback_data);
         napi_throw_error(env, NULL, "Could not create result promise.");
         return NULL;
     }
 
-    napi_async_work verify_async_work;
-    if (napi_ok != napi_create_async_work(env, NULL, verify_resource_name, verify_async_execute, verify_async_complete, verify_callback_data, &verify_async_work))
+    if (napi_ok != signun_task_create(env, &verify_callback_data->task, SIGNUN_OP_VERIFY, priority, cancel_token, verify_resource_name, verify_async_execute, verify_async_complete))
     {
         REJECT_WITH_ERROR(env, "Could not create async work.", verify_callback_data->deferred);
-        free(verify_callback_data);
+        signun_pool_release(env, &verify_callback_data_pool, verify_callback_data);
         return promise;
     }
 
-    verify_callback_data->async_work = verify_async_work;
+    napi_async_work verify_async_work = verify_callback_data->task.async_work;
+
+    napi_status queue_status = signun_task_queue(env, &verify_callback_data->task);
+    if (napi_queue_full == queue_status)
+    {
+        REJECT_WITH_ERROR(env, "Too many operations are in flight.", verify_callback_data->deferred);
+        signun_pool_release(env, &verify_callback_data_pool, verify_callback_data);
+        napi_delete_async_work(env, verify_async_work);
+        return promise;
+    }
 
-    napi_status queue_status = napi_queue_async_work(env, verify_async_work);
     if (napi_ok != queue_status)
     {
         REJECT_WITH_ERROR(env, "Could not queue async work.", verify_callback_data->deferred);
-        free(verify_callback_data);
+        signun_pool_release(env, &verify_callback_data_pool, verify_callback_data);
         napi_delete_async_work(env, verify_async_work);
         return promise;
     }
     
     return promise;
 }
+
+static bool verify_batch_item(verify_batch_data_t *batch_data, size_t i)
+{
+    const unsigned char *message = &batch_data->messages[i * MESSAGE_LENGTH];
+    const unsigned char *raw_public_key = &batch_data->raw_public_keys[i * batch_data->raw_public_key_length];
+
+    size_t offset = i * SIGNATURE_LENGTH;
+    size_t length = SIGNATURE_LENGTH;
+    if (batch_data->der_signature_offsets)
+    {
+        offset = batch_data->der_signature_offsets[i];
+        length = batch_data->der_signature_offsets[i + 1] - offset;
+    }
+
+    const unsigned char flags = (batch_data->der_signature_offsets ? SIGNATURE_CACHE_FLAG_DER : 0)
+        | (batch_data->normalize ? SIGNATURE_CACHE_FLAG_NORMALIZE : 0);
+
+    secp256k1_addon_signature_cache_key_t cache_key;
+    if (secp256k1_addon_signature_cache_lookup(&cache_key, message, &batch_data->raw_signatures[offset], length,
+        raw_public_key, batch_data->raw_public_key_length, flags))
+    {
+        return true;
+    }
+
+    secp256k1_ecdsa_signature signature;
+    if (batch_data->der_signature_offsets)
+    {
+        if (0 == secp256k1_ecdsa_signature_parse_der(batch_data->secp256k1context, &signature, &batch_data->raw_signatures[offset], length))
+        {
+            return false;
+        }
+    }
+    else if (0 == secp256k1_ecdsa_signature_parse_compact(batch_data->secp256k1context, &signature, &batch_data->raw_signatures[offset]))
+    {
+        return false;
+    }
+
+    if (batch_data->normalize)
+    {
+        secp256k1_ecdsa_signature_normalize(batch_data->secp256k1context, &signature, &signature);
+    }
+
+    if (!secp256k1_addon_ecdsa_verify_public_key(batch_data->secp256k1context, &signature, message, raw_public_key, batch_data->raw_public_key_length))
+    {
+        return false;
+    }
+
+    secp256k1_addon_signature_cache_insert(&cache_key);
+
+    return true;
+}
+
+static void verify_batch_execute(signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    verify_batch_data_t *batch_data = (verify_batch_data_t *) batch;
+
+    for (size_t i = chunk->start; i < chunk->end; ++i)
+    {
+        batch_data->results[i] = verify_batch_item(batch_data, i) ? 1 : 0;
+    }
+}
+
+static napi_status verify_batch_complete(napi_env env, signun_batch_t *batch, napi_value *result)
+{
+    return signun_batch_get_retained_value(env, batch, 3, result);
+}
+
+static void verify_batch_finalize(napi_env env, signun_batch_t *batch)
+{
+    verify_batch_data_t *batch_data = (verify_batch_data_t *) batch;
+
+    free(batch_data->der_signature_offsets);
+    free(batch_data);
+}
+
+napi_value secp256k1_addon_verify_batch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 8;
+    napi_value argv[8];
+    secp256k1_addon_callback_data_t *current_callback_data;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &current_callback_data),
+        env, "Could not read function arguments."
+    );
+
+    size_t messages_length;
+    const unsigned char *messages;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[0], (void **) &messages, &messages_length),
+        env, "Invalid buffer was passed as messages."
+    );
+
+    size_t raw_signatures_length;
+    const unsigned char *raw_signatures;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[1], (void **) &raw_signatures, &raw_signatures_length),
+        env, "Invalid buffer was passed as signatures."
+    );
+
+    size_t raw_public_keys_length;
+    const unsigned char *raw_public_keys;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_bytes(env, argv[2], (void **) &raw_public_keys, &raw_public_keys_length),
+        env, "Invalid buffer was passed as public keys."
+    );
+
+    bool is_der;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[3], &is_der),
+        env, "Invalid bool was passed as DER flag."
+    );
+
+    bool normalize;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_bool(env, argv[4], &normalize),
+        env, "Invalid bool was passed as normalize flag."
+    );
+
+    signun_priority_t priority;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_priority(env, argv[5], SIGNUN_PRIORITY_BULK, &priority),
+        env, "Invalid priority was passed."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[6], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (0 != messages_length % MESSAGE_LENGTH)
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as messages.");
+        return NULL;
+    }
+
+    const size_t count = messages_length / MESSAGE_LENGTH;
+    const size_t raw_public_key_length = 0 == count ? 0 : raw_public_keys_length / count;
+
+    if (0 != count && (raw_public_keys_length != count * raw_public_key_length
+        || (33 != raw_public_key_length && SERIALIZED_PUBLIC_KEY_LENGTH != raw_public_key_length)))
+    {
+        napi_throw_error(env, NULL, "Invalid buffer was passed as public keys.");
+        return NULL;
+    }
+
+    const char *resource_identifier = "secp256k1::batch::verify";
+    napi_value verify_resource_name;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_string_utf8(env, resource_identifier, NAPI_AUTO_LENGTH, &verify_resource_name),
+        env, "Could not create resource name."
+    );
+
+    verify_batch_data_t *batch_data = (verify_batch_data_t *)calloc(1, sizeof (verify_batch_data_t));
+    if (!batch_data)
+    {
+        napi_throw_error(env, NULL, "Could not allocate the batch data.");
+        return NULL;
+    }
+
+    batch_data->secp256k1context = current_callback_data->secp256k1context;
+    batch_data->messages = messages;
+    batch_data->raw_signatures = raw_signatures;
+    batch_data->normalize = normalize;
+    batch_data->raw_public_keys = raw_public_keys;
+    batch_data->raw_public_key_length = raw_public_key_length;
+
+    if (is_der)
+    {
+        size_t der_signature_count;
+        batch_data->der_signature_offsets = (size_t *)malloc((count + 1) * sizeof (size_t));
+
+        // The offsets only have room for count signatures, so they are filled
+        // in once the count is known to match.
+        if (!batch_data->der_signature_offsets
+            || !secp256k1_addon_scan_der_signatures(raw_signatures, raw_signatures_length, NULL, &der_signature_count)
+            || der_signature_count != count)
+        {
+            verify_batch_finalize(env, &batch_data->batch);
+            napi_throw_error(env, NULL, "Invalid buffer was passed as signatures.");
+            return NULL;
+        }
+
+        secp256k1_addon_scan_der_signatures(raw_signatures, raw_signatures_length, batch_data->der_signature_offsets, &der_signature_count);
+    }
+    else if (raw_signatures_length != count * SIGNATURE_LENGTH)
+    {
+        verify_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Invalid buffer was passed as signatures.");
+        return NULL;
+    }
+
+    napi_value js_results;
+    if (napi_ok != napi_create_buffer(env, count, (void **) &batch_data->results, &js_results))
+    {
+        verify_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create the result buffer.");
+        return NULL;
+    }
+
+    napi_value promise;
+    if (napi_ok != signun_batch_init(env, &batch_data->batch, count, VERIFY_BATCH_CHUNK_SIZE,
+        verify_batch_execute, verify_batch_complete, verify_batch_finalize, &promise))
+    {
+        verify_batch_finalize(env, &batch_data->batch);
+        napi_throw_error(env, NULL, "Could not create result promise.");
+        return NULL;
+    }
+
+    if (napi_ok != signun_batch_retain(env, &batch_data->batch, argv[0])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[1])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, argv[2])
+        || napi_ok != signun_batch_retain(env, &batch_data->batch, js_results)
+        || napi_ok != signun_batch_set_listener(env, &batch_data->batch, argv[7], batch_data->results, 1))
+    {
+        REJECT_WITH_ERROR(env, "Could not retain the batch buffers.", batch_data->batch.deferred);
+        signun_batch_discard(env, &batch_data->batch);
+        verify_batch_finalize(env, &batch_data->batch);
+        return promise;
+    }
+
+    signun_batch_queue(env, &batch_data->batch, SIGNUN_OP_VERIFY_BATCH, priority, cancel_token, verify_resource_name);
+
+    return promise;
+}
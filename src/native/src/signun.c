@@ -1,6 +1,10 @@
+#include "argon2_addon/argon2_addon.h"
 #include "blake2_addon/blake2_addon.h"
+#include "ed25519_addon/ed25519_addon.h"
 #include "secp256k1_addon/secp256k1_addon.h"
 #include "signun.h"
+#include "signun_instance.h"
+#include "signun_scheduler.h"
 
 #include "signun_util.h"
 
@@ -16,6 +20,16 @@ napi_value create_signun_addon(napi_env env)
         env, INITIALIZATION_ERROR_MESSAGE
     );
 
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_instance_create(env),
+        env, INITIALIZATION_ERROR_MESSAGE
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        create_argon2_addon(env, addon),
+        env, INITIALIZATION_ERROR_MESSAGE
+    );
+
     THROW_AND_RETURN_NULL_ON_FAILURE(
         create_blake2_addon(env, addon),
         env, INITIALIZATION_ERROR_MESSAGE
@@ -26,5 +40,15 @@ napi_value create_signun_addon(napi_env env)
         env, INITIALIZATION_ERROR_MESSAGE
     );
 
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        create_ed25519_addon(env, addon),
+        env, INITIALIZATION_ERROR_MESSAGE
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        create_scheduler_addon(env, addon),
+        env, INITIALIZATION_ERROR_MESSAGE
+    );
+
     return addon;
 }
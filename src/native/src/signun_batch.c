@@ -0,0 +1,391 @@
+#include "signun_batch.h"
+
+#include <stdlib.h>
+
+#include "signun_util.h"
+
+
+static void release_retained_values(napi_env env, signun_batch_t *batch)
+{
+    for (size_t i = 0; i < batch->retained_value_count; ++i)
+    {
+        napi_delete_reference(env, batch->retained_values[i]);
+    }
+
+    batch->retained_value_count = 0;
+
+    if (batch->listener)
+    {
+        napi_delete_reference(env, batch->listener);
+        batch->listener = NULL;
+    }
+}
+
+static bool is_failed(signun_batch_t *batch)
+{
+    uv_mutex_lock(&batch->mutex);
+    const bool failed = batch->failed;
+    uv_mutex_unlock(&batch->mutex);
+
+    return failed;
+}
+
+static void set_failed(signun_batch_t *batch)
+{
+    uv_mutex_lock(&batch->mutex);
+    batch->failed = true;
+    uv_mutex_unlock(&batch->mutex);
+}
+
+static void fail_batch(signun_batch_t *batch, const char *message)
+{
+    set_failed(batch);
+
+    if (!batch->error_message)
+    {
+        batch->error_message = message;
+    }
+}
+
+static void deliver_chunk(napi_env env, signun_batch_t *batch, signun_batch_chunk_t *chunk)
+{
+    napi_value listener;
+    napi_value undefined;
+    napi_value argv[3];
+    if (napi_ok != napi_get_reference_value(env, batch->listener, &listener)
+        || napi_ok != napi_get_undefined(env, &undefined)
+        || napi_ok != napi_create_double(env, (double) chunk->start, &argv[0])
+        || napi_ok != napi_create_double(env, (double) chunk->end, &argv[1])
+        || napi_ok != napi_create_buffer_copy(env, (chunk->end - chunk->start) * batch->result_length,
+            &batch->results[chunk->start * batch->result_length], NULL, &argv[2]))
+    {
+        fail_batch(batch, "Could not deliver the chunk results.");
+        return;
+    }
+
+    if (napi_ok != napi_call_function(env, undefined, listener, 3, argv, NULL))
+    {
+        // Leaving the exception pending would make it an uncaught one.
+        napi_value exception;
+        napi_get_and_clear_last_exception(env, &exception);
+
+        fail_batch(batch, "The chunk listener threw.");
+    }
+}
+
+static void settle_batch(napi_env env, signun_batch_t *batch)
+{
+    if (batch->is_aborted)
+    {
+        REJECT_WITH_ABORT_ERROR(env, batch->deferred);
+    }
+    else if (batch->error_message)
+    {
+        REJECT_WITH_ERROR(env, batch->error_message, batch->deferred);
+    }
+    else
+    {
+        napi_value js_result;
+        if (napi_ok != batch->complete(env, batch, &js_result))
+        {
+            REJECT_WITH_ERROR(env, "Could not create the batch result.", batch->deferred);
+        }
+        else
+        {
+            napi_resolve_deferred(env, batch->deferred, js_result);
+        }
+    }
+
+    release_retained_values(env, batch);
+
+    free(batch->chunks);
+    batch->chunks = NULL;
+
+    uv_mutex_destroy(&batch->mutex);
+
+    batch->finalize(env, batch);
+}
+
+static bool split_chunks(signun_batch_t *batch, size_t item_count)
+{
+    free(batch->chunks);
+
+    batch->item_count = item_count;
+    batch->chunk_count = (item_count + batch->chunk_size - 1) / batch->chunk_size;
+    batch->chunks = NULL;
+
+    if (0 < batch->chunk_count)
+    {
+        batch->chunks = (signun_batch_chunk_t *)calloc(batch->chunk_count, sizeof (signun_batch_chunk_t));
+        if (!batch->chunks)
+        {
+            batch->chunk_count = 0;
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < batch->chunk_count; ++i)
+    {
+        signun_batch_chunk_t *chunk = &batch->chunks[i];
+
+        chunk->batch = batch;
+        chunk->start = i * batch->chunk_size;
+        chunk->end = chunk->start + batch->chunk_size < item_count ? chunk->start + batch->chunk_size : item_count;
+        chunk->error_message = NULL;
+    }
+
+    return true;
+}
+
+static void queue_chunks(napi_env env, signun_batch_t *batch, napi_value resource_name);
+
+/*
+ * Queues the next phase, if there is one. Called once every chunk of the
+ * current phase has completed, from the completion of the last one, so the
+ * cancel token is still held by that chunk.
+ */
+static bool advance_batch(napi_env env, signun_batch_t *batch)
+{
+    if (!batch->advance || is_failed(batch))
+    {
+        return false;
+    }
+
+    const size_t item_count = batch->advance(batch);
+    if (0 == item_count)
+    {
+        return false;
+    }
+
+    napi_value resource_name;
+    if (!split_chunks(batch, item_count)
+        || napi_ok != napi_create_string_utf8(env, batch->resource_identifier, NAPI_AUTO_LENGTH, &resource_name))
+    {
+        fail_batch(batch, "Could not queue the next phase.");
+        return false;
+    }
+
+    queue_chunks(env, batch, resource_name);
+
+    return true;
+}
+
+static void batch_chunk_execute(napi_env env, void *data)
+{
+    signun_batch_chunk_t *chunk = (signun_batch_chunk_t *) data;
+    signun_batch_t *batch = chunk->batch;
+
+    if (is_failed(batch))
+    {
+        return;
+    }
+
+    batch->execute(batch, chunk);
+}
+
+static void batch_chunk_complete(napi_env env, napi_status status, void *data)
+{
+    signun_batch_chunk_t *chunk = (signun_batch_chunk_t *) data;
+    signun_batch_t *batch = chunk->batch;
+
+    if (napi_ok != napi_delete_async_work(env, chunk->task.async_work))
+    {
+        fail_batch(batch, "Could not delete async work.");
+    }
+
+    if (napi_cancelled == status)
+    {
+        batch->is_aborted = true;
+        // No point in running the rest of an aborted batch.
+        set_failed(batch);
+    }
+    else if (napi_ok != status)
+    {
+        fail_batch(batch, "The execution was cancelled.");
+    }
+    else if (chunk->error_message)
+    {
+        fail_batch(batch, chunk->error_message);
+    }
+    else if (batch->listener && !is_failed(batch))
+    {
+        deliver_chunk(env, batch, chunk);
+    }
+
+    if (0 == --batch->pending_chunk_count && !advance_batch(env, batch))
+    {
+        settle_batch(env, batch);
+    }
+}
+
+napi_status signun_batch_init(napi_env env, signun_batch_t *batch, size_t item_count, size_t chunk_size,
+    signun_batch_execute_callback execute, signun_batch_complete_callback complete, signun_batch_finalize_callback finalize,
+    napi_value *promise)
+{
+    batch->chunk_size = chunk_size;
+    batch->pending_chunk_count = 0;
+    batch->chunks = NULL;
+    batch->failed = false;
+    batch->is_aborted = false;
+    batch->error_message = NULL;
+    batch->retained_value_count = 0;
+    batch->listener = NULL;
+    batch->results = NULL;
+    batch->result_length = 0;
+    batch->execute = execute;
+    batch->complete = complete;
+    batch->finalize = finalize;
+    batch->advance = NULL;
+    batch->resource_identifier = NULL;
+    batch->cancel_token = NULL;
+
+    if (0 != uv_mutex_init(&batch->mutex))
+    {
+        return napi_generic_failure;
+    }
+
+    if (!split_chunks(batch, item_count))
+    {
+        uv_mutex_destroy(&batch->mutex);
+        return napi_generic_failure;
+    }
+
+    napi_status status = napi_create_promise(env, &batch->deferred, promise);
+    if (napi_ok != status)
+    {
+        free(batch->chunks);
+        batch->chunks = NULL;
+
+        uv_mutex_destroy(&batch->mutex);
+    }
+
+    return status;
+}
+
+void signun_batch_set_advance(signun_batch_t *batch, signun_batch_advance_callback advance, const char *resource_identifier)
+{
+    batch->advance = advance;
+    batch->resource_identifier = resource_identifier;
+}
+
+napi_status signun_batch_set_listener(napi_env env, signun_batch_t *batch, napi_value listener,
+    const unsigned char *results, size_t result_length)
+{
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, listener, &type));
+
+    if (napi_undefined == type || napi_null == type)
+    {
+        return napi_ok;
+    }
+
+    if (napi_function != type || batch->advance)
+    {
+        return napi_invalid_arg;
+    }
+
+    RETURN_ON_FAILURE(napi_create_reference(env, listener, 1, &batch->listener));
+
+    batch->results = results;
+    batch->result_length = result_length;
+
+    return napi_ok;
+}
+
+napi_status signun_batch_retain(napi_env env, signun_batch_t *batch, napi_value value)
+{
+    if (batch->retained_value_count >= SIGNUN_BATCH_MAX_RETAINED_VALUES)
+    {
+        return napi_generic_failure;
+    }
+
+    RETURN_ON_FAILURE(napi_create_reference(env, value, 1, &batch->retained_values[batch->retained_value_count]));
+
+    batch->retained_value_count++;
+
+    return napi_ok;
+}
+
+napi_status signun_batch_get_retained_value(napi_env env, signun_batch_t *batch, size_t index, napi_value *value)
+{
+    if (index >= batch->retained_value_count)
+    {
+        return napi_generic_failure;
+    }
+
+    return napi_get_reference_value(env, batch->retained_values[index], value);
+}
+
+static void queue_chunks(napi_env env, signun_batch_t *batch, napi_value resource_name)
+{
+    // Keeps the batch from settling while chunks are still being queued.
+    batch->pending_chunk_count = 1;
+
+    for (size_t i = 0; i < batch->chunk_count; ++i)
+    {
+        signun_batch_chunk_t *chunk = &batch->chunks[i];
+
+        if (napi_ok != signun_task_create(env, &chunk->task, batch->op_class, batch->priority, batch->cancel_token, resource_name, batch_chunk_execute, batch_chunk_complete))
+        {
+            fail_batch(batch, "Could not create async work.");
+            break;
+        }
+
+        batch->pending_chunk_count++;
+
+        // Admitted as a whole by signun_batch_queue, so chunks over the
+        // limit wait in the native queue instead of failing the batch.
+        if (napi_ok != signun_task_queue_admitted(env, &chunk->task))
+        {
+            batch->pending_chunk_count--;
+            napi_delete_async_work(env, chunk->task.async_work);
+
+            fail_batch(batch, "Could not queue async work.");
+            break;
+        }
+    }
+
+    if (0 == --batch->pending_chunk_count && !advance_batch(env, batch))
+    {
+        settle_batch(env, batch);
+    }
+}
+
+void signun_batch_queue(napi_env env, signun_batch_t *batch, signun_op_class_t op_class, signun_priority_t priority,
+    signun_cancel_token_t *cancel_token, napi_value resource_name)
+{
+    batch->op_class = op_class;
+    batch->priority = priority;
+    batch->cancel_token = cancel_token;
+
+    // Admitted once, before any chunk is queued, so that a rejected batch
+    // costs no work and an admitted one is never rejected halfway through.
+    napi_status admit_status = signun_op_class_admit(env, op_class);
+    if (napi_ok != admit_status)
+    {
+        fail_batch(batch, napi_queue_full == admit_status
+            ? "Too many operations are in flight."
+            : "Could not queue async work.");
+        settle_batch(env, batch);
+        return;
+    }
+
+    queue_chunks(env, batch, resource_name);
+}
+
+void signun_batch_discard(napi_env env, signun_batch_t *batch)
+{
+    release_retained_values(env, batch);
+
+    free(batch->chunks);
+    batch->chunks = NULL;
+
+    uv_mutex_destroy(&batch->mutex);
+}
+
+void signun_batch_chunk_fail(signun_batch_t *batch, signun_batch_chunk_t *chunk, const char *message)
+{
+    chunk->error_message = message;
+
+    set_failed(batch);
+}
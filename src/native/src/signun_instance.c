@@ -0,0 +1,45 @@
+#include "signun_instance.h"
+
+#include <stdlib.h>
+
+#include "signun_util.h"
+
+
+static void instance_finalize(napi_env env, void *data, void *hint)
+{
+    signun_instance_t *instance = (signun_instance_t *) data;
+
+    signun_scheduler_destroy(instance->scheduler);
+
+    for (size_t i = 0; i < SIGNUN_POOL_COUNT; ++i)
+    {
+        signun_pool_free_list_clear(&instance->pools[i]);
+    }
+
+    free(instance);
+}
+
+napi_status signun_instance_create(napi_env env)
+{
+    signun_instance_t *instance = (signun_instance_t *)calloc(1, sizeof (signun_instance_t));
+    if (!instance)
+    {
+        return napi_generic_failure;
+    }
+
+    napi_status status = napi_set_instance_data(env, instance, instance_finalize, NULL);
+    if (napi_ok != status)
+    {
+        free(instance);
+    }
+
+    return status;
+}
+
+signun_instance_t *signun_get_instance(napi_env env)
+{
+    void *instance;
+    RETURN_VALUE_ON_FAILURE(napi_get_instance_data(env, &instance), NULL);
+
+    return (signun_instance_t *) instance;
+}
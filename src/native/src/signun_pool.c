@@ -0,0 +1,70 @@
+#include "signun_pool.h"
+
+#include <stdlib.h>
+
+#include "signun_instance.h"
+#include "signun_util.h"
+
+
+void *signun_pool_acquire(napi_env env, const signun_pool_t *pool)
+{
+    signun_instance_t *instance = signun_get_instance(env);
+    signun_pool_free_list_t *free_list = instance ? &instance->pools[pool->id] : NULL;
+    signun_pool_node_t *node = free_list ? free_list->free_list : NULL;
+
+    if (!node)
+    {
+        // Items double as freelist nodes while they are not in use.
+        size_t size = pool->item_size < sizeof (signun_pool_node_t) ? sizeof (signun_pool_node_t) : pool->item_size;
+
+        return malloc(size);
+    }
+
+    free_list->free_list = node->next;
+    free_list->free_count--;
+
+    return node;
+}
+
+void signun_pool_release(napi_env env, const signun_pool_t *pool, void *item)
+{
+    if (!item)
+    {
+        return;
+    }
+
+    if (pool->is_secret)
+    {
+        signun_secure_zero(item, pool->item_size);
+    }
+
+    signun_instance_t *instance = signun_get_instance(env);
+    signun_pool_free_list_t *free_list = instance ? &instance->pools[pool->id] : NULL;
+
+    if (!free_list || free_list->free_count >= pool->high_water_mark)
+    {
+        free(item);
+        return;
+    }
+
+    signun_pool_node_t *node = (signun_pool_node_t *) item;
+    node->next = free_list->free_list;
+
+    free_list->free_list = node;
+    free_list->free_count++;
+}
+
+void signun_pool_free_list_clear(signun_pool_free_list_t *free_list)
+{
+    signun_pool_node_t *node = free_list->free_list;
+
+    while (node)
+    {
+        signun_pool_node_t *next = node->next;
+        free(node);
+        node = next;
+    }
+
+    free_list->free_list = NULL;
+    free_list->free_count = 0;
+}
@@ -0,0 +1,993 @@
+#include "signun_scheduler.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "signun_instance.h"
+#include "signun_util.h"
+
+
+#define OP_CLASS_NAME_MAX_LENGTH 32
+#define POLICY_NAME_MAX_LENGTH 16
+#define PRIORITY_NAME_MAX_LENGTH 16
+
+#define DEFAULT_CONCURRENCY 4
+#define MAX_CONCURRENCY 1024
+#define DEFAULT_INTERACTIVE_WEIGHT 4
+
+typedef struct pressure_waiter_s
+{
+    napi_deferred deferred;
+    struct pressure_waiter_s *next;
+} pressure_waiter_t;
+
+typedef struct
+{
+    signun_task_t *head;
+    signun_task_t *tail;
+} task_queue_t;
+
+typedef struct
+{
+    // Maximum number of tasks handed to the libuv pool at once, 0 meaning no limit.
+    unsigned int limit;
+    signun_admission_policy_t policy;
+
+    unsigned int in_flight;
+    unsigned int queued;
+    task_queue_t lanes[SIGNUN_PRIORITY_COUNT];
+
+    pressure_waiter_t *waiters;
+} op_class_state_t;
+
+typedef struct
+{
+    // Maximum number of tasks handed to the libuv pool at once, across all op classes.
+    unsigned int concurrency;
+    unsigned int running;
+
+    signun_lane_scheduling_t scheduling;
+    unsigned int interactive_weight;
+    unsigned int interactive_streak;
+
+    unsigned int queued[SIGNUN_PRIORITY_COUNT];
+    // Op classes are served round-robin within a lane.
+    size_t next_op_class[SIGNUN_PRIORITY_COUNT];
+
+    // Tasks handed to libuv, kept so that they can be cancelled.
+    signun_task_t *running_tasks;
+} lane_state_t;
+
+/*
+ * One scheduler per environment, as the main thread and every worker_threads
+ * Worker each queue work through their own napi_env and loop.
+ */
+struct signun_scheduler_s
+{
+    op_class_state_t op_classes[SIGNUN_OP_CLASS_COUNT];
+    lane_state_t lanes;
+};
+
+static const char *op_class_names[] = {
+    [SIGNUN_OP_PRIVATE_KEY_VERIFY] = "privateKeyVerify",
+    [SIGNUN_OP_PUBLIC_KEY_CREATE] = "publicKeyCreate",
+    [SIGNUN_OP_SIGN] = "sign",
+    [SIGNUN_OP_VERIFY] = "verify",
+    [SIGNUN_OP_HASH] = "hash",
+    [SIGNUN_OP_KEYED_HASH] = "keyedHash",
+    [SIGNUN_OP_SIGNATURE_BATCH] = "signatureBatch",
+    [SIGNUN_OP_VERIFY_BATCH] = "verifyBatch",
+    [SIGNUN_OP_PUBLIC_KEY_BATCH] = "publicKeyBatch",
+    [SIGNUN_OP_DERIVE] = "derive",
+    [SIGNUN_OP_DERIVE_BATCH] = "deriveBatch",
+    [SIGNUN_OP_ECDH] = "ecdh",
+    [SIGNUN_OP_ECDH_BATCH] = "ecdhBatch",
+    [SIGNUN_OP_SIGN_BATCH] = "signBatch",
+    [SIGNUN_OP_KEY_PAIR] = "keyPair",
+    [SIGNUN_OP_MAC_BATCH] = "macBatch",
+    [SIGNUN_OP_MERKLE] = "merkle",
+    [SIGNUN_OP_PASSWORD_HASH] = "passwordHash",
+    [SIGNUN_OP_WORK] = "work"
+};
+
+static const char *policy_names[] = {
+    [SIGNUN_POLICY_QUEUE] = "queue",
+    [SIGNUN_POLICY_REJECT] = "reject"
+};
+
+static const char *priority_names[] = {
+    [SIGNUN_PRIORITY_INTERACTIVE] = "interactive",
+    [SIGNUN_PRIORITY_BULK] = "bulk"
+};
+
+static const char *scheduling_names[] = {
+    [SIGNUN_LANE_SCHEDULING_STRICT] = "strict",
+    [SIGNUN_LANE_SCHEDULING_WEIGHTED] = "weighted"
+};
+
+static bool has_capacity(const op_class_state_t *state)
+{
+    return 0 == state->limit || state->in_flight < state->limit;
+}
+
+static bool is_under_pressure(const op_class_state_t *state)
+{
+    return 0 != state->limit && state->in_flight + state->queued >= state->limit;
+}
+
+static void task_queue_push(task_queue_t *queue, signun_task_t *task)
+{
+    task->next = NULL;
+
+    if (queue->tail)
+    {
+        queue->tail->next = task;
+    }
+    else
+    {
+        queue->head = task;
+    }
+    queue->tail = task;
+}
+
+static signun_task_t *task_queue_pop(task_queue_t *queue)
+{
+    signun_task_t *task = queue->head;
+
+    queue->head = task->next;
+    if (!queue->head)
+    {
+        queue->tail = NULL;
+    }
+
+    task->next = NULL;
+
+    return task;
+}
+
+static signun_task_t *take_from_lane(signun_scheduler_t *scheduler, signun_priority_t priority)
+{
+    if (0 == scheduler->lanes.queued[priority])
+    {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < SIGNUN_OP_CLASS_COUNT; ++i)
+    {
+        size_t index = (scheduler->lanes.next_op_class[priority] + i) % SIGNUN_OP_CLASS_COUNT;
+        op_class_state_t *state = &scheduler->op_classes[index];
+
+        if (!state->lanes[priority].head || !has_capacity(state))
+        {
+            continue;
+        }
+
+        scheduler->lanes.next_op_class[priority] = (index + 1) % SIGNUN_OP_CLASS_COUNT;
+        scheduler->lanes.queued[priority]--;
+        state->queued--;
+
+        return task_queue_pop(&state->lanes[priority]);
+    }
+
+    return NULL;
+}
+
+static signun_task_t *take_next_task(signun_scheduler_t *scheduler)
+{
+    bool bulk_first = SIGNUN_LANE_SCHEDULING_WEIGHTED == scheduler->lanes.scheduling
+        && scheduler->lanes.interactive_streak >= scheduler->lanes.interactive_weight;
+
+    signun_priority_t order[SIGNUN_PRIORITY_COUNT] = {
+        bulk_first ? SIGNUN_PRIORITY_BULK : SIGNUN_PRIORITY_INTERACTIVE,
+        bulk_first ? SIGNUN_PRIORITY_INTERACTIVE : SIGNUN_PRIORITY_BULK
+    };
+
+    for (size_t i = 0; i < SIGNUN_PRIORITY_COUNT; ++i)
+    {
+        signun_task_t *task = take_from_lane(scheduler, order[i]);
+        if (!task)
+        {
+            continue;
+        }
+
+        if (SIGNUN_PRIORITY_INTERACTIVE == order[i])
+        {
+            scheduler->lanes.interactive_streak++;
+        }
+        else
+        {
+            scheduler->lanes.interactive_streak = 0;
+        }
+
+        return task;
+    }
+
+    return NULL;
+}
+
+static void running_tasks_push(signun_scheduler_t *scheduler, signun_task_t *task)
+{
+    task->next = scheduler->lanes.running_tasks;
+    scheduler->lanes.running_tasks = task;
+}
+
+static void running_tasks_remove(signun_scheduler_t *scheduler, signun_task_t *task)
+{
+    signun_task_t **link = &scheduler->lanes.running_tasks;
+
+    while (*link && *link != task)
+    {
+        link = &(*link)->next;
+    }
+
+    if (*link)
+    {
+        *link = task->next;
+    }
+
+    task->next = NULL;
+}
+
+static void cancel_token_release(signun_cancel_token_t *cancel_token)
+{
+    if (cancel_token && 0 == --cancel_token->ref_count)
+    {
+        uv_mutex_destroy(&cancel_token->mutex);
+        free(cancel_token);
+    }
+}
+
+static bool cancel_token_is_cancelled(signun_cancel_token_t *cancel_token)
+{
+    uv_mutex_lock(&cancel_token->mutex);
+    const bool cancelled = cancel_token->cancelled;
+    uv_mutex_unlock(&cancel_token->mutex);
+
+    return cancelled;
+}
+
+static void finish_task(napi_env env, napi_status status, signun_task_t *task)
+{
+    signun_cancel_token_t *cancel_token = task->cancel_token;
+
+    if (cancel_token && cancel_token_is_cancelled(cancel_token))
+    {
+        status = napi_cancelled;
+    }
+
+    // May free the task, so it must not be touched afterwards.
+    task->complete(env, status, task);
+
+    cancel_token_release(cancel_token);
+}
+
+static void dispatch_queued(napi_env env, signun_scheduler_t *scheduler)
+{
+    while (scheduler->lanes.running < scheduler->lanes.concurrency)
+    {
+        signun_task_t *task = take_next_task(scheduler);
+        if (!task)
+        {
+            return;
+        }
+
+        op_class_state_t *state = &scheduler->op_classes[task->op_class];
+
+        state->in_flight++;
+        scheduler->lanes.running++;
+        running_tasks_push(scheduler, task);
+
+        napi_status status = napi_queue_async_work(env, task->async_work);
+        if (napi_ok != status)
+        {
+            state->in_flight--;
+            scheduler->lanes.running--;
+            running_tasks_remove(scheduler, task);
+
+            // The task owns its callback data, so it has to be told to clean up.
+            finish_task(env, status, task);
+        }
+    }
+}
+
+static void notify_waiters(napi_env env, op_class_state_t *state)
+{
+    if (is_under_pressure(state))
+    {
+        return;
+    }
+
+    napi_value undefined;
+    napi_get_undefined(env, &undefined);
+
+    pressure_waiter_t *waiter = state->waiters;
+    state->waiters = NULL;
+
+    while (waiter)
+    {
+        pressure_waiter_t *next = waiter->next;
+
+        napi_resolve_deferred(env, waiter->deferred, undefined);
+        free(waiter);
+
+        waiter = next;
+    }
+}
+
+static void notify_all_waiters(napi_env env, signun_scheduler_t *scheduler)
+{
+    for (size_t i = 0; i < SIGNUN_OP_CLASS_COUNT; ++i)
+    {
+        notify_waiters(env, &scheduler->op_classes[i]);
+    }
+}
+
+static void task_async_execute(napi_env env, void *data)
+{
+    signun_task_t *task = (signun_task_t *) data;
+
+    if (signun_task_is_cancelled(task))
+    {
+        return;
+    }
+
+    task->execute(env, task);
+}
+
+static void task_async_complete(napi_env env, napi_status status, void *data)
+{
+    signun_task_t *task = (signun_task_t *) data;
+    // Read up front, as completing the task may free it.
+    signun_scheduler_t *scheduler = task->scheduler;
+    op_class_state_t *state = &scheduler->op_classes[task->op_class];
+
+    state->in_flight--;
+    scheduler->lanes.running--;
+    running_tasks_remove(scheduler, task);
+
+    finish_task(env, status, task);
+
+    dispatch_queued(env, scheduler);
+    notify_all_waiters(env, scheduler);
+}
+
+napi_status signun_task_create(napi_env env, signun_task_t *task, signun_op_class_t op_class, signun_priority_t priority,
+    signun_cancel_token_t *cancel_token, napi_value resource_name, napi_async_execute_callback execute, napi_async_complete_callback complete)
+{
+    signun_instance_t *instance = signun_get_instance(env);
+    if (!instance)
+    {
+        return napi_generic_failure;
+    }
+
+    task->scheduler = instance->scheduler;
+    task->op_class = op_class;
+    task->priority = priority;
+    task->cancel_token = NULL;
+    task->execute = execute;
+    task->complete = complete;
+    task->next = NULL;
+
+    RETURN_ON_FAILURE(
+        napi_create_async_work(env, NULL, resource_name, task_async_execute, task_async_complete, task, &task->async_work)
+    );
+
+    // The token is only taken once nothing else can fail, as the caller frees
+    // the task on failure without going through the scheduler.
+    if (cancel_token)
+    {
+        cancel_token->ref_count++;
+        task->cancel_token = cancel_token;
+    }
+
+    return napi_ok;
+}
+
+bool signun_task_is_cancelled(const signun_task_t *task)
+{
+    return task->cancel_token && cancel_token_is_cancelled(task->cancel_token);
+}
+
+static bool is_rejected(const op_class_state_t *state)
+{
+    return SIGNUN_POLICY_REJECT == state->policy && is_under_pressure(state);
+}
+
+napi_status signun_task_queue_admitted(napi_env env, signun_task_t *task)
+{
+    signun_scheduler_t *scheduler = task->scheduler;
+    op_class_state_t *state = &scheduler->op_classes[task->op_class];
+
+    task_queue_push(&state->lanes[task->priority], task);
+    state->queued++;
+    scheduler->lanes.queued[task->priority]++;
+
+    dispatch_queued(env, scheduler);
+
+    return napi_ok;
+}
+
+napi_status signun_task_queue(napi_env env, signun_task_t *task)
+{
+    if (is_rejected(&task->scheduler->op_classes[task->op_class]))
+    {
+        // The caller frees the rejected task itself.
+        cancel_token_release(task->cancel_token);
+        task->cancel_token = NULL;
+
+        return napi_queue_full;
+    }
+
+    return signun_task_queue_admitted(env, task);
+}
+
+napi_status signun_op_class_admit(napi_env env, signun_op_class_t op_class)
+{
+    signun_instance_t *instance = signun_get_instance(env);
+    if (!instance)
+    {
+        return napi_generic_failure;
+    }
+
+    return is_rejected(&instance->scheduler->op_classes[op_class]) ? napi_queue_full : napi_ok;
+}
+
+static bool find_name(const char *name, const char **names, size_t name_count, size_t *index)
+{
+    for (size_t i = 0; i < name_count; ++i)
+    {
+        if (0 == strcmp(name, names[i]))
+        {
+            *index = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+napi_status signun_get_priority(napi_env env, napi_value value, signun_priority_t default_priority, signun_priority_t *priority)
+{
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, value, &type));
+
+    if (napi_undefined == type || napi_null == type)
+    {
+        *priority = default_priority;
+        return napi_ok;
+    }
+
+    char name[PRIORITY_NAME_MAX_LENGTH];
+    RETURN_ON_FAILURE(napi_get_value_string_utf8(env, value, name, PRIORITY_NAME_MAX_LENGTH, NULL));
+
+    size_t index;
+    if (!find_name(name, priority_names, SIGNUN_PRIORITY_COUNT, &index))
+    {
+        return napi_invalid_arg;
+    }
+
+    *priority = (signun_priority_t) index;
+
+    return napi_ok;
+}
+
+napi_status signun_get_cancel_token(napi_env env, napi_value value, signun_cancel_token_t **cancel_token)
+{
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, value, &type));
+
+    if (napi_undefined == type || napi_null == type)
+    {
+        *cancel_token = NULL;
+        return napi_ok;
+    }
+
+    if (napi_external != type)
+    {
+        return napi_invalid_arg;
+    }
+
+    return napi_get_value_external(env, value, (void **) cancel_token);
+}
+
+static void cancel_queued_tasks(napi_env env, signun_scheduler_t *scheduler, signun_cancel_token_t *cancel_token)
+{
+    signun_task_t *cancelled = NULL;
+
+    for (size_t i = 0; i < SIGNUN_OP_CLASS_COUNT; ++i)
+    {
+        op_class_state_t *state = &scheduler->op_classes[i];
+
+        for (size_t priority = 0; priority < SIGNUN_PRIORITY_COUNT; ++priority)
+        {
+            task_queue_t *queue = &state->lanes[priority];
+            signun_task_t **link = &queue->head;
+            signun_task_t *previous = NULL;
+
+            while (*link)
+            {
+                signun_task_t *task = *link;
+
+                if (task->cancel_token != cancel_token)
+                {
+                    previous = task;
+                    link = &task->next;
+                    continue;
+                }
+
+                *link = task->next;
+                if (queue->tail == task)
+                {
+                    queue->tail = previous;
+                }
+
+                state->queued--;
+                scheduler->lanes.queued[priority]--;
+
+                task->next = cancelled;
+                cancelled = task;
+            }
+        }
+    }
+
+    // Completed only after all queues are consistent again, since completion
+    // settles promises and frees the tasks.
+    while (cancelled)
+    {
+        signun_task_t *next = cancelled->next;
+
+        finish_task(env, napi_cancelled, cancelled);
+
+        cancelled = next;
+    }
+}
+
+static void cancel_running_tasks(napi_env env, signun_scheduler_t *scheduler, signun_cancel_token_t *cancel_token)
+{
+    for (signun_task_t *task = scheduler->lanes.running_tasks; task; task = task->next)
+    {
+        if (task->cancel_token == cancel_token)
+        {
+            // Fails for work that has already started, which then notices the
+            // flag on its own. Either way, the task completes through libuv.
+            napi_cancel_async_work(env, task->async_work);
+        }
+    }
+}
+
+static void cancel_token_finalize(napi_env env, void *data, void *hint)
+{
+    cancel_token_release((signun_cancel_token_t *) data);
+}
+
+static napi_value scheduler_addon_create_cancel_token(napi_env env, napi_callback_info info)
+{
+    signun_cancel_token_t *cancel_token = (signun_cancel_token_t *)malloc(sizeof (signun_cancel_token_t));
+    if (!cancel_token)
+    {
+        napi_throw_error(env, NULL, "Could not allocate a cancel token.");
+        return NULL;
+    }
+
+    if (0 != uv_mutex_init(&cancel_token->mutex))
+    {
+        free(cancel_token);
+        napi_throw_error(env, NULL, "Could not create the cancel token.");
+        return NULL;
+    }
+
+    cancel_token->cancelled = false;
+    // Owned by the JavaScript object until it is collected.
+    cancel_token->ref_count = 1;
+
+    napi_value js_cancel_token;
+    if (napi_ok != napi_create_external(env, cancel_token, cancel_token_finalize, NULL, &js_cancel_token))
+    {
+        uv_mutex_destroy(&cancel_token->mutex);
+        free(cancel_token);
+        napi_throw_error(env, NULL, "Could not create the cancel token.");
+        return NULL;
+    }
+
+    return js_cancel_token;
+}
+
+static napi_value scheduler_addon_cancel(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    signun_scheduler_t *scheduler;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &scheduler),
+        env, "Could not read function arguments."
+    );
+
+    signun_cancel_token_t *cancel_token;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        signun_get_cancel_token(env, argv[0], &cancel_token),
+        env, "Invalid cancel token was passed."
+    );
+
+    if (!cancel_token || cancel_token_is_cancelled(cancel_token))
+    {
+        return NULL;
+    }
+
+    uv_mutex_lock(&cancel_token->mutex);
+    cancel_token->cancelled = true;
+    uv_mutex_unlock(&cancel_token->mutex);
+
+    cancel_queued_tasks(env, scheduler, cancel_token);
+    cancel_running_tasks(env, scheduler, cancel_token);
+
+    notify_all_waiters(env, scheduler);
+
+    return NULL;
+}
+
+static op_class_state_t *get_op_class_state(napi_env env, signun_scheduler_t *scheduler, napi_value js_name)
+{
+    char name[OP_CLASS_NAME_MAX_LENGTH];
+    RETURN_VALUE_ON_FAILURE(
+        napi_get_value_string_utf8(env, js_name, name, OP_CLASS_NAME_MAX_LENGTH, NULL), NULL
+    );
+
+    for (size_t i = 0; i < SIGNUN_OP_CLASS_COUNT; ++i)
+    {
+        if (0 == strcmp(name, op_class_names[i]))
+        {
+            return &scheduler->op_classes[i];
+        }
+    }
+
+    return NULL;
+}
+
+static napi_value scheduler_addon_configure(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value argv[3];
+    signun_scheduler_t *scheduler;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &scheduler),
+        env, "Could not read function arguments."
+    );
+
+    op_class_state_t *state = get_op_class_state(env, scheduler, argv[0]);
+    if (!state)
+    {
+        napi_throw_error(env, NULL, "Unknown operation class.");
+        return NULL;
+    }
+
+    unsigned int limit;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[1], &limit),
+        env, "Invalid limit was passed."
+    );
+
+    char policy_name[POLICY_NAME_MAX_LENGTH];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_string_utf8(env, argv[2], policy_name, POLICY_NAME_MAX_LENGTH, NULL),
+        env, "Invalid policy was passed."
+    );
+
+    size_t policy;
+    if (!find_name(policy_name, policy_names, sizeof (policy_names) / sizeof (policy_names[0]), &policy))
+    {
+        napi_throw_error(env, NULL, "Unknown admission policy.");
+        return NULL;
+    }
+
+    state->policy = (signun_admission_policy_t) policy;
+    state->limit = limit;
+
+    // A raised limit may free up room for work that is already waiting.
+    dispatch_queued(env, scheduler);
+    notify_waiters(env, state);
+
+    return NULL;
+}
+
+static napi_value scheduler_addon_depth(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    signun_scheduler_t *scheduler;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &scheduler),
+        env, "Could not read function arguments."
+    );
+
+    op_class_state_t *state = get_op_class_state(env, scheduler, argv[0]);
+    if (!state)
+    {
+        napi_throw_error(env, NULL, "Unknown operation class.");
+        return NULL;
+    }
+
+    napi_value js_in_flight;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_uint32(env, state->in_flight, &js_in_flight),
+        env, "Could not set the in-flight count."
+    );
+
+    napi_value js_queued;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_uint32(env, state->queued, &js_queued),
+        env, "Could not set the queued count."
+    );
+
+    napi_value js_limit;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_uint32(env, state->limit, &js_limit),
+        env, "Could not set the limit."
+    );
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_object(env, &js_result),
+        env, "Could not create the result object."
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_set_named_property(env, js_result, "inFlight", js_in_flight),
+        env, "Could not set named property: 'inFlight'."
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_set_named_property(env, js_result, "queued", js_queued),
+        env, "Could not set named property: 'queued'."
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_set_named_property(env, js_result, "limit", js_limit),
+        env, "Could not set named property: 'limit'."
+    );
+
+    return js_result;
+}
+
+static napi_value scheduler_addon_pressure(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    signun_scheduler_t *scheduler;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &scheduler),
+        env, "Could not read function arguments."
+    );
+
+    op_class_state_t *state = get_op_class_state(env, scheduler, argv[0]);
+    if (!state)
+    {
+        napi_throw_error(env, NULL, "Unknown operation class.");
+        return NULL;
+    }
+
+    napi_deferred deferred;
+    napi_value promise;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_promise(env, &deferred, &promise),
+        env, "Could not create result promise."
+    );
+
+    if (!is_under_pressure(state))
+    {
+        napi_value undefined;
+        napi_get_undefined(env, &undefined);
+        napi_resolve_deferred(env, deferred, undefined);
+
+        return promise;
+    }
+
+    pressure_waiter_t *waiter = (pressure_waiter_t *)malloc(sizeof (pressure_waiter_t));
+    if (!waiter)
+    {
+        REJECT_WITH_ERROR(env, "Could not allocate a pressure waiter.", deferred);
+        return promise;
+    }
+
+    waiter->deferred = deferred;
+    waiter->next = state->waiters;
+    state->waiters = waiter;
+
+    return promise;
+}
+
+static napi_value scheduler_addon_configure_lanes(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value argv[3];
+    signun_scheduler_t *scheduler;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, &argc, argv, NULL, (void **) &scheduler),
+        env, "Could not read function arguments."
+    );
+
+    unsigned int concurrency;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[0], &concurrency),
+        env, "Invalid concurrency was passed."
+    );
+
+    if (0 == concurrency || concurrency > MAX_CONCURRENCY)
+    {
+        napi_throw_range_error(env, NULL, "Concurrency is out of range.");
+        return NULL;
+    }
+
+    char scheduling_name[POLICY_NAME_MAX_LENGTH];
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_string_utf8(env, argv[1], scheduling_name, POLICY_NAME_MAX_LENGTH, NULL),
+        env, "Invalid lane scheduling was passed."
+    );
+
+    size_t scheduling;
+    if (!find_name(scheduling_name, scheduling_names, sizeof (scheduling_names) / sizeof (scheduling_names[0]), &scheduling))
+    {
+        napi_throw_error(env, NULL, "Unknown lane scheduling.");
+        return NULL;
+    }
+
+    unsigned int interactive_weight;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_value_uint32(env, argv[2], &interactive_weight),
+        env, "Invalid interactive weight was passed."
+    );
+
+    // A weight of 0 would dispatch bulk work first every time, inverting the lanes.
+    if (0 == interactive_weight)
+    {
+        napi_throw_range_error(env, NULL, "Interactive weight is out of range.");
+        return NULL;
+    }
+
+    scheduler->lanes.concurrency = concurrency;
+    scheduler->lanes.scheduling = (signun_lane_scheduling_t) scheduling;
+    scheduler->lanes.interactive_weight = interactive_weight;
+    scheduler->lanes.interactive_streak = 0;
+
+    dispatch_queued(env, scheduler);
+    notify_all_waiters(env, scheduler);
+
+    return NULL;
+}
+
+static napi_value scheduler_addon_lanes(napi_env env, napi_callback_info info)
+{
+    signun_scheduler_t *scheduler;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_get_cb_info(env, info, NULL, NULL, NULL, (void **) &scheduler),
+        env, "Could not read function arguments."
+    );
+
+    napi_value js_running;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_uint32(env, scheduler->lanes.running, &js_running),
+        env, "Could not set the running count."
+    );
+
+    napi_value js_concurrency;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_uint32(env, scheduler->lanes.concurrency, &js_concurrency),
+        env, "Could not set the concurrency."
+    );
+
+    napi_value js_interactive;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_uint32(env, scheduler->lanes.queued[SIGNUN_PRIORITY_INTERACTIVE], &js_interactive),
+        env, "Could not set the interactive queue depth."
+    );
+
+    napi_value js_bulk;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_uint32(env, scheduler->lanes.queued[SIGNUN_PRIORITY_BULK], &js_bulk),
+        env, "Could not set the bulk queue depth."
+    );
+
+    napi_value js_result;
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_create_object(env, &js_result),
+        env, "Could not create the result object."
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_set_named_property(env, js_result, "running", js_running),
+        env, "Could not set named property: 'running'."
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_set_named_property(env, js_result, "concurrency", js_concurrency),
+        env, "Could not set named property: 'concurrency'."
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_set_named_property(env, js_result, "interactive", js_interactive),
+        env, "Could not set named property: 'interactive'."
+    );
+
+    THROW_AND_RETURN_NULL_ON_FAILURE(
+        napi_set_named_property(env, js_result, "bulk", js_bulk),
+        env, "Could not set named property: 'bulk'."
+    );
+
+    return js_result;
+}
+
+void signun_scheduler_destroy(signun_scheduler_t *scheduler)
+{
+    if (!scheduler)
+    {
+        return;
+    }
+
+    // The environment is going away, so waiters are dropped without settling.
+    for (size_t i = 0; i < SIGNUN_OP_CLASS_COUNT; ++i)
+    {
+        pressure_waiter_t *waiter = scheduler->op_classes[i].waiters;
+
+        while (waiter)
+        {
+            pressure_waiter_t *next = waiter->next;
+            free(waiter);
+            waiter = next;
+        }
+    }
+
+    free(scheduler);
+}
+
+napi_status create_scheduler_addon(napi_env env, napi_value base)
+{
+    napi_value addon;
+
+    signun_instance_t *instance = signun_get_instance(env);
+    if (!instance)
+    {
+        return napi_generic_failure;
+    }
+
+    signun_scheduler_t *scheduler = (signun_scheduler_t *)calloc(1, sizeof (signun_scheduler_t));
+    if (!scheduler)
+    {
+        return napi_generic_failure;
+    }
+
+    scheduler->lanes.concurrency = DEFAULT_CONCURRENCY;
+    scheduler->lanes.scheduling = SIGNUN_LANE_SCHEDULING_WEIGHTED;
+    scheduler->lanes.interactive_weight = DEFAULT_INTERACTIVE_WEIGHT;
+
+    // Owned by the instance from here on, which frees it with the environment.
+    instance->scheduler = scheduler;
+
+    // Holding more tasks than the pool has threads would only hide them from
+    // the lanes, so the default matches the size of the libuv pool.
+    const char *threadpool_size = getenv("UV_THREADPOOL_SIZE");
+    if (threadpool_size)
+    {
+        long size = strtol(threadpool_size, NULL, 10);
+        if (0 < size && size <= MAX_CONCURRENCY)
+        {
+            scheduler->lanes.concurrency = (unsigned int) size;
+        }
+    }
+
+    RETURN_ON_FAILURE(napi_create_object(env, &addon));
+
+    const size_t property_count = 7;
+    napi_property_descriptor properties[] = {
+        DECLARE_NAPI_METHOD("configure", scheduler_addon_configure, scheduler),
+        DECLARE_NAPI_METHOD("depth", scheduler_addon_depth, scheduler),
+        DECLARE_NAPI_METHOD("pressure", scheduler_addon_pressure, scheduler),
+        DECLARE_NAPI_METHOD("configureLanes", scheduler_addon_configure_lanes, scheduler),
+        DECLARE_NAPI_METHOD("lanes", scheduler_addon_lanes, scheduler),
+        DECLARE_NAPI_METHOD("createCancelToken", scheduler_addon_create_cancel_token, scheduler),
+        DECLARE_NAPI_METHOD("cancel", scheduler_addon_cancel, scheduler)
+    };
+
+    RETURN_ON_FAILURE(napi_define_properties(env, addon, property_count, properties));
+    RETURN_ON_FAILURE(napi_set_named_property(env, base, "scheduler", addon));
+
+    return napi_ok;
+}
@@ -0,0 +1,226 @@
+#include "signun_sha512.h"
+
+#include <string.h>
+
+#include "signun_util.h"
+
+
+#define ROTR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+#define HMAC_INNER_PAD 0x36
+#define HMAC_OUTER_PAD 0x5c
+
+static const uint64_t round_constants[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+static const uint64_t initial_state[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+static uint64_t load64_be(const unsigned char *input)
+{
+    uint64_t value = 0;
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        value = (value << 8) | input[i];
+    }
+
+    return value;
+}
+
+static void store64_be(unsigned char *output, uint64_t value)
+{
+    for (size_t i = 0; i < 8; ++i)
+    {
+        output[7 - i] = (unsigned char) (value >> (8 * i));
+    }
+}
+
+static void compress(signun_sha512_t *sha512, const unsigned char *block)
+{
+    uint64_t w[80];
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+        w[i] = load64_be(&block[8 * i]);
+    }
+
+    for (size_t i = 16; i < 80; ++i)
+    {
+        const uint64_t s0 = ROTR64(w[i - 15], 1) ^ ROTR64(w[i - 15], 8) ^ (w[i - 15] >> 7);
+        const uint64_t s1 = ROTR64(w[i - 2], 19) ^ ROTR64(w[i - 2], 61) ^ (w[i - 2] >> 6);
+
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint64_t a = sha512->state[0];
+    uint64_t b = sha512->state[1];
+    uint64_t c = sha512->state[2];
+    uint64_t d = sha512->state[3];
+    uint64_t e = sha512->state[4];
+    uint64_t f = sha512->state[5];
+    uint64_t g = sha512->state[6];
+    uint64_t h = sha512->state[7];
+
+    for (size_t i = 0; i < 80; ++i)
+    {
+        const uint64_t s1 = ROTR64(e, 14) ^ ROTR64(e, 18) ^ ROTR64(e, 41);
+        const uint64_t ch = (e & f) ^ (~e & g);
+        const uint64_t t1 = h + s1 + ch + round_constants[i] + w[i];
+        const uint64_t s0 = ROTR64(a, 28) ^ ROTR64(a, 34) ^ ROTR64(a, 39);
+        const uint64_t maj = (a & b) ^ (a & c) ^ (b & c);
+        const uint64_t t2 = s0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    sha512->state[0] += a;
+    sha512->state[1] += b;
+    sha512->state[2] += c;
+    sha512->state[3] += d;
+    sha512->state[4] += e;
+    sha512->state[5] += f;
+    sha512->state[6] += g;
+    sha512->state[7] += h;
+
+    signun_secure_zero(w, sizeof w);
+}
+
+void signun_sha512_init(signun_sha512_t *sha512)
+{
+    memcpy(sha512->state, initial_state, sizeof initial_state);
+    sha512->length = 0;
+    sha512->buffer_length = 0;
+}
+
+void signun_sha512_update(signun_sha512_t *sha512, const unsigned char *data, size_t length)
+{
+    sha512->length += length;
+
+    if (0 < sha512->buffer_length)
+    {
+        const size_t missing = SIGNUN_SHA512_BLOCK_LENGTH - sha512->buffer_length;
+        const size_t taken = length < missing ? length : missing;
+
+        memcpy(&sha512->buffer[sha512->buffer_length], data, taken);
+        sha512->buffer_length += taken;
+        data += taken;
+        length -= taken;
+
+        if (SIGNUN_SHA512_BLOCK_LENGTH > sha512->buffer_length)
+        {
+            return;
+        }
+
+        compress(sha512, sha512->buffer);
+        sha512->buffer_length = 0;
+    }
+
+    while (SIGNUN_SHA512_BLOCK_LENGTH <= length)
+    {
+        compress(sha512, data);
+        data += SIGNUN_SHA512_BLOCK_LENGTH;
+        length -= SIGNUN_SHA512_BLOCK_LENGTH;
+    }
+
+    memcpy(sha512->buffer, data, length);
+    sha512->buffer_length = length;
+}
+
+void signun_sha512_final(signun_sha512_t *sha512, unsigned char *digest)
+{
+    // Messages are never long enough for the upper half of the 128-bit length.
+    const uint64_t bit_length = sha512->length * 8;
+
+    sha512->buffer[sha512->buffer_length++] = 0x80;
+
+    if (SIGNUN_SHA512_BLOCK_LENGTH - 16 < sha512->buffer_length)
+    {
+        memset(&sha512->buffer[sha512->buffer_length], 0, SIGNUN_SHA512_BLOCK_LENGTH - sha512->buffer_length);
+        compress(sha512, sha512->buffer);
+        sha512->buffer_length = 0;
+    }
+
+    memset(&sha512->buffer[sha512->buffer_length], 0, SIGNUN_SHA512_BLOCK_LENGTH - 8 - sha512->buffer_length);
+    store64_be(&sha512->buffer[SIGNUN_SHA512_BLOCK_LENGTH - 8], bit_length);
+    compress(sha512, sha512->buffer);
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        store64_be(&digest[8 * i], sha512->state[i]);
+    }
+
+    signun_secure_zero(sha512, sizeof (signun_sha512_t));
+}
+
+void signun_hmac_sha512(const unsigned char *key, size_t key_length, const unsigned char *data, size_t data_length, unsigned char *mac)
+{
+    unsigned char block_key[SIGNUN_SHA512_BLOCK_LENGTH] = { 0 };
+    unsigned char pad[SIGNUN_SHA512_BLOCK_LENGTH];
+    unsigned char inner_digest[SIGNUN_SHA512_DIGEST_LENGTH];
+    signun_sha512_t sha512;
+
+    if (SIGNUN_SHA512_BLOCK_LENGTH < key_length)
+    {
+        signun_sha512_init(&sha512);
+        signun_sha512_update(&sha512, key, key_length);
+        signun_sha512_final(&sha512, block_key);
+    }
+    else
+    {
+        memcpy(block_key, key, key_length);
+    }
+
+    for (size_t i = 0; i < SIGNUN_SHA512_BLOCK_LENGTH; ++i)
+    {
+        pad[i] = block_key[i] ^ HMAC_INNER_PAD;
+    }
+
+    signun_sha512_init(&sha512);
+    signun_sha512_update(&sha512, pad, SIGNUN_SHA512_BLOCK_LENGTH);
+    signun_sha512_update(&sha512, data, data_length);
+    signun_sha512_final(&sha512, inner_digest);
+
+    for (size_t i = 0; i < SIGNUN_SHA512_BLOCK_LENGTH; ++i)
+    {
+        pad[i] = block_key[i] ^ HMAC_OUTER_PAD;
+    }
+
+    signun_sha512_init(&sha512);
+    signun_sha512_update(&sha512, pad, SIGNUN_SHA512_BLOCK_LENGTH);
+    signun_sha512_update(&sha512, inner_digest, SIGNUN_SHA512_DIGEST_LENGTH);
+    signun_sha512_final(&sha512, mac);
+
+    signun_secure_zero(block_key, sizeof block_key);
+    signun_secure_zero(pad, sizeof pad);
+    signun_secure_zero(inner_digest, sizeof inner_digest);
+}
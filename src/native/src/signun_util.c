@@ -1,5 +1,8 @@
 #include "signun_util.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 
 napi_status signun_create_error(napi_env env, const char *message, napi_value *error)
 {
@@ -10,3 +13,193 @@ napi_status signun_create_error(napi_env env, const char *message, napi_value *e
 
     return napi_ok;
 }
+
+napi_status signun_create_abort_error(napi_env env, napi_value *error)
+{
+    napi_value js_code;
+    RETURN_ON_FAILURE(napi_create_string_utf8(env, "ABORT_ERR", NAPI_AUTO_LENGTH, &js_code));
+
+    napi_value js_message;
+    RETURN_ON_FAILURE(napi_create_string_utf8(env, "The operation was aborted.", NAPI_AUTO_LENGTH, &js_message));
+
+    RETURN_ON_FAILURE(napi_create_error(env, js_code, js_message, error));
+
+    napi_value js_name;
+    RETURN_ON_FAILURE(napi_create_string_utf8(env, "AbortError", NAPI_AUTO_LENGTH, &js_name));
+
+    RETURN_ON_FAILURE(napi_set_named_property(env, *error, "name", js_name));
+
+    return napi_ok;
+}
+
+// Calling memset through a volatile pointer keeps it from being elided.
+static void *(*const volatile memset_ptr)(void *, int, size_t) = memset;
+
+void signun_secure_zero(void *ptr, size_t length)
+{
+    memset_ptr(ptr, 0, length);
+}
+
+static size_t typedarray_element_size(napi_typedarray_type type)
+{
+    switch (type)
+    {
+        case napi_int8_array:
+        case napi_uint8_array:
+        case napi_uint8_clamped_array:
+            return 1;
+        case napi_int16_array:
+        case napi_uint16_array:
+            return 2;
+        case napi_int32_array:
+        case napi_uint32_array:
+        case napi_float32_array:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+napi_status signun_get_bytes(napi_env env, napi_value value, void **data, size_t *length)
+{
+    size_t byte_length;
+
+    bool is_typedarray;
+    RETURN_ON_FAILURE(napi_is_typedarray(env, value, &is_typedarray));
+
+    bool is_dataview = false;
+    if (!is_typedarray)
+    {
+        RETURN_ON_FAILURE(napi_is_dataview(env, value, &is_dataview));
+    }
+
+    bool is_arraybuffer = false;
+    if (!is_typedarray && !is_dataview)
+    {
+        RETURN_ON_FAILURE(napi_is_arraybuffer(env, value, &is_arraybuffer));
+    }
+
+    if (is_typedarray)
+    {
+        // Buffers are Uint8Arrays, so they take this path too.
+        napi_typedarray_type type;
+        size_t element_count;
+        RETURN_ON_FAILURE(napi_get_typedarray_info(env, value, &type, &element_count, data, NULL, NULL));
+
+        byte_length = element_count * typedarray_element_size(type);
+    }
+    else if (is_dataview)
+    {
+        RETURN_ON_FAILURE(napi_get_dataview_info(env, value, &byte_length, data, NULL, NULL));
+    }
+    else if (is_arraybuffer)
+    {
+        RETURN_ON_FAILURE(napi_get_arraybuffer_info(env, value, data, &byte_length));
+    }
+    else
+    {
+        return napi_invalid_arg;
+    }
+
+    if (length)
+    {
+        *length = byte_length;
+    }
+
+    return napi_ok;
+}
+
+napi_status signun_get_bytes_or_string(napi_env env, napi_value value, unsigned char *scratch, size_t scratch_length,
+    unsigned char **data, size_t *length, unsigned char **allocation)
+{
+    *allocation = NULL;
+
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, value, &type));
+
+    if (napi_string != type)
+    {
+        return signun_get_bytes(env, value, (void **) data, length);
+    }
+
+    size_t string_length;
+    RETURN_ON_FAILURE(napi_get_value_string_utf8(env, value, NULL, 0, &string_length));
+
+    // N-API always writes a terminating NUL, which is not part of the data.
+    unsigned char *output = scratch;
+    if (string_length + 1 > scratch_length)
+    {
+        output = *allocation = (unsigned char *)malloc(string_length + 1);
+        if (!output)
+        {
+            return napi_generic_failure;
+        }
+    }
+
+    napi_status status = napi_get_value_string_utf8(env, value, (char *) output, string_length + 1, length);
+    if (napi_ok != status)
+    {
+        free(*allocation);
+        *allocation = NULL;
+        return status;
+    }
+
+    *data = output;
+
+    return napi_ok;
+}
+
+napi_status signun_pin_bytes(napi_env env, napi_value value, napi_ref *ref)
+{
+    *ref = NULL;
+
+    napi_valuetype type;
+    RETURN_ON_FAILURE(napi_typeof(env, value, &type));
+
+    if (napi_string == type)
+    {
+        return napi_ok;
+    }
+
+    return napi_create_reference(env, value, 1, ref);
+}
+
+void signun_unpin_bytes(napi_env env, napi_ref *ref)
+{
+    if (*ref)
+    {
+        napi_delete_reference(env, *ref);
+        *ref = NULL;
+    }
+}
+
+napi_status signun_get_packed_bytes(napi_env env, napi_value js_data, napi_value js_offsets,
+    const unsigned char **data, const uint32_t **offsets, size_t *count)
+{
+    size_t data_length;
+    RETURN_ON_FAILURE(signun_get_bytes(env, js_data, (void **) data, &data_length));
+
+    napi_typedarray_type offsets_type;
+    size_t offset_count;
+    void *raw_offsets;
+    RETURN_ON_FAILURE(napi_get_typedarray_info(env, js_offsets, &offsets_type, &offset_count, &raw_offsets, NULL, NULL));
+
+    if (napi_uint32_array != offsets_type || 0 == offset_count)
+    {
+        return napi_invalid_arg;
+    }
+
+    const uint32_t *item_offsets = (const uint32_t *) raw_offsets;
+    for (size_t i = 1; i < offset_count; ++i)
+    {
+        if (item_offsets[i] < item_offsets[i - 1] || data_length < item_offsets[i])
+        {
+            return napi_invalid_arg;
+        }
+    }
+
+    *offsets = item_offsets;
+    *count = offset_count - 1;
+
+    return napi_ok;
+}
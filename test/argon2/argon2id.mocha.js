@@ -0,0 +1,77 @@
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { argon2id } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+// Cheap costs, so that the tests do not spend their time filling memory.
+const costs = { timeCost: 2, memoryCost: 256, parallelism: 2 };
+
+describe('argon2id', function describeArgon2id() {
+    it('matches the RFC 9106 test vector', async function () {
+        // When
+        const tag = await argon2id.hashRaw(Buffer.alloc(32, 0x01), Buffer.alloc(16, 0x02), {
+            timeCost: 3,
+            memoryCost: 32,
+            parallelism: 4,
+            secret: Buffer.alloc(8, 0x03),
+            associatedData: Buffer.alloc(12, 0x04)
+        });
+
+        // Then
+        expect(tag.toString('hex')).to.equal('0d640df58d78766c08c037a34a8b53c9d01ef0452d75b65eb52520e96b01e659');
+    });
+
+    it('matches the reference implementation with a single lane', async function () {
+        // When
+        const tag = await argon2id.hashRaw('password', Buffer.from('somesalt'), { timeCost: 2, memoryCost: 65536, parallelism: 1 });
+
+        // Then
+        expect(tag.toString('base64')).to.equal('CTFhFdXPJO1aFaMaO6Mm5c8y7cJHAph8ArZWb2GRPPc=');
+    });
+
+    it('verifies the hash of the right password only', async function () {
+        // Given
+        const encoded = await argon2id.hash('correct horse battery staple', costs);
+
+        // When
+        const isCorrect = await argon2id.verify(encoded, 'correct horse battery staple');
+        const isWrong = await argon2id.verify(encoded, 'correct horse battery stapler');
+
+        // Then
+        expect(encoded).to.match(/^\$argon2id\$v=19\$m=256,t=2,p=2\$[A-Za-z0-9+/]{22}\$[A-Za-z0-9+/]{43}$/);
+        expect(isCorrect).to.be.true;
+        expect(isWrong).to.be.false;
+    });
+
+    it('mixes the secret into the hash', async function () {
+        // Given
+        const secret = Buffer.from('pepper');
+        const encoded = await argon2id.hash('password', { ...costs, secret });
+
+        // Then
+        expect(await argon2id.verify(encoded, 'password', { secret })).to.be.true;
+        expect(await argon2id.verify(encoded, 'password')).to.be.false;
+    });
+
+    it('rejects invalid parameters', async function () {
+        expect(() => argon2id.hashRaw('password', Buffer.alloc(4))).to.throw(RangeError);
+        expect(() => argon2id.hashRaw('password', Buffer.alloc(16), { memoryCost: 8, parallelism: 2 })).to.throw(RangeError);
+        await expect(argon2id.verify('$argon2i$v=19$m=256,t=2,p=2$c29tZXNhbHQ$AAAA', 'password')).to.be.rejectedWith(TypeError);
+    });
+
+    it('can be aborted', async function () {
+        // Given
+        const controller = new AbortController();
+
+        // When
+        const promise = argon2id.hashRaw('password', Buffer.alloc(16), { memoryCost: 64 * 1024, signal: controller.signal });
+        controller.abort();
+
+        // Then
+        await expect(promise).to.be.rejectedWith('The operation was aborted.');
+    });
+});
@@ -0,0 +1,102 @@
+const { createHash, randomBytes } = require('crypto');
+const v8 = require('v8');
+const vm = require('vm');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { blake2b } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+function reference(data) {
+    return createHash('blake2b512').update(data).digest();
+}
+
+function collectGarbage() {
+    v8.setFlagsFromString('--expose-gc');
+    vm.runInNewContext('gc')();
+}
+
+describe('blake2b', function describeBlake2b() {
+    describe('input types', function describeInputTypes() {
+        it('hashes typed arrays, DataViews and ArrayBuffers in place', async function () {
+            // Given
+            const backing = randomBytes(256);
+            const data = backing.subarray(16, 144);
+            const expected = reference(data);
+
+            const views = [
+                new Uint8Array(backing.buffer, backing.byteOffset + 16, 128),
+                new Uint32Array(backing.buffer.slice(backing.byteOffset + 16, backing.byteOffset + 144)),
+                new DataView(backing.buffer, backing.byteOffset + 16, 128),
+                backing.buffer.slice(backing.byteOffset + 16, backing.byteOffset + 144)
+            ];
+
+            // Then
+            for (const view of views) {
+                expect((await blake2b.hash(view, 64)).equals(expected)).to.be.true;
+            }
+        });
+
+        it('hashes strings', async function () {
+            // Given
+            const short = 'signun ✓';
+            const long = 'ä'.repeat(1000);
+            const hex = randomBytes(40).toString('hex');
+
+            // Then
+            expect((await blake2b.hash(short, 64)).equals(reference(Buffer.from(short)))).to.be.true;
+            expect((await blake2b.hash(long, 64)).equals(reference(Buffer.from(long)))).to.be.true;
+            expect((await blake2b.hash(hex, 64, { encoding: 'hex' })).equals(reference(Buffer.from(hex, 'hex')))).to.be.true;
+        });
+
+        it('macs strings and views like Buffers', async function () {
+            // Given
+            const key = randomBytes(32);
+            const mac = blake2b.createMac(new Uint8Array(key), 32);
+            const text = 'x'.repeat(600);
+
+            // When
+            const tag = mac.macSync(Buffer.from(text));
+
+            // Then
+            expect(mac.macSync(text).equals(tag)).to.be.true;
+            expect((await mac.mac(text)).equals(tag)).to.be.true;
+            expect((await blake2b.keyedHash(text, key.buffer.slice(key.byteOffset, key.byteOffset + 32), 32)).equals(tag)).to.be.true;
+            expect(mac.verifySync(text, new DataView(tag.buffer, tag.byteOffset, tag.byteLength))).to.be.true;
+        });
+
+        it('keeps inputs alive until the hash completes', async function () {
+            // Given
+            const key = randomBytes(32);
+            const mac = blake2b.createMac(key, 32);
+            const digests = [];
+            const tags = [];
+            const pending = [];
+
+            // When
+            for (let i = 0; i < 64; i++) {
+                const data = new Uint8Array(1024 * 1024).fill(i);
+                digests.push(reference(data));
+                tags.push(mac.macSync(data));
+                pending.push(blake2b.hash(data, 64), blake2b.keyedHash(data, key, 32));
+            }
+            collectGarbage();
+            const results = await Promise.all(pending);
+
+            // Then
+            for (let i = 0; i < 64; i++) {
+                expect(results[2 * i].equals(digests[i])).to.be.true;
+                expect(results[2 * i + 1].equals(tags[i])).to.be.true;
+            }
+        });
+
+        it('rejects other values', function () {
+            expect(() => blake2b.hash([1, 2, 3], 32)).to.throw(TypeError);
+            expect(() => blake2b.hash('abc', 32, { encoding: 'nope' })).to.throw(TypeError);
+        });
+    });
+});
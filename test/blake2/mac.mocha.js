@@ -0,0 +1,93 @@
+const { createHash, randomBytes } = require('crypto');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { blake2b } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+describe('blake2b', function describeBlake2b() {
+    describe('mac', function describeMac() {
+        it('matches the keyed hash of each message', async function () {
+            // Given
+            const key = randomBytes(32);
+            const mac = blake2b.createMac(key, 32);
+            const data = randomBytes(100);
+
+            // When
+            const syncTag = mac.macSync(data);
+            const asyncTag = await mac.mac(data);
+
+            // Then
+            const expected = await blake2b.keyedHash(data, key, 32);
+
+            expect(syncTag.equals(expected)).to.be.true;
+            expect(asyncTag.equals(expected)).to.be.true;
+        });
+
+        it('hashes an unkeyed prefix once for every message', function () {
+            // Given
+            const prefix = Buffer.from('signun/domain');
+            const mac = blake2b.createMac(null, 64, { prefix });
+            const data = randomBytes(300);
+
+            // When
+            const hash = mac.macSync(data);
+
+            // Then
+            const expected = createHash('blake2b512').update(prefix).update(data).digest();
+
+            expect(hash.equals(expected)).to.be.true;
+        });
+
+        it('matches the keyed hash around block boundaries', async function () {
+            // Given
+            const key = randomBytes(64);
+            const prefix = randomBytes(128);
+            const mac = blake2b.createMac(key, 64);
+            const prefixedMac = blake2b.createMac(key, 64, { prefix });
+            const unkeyedMac = blake2b.createMac(null, 64, { prefix });
+
+            for (const length of [0, 1, 127, 128, 129, 256]) {
+                // When
+                const data = randomBytes(length);
+
+                // Then
+                const prefixed = Buffer.concat([prefix, data]);
+
+                expect(mac.macSync(data).equals(await blake2b.keyedHash(data, key, 64))).to.be.true;
+                expect(prefixedMac.macSync(data).equals(await blake2b.keyedHash(prefixed, key, 64))).to.be.true;
+                expect(unkeyedMac.macSync(data).equals(createHash('blake2b512').update(prefixed).digest())).to.be.true;
+            }
+        });
+
+        it('macs many messages like single messages', async function () {
+            // Given
+            const mac = blake2b.createMac(randomBytes(64), 16);
+            const messages = new Array(10000).fill().map((_, i) => randomBytes(i % 200));
+
+            // When
+            const tags = await mac.macMany(messages);
+
+            // Then
+            expect(tags.length).to.equal(10000 * 16);
+            messages.forEach((message, i) => expect(tags.subarray(i * 16, (i + 1) * 16).equals(mac.macSync(message))).to.be.true);
+        });
+
+        it('verifies a tag', async function () {
+            // Given
+            const mac = blake2b.createMac(randomBytes(32), 32);
+            const data = randomBytes(64);
+            const tag = mac.macSync(data);
+
+            // Then
+            expect(mac.verifySync(data, tag)).to.be.true;
+            expect(await mac.verify(data, tag)).to.be.true;
+            expect(mac.verifySync(randomBytes(64), tag)).to.be.false;
+            expect(mac.verifySync(data, tag.subarray(1))).to.be.false;
+        });
+    });
+});
@@ -0,0 +1,227 @@
+const { createHash, randomBytes } = require('crypto');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { blake2b } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+// Node only provides the 64 byte variant of BLAKE2b, so the reference trees
+// use 64 byte hashes.
+const options = { leafHashLength: 64, nodeHashLength: 64 };
+
+function hash(prefix, data) {
+    return createHash('blake2b512').update(Buffer.from([prefix])).update(data).digest();
+}
+
+function referenceLevels(leaves, leafLength) {
+    let level = [];
+    for (let i = 0; i < leaves.length; i += leafLength) {
+        level.push(hash(0x00, leaves.subarray(i, i + leafLength)));
+    }
+
+    const levels = [level];
+    while (level.length > 1) {
+        const next = [];
+        for (let i = 0; i < level.length; i += 2) {
+            next.push(hash(0x01, Buffer.concat(level.slice(i, i + 2))));
+        }
+
+        levels.push(next);
+        level = next;
+    }
+
+    return levels;
+}
+
+// The leaf count tells which levels have no sibling on the path.
+function verifyProof(root, leafCount, leaf, index, proof) {
+    let node = hash(0x00, leaf);
+    let offset = 0;
+
+    for (let count = leafCount; count > 1; count = Math.ceil(count / 2), index = Math.floor(index / 2)) {
+        if ((index ^ 1) < count) {
+            const sibling = proof.subarray(offset, offset + 64);
+            offset += 64;
+
+            node = hash(0x01, index % 2 === 0 ? Buffer.concat([node, sibling]) : Buffer.concat([sibling, node]));
+        } else {
+            node = hash(0x01, node);
+        }
+    }
+
+    return offset === proof.length && node.equals(root);
+}
+
+describe('blake2b', function describeBlake2b() {
+    describe('merkleRoot', function describeMerkleRoot() {
+        [1, 2, 3, 7, 8, 1000, 20001].forEach(leafCount => {
+            it(`matches a reference tree of ${leafCount} leaves`, async function () {
+                // Given
+                const leaves = randomBytes(leafCount * 40);
+
+                // When
+                const { root, proofs } = await blake2b.merkleRoot(leaves, { ...options, leafLength: 40 });
+
+                // Then
+                const levels = referenceLevels(leaves, 40);
+
+                expect(root.equals(levels[levels.length - 1][0])).to.be.true;
+                expect(proofs).to.be.undefined;
+            });
+        });
+
+        it('returns inclusion proofs', async function () {
+            // Given
+            const leafCount = 10001;
+            const leaves = randomBytes(leafCount * 32);
+            const indices = [0, 1, 5000, 9999, 10000];
+
+            // When
+            const { root, proofs } = await blake2b.merkleRoot(leaves, { ...options, proofs: indices });
+
+            // Then
+            expect(proofs.length).to.equal(indices.length);
+            indices.forEach((index, i) => {
+                const leaf = leaves.subarray(index * 32, (index + 1) * 32);
+
+                expect(verifyProof(root, leafCount, leaf, index, proofs[i])).to.be.true;
+            });
+        });
+
+        it('uses the requested hash lengths without domain separation', async function () {
+            // Given
+            const leaves = randomBytes(3 * 16);
+
+            // When
+            const { root } = await blake2b.merkleRoot(leaves, {
+                leafLength: 16,
+                leafHashLength: 64,
+                nodeHashLength: 20,
+                domainSeparation: false
+            });
+
+            // Then
+            const leafHash = i => createHash('blake2b512').update(leaves.subarray(i * 16, (i + 1) * 16)).digest();
+            const nodeHash = data => blake2b.hash(data, 20);
+            const left = await nodeHash(Buffer.concat([leafHash(0), leafHash(1)]));
+            const right = await nodeHash(leafHash(2));
+            const expected = await nodeHash(Buffer.concat([left, right]));
+
+            expect(root.equals(expected)).to.be.true;
+        });
+
+        it('rejects leaves that are not a multiple of the leaf length', function () {
+            expect(() => blake2b.merkleRoot(randomBytes(33))).to.throw(RangeError);
+            expect(() => blake2b.merkleRoot(Buffer.alloc(0))).to.throw(RangeError);
+            expect(() => blake2b.merkleRoot(randomBytes(64), { proofs: [2] })).to.throw(RangeError);
+        });
+    });
+
+    describe('createMerkleAccumulator', function describeCreateMerkleAccumulator() {
+        it('matches merkleRoot after every append', async function () {
+            // Given
+            const accumulator = blake2b.createMerkleAccumulator();
+            const leaves = randomBytes(40 * 32);
+
+            // Then
+            expect(accumulator.root()).to.be.null;
+
+            for (let i = 0; i < 40; ++i) {
+                expect(accumulator.append(leaves.subarray(i * 32, (i + 1) * 32))).to.equal(i);
+
+                const { root, proofs } = await blake2b.merkleRoot(leaves.subarray(0, (i + 1) * 32), { proofs: [0, i] });
+
+                expect(accumulator.root().equals(root)).to.be.true;
+                expect(accumulator.proof(0).equals(proofs[0])).to.be.true;
+                expect(accumulator.proof(i).equals(proofs[1])).to.be.true;
+            }
+        });
+
+        it('appends many leaves across several growths', async function () {
+            // Given
+            const accumulator = blake2b.createMerkleAccumulator(options);
+            const leaves = randomBytes(30001 * 32);
+
+            // When
+            accumulator.append(leaves.subarray(0, 32));
+            const firstIndex = await accumulator.appendMany(leaves.subarray(32, 20000 * 32));
+            await accumulator.appendMany(leaves.subarray(20000 * 32));
+
+            // Then
+            const levels = referenceLevels(leaves, 32);
+
+            expect(firstIndex).to.equal(1);
+            expect(accumulator.size()).to.equal(30001);
+            expect(accumulator.root().equals(levels[levels.length - 1][0])).to.be.true;
+            expect(verifyProof(accumulator.root(), 30001, leaves.subarray(12345 * 32, 12346 * 32), 12345, accumulator.proof(12345))).to.be.true;
+        });
+
+        it('updates a leaf', async function () {
+            // Given
+            const accumulator = blake2b.createMerkleAccumulator();
+            const leaves = randomBytes(1000 * 32);
+            await accumulator.appendMany(leaves);
+
+            // When
+            const leaf = randomBytes(32);
+            accumulator.update(321, leaf);
+
+            // Then
+            leaf.copy(leaves, 321 * 32);
+            const { root } = await blake2b.merkleRoot(leaves);
+
+            expect(accumulator.root().equals(root)).to.be.true;
+        });
+
+        it('is busy while appending many leaves', async function () {
+            // Given
+            const accumulator = blake2b.createMerkleAccumulator();
+
+            // When
+            const pending = accumulator.appendMany(randomBytes(100 * 32));
+
+            // Then
+            expect(() => accumulator.append(randomBytes(32))).to.throw('The accumulator is busy.');
+            expect(await pending).to.equal(0);
+            expect(accumulator.size()).to.equal(100);
+        });
+
+        it('reopens a memory-mapped accumulator', async function () {
+            // Given
+            const directory = fs.mkdtempSync(path.join(os.tmpdir(), 'signun-'));
+            const file = path.join(directory, 'accumulator');
+            const leaves = randomBytes(5000 * 32);
+
+            try {
+                const accumulator = blake2b.createMerkleAccumulator({ path: file });
+                await accumulator.appendMany(leaves);
+                const root = accumulator.root();
+                accumulator.sync();
+                accumulator.close();
+
+                // When
+                const reopened = blake2b.createMerkleAccumulator({ path: file });
+
+                // Then
+                expect(reopened.size()).to.equal(5000);
+                expect(reopened.root().equals(root)).to.be.true;
+                reopened.close();
+                expect(() => reopened.root()).to.throw('The accumulator is closed.');
+                expect(() => blake2b.createMerkleAccumulator({ path: file, nodeHashLength: 64 })).to.throw('The accumulator file does not match the options.');
+            } finally {
+                if (fs.existsSync(file)) {
+                    fs.unlinkSync(file);
+                }
+
+                fs.rmdirSync(directory);
+            }
+        });
+    });
+});
@@ -0,0 +1,66 @@
+const { createHash, randomBytes } = require('crypto');
+const { Readable } = require('stream');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { blake2b } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+describe('blake2b', function describeBlake2b() {
+    describe('hash stream', function describeHashStream() {
+        it('hashes the chunks in write order', async function () {
+            // Given
+            const chunks = new Array(200).fill().map((_, i) => randomBytes(i * 97 % 5000));
+            const stream = blake2b.createHashStream(64, { queueDepth: 2 });
+
+            // When
+            const digest = await hashChunks(stream, chunks);
+
+            // Then
+            const expected = createHash('blake2b512').update(Buffer.concat(chunks)).digest();
+
+            expect(digest.equals(expected)).to.be.true;
+        });
+
+        it('matches a keyed hash', async function () {
+            // Given
+            const key = randomBytes(32);
+            const data = randomBytes(100000);
+
+            // When
+            const digest = await hashChunks(blake2b.createHashStream(32, { key }), [data.subarray(0, 1), data.subarray(1)]);
+
+            // Then
+            expect(digest.equals(await blake2b.keyedHash(data, key, 32))).to.be.true;
+        });
+
+        it('rejects when aborted', async function () {
+            // Given
+            const controller = new AbortController();
+            const stream = blake2b.createHashStream(32, { signal: controller.signal });
+
+            // When
+            const result = hashChunks(stream, new Array(1000).fill().map(() => randomBytes(10000)));
+            controller.abort();
+
+            // Then
+            await expect(result).to.be.rejectedWith('The operation was aborted.');
+        });
+    });
+});
+
+function hashChunks(stream, chunks) {
+    return new Promise((resolve, reject) => {
+        const digests = [];
+
+        stream.on('data', digest => digests.push(digest));
+        stream.on('end', () => resolve(Buffer.concat(digests)));
+        stream.on('error', reject);
+
+        Readable.from(chunks).pipe(stream);
+    });
+};
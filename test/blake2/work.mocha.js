@@ -0,0 +1,87 @@
+const { randomBytes } = require('crypto');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { blake2b, work } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+// About one in 4096 nonces meets this threshold, so that searches are quick.
+const EASY_THRESHOLD = 0xfff0000000000000n;
+
+async function workValue(root, nonce) {
+    const hash = await blake2b.hash(Buffer.concat([nonce, root]), 8);
+
+    return hash.readBigUInt64LE();
+};
+
+describe('work', function describeWork() {
+    it('validates against the hash of the nonce and the root', async function () {
+        // Given
+        const root = randomBytes(32);
+        const nonce = randomBytes(8);
+        const value = await workValue(root, nonce);
+
+        // Then
+        expect(work.validate(root, nonce, value)).to.be.true;
+        expect(work.validate(root, nonce, 0n)).to.be.true;
+
+        if (value < 2n ** 64n - 1n) {
+            expect(work.validate(root, nonce, value + 1n)).to.be.false;
+        }
+    });
+
+    it('generates a nonce that meets the threshold', async function () {
+        // Given
+        const root = randomBytes(32);
+
+        // When
+        const nonce = await work.generate(root, EASY_THRESHOLD, { threads: 2 });
+
+        // Then
+        expect(nonce.byteLength).to.equal(8);
+        expect(work.validate(root, nonce, EASY_THRESHOLD)).to.be.true;
+        expect(await workValue(root, nonce) >= EASY_THRESHOLD).to.be.true;
+    });
+
+    it('validates a batch, one result per nonce', async function () {
+        // Given
+        const roots = [randomBytes(32), randomBytes(32), randomBytes(32)];
+        const nonces = await Promise.all(roots.map(root => work.generate(root, EASY_THRESHOLD)));
+        nonces[1] = Buffer.from(nonces[1]);
+        nonces[1][0] ^= 1;
+
+        // When
+        const results = await work.validateBatch(Buffer.concat(roots), Buffer.concat(nonces), EASY_THRESHOLD);
+
+        // Then
+        const expected = roots.map((root, i) => (work.validate(root, nonces[i], EASY_THRESHOLD) ? 1 : 0));
+
+        expect([...results]).to.deep.equal(expected);
+        expect(results[0]).to.equal(1);
+        expect(results[2]).to.equal(1);
+    });
+
+    it('can be aborted', async function () {
+        // Given
+        const controller = new AbortController();
+
+        // When
+        const promise = work.generate(randomBytes(32), 2n ** 64n - 1n, { signal: controller.signal });
+        setTimeout(() => controller.abort(), 20);
+
+        // Then
+        await expect(promise).to.be.rejectedWith('The operation was aborted.');
+    });
+
+    it('rejects invalid parameters', function () {
+        expect(() => work.validate(randomBytes(31), randomBytes(8), 0n)).to.throw(RangeError);
+        expect(() => work.validate(randomBytes(32), randomBytes(8), 2n ** 64n)).to.throw(RangeError);
+        expect(() => work.generate(randomBytes(32), 1, { threads: 1 })).to.throw(RangeError);
+        expect(() => work.generate(randomBytes(32), 1n, { threads: 0 })).to.throw(RangeError);
+        expect(() => work.validateBatch(randomBytes(64), randomBytes(8), 0n)).to.throw(RangeError);
+    });
+});
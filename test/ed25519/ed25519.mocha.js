@@ -0,0 +1,133 @@
+const crypto = require('crypto');
+const { randomBytes } = crypto;
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { ed25519 } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+// PKCS#8 wrapping of a raw Ed25519 seed, as Node imports them.
+const PKCS8_ED25519_PREFIX = Buffer.from('302e020100300506032b657004220420', 'hex');
+
+function nodePrivateKey(seed) {
+    return crypto.createPrivateKey({
+        key: Buffer.concat([PKCS8_ED25519_PREFIX, seed]),
+        format: 'der',
+        type: 'pkcs8'
+    });
+};
+
+describe('ed25519', function describeEd25519() {
+    describe('sha512', function describeSha512() {
+        it('matches the RFC 8032 test vector', function () {
+            // Given
+            const seed = Buffer.from('4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb', 'hex');
+            const message = Buffer.from('72', 'hex');
+
+            // When
+            const publicKey = ed25519.publicKeyCreateSync(seed, { hash: 'sha512' });
+            const signature = ed25519.signSync(message, seed, { hash: 'sha512' });
+
+            // Then
+            expect(publicKey.toString('hex')).to.equal('3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c');
+            expect(signature.toString('hex')).to.equal('92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223'
+                + 'ebdb69da085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00');
+        });
+
+        it('agrees with the Ed25519 of Node', async function () {
+            for (let i = 0; i < 20; ++i) {
+                // Given
+                const seed = randomBytes(32);
+                const message = randomBytes(i * 13);
+                const privateKey = nodePrivateKey(seed);
+                const publicKey = crypto.createPublicKey(privateKey);
+
+                // When
+                const signature = await ed25519.sign(message, seed, { hash: 'sha512' });
+
+                // Then
+                expect(signature.equals(crypto.sign(null, message, privateKey))).to.be.true;
+                expect(crypto.verify(null, message, publicKey, signature)).to.be.true;
+                expect(ed25519.verifySync(message, signature, ed25519.publicKeyCreateSync(seed, { hash: 'sha512' }), { hash: 'sha512' })).to.be.true;
+            }
+        });
+
+        it('rejects non-canonical public keys and scalars', function () {
+            // Given, R = B and S = 1, which verifies against the identity for any message
+            const message = Buffer.from('Non-canonical');
+            const base = Buffer.from('5866666666666666666666666666666666666666666666666666666666666666', 'hex');
+            const one = Buffer.from('0100000000000000000000000000000000000000000000000000000000000000', 'hex');
+            const onePlusL = Buffer.from('eed3f55c1a631258d69cf7a2def9de1400000000000000000000000000000010', 'hex');
+            const identity = one;
+            const identityAboveP = Buffer.from('eeffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff7f', 'hex');
+            const identityNegativeZero = Buffer.from('0100000000000000000000000000000000000000000000000000000000000080', 'hex');
+            const options = { hash: 'sha512' };
+
+            // Then
+            expect(ed25519.verifySync(message, Buffer.concat([base, one]), identity, options)).to.be.true;
+            expect(ed25519.verifySync(message, Buffer.concat([base, onePlusL]), identity, options)).to.be.false;
+            expect(ed25519.verifySync(message, Buffer.concat([base, one]), identityAboveP, options)).to.be.false;
+            expect(ed25519.verifySync(message, Buffer.concat([base, one]), identityNegativeZero, options)).to.be.false;
+        });
+    });
+
+    describe('blake2b-512', function describeBlake2b() {
+        it('derives the public key of the zero seed', async function () {
+            // When
+            const publicKey = await ed25519.publicKeyCreate(Buffer.alloc(32));
+
+            // Then
+            expect(publicKey.toString('hex')).to.equal('19d3d919475deed4696b5d13018151d1af88b2bd3bcff048b45031c1f36d1858');
+        });
+
+        it('verifies its own signatures only', async function () {
+            // Given
+            const { seed, publicKey } = await ed25519.generateKeyPair();
+            const message = 'Signed with BLAKE2b';
+
+            // When
+            const signature = await ed25519.sign(message, seed);
+            const tampered = Buffer.from(signature);
+            tampered[10] ^= 1;
+
+            // Then
+            expect(await ed25519.verify(message, signature, publicKey)).to.be.true;
+            expect(await ed25519.verify(message, tampered, publicKey)).to.be.false;
+            expect(ed25519.verifySync(message, signature, publicKey, { hash: 'sha512' })).to.be.false;
+        });
+    });
+
+    describe('verifyBatch', function describeVerifyBatch() {
+        it('verifies a batch with one tampered signature', async function () {
+            // Given
+            const count = 70;
+            const { seed, publicKey } = ed25519.generateKeyPairSync();
+            const messages = Array.from({ length: count }, (_, i) => randomBytes(i));
+            const signatures = Buffer.concat(messages.map(message => ed25519.signSync(message, seed)));
+            const publicKeys = Buffer.concat(messages.map(() => publicKey));
+
+            signatures[5 * 64] ^= 1;
+
+            // When
+            const results = await ed25519.verifyBatch(messages, signatures, publicKeys);
+
+            const chunked = Buffer.alloc(count, 0xff);
+            for await (const { start, results: chunk } of ed25519.verifyBatchChunks(messages, signatures, publicKeys)) {
+                chunk.copy(chunked, start);
+            }
+
+            // Then
+            expect(results.length).to.equal(count);
+            expect(results.every((result, i) => result === (i === 5 ? 0 : 1))).to.be.true;
+            expect(chunked.equals(results)).to.be.true;
+        });
+
+        it('rejects signatures that do not match the messages', function () {
+            expect(() => ed25519.verifyBatch([Buffer.alloc(1)], Buffer.alloc(63), Buffer.alloc(32))).to.throw();
+        });
+    });
+});
@@ -0,0 +1,90 @@
+const { randomBytes } = require('crypto');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { musig, secp256k1 } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+function signTogether(keyPairs, message) {
+    const aggregate = musig.aggregatePublicKeys(keyPairs.map(keyPair => keyPair.publicKey));
+    const sessions = keyPairs.map(keyPair => aggregate.createSession(keyPair.privateKey, message));
+    const publicNonces = sessions.map(session => session.publicNonce);
+
+    sessions.forEach(session => session.processNonces(publicNonces));
+
+    const partialSignatures = sessions.map(session => session.sign());
+
+    return { aggregate, sessions, publicNonces, partialSignatures };
+};
+
+describe('musig', function describeMusig() {
+    const keyPairs = [0, 1, 2].map(() => secp256k1.generateKeyPairSync());
+
+    it('aggregates the partial signatures of every signer into a valid signature', async function () {
+        // Given
+        const message = randomBytes(32);
+        const { aggregate, sessions, partialSignatures } = signTogether(keyPairs, message);
+
+        // When
+        const signature = sessions[0].aggregate(partialSignatures);
+
+        // Then
+        expect(signature.length).to.equal(64);
+        expect(musig.verifySync(message, signature, aggregate.publicKey)).to.equal(true);
+        expect(await musig.verify(message, signature, aggregate.publicKey)).to.equal(true);
+        expect(musig.verifySync(randomBytes(32), signature, aggregate.publicKey)).to.equal(false);
+    });
+
+    it('aggregates to the same public key in any order of the signers', function () {
+        // Given
+        const publicKeys = keyPairs.map(keyPair => keyPair.publicKey);
+
+        // When
+        const aggregate = musig.aggregatePublicKeys(publicKeys);
+        const reversedAggregate = musig.aggregatePublicKeys([...publicKeys].reverse());
+
+        // Then
+        expect(reversedAggregate.publicKey.equals(aggregate.publicKey)).to.equal(true);
+    });
+
+    it('rejects the partial signature of the wrong signer', function () {
+        // Given
+        const message = randomBytes(32);
+        const { sessions, publicNonces, partialSignatures } = signTogether(keyPairs, message);
+
+        // When
+        const valid = sessions[0].verifyPartial(partialSignatures[1], publicNonces[1], keyPairs[1].publicKey);
+        const invalid = sessions[0].verifyPartial(partialSignatures[1], publicNonces[1], keyPairs[2].publicKey);
+
+        // Then
+        expect(valid).to.equal(true);
+        expect(invalid).to.equal(false);
+    });
+
+    it('signs at most once per session', function () {
+        // Given
+        const { sessions } = signTogether(keyPairs, randomBytes(32));
+
+        // Then
+        expect(() => sessions[0].sign()).to.throw('The session has already signed.');
+    });
+
+    it('verifies a batch of signatures', async function () {
+        // Given
+        const messages = [randomBytes(32), randomBytes(32)];
+        const signed = messages.map(message => signTogether(keyPairs, message));
+        const signatures = signed.map(({ sessions, partialSignatures }) => sessions[0].aggregate(partialSignatures));
+        const publicKeys = signed.map(({ aggregate }) => aggregate.publicKey);
+
+        // When
+        const results = await musig.verifyBatch(Buffer.concat([messages[0], randomBytes(32)]),
+            Buffer.concat(signatures), Buffer.concat(publicKeys));
+
+        // Then
+        expect([...results]).to.deep.equal([1, 0]);
+    });
+});
@@ -0,0 +1,211 @@
+const { randomBytes } = require('crypto');
+const path = require('path');
+const { Worker } = require('worker_threads');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { blake2b, scheduler, secp256k1 } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+describe('scheduler', function describeScheduler() {
+    const { concurrency } = scheduler.lanes();
+
+    afterEach(function resetScheduler() {
+        scheduler.configure('verify');
+        scheduler.configure('verifyBatch');
+        scheduler.configureLanes({ concurrency });
+    });
+
+    describe('admission control', function describeAdmissionControl() {
+        it('queues work over the limit with the queue policy', async function () {
+            // Given
+            const { message, signature, publicKey } = await createSignedMessage();
+            scheduler.configure('verify', { limit: 1, policy: 'queue' });
+
+            // When
+            const results = [1, 2, 3].map(() => secp256k1.verify(message, signature, publicKey));
+            const depth = scheduler.depth('verify');
+
+            // Then
+            expect(depth).to.deep.equal({ inFlight: 1, queued: 2, limit: 1 });
+            expect(await Promise.all(results)).to.deep.equal([true, true, true]);
+            expect(scheduler.depth('verify')).to.deep.equal({ inFlight: 0, queued: 0, limit: 1 });
+        });
+
+        it('rejects work over the limit with the reject policy', async function () {
+            // Given
+            const { message, signature, publicKey } = await createSignedMessage();
+            scheduler.configure('verify', { limit: 1, policy: 'reject' });
+
+            // When
+            const admitted = secp256k1.verify(message, signature, publicKey);
+            const rejected = secp256k1.verify(message, signature, publicKey);
+
+            // Then
+            await expect(rejected).to.be.rejectedWith('Too many operations are in flight.');
+            expect(await admitted).to.be.true;
+        });
+
+        it('admits a batch of more chunks than the limit as a whole', async function () {
+            // Given, 16 chunks of 128 verifications
+            const { message, signature, publicKey } = await createSignedMessage();
+            const count = 16 * 128;
+            const messages = Buffer.concat(Array.from({ length: count }, () => message));
+            const signatures = Buffer.concat(Array.from({ length: count }, () => signature));
+            const publicKeys = Buffer.concat(Array.from({ length: count }, () => publicKey));
+            scheduler.configure('verifyBatch', { limit: 2, policy: 'reject' });
+
+            // When
+            const admitted = secp256k1.verifyBatch(messages, signatures, publicKeys);
+            const depth = scheduler.depth('verifyBatch');
+            const rejected = secp256k1.verifyBatch(messages, signatures, publicKeys);
+
+            // Then
+            expect(depth.inFlight + depth.queued).to.equal(16);
+            await expect(rejected).to.be.rejectedWith('Too many operations are in flight.');
+            expect((await admitted).every(result => 1 === result)).to.be.true;
+            expect(scheduler.depth('verifyBatch')).to.deep.equal({ inFlight: 0, queued: 0, limit: 2 });
+        });
+
+        it('resolves pressure once the op class has room again', async function () {
+            // Given
+            const { message, signature, publicKey } = await createSignedMessage();
+            scheduler.configure('verify', { limit: 1, policy: 'queue' });
+            const pending = secp256k1.verify(message, signature, publicKey);
+
+            // When
+            await scheduler.pressure('verify');
+
+            // Then
+            expect(scheduler.depth('verify').inFlight).to.equal(0);
+            expect(await pending).to.be.true;
+        });
+
+        it('throws on an unknown op class', function () {
+            expect(() => scheduler.depth('mine')).to.throw(TypeError);
+        });
+    });
+
+    describe('priority lanes', function describePriorityLanes() {
+        it('dispatches interactive work ahead of queued bulk work', async function () {
+            // Given
+            const { message, signature, publicKey } = await createSignedMessage();
+            scheduler.configureLanes({ concurrency: 1, scheduling: 'strict' });
+            const completed = [];
+
+            // When
+            const bulk = [1, 2, 3].map((i) => secp256k1.verify(message, signature, publicKey, { priority: 'bulk' })
+                .then(() => completed.push(`bulk${i}`)));
+            const interactive = secp256k1.verify(message, signature, publicKey, { priority: 'interactive' })
+                .then(() => completed.push('interactive'));
+            const lanes = scheduler.lanes();
+
+            // Then
+            expect(lanes).to.deep.equal({ running: 1, concurrency: 1, interactive: 1, bulk: 2 });
+            await Promise.all([...bulk, interactive]);
+            expect(completed).to.deep.equal(['bulk1', 'interactive', 'bulk2', 'bulk3']);
+        });
+
+        it('throws on an interactive weight below 1', function () {
+            expect(() => scheduler.configureLanes({ interactiveWeight: 0 })).to.throw(RangeError);
+        });
+
+        it('throws on an unknown priority', function () {
+            expect(() => secp256k1.verify(Buffer.alloc(32), Buffer.alloc(64), Buffer.alloc(33), { priority: 'urgent' })).to.throw(TypeError);
+        });
+    });
+
+    describe('cancellation', function describeCancellation() {
+        it('drops queued work when its signal is aborted', async function () {
+            // Given
+            const { message, signature, publicKey } = await createSignedMessage();
+            scheduler.configureLanes({ concurrency: 1 });
+            const controller = new AbortController();
+
+            // When
+            const running = secp256k1.verify(message, signature, publicKey);
+            const queued = secp256k1.verify(message, signature, publicKey, { signal: controller.signal });
+            controller.abort();
+
+            // Then
+            expect(scheduler.lanes().interactive).to.equal(0);
+            await expect(queued).to.be.rejectedWith('The operation was aborted.');
+            expect(await running).to.be.true;
+        });
+
+        it('rejects with an AbortError', async function () {
+            // Given
+            const { message, signature, publicKey } = await createSignedMessage();
+            const controller = new AbortController();
+            controller.abort();
+
+            // When
+            const error = await secp256k1.verify(message, signature, publicKey, { signal: controller.signal })
+                .catch(err => err);
+
+            // Then
+            expect(error.name).to.equal('AbortError');
+            expect(error.code).to.equal('ABORT_ERR');
+        });
+
+        it('does not affect work whose signal is not aborted', async function () {
+            // Given
+            const { message, signature, publicKey } = await createSignedMessage();
+            const controller = new AbortController();
+
+            // When
+            const result = await secp256k1.verify(message, signature, publicKey, { signal: controller.signal });
+            controller.abort();
+
+            // Then
+            expect(result).to.be.true;
+        });
+    });
+
+    describe('worker threads', function describeWorkerThreads() {
+        it('keeps a separate scheduler in every worker', async function () {
+            // Given
+            const worker = new Worker(`
+                const { parentPort } = require('worker_threads');
+                const { blake2b, scheduler } = require(${JSON.stringify(path.resolve(__dirname, '../../src/js'))});
+
+                scheduler.configure('hash', { limit: 1, policy: 'reject' });
+                const results = Array.from({ length: 16 }, () => blake2b.hash(Buffer.alloc(1024), 32).then(() => 'ok', () => 'rejected'));
+
+                Promise.all(results).then(results => parentPort.postMessage({ results, depth: scheduler.depth('hash') }));
+            `, { eval: true });
+
+            // When
+            const hashes = await Promise.all(Array.from({ length: 16 }, () => blake2b.hash(Buffer.alloc(1024), 32)));
+            const { results, depth } = await new Promise((resolve, reject) => worker.once('message', resolve).once('error', reject));
+            await worker.terminate();
+
+            // Then
+            expect(hashes.length).to.equal(16);
+            expect(results.filter(result => 'ok' === result).length).to.equal(1);
+            expect(depth).to.deep.equal({ inFlight: 0, queued: 0, limit: 1 });
+            expect(scheduler.depth('hash')).to.deep.equal({ inFlight: 0, queued: 0, limit: 0 });
+        });
+    });
+});
+
+async function createSignedMessage() {
+    let privateKey;
+
+    do {
+        privateKey = randomBytes(32);
+    } while (!(await secp256k1.privateKeyVerify(privateKey)));
+
+    const message = randomBytes(32);
+    const { signature } = await secp256k1.sign(message, privateKey);
+
+    return {
+        message,
+        signature,
+        publicKey: await secp256k1.publicKeyCreate(privateKey)
+    };
+};
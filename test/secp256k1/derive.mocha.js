@@ -0,0 +1,105 @@
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { secp256k1 } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+// Test vector 1 of BIP32.
+const seed = Buffer.from('000102030405060708090a0b0c0d0e0f', 'hex');
+const vectors = [
+    {
+        path: "m/0'",
+        privateKey: 'edb2e14f9ee77d26dd93b4ecede8d16ed408ce149b6cd80b0715a2d911a0afea',
+        chainCode: '47fdacbd0f1097043b78c63c20c34ef4ed9a111d980047ad16282c7ae6236141'
+    },
+    {
+        path: "m/0'/1/2'/2/1000000000",
+        privateKey: '471b76e389e528d6de6d816857e012c5455051cad6660850e58372a6c3e6e7c8',
+        chainCode: 'c783e67b921d2beb8f6b389cc646d7263b4145701dadd2161548a8b078e65e9e'
+    }
+];
+
+describe('secp256k1', function describeSecp256k1() {
+    describe('hierarchical key derivation', function describeDerivation() {
+        afterEach(function () {
+            secp256k1.clearDerivationCache();
+        });
+
+        it('derives the master node from a seed', function () {
+            // When
+            const master = secp256k1.deriveMasterSync(seed);
+
+            // Then
+            expect(master.privateKey.toString('hex')).to.equal('e8f32e723decf4051aefac8e2c93c9c5b214313817cdb01a1494b917c8436b35');
+            expect(master.chainCode.toString('hex')).to.equal('873dff81c02f525623fd1fe5167eac3a55a049de3d314bb42ee227ffed37d508');
+        });
+
+        vectors.forEach(({ path, privateKey, chainCode }) => {
+            it(`derives ${path} sync and async`, async function () {
+                // Given
+                const master = secp256k1.deriveMasterSync(seed);
+
+                // When
+                const syncNode = secp256k1.derivePathSync(master, path);
+                const asyncNode = await secp256k1.derivePath(master, path);
+
+                // Then
+                [syncNode, asyncNode].forEach(node => {
+                    expect(node.privateKey.toString('hex')).to.equal(privateKey);
+                    expect(node.chainCode.toString('hex')).to.equal(chainCode);
+                });
+            });
+        });
+
+        it('derives the same public keys from a public parent', async function () {
+            // Given
+            const account = secp256k1.derivePathSync(secp256k1.deriveMasterSync(seed), "m/0'");
+            const neutered = { publicKey: await secp256k1.publicKeyCreate(account.privateKey), chainCode: account.chainCode };
+
+            // When
+            const privateChild = secp256k1.derivePathSync(account, [1, 5]);
+            const publicChild = secp256k1.derivePathSync(neutered, 'm/1/5');
+
+            // Then
+            expect(publicChild.publicKey.equals(await secp256k1.publicKeyCreate(privateChild.privateKey))).to.be.true;
+            expect(publicChild.chainCode.equals(privateChild.chainCode)).to.be.true;
+        });
+
+        it('cannot derive a hardened child from a public parent', function () {
+            // Given
+            const master = secp256k1.deriveMasterSync(seed);
+            const neutered = { publicKey: secp256k1.publicKeyCreateSync(master.privateKey), chainCode: master.chainCode };
+
+            // Then
+            expect(() => secp256k1.deriveChildSync(neutered, secp256k1.HARDENED)).to.throw();
+        });
+
+        it('derives a batch of children like single derivations', async function () {
+            // Given
+            const master = secp256k1.deriveMasterSync(seed);
+            const count = 600;
+
+            // When
+            const { privateKeys, chainCodes } = await secp256k1.deriveBatch(master, "m/0'/1", 10, count);
+
+            // Then
+            expect(privateKeys.length).to.equal(count * 32);
+
+            for (const i of [0, 255, 256, count - 1]) {
+                const node = secp256k1.derivePathSync(master, `m/0'/1/${10 + i}`);
+
+                expect(privateKeys.subarray(i * 32, (i + 1) * 32).equals(node.privateKey)).to.be.true;
+                expect(chainCodes.subarray(i * 32, (i + 1) * 32).equals(node.chainCode)).to.be.true;
+            }
+        });
+
+        it('parses paths', function () {
+            expect(secp256k1.parsePath("m/44'/0h/7")).to.deep.equal([44 + secp256k1.HARDENED, secp256k1.HARDENED, 7]);
+            expect(secp256k1.parsePath('m')).to.deep.equal([]);
+            expect(() => secp256k1.parsePath('m/x')).to.throw(RangeError);
+        });
+    });
+});
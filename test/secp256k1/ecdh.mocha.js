@@ -0,0 +1,113 @@
+const { createHash, randomBytes } = require('crypto');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { secp256k1 } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+describe('secp256k1', function describeSecp256k1() {
+    describe('ecdh', function describeEcdh() {
+        it('computes the same secret on both sides', async function () {
+            // Given
+            const alice = await generateKeyPair();
+            const bob = await generateKeyPair();
+
+            // When
+            const aliceSecret = await secp256k1.ecdh(bob.publicKey, alice.privateKey);
+            const bobSecret = secp256k1.ecdhSync(alice.publicKey, bob.privateKey);
+
+            // Then
+            expect(aliceSecret.length).to.equal(32);
+            expect(aliceSecret.equals(bobSecret)).to.be.true;
+        });
+
+        it('passes the shared point to a custom hash function', async function () {
+            // Given
+            const alice = await generateKeyPair();
+            const bob = await generateKeyPair();
+            const hashfn = (x, y) => Buffer.concat([x, y]);
+
+            // When
+            const point = await secp256k1.ecdh(bob.publicKey, alice.privateKey, { hashfn });
+            const secret = secp256k1.ecdhSync(bob.publicKey, alice.privateKey);
+
+            // Then
+            const compressedPoint = Buffer.concat([Buffer.from([0x02 | (point[63] & 1)]), point.subarray(0, 32)]);
+            const expectedSecret = createHash('sha256').update(compressedPoint).digest();
+
+            expect(point.length).to.equal(64);
+            expect(secret.equals(expectedSecret)).to.be.true;
+        });
+
+        it('zeroes the shared point once the hash function returns', async function () {
+            // Given
+            const alice = await generateKeyPair();
+            const bob = await generateKeyPair();
+            let coordinates;
+            const hashfn = (x, y) => {
+                coordinates = [x, y];
+                return Buffer.concat([x, y]);
+            };
+
+            // When
+            const point = secp256k1.ecdhSync(bob.publicKey, alice.privateKey, { hashfn });
+
+            // Then
+            expect(point.every(byte => byte === 0)).to.be.false;
+            expect(coordinates.every(coordinate => coordinate.every(byte => byte === 0))).to.be.true;
+        });
+
+        it('throws on a hash function that is not a function', async function () {
+            const alice = await generateKeyPair();
+            const bob = await generateKeyPair();
+
+            expect(() => secp256k1.ecdhSync(bob.publicKey, alice.privateKey, { hashfn: 'sha256' })).to.throw(TypeError);
+        });
+
+        it('computes a batch of secrets like single secrets', async function () {
+            // Given
+            const { privateKey } = await generateKeyPair();
+            const peers = await Promise.all(new Array(200).fill().map(() => generateKeyPair()));
+            const publicKeys = Buffer.concat(peers.map(peer => peer.publicKey));
+            // No public key starts with 0x05.
+            Buffer.concat([Buffer.from([0x05]), randomBytes(32)]).copy(publicKeys, 5 * 33);
+
+            // When
+            const { secrets, valid } = await secp256k1.ecdhBatch(publicKeys, privateKey);
+
+            // Then
+            for (let i = 0; i < 200; ++i) {
+                if (i === 5) {
+                    expect(valid[i]).to.equal(0);
+                    continue;
+                }
+
+                expect(valid[i]).to.equal(1);
+                expect(secrets.subarray(i * 32, (i + 1) * 32).equals(secp256k1.ecdhSync(peers[i].publicKey, privateKey))).to.be.true;
+            }
+        });
+
+        it('rejects an invalid public key', async function () {
+            const { privateKey } = await generateKeyPair();
+
+            expect(() => secp256k1.ecdhSync(randomBytes(20), privateKey)).to.throw(RangeError);
+        });
+    });
+});
+
+async function generateKeyPair() {
+    let privateKey;
+
+    do {
+        privateKey = randomBytes(32);
+    } while (!(await secp256k1.privateKeyVerify(privateKey)));
+
+    return {
+        privateKey,
+        publicKey: await secp256k1.publicKeyCreate(privateKey)
+    };
+};
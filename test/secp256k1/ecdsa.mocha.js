@@ -4,7 +4,7 @@ const path = require('path');
 const chai = require('chai');
 const chaiAsPromised = require('chai-as-promised');
 
-const { secp256k1 } = require('../../src/js');
+const { blake2b, secp256k1 } = require('../../src/js');
 
 
 chai.use(chaiAsPromised);
@@ -38,6 +38,212 @@ describe('secp256k1', function describeSecp256k1() {
             // Then
             expect(isValid).to.be.false;
         });
+
+        it('can sign and verify typed array views without copying them first', async function () {
+            // Given
+            const { privateKey, publicKey } = await generateKeyPair();
+            const message = randomBytes(32);
+            const backing = Buffer.concat([randomBytes(8), message, privateKey]);
+
+            // When
+            const { signature } = await secp256k1.sign(new Uint8Array(backing.buffer, backing.byteOffset + 8, 32),
+                new DataView(backing.buffer, backing.byteOffset + 40, 32));
+            const isValid = await secp256k1.verify(message.buffer.slice(message.byteOffset, message.byteOffset + 32),
+                new Uint8Array(signature), new Uint8Array(publicKey));
+
+            // Then
+            expect(isValid).to.be.true;
+        });
+    });
+
+    describe('key pair generation', function describeKeyPairGeneration() {
+        it('generates a matching key pair', async function () {
+            // Given
+            const syncKeyPair = secp256k1.generateKeyPairSync();
+            const asyncKeyPair = await secp256k1.generateKeyPair({ compressed: false });
+
+            // Then
+            expect(syncKeyPair.publicKey.equals(secp256k1.publicKeyCreateSync(syncKeyPair.privateKey, true))).to.be.true;
+            expect(asyncKeyPair.publicKey.equals(secp256k1.publicKeyCreateSync(asyncKeyPair.privateKey, false))).to.be.true;
+            expect(syncKeyPair.privateKey.equals(asyncKeyPair.privateKey)).to.be.false;
+        });
+
+        it('generates a batch of distinct key pairs', async function () {
+            // When
+            const { privateKeys, publicKeys } = await secp256k1.generateKeyPairs(1000);
+
+            // Then
+            const seen = new Set();
+
+            for (let i = 0; i < 1000; ++i) {
+                const privateKey = privateKeys.subarray(i * 32, (i + 1) * 32);
+
+                expect(secp256k1.privateKeyVerifySync(privateKey)).to.be.true;
+                expect(publicKeys.subarray(i * 33, (i + 1) * 33).equals(secp256k1.publicKeyCreateSync(privateKey))).to.be.true;
+
+                seen.add(privateKey.toString('hex'));
+            }
+
+            expect(seen.size).to.equal(1000);
+        });
+    });
+
+    describe('nonce strategies', function describeNonceStrategies() {
+        it('produces the same signature sync and async', async function () {
+            // Given
+            const { privateKey } = await generateKeyPair();
+            const message = randomBytes(32);
+            const data = randomBytes(32);
+            const tag = randomBytes(16);
+
+            for (const options of [{}, { data }, { nonce: 'rfc6979+tagged', tag }, { nonce: 'lowr' }]) {
+                // When
+                const syncResult = secp256k1.signSync(message, privateKey, options);
+                const asyncResult = await secp256k1.sign(message, privateKey, options);
+
+                // Then
+                expect(asyncResult.signature.equals(syncResult.signature)).to.be.true;
+                expect(asyncResult.recovery).to.equal(syncResult.recovery);
+            }
+        });
+
+        it('produces a different valid signature with each strategy', async function () {
+            // Given
+            const { privateKey, publicKey } = await generateKeyPair();
+            const message = randomBytes(32);
+
+            // When
+            const signatures = [
+                secp256k1.signSync(message, privateKey).signature,
+                secp256k1.signSync(message, privateKey, { nonce: 'rfc6979+entropy' }).signature,
+                secp256k1.signSync(message, privateKey, { nonce: 'rfc6979+tagged', tag: Buffer.alloc(16, 1) }).signature
+            ];
+
+            // Then
+            expect(new Set(signatures.map(signature => signature.toString('hex'))).size).to.equal(3);
+            signatures.forEach(signature => expect(secp256k1.verifySync(message, signature, publicKey)).to.be.true);
+        });
+
+        it('grinds for a low R value', async function () {
+            // Given
+            const { privateKey, publicKey } = await generateKeyPair();
+
+            for (let i = 0; i < 16; ++i) {
+                const message = randomBytes(32);
+
+                // When
+                const { signature } = secp256k1.signSync(message, privateKey, { nonce: 'lowr' });
+
+                // Then
+                expect(signature[0]).to.be.below(0x80);
+                expect(secp256k1.verifySync(message, signature, publicKey)).to.be.true;
+            }
+        });
+
+        it('keeps the extra entropy while grinding for a low R value', async function () {
+            // Given
+            const { privateKey } = await generateKeyPair();
+            const [data1, data2] = [randomBytes(32), randomBytes(32)];
+            let message;
+
+            // Both first attempts have a high R, so both signatures come from grinding.
+            do {
+                message = randomBytes(32);
+            } while (secp256k1.signSync(message, privateKey, { data: data1 }).signature[0] < 0x80
+                || secp256k1.signSync(message, privateKey, { data: data2 }).signature[0] < 0x80);
+
+            // When
+            const { signature: signature1 } = secp256k1.signSync(message, privateKey, { data: data1, nonce: 'lowr' });
+            const { signature: signature2 } = secp256k1.signSync(message, privateKey, { data: data2, nonce: 'lowr' });
+
+            // Then
+            expect(signature1[0]).to.be.below(0x80);
+            expect(signature1.equals(signature2)).to.be.false;
+        });
+
+        it('signs a batch like single signatures', async function () {
+            // Given
+            const { privateKey } = await generateKeyPair();
+            const messages = randomBytes(300 * 32);
+
+            // When
+            const { signatures, recoveries, valid } = await secp256k1.signBatch(messages, privateKey, { nonce: 'lowr' });
+
+            // Then
+            for (let i = 0; i < 300; ++i) {
+                const { signature, recovery } = secp256k1.signSync(messages.subarray(i * 32, (i + 1) * 32), privateKey, { nonce: 'lowr' });
+
+                expect(valid[i]).to.equal(1);
+                expect(recoveries[i]).to.equal(recovery);
+                expect(signatures.subarray(i * 64, (i + 1) * 64).equals(signature)).to.be.true;
+            }
+        });
+
+        it('requires a tag for the tagged strategy', async function () {
+            const { privateKey } = await generateKeyPair();
+
+            expect(() => secp256k1.signSync(randomBytes(32), privateKey, { nonce: 'rfc6979+tagged' })).to.throw(TypeError);
+        });
+    });
+
+    describe('message signatures', function describeMessageSignatures() {
+        it('signs the BLAKE2b-256 digest of the payload', async function () {
+            // Given
+            const { privateKey, publicKey } = await generateKeyPair();
+            const payload = randomBytes(1000);
+            const digest = await blake2b.hash(payload, 32);
+
+            // When
+            const syncResult = secp256k1.signMessageSync(payload, privateKey);
+            const asyncResult = await secp256k1.signMessage(payload, privateKey);
+
+            // Then
+            const expected = secp256k1.signSync(digest, privateKey);
+
+            expect(syncResult.signature.equals(expected.signature)).to.be.true;
+            expect(asyncResult.signature.equals(expected.signature)).to.be.true;
+            expect(asyncResult.recovery).to.equal(expected.recovery);
+            expect(secp256k1.verifyMessageSync(payload, syncResult.signature, publicKey)).to.be.true;
+            expect(await secp256k1.verifyMessage(payload, syncResult.signature, publicKey)).to.be.true;
+        });
+
+        it('personalizes the digest', async function () {
+            // Given
+            const { privateKey, publicKey } = await generateKeyPair();
+            // hashlib.blake2b(b'signun', digest_size=32, person=b'signun/message')
+            const digest = Buffer.from('995361af0d28f737d0870f86a7c2ea3af3f21337650fae8041e38d507b1c5d18', 'hex');
+
+            // When
+            const { signature } = await secp256k1.signMessage('signun', privateKey, { personal: 'signun/message' });
+
+            // Then
+            expect(secp256k1.verifySync(digest, signature, publicKey)).to.be.true;
+            expect(secp256k1.verifyMessageSync('signun', signature, publicKey, { personal: 'signun/message' })).to.be.true;
+            expect(secp256k1.verifyMessageSync('signun', signature, publicKey)).to.be.false;
+            expect(() => secp256k1.signMessageSync('signun', privateKey, { personal: Buffer.alloc(17) })).to.throw(RangeError);
+        });
+
+        it('signs and verifies a batch like single payloads', async function () {
+            // Given
+            const { privateKey, publicKey } = await generateKeyPair();
+            const payloads = new Array(300).fill().map((_, i) => randomBytes(i % 100));
+            const personal = Buffer.from('batch');
+
+            // When
+            const { signatures, recoveries, valid } = await secp256k1.signMessageBatch(payloads, privateKey, { personal, nonce: 'lowr' });
+            const tampered = payloads.map((payload, i) => i % 2 ? randomBytes(8) : payload);
+            const results = await secp256k1.verifyMessageBatch(tampered, signatures, Buffer.concat(payloads.map(() => publicKey)), { personal });
+
+            // Then
+            payloads.forEach((payload, i) => {
+                const { signature, recovery } = secp256k1.signMessageSync(payload, privateKey, { personal, nonce: 'lowr' });
+
+                expect(valid[i]).to.equal(1);
+                expect(recoveries[i]).to.equal(recovery);
+                expect(signatures.subarray(i * 64, (i + 1) * 64).equals(signature)).to.be.true;
+                expect(results[i]).to.equal(i % 2 ? 0 : 1);
+            });
+        });
     });
 });
 
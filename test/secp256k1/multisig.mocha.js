@@ -0,0 +1,89 @@
+const { randomBytes } = require('crypto');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { secp256k1 } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+describe('secp256k1', function describeSecp256k1() {
+    describe('multisig verification', function describeMultisig() {
+        const keyPairs = [0, 1, 2].map(() => secp256k1.generateKeyPairSync());
+        const publicKeys = keyPairs.map(keyPair => keyPair.publicKey);
+
+        function signWith(message, indices) {
+            return indices.map(i => secp256k1.signSync(message, keyPairs[i].privateKey).signature);
+        };
+
+        it('matches the signatures to the public keys in order', async function () {
+            // Given
+            const message = randomBytes(32);
+            const signatures = signWith(message, [0, 2]);
+
+            // When
+            const isValid = await secp256k1.verifyMultisig(message, signatures, publicKeys, 2);
+            const isValidSync = secp256k1.verifyMultisigSync(message, signatures, publicKeys, 2);
+            const isReversedValid = await secp256k1.verifyMultisig(message, [...signatures].reverse(), publicKeys, 2);
+
+            // Then
+            expect(isValid).to.equal(true);
+            expect(isValidSync).to.equal(true);
+            expect(isReversedValid).to.equal(false);
+        });
+
+        it('fails once a signature matches none of the public keys left', async function () {
+            // Given
+            const message = randomBytes(32);
+            const signatures = [...signWith(message, [0]), ...signWith(randomBytes(32), [1])];
+
+            // When
+            const isValid = await secp256k1.verifyMultisig(message, signatures, publicKeys, 2);
+            const isEmptyValid = await secp256k1.verifyMultisig(message, [], publicKeys, 0);
+
+            // Then
+            expect(isValid).to.equal(false);
+            expect(isEmptyValid).to.equal(true);
+        });
+
+        it('verifies DER signatures', function () {
+            // Given
+            const message = randomBytes(32);
+            const signatures = signWith(message, [1, 2]).map(signature => secp256k1.signatureExportSync(signature));
+
+            // When
+            const isValid = secp256k1.verifyMultisigSync(message, signatures, publicKeys, 2, { signatureFormat: 'der' });
+
+            // Then
+            expect(isValid).to.equal(true);
+        });
+
+        it('verifies a batch of checks like single checks', async function () {
+            // Given
+            const messages = [randomBytes(32), randomBytes(32), randomBytes(32)];
+            const checks = [
+                { message: messages[0], signatures: signWith(messages[0], [0, 1]), publicKeys, m: 2 },
+                { message: messages[1], signatures: signWith(messages[1], [2, 0]), publicKeys, m: 2 },
+                { message: messages[2], signatures: signWith(messages[2], [1]), publicKeys: publicKeys.slice(1), m: 1 }
+            ];
+
+            // When
+            const results = await secp256k1.verifyMultisigBatch(checks);
+
+            // Then
+            expect([...results]).to.deep.equal([1, 0, 1]);
+        });
+
+        it('requires exactly m signatures', function () {
+            // Given
+            const message = randomBytes(32);
+            const signatures = signWith(message, [0, 1]);
+
+            // Then
+            expect(() => secp256k1.verifyMultisigSync(message, signatures, publicKeys, 1)).to.throw(RangeError);
+            expect(() => secp256k1.verifyMultisigSync(message, signatures, publicKeys, 4)).to.throw(RangeError);
+        });
+    });
+});
@@ -0,0 +1,179 @@
+const { randomBytes } = require('crypto');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { secp256k1 } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+describe('secp256k1', function describeSecp256k1() {
+    describe('public key conversion', function describePublicKeyConversion() {
+        it('can convert between compressed and uncompressed public keys', async function () {
+            // Given
+            const privateKey = await generatePrivateKey();
+            const compressed = await secp256k1.publicKeyCreate(privateKey, true);
+            const uncompressed = await secp256k1.publicKeyCreate(privateKey, false);
+
+            // When
+            const decompressed = secp256k1.publicKeyConvertSync(compressed, 'uncompressed');
+            const recompressed = secp256k1.publicKeyConvertSync(uncompressed, 'compressed');
+
+            // Then
+            expect(decompressed.equals(uncompressed)).to.be.true;
+            expect(recompressed.equals(compressed)).to.be.true;
+        });
+
+        it('can convert to and from x-only public keys', async function () {
+            // Given
+            const publicKey = await secp256k1.publicKeyCreate(await generatePrivateKey());
+
+            // When
+            const xonly = secp256k1.publicKeyConvertSync(publicKey, 'xonly');
+            const lifted = secp256k1.publicKeyConvertSync(xonly, 'compressed');
+
+            // Then
+            expect(xonly.equals(publicKey.subarray(1))).to.be.true;
+            expect(lifted[0]).to.equal(0x02);
+            expect(lifted.subarray(1).equals(xonly)).to.be.true;
+        });
+
+        it('can convert public keys asynchronously', async function () {
+            // Given
+            const privateKey = await generatePrivateKey();
+            const compressed = secp256k1.publicKeyCreateSync(privateKey, true);
+            const uncompressed = secp256k1.publicKeyCreateSync(privateKey, false);
+
+            // When
+            const decompressed = await secp256k1.publicKeyConvert(compressed, 'uncompressed');
+            const xonly = await secp256k1.publicKeyConvert(uncompressed, 'xonly', { priority: 'bulk' });
+
+            // Then
+            expect(decompressed.equals(uncompressed)).to.be.true;
+            expect(xonly.equals(compressed.subarray(1))).to.be.true;
+            await expect(secp256k1.publicKeyConvert(Buffer.alloc(33, 0x07))).to.be.rejectedWith('Could not parse the public key.');
+        });
+
+        it('can convert a batch of public keys', async function () {
+            // Given
+            const count = 2000;
+            const compressed = [];
+            const uncompressed = [];
+
+            for (let i = 0; i < count; ++i) {
+                const privateKey = await generatePrivateKey();
+
+                compressed.push(secp256k1.publicKeyCreateSync(privateKey, true));
+                uncompressed.push(secp256k1.publicKeyCreateSync(privateKey, false));
+            }
+
+            // When
+            const { publicKeys, valid } = await secp256k1.publicKeyConvertBatch(Buffer.concat(compressed), 'compressed', 'uncompressed');
+
+            // Then
+            expect(publicKeys.equals(Buffer.concat(uncompressed))).to.be.true;
+            expect(valid.every(isValid => isValid === 1)).to.be.true;
+        });
+
+        it('flags the public keys of a batch that cannot be parsed', async function () {
+            // Given
+            const publicKey = await secp256k1.publicKeyCreate(await generatePrivateKey());
+            const invalidPublicKey = Buffer.alloc(33, 0x07);
+
+            // When
+            const { publicKeys, valid } = await secp256k1.publicKeyConvertBatch(Buffer.concat([invalidPublicKey, publicKey]), 'compressed', 'uncompressed');
+
+            // Then
+            expect([...valid]).to.deep.equal([0, 1]);
+            expect(publicKeys.subarray(0, 65).every(byte => byte === 0)).to.be.true;
+        });
+    });
+
+    describe('public key pinning', function describePublicKeyPinning() {
+        let maxBytes;
+
+        before(function () {
+            ({ maxBytes } = secp256k1.pinnedPublicKeyStats());
+        });
+
+        afterEach(function () {
+            secp256k1.configurePinnedPublicKeys({ maxBytes: 0 });
+            secp256k1.configurePinnedPublicKeys({ maxBytes });
+        });
+
+        it('verifies against a pinned public key in either form', async function () {
+            // Given
+            const privateKey = await generatePrivateKey();
+            const compressed = secp256k1.publicKeyCreateSync(privateKey, true);
+            const uncompressed = secp256k1.publicKeyCreateSync(privateKey, false);
+            const messages = Array.from({ length: 32 }, () => randomBytes(32));
+            const signatures = messages.map(message => secp256k1.signSync(message, privateKey).signature);
+            const tampered = Buffer.from(signatures[0]);
+            tampered[40] ^= 1;
+            const forged = Buffer.from(uncompressed);
+            forged[64] ^= 2;
+
+            // When
+            secp256k1.pinPublicKey(compressed);
+
+            // Then
+            expect(secp256k1.pinnedPublicKeyStats().count).to.equal(1);
+            expect(messages.every((message, i) => secp256k1.verifySync(message, signatures[i], compressed))).to.be.true;
+            expect(await secp256k1.verify(messages[0], signatures[0], uncompressed)).to.be.true;
+            expect(await secp256k1.verify(messages[1], signatures[0], compressed)).to.be.false;
+            expect(secp256k1.verifySync(messages[0], tampered, uncompressed)).to.be.false;
+            expect(() => secp256k1.verifySync(messages[0], signatures[0], forged)).to.throw('Could not parse the public key.');
+
+            const results = await secp256k1.verifyBatch(Buffer.concat(messages), Buffer.concat([tampered, ...signatures.slice(1)]),
+                Buffer.concat(messages.map(() => compressed)));
+            expect([...results]).to.deep.equal(messages.map((_, i) => (i === 0 ? 0 : 1)));
+
+            expect(secp256k1.unpinPublicKey(uncompressed)).to.be.true;
+            expect(secp256k1.unpinPublicKey(compressed)).to.be.false;
+        });
+
+        it('evicts the least recently used public key beyond maxBytes', async function () {
+            // Given
+            const privateKeys = [await generatePrivateKey(), await generatePrivateKey(), await generatePrivateKey()];
+            const [first, second, third] = privateKeys.map(privateKey => secp256k1.publicKeyCreateSync(privateKey));
+            const message = randomBytes(32);
+            const { signature } = secp256k1.signSync(message, privateKeys[0]);
+
+            secp256k1.pinPublicKey(first);
+            const { bytes } = secp256k1.pinnedPublicKeyStats();
+            secp256k1.configurePinnedPublicKeys({ maxBytes: 2 * bytes });
+
+            // When
+            secp256k1.pinPublicKey(second);
+            expect(await secp256k1.verify(message, signature, first)).to.be.true;
+            secp256k1.pinPublicKey(third);
+
+            // Then
+            expect(secp256k1.pinnedPublicKeyStats()).to.deep.equal({ count: 2, bytes: 2 * bytes, maxBytes: 2 * bytes, evictions: 1 });
+            expect(secp256k1.unpinPublicKey(second)).to.be.false;
+            expect(secp256k1.unpinPublicKey(first)).to.be.true;
+            expect(secp256k1.unpinPublicKey(third)).to.be.true;
+        });
+
+        it('rejects a public key that does not fit in maxBytes', function () {
+            // Given
+            secp256k1.configurePinnedPublicKeys({ maxBytes: 0 });
+
+            // Then
+            expect(() => secp256k1.pinPublicKey(secp256k1.publicKeyCreateSync(randomBytes(32).fill(1)))).to.throw('A pinned public key does not fit in maxBytes.');
+            expect(() => secp256k1.pinPublicKey(Buffer.alloc(33, 0x07))).to.throw('Could not parse the public key.');
+        });
+    });
+});
+
+async function generatePrivateKey() {
+    let privateKey;
+
+    do {
+        privateKey = randomBytes(32);
+    } while (!(await secp256k1.privateKeyVerify(privateKey)));
+
+    return privateKey;
+};
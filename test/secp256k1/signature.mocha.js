@@ -0,0 +1,156 @@
+const { randomBytes } = require('crypto');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { secp256k1 } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+describe('secp256k1', function describeSecp256k1() {
+    describe('signature encoding', function describeSignatureEncoding() {
+        it('can export a signature to DER and import it back', async function () {
+            // Given
+            const { privateKey } = await generateKeyPair();
+            const { signature } = await secp256k1.sign(randomBytes(32), privateKey);
+
+            // When
+            const derSignature = secp256k1.signatureExportSync(signature);
+            const importedSignature = secp256k1.signatureImportSync(derSignature);
+
+            // Then
+            expect(derSignature[0]).to.equal(0x30);
+            expect(importedSignature.equals(signature)).to.be.true;
+        });
+
+        it('fails to import a malformed DER signature', function () {
+            expect(() => secp256k1.signatureImportSync(Buffer.from([0x30, 0x01, 0x02]))).to.throw();
+        });
+
+        it('can export and import a batch of signatures', async function () {
+            // Given
+            const { signatures } = await signBatch(100);
+
+            // When
+            const derSignatures = await secp256k1.signatureExportBatch(signatures);
+            const imported = await secp256k1.signatureImportBatch(derSignatures);
+
+            // Then
+            expect(imported.signatures.equals(signatures)).to.be.true;
+            expect(imported.valid.every(isValid => isValid === 1)).to.be.true;
+        });
+
+        it('can normalize a batch of signatures like single signatures', async function () {
+            // Given
+            const { signatures } = await signBatch(10);
+
+            // When
+            const normalized = await secp256k1.signatureNormalizeBatch(signatures);
+
+            // Then
+            for (let i = 0; i < 10; ++i) {
+                const signature = signatures.subarray(i * 64, (i + 1) * 64);
+                const expected = secp256k1.signatureNormalizeSync(signature);
+
+                expect(normalized.subarray(i * 64, (i + 1) * 64).equals(expected)).to.be.true;
+            }
+        });
+    });
+
+    describe('batch verification', function describeBatchVerification() {
+        it('can verify a batch of compact signatures', async function () {
+            // Given
+            const { messages, signatures, publicKeys } = await signBatch(300);
+            randomBytes(32).copy(messages, 7 * 32);
+
+            // When
+            const results = await secp256k1.verifyBatch(messages, signatures, publicKeys);
+
+            // Then
+            expect(results.length).to.equal(300);
+            results.forEach((result, i) => expect(result).to.equal(i === 7 ? 0 : 1));
+        });
+
+        it('can verify a batch of DER signatures', async function () {
+            // Given
+            const { messages, signatures, publicKeys } = await signBatch(50);
+            const derSignatures = await secp256k1.signatureExportBatch(signatures);
+
+            // When
+            const results = await secp256k1.verifyBatch(messages, derSignatures, publicKeys, { signatureFormat: 'der' });
+
+            // Then
+            expect(results.every(result => result === 1)).to.be.true;
+        });
+
+        it('rejects signatures that do not match the messages', function () {
+            const messages = randomBytes(2 * 32);
+
+            expect(() => secp256k1.verifyBatch(messages, randomBytes(64), randomBytes(2 * 33))).to.throw(RangeError);
+        });
+
+        it('can deliver the results chunk by chunk', async function () {
+            // Given
+            const { messages, signatures, publicKeys } = await signBatch(300);
+            signatures[64 * 200] ^= 0xff;
+
+            // When
+            const results = Buffer.alloc(300, 0xff);
+            for await (const chunk of secp256k1.verifyBatchChunks(messages, signatures, publicKeys)) {
+                chunk.results.copy(results, chunk.start);
+                expect(chunk.results.length).to.equal(chunk.end - chunk.start);
+            }
+
+            // Then
+            results.forEach((result, i) => expect(result).to.equal(i === 200 ? 0 : 1));
+        });
+
+        it('aborts the rest of the batch when the iteration ends early', async function () {
+            // Given
+            const { messages, signatures, publicKeys } = await signBatch(1000);
+
+            // When
+            let chunkCount = 0;
+            for await (const chunk of secp256k1.verifyBatchChunks(messages, signatures, publicKeys)) {
+                chunkCount++;
+                break;
+            }
+
+            // Then
+            expect(chunkCount).to.equal(1);
+        });
+    });
+});
+
+async function generateKeyPair() {
+    let privateKey;
+
+    do {
+        privateKey = randomBytes(32);
+    } while (!(await secp256k1.privateKeyVerify(privateKey)));
+
+    return {
+        privateKey,
+        publicKey: await secp256k1.publicKeyCreate(privateKey)
+    };
+};
+
+async function signBatch(count) {
+    const { privateKey, publicKey } = await generateKeyPair();
+    const messages = randomBytes(count * 32);
+    const signatures = Buffer.alloc(count * 64);
+
+    for (let i = 0; i < count; ++i) {
+        const { signature } = secp256k1.signSync(messages.subarray(i * 32, (i + 1) * 32), privateKey);
+
+        signature.copy(signatures, i * 64);
+    }
+
+    return {
+        messages,
+        signatures,
+        publicKeys: Buffer.concat(new Array(count).fill(publicKey))
+    };
+};
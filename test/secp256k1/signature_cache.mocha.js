@@ -0,0 +1,116 @@
+const { randomBytes } = require('crypto');
+const { tmpdir } = require('os');
+const { chmodSync, existsSync, statSync, unlinkSync } = require('fs');
+const path = require('path');
+
+const chai = require('chai');
+const chaiAsPromised = require('chai-as-promised');
+
+const { secp256k1 } = require('../../src/js');
+
+
+chai.use(chaiAsPromised);
+const expect = chai.expect;
+
+describe('secp256k1', function describeSecp256k1() {
+    describe('signature cache', function describeSignatureCache() {
+        beforeEach(function () {
+            secp256k1.configureSignatureCache({ maxBytes: 64 * 1024 });
+        });
+
+        afterEach(function () {
+            secp256k1.configureSignatureCache({ maxBytes: 0 });
+        });
+
+        it('answers repeated verifies from the cache', async function () {
+            // Given
+            const { privateKey, publicKey } = secp256k1.generateKeyPairSync();
+            const message = randomBytes(32);
+            const { signature } = secp256k1.signSync(message, privateKey);
+
+            // When
+            const first = secp256k1.verifySync(message, signature, publicKey);
+            const second = await secp256k1.verify(message, signature, publicKey);
+            const tampered = await secp256k1.verify(randomBytes(32), signature, publicKey);
+
+            // Then
+            expect(first).to.be.true;
+            expect(second).to.be.true;
+            expect(tampered).to.be.false;
+            expect(secp256k1.signatureCacheStats()).to.include({
+                enabled: true,
+                capacity: 4096,
+                size: 1,
+                lookups: 3,
+                hits: 1,
+                insertions: 1
+            });
+        });
+
+        it('keeps normalized batch verifies apart from plain ones', async function () {
+            // Given
+            const { privateKey, publicKey } = secp256k1.generateKeyPairSync();
+            const message = randomBytes(32);
+            const { signature } = secp256k1.signSync(message, privateKey);
+
+            // When
+            await secp256k1.verifyBatch(message, signature, publicKey);
+            const [plain] = await secp256k1.verifyBatch(message, signature, publicKey);
+            const [normalized] = await secp256k1.verifyBatch(message, signature, publicKey, { normalize: true });
+
+            // Then
+            expect(plain).to.equal(1);
+            expect(normalized).to.equal(1);
+            expect(secp256k1.signatureCacheStats()).to.include({ size: 2, hits: 1 });
+        });
+
+        it('survives a save and load', async function () {
+            // Given
+            const file = path.join(tmpdir(), `signun-sigcache-${process.pid}.bin`);
+            const { privateKey, publicKey } = secp256k1.generateKeyPairSync();
+            const message = randomBytes(32);
+            const { signature } = secp256k1.signSync(message, privateKey);
+
+            secp256k1.verifySync(message, signature, publicKey);
+
+            // When
+            try {
+                secp256k1.saveSignatureCache(file);
+                secp256k1.configureSignatureCache({ maxBytes: 64 * 1024, path: file });
+
+                // Then
+                expect(await secp256k1.verify(message, signature, publicKey)).to.be.true;
+                expect(secp256k1.signatureCacheStats()).to.include({ size: 1, hits: 1 });
+                expect(() => secp256k1.configureSignatureCache({ maxBytes: 128 * 1024, path: file })).to.throw();
+            } finally {
+                if (existsSync(file)) {
+                    unlinkSync(file);
+                }
+            }
+        });
+
+        it('keeps the saved file private to the current user', function () {
+            if (process.platform === 'win32') {
+                this.skip();
+            }
+
+            // Given
+            const file = path.join(tmpdir(), `signun-sigcache-private-${process.pid}.bin`);
+
+            try {
+                // When
+                secp256k1.saveSignatureCache(file);
+
+                // Then
+                expect(statSync(file).mode & 0o777).to.equal(0o600);
+
+                chmodSync(file, 0o622);
+                expect(() => secp256k1.configureSignatureCache({ maxBytes: 64 * 1024, path: file })).to.throw('may be written by other users');
+            } finally {
+                if (existsSync(file)) {
+                    unlinkSync(file);
+                }
+            }
+        });
+    });
+});
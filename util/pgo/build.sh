@@ -0,0 +1,15 @@
+#!/bin/sh
+# Builds the addon with LTO and PGO: an instrumented build runs the training
+# workload, then the final build is optimized with the recorded profile.
+#
+#   sh ./util/pgo/build.sh [seconds per workload]
+set -e
+
+cd "$(dirname "$0")/../.."
+
+rm -rf pgo-profile
+mkdir -p pgo-profile
+
+node-gyp rebuild --signun_build_profile=pgo-generate
+node util/pgo/train.js "${1:-2}"
+node-gyp rebuild --signun_build_profile=pgo-use
@@ -0,0 +1,69 @@
+// Representative workload for profile-guided builds, which doubles as a
+// benchmark: run it against the default and the tuned build to compare.
+//
+//   node util/pgo/train.js [seconds per workload = 2]
+const { randomBytes } = require('crypto');
+
+const { blake2b, secp256k1 } = require('../../src/js');
+
+
+const BATCH_SIZE = 1024;
+
+const secondsPerWorkload = Number(process.argv[2] || 2);
+
+function createWorkloads() {
+    const { privateKey, publicKey } = secp256k1.generateKeyPairSync();
+    const message = randomBytes(32);
+    const { signature } = secp256k1.signSync(message, privateKey);
+
+    const messages = randomBytes(BATCH_SIZE * 32);
+    const publicKeys = Buffer.concat(new Array(BATCH_SIZE).fill(publicKey));
+    const signatures = Buffer.concat(new Array(BATCH_SIZE).fill().map((_, i) =>
+        secp256k1.signSync(messages.subarray(i * 32, (i + 1) * 32), privateKey).signature));
+
+    const small = randomBytes(64);
+    const large = randomBytes(1024 * 1024);
+    const key = randomBytes(32);
+    const mac = blake2b.createMac(key, 32);
+    const payloads = new Array(BATCH_SIZE).fill().map(() => randomBytes(256));
+
+    return [
+        ['signSync', 1, () => secp256k1.signSync(message, privateKey)],
+        ['verifySync', 1, () => secp256k1.verifySync(message, signature, publicKey)],
+        ['sign', 1, () => secp256k1.sign(message, privateKey)],
+        ['verify', 1, () => secp256k1.verify(message, signature, publicKey)],
+        ['signBatch', BATCH_SIZE, () => secp256k1.signBatch(messages, privateKey)],
+        ['verifyBatch', BATCH_SIZE, () => secp256k1.verifyBatch(messages, signatures, publicKeys)],
+        ['signMessageBatch', BATCH_SIZE, () => secp256k1.signMessageBatch(payloads, privateKey)],
+        ['hash 64 B', 1, () => blake2b.hash(small, 32)],
+        ['hash 1 MiB', 1, () => blake2b.hash(large, 32)],
+        ['keyedHash 64 B', 1, () => blake2b.keyedHash(small, key, 32)],
+        ['macSync 64 B', 1, () => mac.macSync(small)],
+        ['macMany', BATCH_SIZE, () => mac.macMany(payloads)]
+    ];
+};
+
+async function run(name, itemsPerCall, call) {
+    const deadline = process.hrtime.bigint() + BigInt(Math.round(secondsPerWorkload * 1e9));
+    const start = process.hrtime.bigint();
+    let items = 0;
+
+    do {
+        // Keeps a handful of async calls in flight, like a server would.
+        await Promise.all(new Array(8).fill().map(call));
+        items += 8 * itemsPerCall;
+    } while (process.hrtime.bigint() < deadline);
+
+    const seconds = Number(process.hrtime.bigint() - start) / 1e9;
+
+    console.log(`${name.padEnd(20)} ${Math.round(items / seconds).toString().padStart(12)} ops/s`);
+};
+
+(async function main() {
+    for (const [name, itemsPerCall, call] of createWorkloads()) {
+        await run(name, itemsPerCall, call);
+    }
+})().catch(err => {
+    console.error(err);
+    process.exit(1);
+});